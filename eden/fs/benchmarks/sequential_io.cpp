@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include <fcntl.h>
+#include <folly/Exception.h>
+#include <folly/File.h>
+#include <folly/String.h>
+#include <folly/portability/GFlags.h>
+#include <algorithm>
+#include <random>
+#include "eden/common/utils/benchharness/Bench.h"
+
+/**
+ * Measures the throughput of large sequential writes and reads of a file.
+ *
+ * Run it against a file in an EdenFS checkout to compare the FUSE data paths,
+ * e.g. with fuse:use-splice set and then unset. The file is written before
+ * being read, so that it is materialized and reads are served from the
+ * overlay.
+ */
+
+namespace {
+constexpr size_t kDefaultFileSize = 256 * 1024 * 1024;
+
+DEFINE_string(
+    filename,
+    "sequential_io.tmp",
+    "Path of the file to write and read");
+DEFINE_uint64(filesize, kDefaultFileSize, "File size in bytes");
+
+struct TemporaryFile {
+  TemporaryFile()
+      : file{FLAGS_filename, O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC} {
+    if (FLAGS_filesize == 0) {
+      throw std::invalid_argument{"file size must not be zero"};
+    }
+  }
+
+  ~TemporaryFile() {
+    file.close();
+    if (-1 == unlink(FLAGS_filename.c_str())) {
+      int err = errno;
+      fmt::print(
+          stderr,
+          "error unlinking {}: {}",
+          FLAGS_filename,
+          folly::errnoStr(err));
+    }
+  }
+
+  folly::File file;
+};
+
+int getTemporaryFD() {
+  static TemporaryFile tf;
+  return tf.file.fd();
+}
+
+using random_bytes_engine = std::independent_bits_engine<
+    std::default_random_engine,
+    CHAR_BIT,
+    unsigned short>;
+
+void sequential_write(benchmark::State& state) {
+  int fd = getTemporaryFD();
+  auto blockSize = static_cast<size_t>(state.range(0));
+
+  std::vector<uint8_t> block(blockSize);
+  std::generate(block.begin(), block.end(), random_bytes_engine{});
+
+  size_t total_written = 0;
+  uint64_t offset = 0;
+  for (auto _ : state) {
+    if (offset + blockSize > FLAGS_filesize) {
+      offset = 0;
+    }
+    auto result = pwrite(fd, block.data(), blockSize, offset);
+    folly::checkUnixError(result);
+    offset += result;
+    total_written += result;
+  }
+
+  state.SetBytesProcessed(total_written);
+}
+
+void sequential_read(benchmark::State& state) {
+  int fd = getTemporaryFD();
+  auto blockSize = static_cast<size_t>(state.range(0));
+
+  // Fill the file, which also materializes it.
+  std::vector<uint8_t> block(blockSize);
+  std::generate(block.begin(), block.end(), random_bytes_engine{});
+  for (uint64_t offset = 0; offset + blockSize <= FLAGS_filesize;
+       offset += blockSize) {
+    folly::checkUnixError(pwrite(fd, block.data(), blockSize, offset));
+  }
+  folly::checkUnixError(fsync(fd));
+
+  size_t total_read = 0;
+  uint64_t offset = FLAGS_filesize;
+  for (auto _ : state) {
+    if (offset + blockSize > FLAGS_filesize) {
+      // Drop the file from the page cache so that every read reaches EdenFS.
+      state.PauseTiming();
+      posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+      state.ResumeTiming();
+      offset = 0;
+    }
+    auto result = pread(fd, block.data(), blockSize, offset);
+    folly::checkUnixError(result);
+    offset += blockSize;
+    total_read += result;
+  }
+
+  state.SetBytesProcessed(total_read);
+}
+
+BENCHMARK(sequential_write)
+    // By default, google benchmark shows throughput numbers in bytes per CPU
+    // second. That's not useful, so tell it we care about wall clock time.
+    ->UseRealTime()
+    ->ArgName("block")
+    ->Arg(128 * 1024)
+    ->Arg(1024 * 1024);
+
+BENCHMARK(sequential_read)
+    ->UseRealTime()
+    ->ArgName("block")
+    ->Arg(128 * 1024)
+    ->Arg(1024 * 1024);
+
+} // namespace
+
+EDEN_BENCHMARK_MAIN();
@@ -25,6 +25,7 @@
 #include "eden/fs/config/HgObjectIdFormat.h"
 #include "eden/fs/config/MountProtocol.h"
 #include "eden/fs/config/ReaddirPrefetch.h"
+#include "eden/fs/config/RocksDbProfile.h"
 #include "eden/fs/eden-config.h"
 #include "eden/fs/utils/PathFuncs.h"
 
@@ -399,6 +400,15 @@ class EdenConfig : private ConfigSettingManager {
       100000,
       this};
 
+  /**
+   * Maximum number of processes whose fetches are counted. Beyond that, the
+   * processes fetching the least are forgotten. Only read at startup.
+   */
+  ConfigSetting<size_t> fetchCountsMaximumPids{
+      "store:fetch-counts-max-pids",
+      4096,
+      this};
+
   /**
    * The maximum number of tree prefetch operations to allow in parallel for any
    * checkout.  Setting this to 0 will disable prefetch operations.
@@ -408,6 +418,95 @@ class EdenConfig : private ConfigSettingManager {
       5,
       this};
 
+  /**
+   * Number of threads hashing large blobs. See BlobHasher.
+   */
+  ConfigSetting<uint8_t> blobHashingThreads{
+      "store:blob-hashing-threads",
+      4,
+      this};
+
+  /**
+   * Blobs of at least this many bytes are hashed on the blob hashing threads
+   * rather than inline on the thread that needs the hash. Their metadata only
+   * holds the SHA-1 hash; the BLAKE3 hash is computed lazily, if requested.
+   */
+  ConfigSetting<size_t> blobHashingParallelThreshold{
+      "store:blob-hashing-parallel-threshold",
+      1024 * 1024,
+      this};
+
+  /**
+   * Maximum number of trees that ObjectStore::prefetchTrees requests at once.
+   * Larger batches make fewer round trips to the backing store, at the cost
+   * of memory.
+   */
+  ConfigSetting<uint32_t> prefetchTreesBatchSize{
+      "store:prefetch-trees-batch-size",
+      10000,
+      this};
+
+  /**
+   * Maximum number of entries kept in the ObjectStore's in-memory blob
+   * metadata cache. Each entry takes around 100 bytes.
+   */
+  ConfigSetting<size_t> blobMetadataCacheSize{
+      "store:blob-metadata-cache-size",
+      1'000'000,
+      this};
+
+  /**
+   * Number of independently locked shards the blob metadata cache is split
+   * into.
+   */
+  ConfigSetting<size_t> blobMetadataCacheShards{
+      "store:blob-metadata-cache-shards",
+      64,
+      this};
+
+  /**
+   * Whether writes to the LocalStore are queued and committed in large
+   * batches by a dedicated thread, instead of being committed by every
+   * importing thread. Only read at startup.
+   */
+  ConfigSetting<bool> localStoreGroupCommit{"store:group-commit", false, this};
+
+  /**
+   * Number of bytes of queued LocalStore writes that causes a batch to be
+   * committed right away.
+   */
+  ConfigSetting<size_t> localStoreGroupCommitBatchBytes{
+      "store:group-commit-batch-bytes",
+      4 * 1024 * 1024,
+      this};
+
+  /**
+   * Maximum time a LocalStore write stays queued before its batch is
+   * committed.
+   */
+  ConfigSetting<std::chrono::nanoseconds> localStoreGroupCommitInterval{
+      "store:group-commit-interval",
+      std::chrono::milliseconds{5},
+      this};
+
+  /**
+   * How the column families of the RocksDB LocalStore are tuned. One of
+   * "uniform", "per-keyspace" or "per-keyspace-zstd". Only read at startup.
+   */
+  ConfigSetting<RocksDbProfile> rocksDbProfile{
+      "store:rocksdb-profile",
+      RocksDbProfile::Uniform,
+      this};
+
+  /**
+   * Number of read-only connections that lookups in the SQLite LocalStore are
+   * spread over. Only read at startup.
+   */
+  ConfigSetting<size_t> localStoreSqliteReaders{
+      "store:sqlite-reader-connections",
+      4,
+      this};
+
   // [fuse]
 
   /**
@@ -458,6 +557,52 @@ class EdenConfig : private ConfigSettingManager {
    */
   ConfigSetting<uint32_t> maximumFuseRequests{"fuse:max-requests", 1000, this};
 
+  /**
+   * Whether the kernel should be told to list directories with
+   * FUSE_READDIRPLUS, which returns the attributes of the entries along with
+   * them, saving a lookup per entry. Only applies to Linux, and to mounts
+   * started after it is changed.
+   */
+  ConfigSetting<bool> fuseUseReaddirplus{"fuse:use-readdirplus", false, this};
+
+  /**
+   * Whether FUSE requests and replies should be moved through pipes with
+   * splice(2), so that the data of large writes, and of large reads of
+   * materialized files, goes between the kernel and the overlay without being
+   * copied to userspace. Only applies to Linux, and to mounts started after it
+   * is changed.
+   */
+  ConfigSetting<bool> fuseUseSplice{"fuse:use-splice", false, this};
+
+  /**
+   * How many file descriptors the FUSE worker threads of a mount read
+   * requests from. Beyond the first, they are clones of the mount's FUSE
+   * device, and the worker threads are spread evenly over them, so that they
+   * do not all wait on the same descriptor. Only applies to Linux, is capped
+   * by the number of worker threads, and applies to mounts started after it
+   * is changed.
+   */
+  ConfigSetting<size_t> fuseDeviceQueues{"fuse:device-queues", 1, this};
+
+  /**
+   * Whether to receive FUSE requests and send their replies through one
+   * io_uring per CPU rather than read(2) and write(2) on the FUSE device.
+   * Requires Linux 6.14 or newer, with the enable_uring parameter of the fuse
+   * module set. Requests otherwise keep going through the FUSE device. Applies
+   * to mounts started after it is changed, and carries over graceful restarts
+   * of the mounts that use it.
+   */
+  ConfigSetting<bool> fuseUseIoUring{"fuse:use-io-uring", false, this};
+
+  /**
+   * How many requests each FUSE-over-io_uring ring can hold at once. Each
+   * takes a buffer as large as the largest FUSE request.
+   */
+  ConfigSetting<size_t> fuseIoUringQueueDepth{
+      "fuse:io-uring-queue-depth",
+      8,
+      this};
+
   // [nfs]
 
   /**
@@ -706,6 +851,74 @@ class EdenConfig : private ConfigSettingManager {
       1024,
       this};
 
+  /**
+   * Keep the pending import requests in per-type, per-priority-class lanes
+   * with sharded de-duplication, rather than in heaps protected by a single
+   * lock. Reduces contention between the threads enqueueing requests and the
+   * import threads. Only read when the backing store is created.
+   */
+  ConfigSetting<bool> importQueueLanes{"hg:import-queue-lanes", false, this};
+
+  /**
+   * Share the import threads fairly between the processes issuing requests,
+   * rather than always importing the most urgent request first. Requests are
+   * grouped by client pid, or by cause when the pid is unknown, and the
+   * groups are served in weighted round-robin order, so that a process
+   * fetching many objects cannot starve the others. Takes precedence over
+   * hg:import-queue-lanes. Only read when the backing store is created.
+   */
+  ConfigSetting<bool> importQueueFairScheduling{
+      "hg:import-queue-fair-scheduling",
+      false,
+      this};
+
+  /**
+   * When true, the import-batch-size* settings are only the initial batch
+   * sizes, and HgImportRequestQueue tunes the batch size of each object type
+   * from the observed batch latency: it grows the size additively while
+   * batches are full and finish under adaptive-import-batch-latency-target,
+   * and halves it whenever a batch takes longer.
+   */
+  ConfigSetting<bool> adaptiveImportBatchSize{
+      "hg:adaptive-import-batch-size",
+      false,
+      this};
+
+  /**
+   * Lower bound of the adaptive import batch sizes.
+   */
+  ConfigSetting<uint32_t> adaptiveImportBatchSizeMin{
+      "hg:adaptive-import-batch-size-min",
+      1,
+      this};
+
+  /**
+   * Upper bound of the adaptive import batch sizes.
+   */
+  ConfigSetting<uint32_t> adaptiveImportBatchSizeMax{
+      "hg:adaptive-import-batch-size-max",
+      2048,
+      this};
+
+  /**
+   * How many requests an adaptive import batch size grows by after a full
+   * batch finished under the latency target.
+   */
+  ConfigSetting<uint32_t> adaptiveImportBatchSizeStep{
+      "hg:adaptive-import-batch-size-step",
+      8,
+      this};
+
+  /**
+   * Batches taking longer than this to import shrink the adaptive import
+   * batch size, so that interactive requests queued behind a large prefetch
+   * are not delayed for too long.
+   */
+  ConfigSetting<std::chrono::nanoseconds> adaptiveImportBatchLatencyTarget{
+      "hg:adaptive-import-batch-latency-target",
+      std::chrono::milliseconds(200),
+      this};
+
   /**
    * Whether fetching trees should fall back on an external hg importer process.
    */
@@ -739,6 +952,24 @@ class EdenConfig : private ConfigSettingManager {
       32,
       this};
 
+  // [git]
+
+  /**
+   * Number of threads importing objects from a git repository. Each of them
+   * has its own libgit2 repository handle.
+   */
+  ConfigSetting<uint32_t> gitImportThreads{"git:num-import-threads", 8, this};
+
+  /**
+   * Maximum number of trees or blobs that a git import thread takes off the
+   * import queue at once. Threads split the queue evenly between them, so
+   * they only take this many when a lot of requests are queued.
+   */
+  ConfigSetting<uint32_t> gitImportBatchSize{
+      "git:import-batch-size",
+      32,
+      this};
+
   // [telemetry]
 
   /**
@@ -927,6 +1158,82 @@ class EdenConfig : private ConfigSettingManager {
       16,
       this};
 
+  /**
+   * Number of independently locked shards the blob cache is split into. The
+   * cache size and minimum item count are divided evenly between the shards.
+   */
+  ConfigSetting<size_t> inMemoryBlobCacheShards{
+      "blobcache:num-shards",
+      1,
+      this};
+
+  /**
+   * Whether the blob cache uses the scan-resistant W-TinyLFU policy instead
+   * of evicting the least recently used blobs, so that reading many files once
+   * does not flush the blobs that are read over and over. Only read at
+   * startup.
+   */
+  ConfigSetting<bool> inMemoryBlobCacheTinyLfu{
+      "blobcache:enable-tiny-lfu",
+      false,
+      this};
+
+  /**
+   * How many bytes worth of blob chunks to keep in memory, at most. Chunks are
+   * only used to read files at least blobcache:chunked-read-threshold bytes
+   * long.
+   */
+  ConfigSetting<size_t> inMemoryBlobChunkCacheSize{
+      "blobcache:chunk-cache-size",
+      40 * 1024 * 1024,
+      this};
+
+  /**
+   * Files at least this large are read one chunk at a time instead of loading
+   * the entire blob before serving the first byte. 0 disables chunked reads.
+   */
+  ConfigSetting<uint64_t> chunkedReadThreshold{
+      "blobcache:chunked-read-threshold",
+      0,
+      this};
+
+  /**
+   * Whether large blobs are cached in individual files under the EdenFS state
+   * directory instead of in the local store. Only read at startup.
+   */
+  ConfigSetting<bool> enableDiskBlobCache{
+      "blobcache:enable-disk-cache",
+      false,
+      this};
+
+  /**
+   * How many bytes worth of blobs to keep in the on-disk blob cache, at most.
+   */
+  ConfigSetting<uint64_t> diskBlobCacheSize{
+      "blobcache:disk-cache-size",
+      10ull * 1024 * 1024 * 1024,
+      this};
+
+  /**
+   * Blobs at least this large go to the on-disk blob cache rather than the
+   * local store. Smaller blobs are cheaper to keep in the local store.
+   */
+  ConfigSetting<uint64_t> diskBlobCacheMinimumBlobSize{
+      "blobcache:disk-cache-minimum-blob-size",
+      1024 * 1024,
+      this};
+
+  /**
+   * How many bytes worth of blobs may wait to be written to the on-disk blob
+   * cache, at most. Blobs fetched while the writes are this far behind are
+   * not cached on disk, rather than being kept in memory. Only read at
+   * startup.
+   */
+  ConfigSetting<uint64_t> diskBlobCacheMaximumPendingWriteBytes{
+      "blobcache:disk-cache-max-pending-write-bytes",
+      256 * 1024 * 1024,
+      this};
+
   // [treecache]
 
   /**
@@ -954,6 +1261,24 @@ class EdenConfig : private ConfigSettingManager {
       16,
       this};
 
+  /**
+   * Number of independently locked shards the tree cache is split into. The
+   * cache size and minimum item count are divided evenly between the shards.
+   */
+  ConfigSetting<size_t> inMemoryTreeCacheShards{
+      "treecache:num-shards",
+      1,
+      this};
+
+  /**
+   * Whether the tree cache uses the scan-resistant W-TinyLFU policy instead
+   * of evicting the least recently used trees. Only read at startup.
+   */
+  ConfigSetting<bool> inMemoryTreeCacheTinyLfu{
+      "treecache:enable-tiny-lfu",
+      false,
+      this};
+
   // [notifications]
 
   /**
@@ -1155,6 +1480,15 @@ class EdenConfig : private ConfigSettingManager {
       true,
       this};
 
+  /**
+   * Whether prefetchFiles fetches the trees that its globs can reach, level
+   * by level, before evaluating the globs.
+   */
+  ConfigSetting<bool> prefetchFilesPrefetchTrees{
+      "glob:prefetch-files-prefetch-trees",
+      false,
+      this};
+
   // [doctor]
 
   /**
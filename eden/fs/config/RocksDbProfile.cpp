@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/config/RocksDbProfile.h"
+
+namespace facebook::eden {
+
+namespace {
+
+constexpr auto rocksDbProfileStr = [] {
+  std::array<folly::StringPiece, 3> mapping{};
+  mapping[folly::to_underlying(RocksDbProfile::Uniform)] = "uniform";
+  mapping[folly::to_underlying(RocksDbProfile::PerKeySpace)] = "per-keyspace";
+  mapping[folly::to_underlying(RocksDbProfile::PerKeySpaceZstd)] =
+      "per-keyspace-zstd";
+  return mapping;
+}();
+
+}
+
+folly::Expected<RocksDbProfile, std::string>
+FieldConverter<RocksDbProfile>::fromString(
+    folly::StringPiece value,
+    const std::map<std::string, std::string>& /*unused*/) const {
+  for (auto i = 0ul; i < rocksDbProfileStr.size(); i++) {
+    if (value.equals(rocksDbProfileStr[i], folly::AsciiCaseInsensitive())) {
+      return static_cast<RocksDbProfile>(i);
+    }
+  }
+
+  return folly::makeUnexpected(
+      fmt::format("Failed to convert value '{}' to a RocksDbProfile.", value));
+}
+
+std::string FieldConverter<RocksDbProfile>::toDebugString(
+    RocksDbProfile value) const {
+  return rocksDbProfileStr[folly::to_underlying(value)].str();
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include "eden/fs/config/FieldConverter.h"
+
+namespace facebook::eden {
+
+/**
+ * How the column families of the RocksDB LocalStore are tuned.
+ */
+enum class RocksDbProfile {
+  /**
+   * Every KeySpace uses the same options, except for a smaller block cache
+   * for blobs.
+   */
+  Uniform,
+  /**
+   * Block size, bloom filter and compression are chosen for the values of
+   * each KeySpace. Trees are compressed with LZ4 and a dictionary sampled from
+   * them.
+   */
+  PerKeySpace,
+  /**
+   * Like PerKeySpace, but trees are compressed with zstd and a dictionary
+   * trained on them. Requires RocksDB to be built with zstd.
+   */
+  PerKeySpaceZstd,
+};
+
+template <>
+class FieldConverter<RocksDbProfile> {
+ public:
+  folly::Expected<RocksDbProfile, std::string> fromString(
+      folly::StringPiece value,
+      const std::map<std::string, std::string>& convData) const;
+
+  std::string toDebugString(RocksDbProfile value) const;
+};
+
+} // namespace facebook::eden
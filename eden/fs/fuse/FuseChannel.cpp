@@ -10,12 +10,17 @@
 #include "eden/fs/fuse/FuseChannel.h"
 
 #include <boost/cast.hpp>
+#include <fcntl.h>
 #include <fmt/core.h>
+#include <folly/FileUtil.h>
 #include <folly/executors/QueuedImmediateExecutor.h>
 #include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
 #include <folly/system/ThreadName.h>
+#include <pthread.h>
 #include <signal.h>
+#include <sys/ioctl.h>
+#include <algorithm>
 #include <chrono>
 #include <type_traits>
 #include "eden/common/utils/Synchronized.h"
@@ -176,6 +181,7 @@ std::string readdir(FuseArg arg) {
   return fmt::format("offset={}", in.offset);
 }
 
+constexpr RenderFn readdirplus = readdir;
 constexpr RenderFn releasedir = default_render;
 constexpr RenderFn fsyncdir = default_render;
 
@@ -217,6 +223,14 @@ static_assert(
 // This is the minimum size used by libfuse so we use it too!
 constexpr size_t MIN_BUFSIZE = 0x21000;
 
+#ifdef __linux__
+// Read and write payloads smaller than this are copied rather than spliced:
+// splicing them takes more syscalls than copying them costs.
+constexpr size_t kMinSplicedPayloadSize = 32 * 1024;
+
+constexpr size_t kMaxPooledSplicePipes = 64;
+#endif
+
 using Handler = ImmediateFuture<folly::Unit> (FuseChannel::*)(
     FuseRequestContext& request,
     const fuse_in_header& header,
@@ -479,7 +493,13 @@ constexpr auto kFuseHandlers = [] {
       &FuseStats::fallocate,
       Write};
 #ifdef __linux__
-  handlers[FUSE_READDIRPLUS] = {"FUSE_READDIRPLUS", Read};
+  handlers[FUSE_READDIRPLUS] = {
+      "FUSE_READDIRPLUS",
+      &FuseChannel::fuseReadDirPlus,
+      &argrender::readdirplus,
+      &FuseStats::readdirplus,
+      Read,
+      SamplingGroup::Three};
   handlers[FUSE_RENAME2] = {"FUSE_RENAME2", Write};
   handlers[FUSE_LSEEK] = {"FUSE_LSEEK"};
   handlers[FUSE_COPY_FILE_RANGE] = {"FUSE_COPY_FILE_RANGE", Write};
@@ -570,6 +590,20 @@ std::string capsFlagsToLabel(uint32_t flags) {
   return fmt::format("{} unknown:0x{:x}", str, flags);
 }
 
+/**
+ * Every device queue needs at least one worker thread, and clones of the FUSE
+ * device are only supported on Linux.
+ */
+size_t clampDeviceQueues(size_t numDeviceQueues, size_t numThreads) {
+#ifdef __linux__
+  return std::clamp<size_t>(numDeviceQueues, 1, numThreads);
+#else
+  (void)numDeviceQueues;
+  (void)numThreads;
+  return 1;
+#endif
+}
+
 void sigusr2Handler(int /* signum */) {
   // Do nothing.
   // The purpose of this signal is only to interrupt the blocking read() calls
@@ -695,14 +729,22 @@ std::ostream& operator<<(
             << ")";
 }
 
-void FuseChannel::replyError(const fuse_in_header& request, int errorCode) {
+void FuseChannel::replyError(
+    const ReplyTarget& target,
+    const fuse_in_header& request,
+    int errorCode) {
   fuse_out_header err;
   err.len = sizeof(err);
   err.error = -errorCode;
   err.unique = request.unique;
   XLOG(DBG7) << "replyError unique=" << err.unique << " error=" << errorCode
              << " " << folly::errnoStr(errorCode);
-  auto res = write(fuseDevice_.fd(), &err, sizeof(err));
+  if (target.uringEntry) {
+    auto iov = make_iovec(err);
+    FuseUring::commit(*target.uringEntry, &iov, 1);
+    return;
+  }
+  auto res = write(target.fuseDevice, &err, sizeof(err));
   if (res != sizeof(err)) {
     if (res < 0) {
       throwSystemError("replyError: error writing to fuse device");
@@ -713,6 +755,7 @@ void FuseChannel::replyError(const fuse_in_header& request, int errorCode) {
 }
 
 void FuseChannel::sendReply(
+    const ReplyTarget& target,
     const fuse_in_header& request,
     folly::fbvector<iovec>&& vec) const {
   fuse_out_header out;
@@ -721,10 +764,11 @@ void FuseChannel::sendReply(
 
   vec.insert(vec.begin(), make_iovec(out));
 
-  sendRawReply(vec.data(), vec.size());
+  sendRawReply(target, vec.data(), vec.size());
 }
 
 void FuseChannel::sendReply(
+    const ReplyTarget& target,
     const fuse_in_header& request,
     const folly::IOBuf& buf) const {
   fuse_out_header out;
@@ -736,10 +780,11 @@ void FuseChannel::sendReply(
   vec.push_back(make_iovec(out));
   buf.appendToIov(&vec);
 
-  sendRawReply(vec.data(), vec.size());
+  sendRawReply(target, vec.data(), vec.size());
 }
 
 void FuseChannel::sendReply(
+    const ReplyTarget& target,
     const fuse_in_header& request,
     folly::ByteRange bytes) const {
   fuse_out_header out;
@@ -752,10 +797,62 @@ void FuseChannel::sendReply(
   iov[1].iov_base = const_cast<uint8_t*>(bytes.data());
   iov[1].iov_len = bytes.size();
 
-  sendRawReply(iov.data(), iov.size());
+  sendRawReply(target, iov.data(), iov.size());
 }
 
-void FuseChannel::sendRawReply(const iovec iov[], size_t count) const {
+#ifdef __linux__
+void FuseChannel::sendReply(
+    const ReplyTarget& target,
+    const fuse_in_header& request,
+    Pipe& data,
+    size_t size,
+    Pipe& reply) const {
+  XDCHECK(!target.uringEntry);
+  fuse_out_header out;
+  out.unique = request.unique;
+  out.error = 0;
+  out.len = sizeof(out) + size;
+
+  // The kernel expects the whole reply from a single splice() call, so the
+  // header is queued before the payload in reply.
+  auto res = folly::writeFull(reply.write.fd(), &out, sizeof(out));
+  folly::checkUnixError(res, "unable to write reply header to splice pipe");
+  size_t moved = 0;
+  while (moved < size) {
+    res = splice(
+        data.read.fd(),
+        nullptr,
+        reply.write.fd(),
+        nullptr,
+        size - moved,
+        SPLICE_F_MOVE);
+    folly::checkUnixError(res, "unable to move reply payload between pipes");
+    moved += res;
+  }
+
+  res = splice(
+      reply.read.fd(), nullptr, target.fuseDevice, nullptr, out.len, 0);
+  const int err = errno;
+  XLOG(DBG7) << "sendReply: unique=" << out.unique << " len=" << out.len
+             << " spliced=" << res;
+  if (res < 0) {
+    if (err == ENOENT) {
+      // Interrupted by a signal.  We don't need to log this,
+      // but will propagate it back to our caller.
+    } else if (!isFuseDeviceValid(state_.rlock()->stopReason)) {
+      XLOG(INFO) << "error writing to fuse device: session closed";
+    } else {
+      XLOG(WARNING) << "error writing to fuse device: " << folly::errnoStr(err);
+    }
+    throwSystemErrorExplicit(err, "error writing to fuse device");
+  }
+}
+#endif
+
+void FuseChannel::sendRawReply(
+    const ReplyTarget& target,
+    const iovec iov[],
+    size_t count) const {
   // Ensure that the length is set correctly
   XDCHECK_EQ(iov[0].iov_len, sizeof(fuse_out_header));
   const auto header = reinterpret_cast<fuse_out_header*>(iov[0].iov_base);
@@ -764,7 +861,14 @@ void FuseChannel::sendRawReply(const iovec iov[], size_t count) const {
     header->len += iov[i].iov_len;
   }
 
-  const auto res = writev(fuseDevice_.fd(), iov, count);
+  if (target.uringEntry) {
+    XLOG(DBG7) << "sendRawReply: unique=" << header->unique
+               << " header->len=" << header->len << " committed";
+    FuseUring::commit(*target.uringEntry, iov, count);
+    return;
+  }
+
+  const auto res = writev(target.fuseDevice, iov, count);
   const int err = errno;
   XLOG(DBG7) << "sendRawReply: unique=" << header->unique
              << " header->len=" << header->len << " wrote=" << res;
@@ -795,7 +899,12 @@ FuseChannel::FuseChannel(
     CaseSensitivity caseSensitive,
     bool requireUtf8Path,
     int32_t maximumBackgroundRequests,
-    bool useWriteBackCache)
+    bool useWriteBackCache,
+    bool useReaddirplus,
+    bool useSplice,
+    size_t numDeviceQueues,
+    bool useIoUring,
+    size_t ioUringQueueDepth)
     : bufferSize_(std::max(size_t(getpagesize()) + 0x1000, MIN_BUFSIZE)),
       numThreads_(numThreads),
       dispatcher_(std::move(dispatcher)),
@@ -807,7 +916,14 @@ FuseChannel::FuseChannel(
       requireUtf8Path_{requireUtf8Path},
       maximumBackgroundRequests_{maximumBackgroundRequests},
       useWriteBackCache_{useWriteBackCache},
+      useReaddirplus_{useReaddirplus},
+      useSplice_{useSplice},
+      useIoUring_{useIoUring},
+      ioUringQueueDepth_{std::max(ioUringQueueDepth, size_t{1})},
+      numDeviceQueues_{clampDeviceQueues(numDeviceQueues, numThreads)},
+      pid_{getpid()},
       fuseDevice_(std::move(fuseDevice)),
+      deviceQueues_(std::make_unique<DeviceQueue[]>(numDeviceQueues_)),
       processAccessLog_(std::move(processNameCache)),
       traceDetailedArguments_(std::make_shared<std::atomic<size_t>>(0)),
       traceBus_(TraceBus<FuseTraceEvent>::create(
@@ -901,9 +1017,20 @@ void FuseChannel::startWorkerThreads() {
   }
 
   try {
+    cloneDeviceQueues();
+
+    // The thread that read the INIT packet, if any, serves the first queue.
+    // The others are spread evenly over the queues.
     state->workerThreads.reserve(numThreads_);
     while (state->workerThreads.size() < numThreads_) {
-      state->workerThreads.emplace_back([this] { fuseWorkerThread(); });
+      auto& queue =
+          deviceQueues_[state->workerThreads.size() % numDeviceQueues_];
+      state->workerThreads.emplace_back(
+          [this, &queue] { fuseWorkerThread(queue); });
+    }
+
+    if (isUsingIoUring()) {
+      startUringThreads(*state);
     }
 
     invalidationThread_ = std::thread([this] { invalidationThread(); });
@@ -1069,7 +1196,7 @@ void FuseChannel::sendInvalidateInode(
   iov[1].iov_len = sizeof(notify);
 
   try {
-    sendRawReply(iov.data(), iov.size());
+    sendRawReply(ReplyTarget{fuseDevice_.fd()}, iov.data(), iov.size());
     XLOG(DBG7) << "sendInvalidateInode(ino=" << ino << ", off=" << off
                << ", len=" << len << ") OK!";
   } catch (const std::system_error& exc) {
@@ -1128,7 +1255,7 @@ void FuseChannel::sendInvalidateEntry(
   iov[3].iov_len = 1;
 
   try {
-    sendRawReply(iov.data(), iov.size());
+    sendRawReply(ReplyTarget{fuseDevice_.fd()}, iov.data(), iov.size());
   } catch (const std::system_error& exc) {
     // Ignore ENOENT.  This can happen for inode numbers that we allocated on
     // our own and haven't actually told the kernel about yet.
@@ -1146,6 +1273,17 @@ void FuseChannel::sendInvalidateEntry(
   }
 }
 
+FuseChannel::DeviceQueueStats FuseChannel::getDeviceQueueStats(
+    size_t queue) const {
+  XCHECK_LT(queue, numDeviceQueues_);
+  const auto& deviceQueue = deviceQueues_[queue];
+  return DeviceQueueStats{
+      deviceQueue.depth.load(std::memory_order_relaxed),
+      deviceQueue.requests.load(std::memory_order_relaxed),
+      std::chrono::microseconds{
+          deviceQueue.latencyUs.load(std::memory_order_relaxed)}};
+}
+
 std::vector<FuseChannel::OutstandingRequest>
 FuseChannel::getOutstandingRequests() {
   std::vector<FuseChannel::OutstandingRequest> outstandingCalls;
@@ -1242,10 +1380,10 @@ void FuseChannel::initWorkerThread() noexcept {
   initPromise_.setValue(sessionCompletePromise_.getSemiFuture());
 
   // Continue to run like a normal FUSE worker thread.
-  fuseWorkerThread();
+  fuseWorkerThread(deviceQueues_[0]);
 }
 
-void FuseChannel::fuseWorkerThread() noexcept {
+void FuseChannel::fuseWorkerThread(DeviceQueue& queue) noexcept {
   disablePthreadCancellation();
   setThreadName(fmt::format("fuse{}", mountPath_.basename()));
   setThreadSigmask();
@@ -1253,7 +1391,7 @@ void FuseChannel::fuseWorkerThread() noexcept {
       std::make_shared<RequestMetricsScope::LockedRequestWatchList>();
 
   try {
-    processSession();
+    processSession(queue);
   } catch (const std::exception& ex) {
     XLOG(ERR) << "unexpected error in FUSE worker thread: " << exceptionStr(ex);
     // Request that all other FUSE threads exit.
@@ -1263,21 +1401,109 @@ void FuseChannel::fuseWorkerThread() noexcept {
     // Fall through and continue with the normal thread exit code.
   }
 
-  // Record that we have shut down.
-  {
-    auto state = state_.wlock();
-    ++state->stoppedThreads;
-    XDCHECK(!state->destroyPending) << "destroyPending cannot be set while "
-                                       "worker threads are still running";
-
-    // If we are the last thread to stop and there are no more requests
-    // outstanding then invoke sessionComplete().  If we are the last thread
-    // but there are still outstanding requests we will invoke
-    // sessionComplete() when we process the final stage of the request
-    // processing for the last request.
-    if (state->stoppedThreads == numThreads_ && state->pendingRequests == 0) {
-      sessionComplete(std::move(state));
+  threadStopped();
+}
+
+bool FuseChannel::isUsingIoUring() const {
+#ifdef __linux__
+  return connInfo_ && (connInfo_->flags & kFuseInitExt) &&
+      (connInfo_->unused[0] & kFuseOverIoUring);
+#else
+  return false;
+#endif
+}
+
+void FuseChannel::startUringThreads(State& state) {
+  // The kernel refuses entries whose payload buffer cannot hold the largest
+  // request or reply. Without FUSE_MAX_PAGES, requests span up to 32 pages.
+  constexpr size_t kDefaultMaxPages = 32;
+  const size_t maxPages = (connInfo_->flags & FUSE_MAX_PAGES)
+      ? connInfo_->max_pages
+      : kDefaultMaxPages;
+  const size_t payloadSize = std::max(
+      {size_t{FUSE_MIN_READ_BUFFER},
+       size_t{connInfo_->max_write},
+       maxPages * getpagesize()});
+
+  std::vector<std::unique_ptr<FuseUring>> urings;
+  try {
+    const auto numQueues = FuseUring::getNumQueues();
+    for (size_t qid = 0; qid < numQueues; ++qid) {
+      urings.push_back(std::make_unique<FuseUring>(
+          fuseDevice_.fd(), qid, ioUringQueueDepth_, payloadSize));
     }
+  } catch (const std::exception& ex) {
+    // Requests keep going to the FUSE device until every queue has a ring.
+    XLOG(WARN) << "unable to set up FUSE-over-io_uring for \"" << mountPath_
+               << "\", reading requests from the FUSE device instead: "
+               << exceptionStr(ex);
+    return;
+  }
+
+  urings_ = std::move(urings);
+  for (auto& uring : urings_) {
+    state.workerThreads.emplace_back(
+        [this, &ring = *uring] { uringThread(ring); });
+    ++state.numUringThreads;
+  }
+}
+
+void FuseChannel::uringThread(FuseUring& ring) noexcept {
+  disablePthreadCancellation();
+  setThreadName(fmt::format("fuse{}", mountPath_.basename()));
+  setThreadSigmask();
+  *(liveRequestWatches_.get()) =
+      std::make_shared<RequestMetricsScope::LockedRequestWatchList>();
+
+#ifdef __linux__
+  // The kernel queues requests by the CPU they are issued from. Serving them
+  // on the same CPU keeps the request and reply buffers in its caches. CPUs
+  // that are offline or outside our cpuset cannot be pinned to, and their
+  // requests are then served from wherever the thread runs.
+  if (ring.getQueueId() < CPU_SETSIZE) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(ring.getQueueId(), &cpus);
+    auto err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (err != 0) {
+      XLOG(DBG3) << "unable to pin FUSE-over-io_uring queue "
+                 << ring.getQueueId() << ": " << folly::errnoStr(err);
+    }
+  }
+#endif
+
+  try {
+    ring.run(
+        stop_,
+        [this](
+            FuseUring::Entry& entry,
+            const fuse_in_header& header,
+            ByteRange arg) {
+          processRequest(
+              ReplyTarget{-1, &entry}, nullptr, header, arg, std::nullopt);
+        });
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "unexpected error in FUSE-over-io_uring thread: "
+              << exceptionStr(ex);
+    requestSessionExit(StopReason::WORKER_EXCEPTION);
+  }
+
+  threadStopped();
+}
+
+void FuseChannel::threadStopped() {
+  auto state = state_.wlock();
+  ++state->stoppedThreads;
+  XDCHECK(!state->destroyPending) << "destroyPending cannot be set while "
+                                     "worker threads are still running";
+
+  // If we are the last thread to stop and there are no more requests
+  // outstanding then invoke sessionComplete().  If we are the last thread
+  // but there are still outstanding requests we will invoke
+  // sessionComplete() when we process the final stage of the request
+  // processing for the last request.
+  if (allThreadsStopped(*state) && state->pendingRequests == 0) {
+    sessionComplete(std::move(state));
   }
 }
 
@@ -1322,6 +1548,25 @@ void FuseChannel::invalidationThread() noexcept {
   }
 }
 
+void FuseChannel::cloneDeviceQueues() {
+#ifdef __linux__
+  for (size_t i = 1; i < numDeviceQueues_; ++i) {
+    try {
+      folly::File clone{"/dev/fuse", O_RDWR | O_CLOEXEC};
+      uint32_t fd = fuseDevice_.fd();
+      folly::checkUnixError(
+          ioctl(clone.fd(), FUSE_DEV_IOC_CLONE, &fd),
+          "unable to clone the FUSE device");
+      deviceQueues_[i].clone = std::move(clone);
+    } catch (const std::exception& ex) {
+      XLOG(WARN) << "FUSE device queue " << i << " and above of " << mountPath_
+                 << " will share the FUSE device: " << ex.what();
+      break;
+    }
+  }
+#endif
+}
+
 void FuseChannel::stopInvalidationThread() {
   // Check that the thread is joinable just in case we were destroyed
   // before the invalidation thread was started.
@@ -1400,7 +1645,7 @@ void FuseChannel::readInitPacket() {
   }
 
   if (init.header.opcode != FUSE_INIT) {
-    replyError(init.header, EPROTO);
+    replyError(ReplyTarget{fuseDevice_.fd()}, init.header, EPROTO);
     throw_<std::runtime_error>(
         "expected to receive FUSE_INIT for \"",
         mountPath_,
@@ -1434,10 +1679,6 @@ void FuseChannel::readInitPacket() {
   const auto capable = init.init.flags;
   auto& want = connInfo.flags;
 
-  // TODO: follow up and look at the new flags; particularly
-  // FUSE_DO_READDIRPLUS, FUSE_READDIRPLUS_AUTO. FUSE_SPLICE_XXX are interesting
-  // too, but may not directly benefit eden today.
-  //
   // FUSE_ATOMIC_O_TRUNC is a nice optimization when the kernel supports it
   // and the FUSE daemon requires handling open/release for stateful file
   // handles. But FUSE_NO_OPEN_SUPPORT is superior, so edenfs has no need for
@@ -1460,6 +1701,27 @@ void FuseChannel::readInitPacket() {
   want |= FUSE_CACHE_SYMLINKS;
   // We can handle almost any request in parallel.
   want |= FUSE_PARALLEL_DIROPS;
+  if (useReaddirplus_) {
+    // Return the attributes of directory entries along with them, which
+    // saves a lookup per entry when listing a directory is followed by
+    // stat()s of its entries. With FUSE_READDIRPLUS_AUTO, the kernel only
+    // asks for them when it sees such a pattern.
+    want |= FUSE_DO_READDIRPLUS | FUSE_READDIRPLUS_AUTO;
+  }
+  if (useSplice_) {
+    // Move requests and replies through pipes with splice(2), see
+    // processSession() and fuseRead().
+    want |= FUSE_SPLICE_READ | FUSE_SPLICE_WRITE | FUSE_SPLICE_MOVE;
+  }
+  // FUSE_PASSTHROUGH is deliberately not requested for materialized files.
+  // The kernel maps file offsets one to one onto the backing file, but
+  // overlay files start with a FileContentStore::kHeaderLength byte header.
+  // Writes bypassing us would also leave the journal, and the sizes and
+  // hashes cached by OverlayFileAccess, stale. Use fuse:use-splice to avoid
+  // copying their data through userspace instead.
+#else
+  (void)useReaddirplus_;
+  (void)useSplice_;
 #endif
 
 #ifdef FUSE_WRITEBACK_CACHE
@@ -1492,6 +1754,28 @@ void FuseChannel::readInitPacket() {
   // Only return the capabilities the kernel supports.
   want &= capable;
 
+#ifdef __linux__
+  // FUSE-over-io_uring is negotiated in flags2, which the kernel only sends
+  // and reads along with FUSE_INIT_EXT. flags2 follows the fields of
+  // fuse_init_in our copy of the protocol headers knows, and fills
+  // connInfo.unused[0].
+  if (useIoUring_) {
+    uint32_t capable2 = 0;
+    if (capable & kFuseInitExt) {
+      memcpy(&capable2, init.padding_, sizeof(capable2));
+    }
+    if (FuseUring::isSupported() && (capable2 & kFuseOverIoUring)) {
+      want |= kFuseInitExt;
+      connInfo.unused[0] |= kFuseOverIoUring;
+    } else {
+      XLOG(WARN) << "FUSE-over-io_uring is not available for \"" << mountPath_
+                 << "\", reading requests from the FUSE device instead";
+    }
+  }
+#else
+  (void)useIoUring_;
+#endif
+
   XLOG(DBG1) << "Speaking fuse protocol kernel=" << init.init.major << "."
              << init.init.minor << " local=" << FUSE_KERNEL_VERSION << "."
              << FUSE_KERNEL_MINOR_VERSION << " on mount \"" << mountPath_
@@ -1501,7 +1785,7 @@ void FuseChannel::readInitPacket() {
              << ", want=" << capsFlagsToLabel(want);
 
   if (init.init.major != FUSE_KERNEL_VERSION) {
-    replyError(init.header, EPROTO);
+    replyError(ReplyTarget{fuseDevice_.fd()}, init.header, EPROTO);
     throw_<std::runtime_error>(
         "Unsupported FUSE kernel version ",
         init.init.major,
@@ -1526,12 +1810,13 @@ void FuseChannel::readInitPacket() {
       FUSE_KERNEL_MINOR_VERSION > 22,
       "Your kernel headers are too old to build Eden.");
   if (init.init.minor > 22) {
-    sendReply(init.header, connInfo);
+    sendReply(ReplyTarget{fuseDevice_.fd()}, init.header, connInfo);
   } else {
     // If the protocol version predates the expansion of fuse_init_out, only
     // send the start of the packet.
     static_assert(FUSE_COMPAT_22_INIT_OUT_SIZE <= sizeof(connInfo));
     sendReply(
+        ReplyTarget{fuseDevice_.fd()},
         init.header,
         ByteRange{
             reinterpret_cast<const uint8_t*>(&connInfo),
@@ -1542,22 +1827,131 @@ void FuseChannel::readInitPacket() {
       FUSE_KERNEL_MINOR_VERSION == 19,
       "osxfuse: API/ABI likely changed, may need something like the"
       " linux code above to send the correct response to the kernel");
-  sendReply(init.header, connInfo);
+  sendReply(ReplyTarget{fuseDevice_.fd()}, init.header, connInfo);
 #endif
 
   dispatcher_->initConnection(connInfo);
 }
 
-void FuseChannel::processSession() {
+#ifdef __linux__
+Pipe FuseChannel::acquireSplicePipe() const {
+  {
+    auto pipes = splicePipes_.lock();
+    if (!pipes->empty()) {
+      auto pipe = std::move(pipes->back());
+      pipes->pop_back();
+      return pipe;
+    }
+  }
+
+  Pipe pipe;
+  // A pipe must fit a whole request or reply to splice it at once.
+  auto res = fcntl(pipe.write.fd(), F_SETPIPE_SZ, bufferSize_);
+  folly::checkUnixError(res, "unable to grow splice pipe");
+  return pipe;
+}
+
+void FuseChannel::releaseSplicePipe(Pipe&& pipe) const {
+  int pending = 0;
+  if (ioctl(pipe.read.fd(), FIONREAD, &pending) != 0 || pending != 0) {
+    // Left over from a failed request, not worth draining.
+    return;
+  }
+  auto pipes = splicePipes_.lock();
+  if (pipes->size() < kMaxPooledSplicePipes) {
+    pipes->push_back(std::move(pipe));
+  }
+}
+
+ssize_t FuseChannel::spliceRequest(
+    int fuseDevice,
+    Pipe& pipe,
+    folly::MutableByteRange buf,
+    std::optional<Pipe>& splicedPayload) {
+  auto res =
+      splice(fuseDevice, nullptr, pipe.write.fd(), nullptr, buf.size(), 0);
+  if (res <= 0) {
+    return res;
+  }
+  const auto len = static_cast<size_t>(res);
+
+  // Read the header on its own first, to learn whether the payload can be left
+  // in the pipe.
+  constexpr size_t kWriteArgSize =
+      sizeof(fuse_in_header) + sizeof(fuse_write_in);
+  size_t toRead = len;
+  if (len >= kWriteArgSize + kMinSplicedPayloadSize) {
+    if (folly::readFull(pipe.read.fd(), buf.data(), sizeof(fuse_in_header)) !=
+        static_cast<ssize_t>(sizeof(fuse_in_header))) {
+      return -1;
+    }
+    const auto* header = reinterpret_cast<const fuse_in_header*>(buf.data());
+    if (header->opcode == FUSE_WRITE && connInfo_->minor >= 9) {
+      std::optional<Pipe> replacement;
+      try {
+        replacement.emplace(acquireSplicePipe());
+      } catch (const std::exception& ex) {
+        XLOG(WARN) << "unable to create a pipe to splice FUSE writes through: "
+                   << ex.what();
+      }
+      if (replacement) {
+        if (folly::readFull(
+                pipe.read.fd(),
+                buf.data() + sizeof(fuse_in_header),
+                sizeof(fuse_write_in)) !=
+            static_cast<ssize_t>(sizeof(fuse_write_in))) {
+          return -1;
+        }
+        splicedPayload.emplace(std::exchange(pipe, std::move(*replacement)));
+        return kWriteArgSize;
+      }
+    }
+    buf.advance(sizeof(fuse_in_header));
+    toRead -= sizeof(fuse_in_header);
+  }
+
+  if (folly::readFull(pipe.read.fd(), buf.data(), toRead) !=
+      static_cast<ssize_t>(toRead)) {
+    return -1;
+  }
+  return len;
+}
+#endif
+
+void FuseChannel::processSession(DeviceQueue& queue) {
+  const int fuseDevice = getDeviceFd(queue);
+  const ReplyTarget target{fuseDevice};
   std::vector<char> buf(bufferSize_);
-  // Save this for the sanity check later in the loop to avoid
-  // additional syscalls on each loop iteration.
-  auto myPid = getpid();
+
+#ifdef __linux__
+  // With FUSE_SPLICE_READ, requests are moved through a pipe, so that the
+  // payload of large writes can be spliced on to its destination without
+  // being copied to userspace.
+  std::optional<Pipe> requestPipe;
+  if (useSplice_ && (connInfo_->flags & FUSE_SPLICE_READ)) {
+    try {
+      requestPipe.emplace(acquireSplicePipe());
+    } catch (const std::exception& ex) {
+      XLOG(WARN) << "unable to create a pipe to splice FUSE requests through, "
+                 << "reading them instead: " << ex.what();
+    }
+  }
+#endif
 
   while (!stop_.load(std::memory_order_relaxed)) {
-    // TODO: FUSE_SPLICE_READ allows using splice(2) here if we enable it.
-    // We can look at turning this on once the main plumbing is complete.
-    auto res = read(fuseDevice_.fd(), buf.data(), buf.size());
+#ifdef __linux__
+    std::optional<Pipe> splicedPayload;
+    auto res = requestPipe
+        ? spliceRequest(
+              fuseDevice,
+              *requestPipe,
+              folly::MutableByteRange{
+                  reinterpret_cast<uint8_t*>(buf.data()), buf.size()},
+              splicedPayload)
+        : read(fuseDevice, buf.data(), buf.size());
+#else
+    auto res = read(fuseDevice, buf.data(), buf.size());
+#endif
     if (UNLIKELY(res < 0)) {
       int error = errno;
       if (stop_.load(std::memory_order_relaxed)) {
@@ -1610,226 +2004,306 @@ void FuseChannel::processSession() {
     const ByteRange arg{
         reinterpret_cast<const uint8_t*>(header + 1),
         arg_size - sizeof(fuse_in_header)};
+#ifdef __linux__
+    if (!processRequest(
+            target, &queue, *header, arg, std::move(splicedPayload))) {
+      return;
+    }
+#else
+    if (!processRequest(target, &queue, *header, arg, std::nullopt)) {
+      return;
+    }
+#endif
+  }
+}
 
-    XLOG(DBG7) << "fuse request opcode=" << header->opcode << " "
-               << fuseOpcodeName(header->opcode) << " unique=" << header->unique
-               << " len=" << header->len << " nodeid=" << header->nodeid
-               << " uid=" << header->uid << " gid=" << header->gid
-               << " pid=" << header->pid;
-
-    // On Linux, if security caps are enabled and the FUSE filesystem implements
-    // xattr support, every FUSE_WRITE opcode is preceded by FUSE_GETXATTR for
-    // "security.capability". Until we discover a way to tell the kernel that
-    // they will always return nothing in an Eden mount, short-circuit that path
-    // as efficiently and as early as possible.
-    //
-    // On some systems, the kernel also frequently requests
-    // POSIX ACL xattrs, so fast track those too, if only to make strace
-    // logs easier to follow.
-    if (header->opcode == FUSE_GETXATTR) {
-      const auto getxattr =
-          reinterpret_cast<const fuse_getxattr_in*>(arg.data());
-
-      // Evaluate strlen before the comparison loop below.
-      const StringPiece namePiece{reinterpret_cast<const char*>(getxattr + 1)};
-      static constexpr StringPiece kFastTracks[] = {
-          "security.capability",
-          "security.selinux",
-          "system.posix_acl_access",
-          "system.posix_acl_default"};
-
-      // Unclear whether one strlen and matching compares is better than
-      // strcmps, but it's probably in the noise.
-      bool matched = false;
-      for (auto fastTrack : kFastTracks) {
-        if (namePiece == fastTrack) {
-          replyError(*header, ENODATA);
-          matched = true;
-          break;
-        }
-      }
-      if (matched) {
-        continue;
+bool FuseChannel::processRequest(
+    const ReplyTarget& target,
+    DeviceQueue* queue,
+    const fuse_in_header& header,
+    ByteRange arg,
+    std::optional<Pipe> splicedPayload) {
+  XLOG(DBG7) << "fuse request opcode=" << header.opcode << " "
+             << fuseOpcodeName(header.opcode) << " unique=" << header.unique
+             << " len=" << header.len << " nodeid=" << header.nodeid
+             << " uid=" << header.uid << " gid=" << header.gid
+             << " pid=" << header.pid;
+
+  // On Linux, if security caps are enabled and the FUSE filesystem implements
+  // xattr support, every FUSE_WRITE opcode is preceded by FUSE_GETXATTR for
+  // "security.capability". Until we discover a way to tell the kernel that
+  // they will always return nothing in an Eden mount, short-circuit that path
+  // as efficiently and as early as possible.
+  //
+  // On some systems, the kernel also frequently requests
+  // POSIX ACL xattrs, so fast track those too, if only to make strace
+  // logs easier to follow.
+  if (header.opcode == FUSE_GETXATTR) {
+    const auto getxattr =
+        reinterpret_cast<const fuse_getxattr_in*>(arg.data());
+
+    // Evaluate strlen before the comparison loop below.
+    const StringPiece namePiece{reinterpret_cast<const char*>(getxattr + 1)};
+    static constexpr StringPiece kFastTracks[] = {
+        "security.capability",
+        "security.selinux",
+        "system.posix_acl_access",
+        "system.posix_acl_default"};
+
+    // Unclear whether one strlen and matching compares is better than
+    // strcmps, but it's probably in the noise.
+    bool matched = false;
+    for (auto fastTrack : kFastTracks) {
+      if (namePiece == fastTrack) {
+        replyError(target, header, ENODATA);
+        matched = true;
+        break;
       }
     }
-
-    // Sanity check to ensure that the request wasn't from ourself.
-    //
-    // We should never make requests to ourself via normal filesytem
-    // operations going through the kernel.  Otherwise we risk deadlocks if the
-    // kernel calls us while holding an inode lock, and we then end up making a
-    // filesystem call that need the same inode lock.  We will then not be able
-    // to resolve this deadlock on kernel inode locks without rebooting the
-    // system.
-    if (UNLIKELY(static_cast<pid_t>(header->pid) == myPid)) {
-      replyError(*header, EIO);
-      XLOG(CRITICAL) << "Received FUSE request from our own pid: opcode="
-                     << header->opcode << " nodeid=" << header->nodeid
-                     << " pid=" << header->pid;
-      continue;
+    if (matched) {
+      return true;
     }
+  }
 
-    auto* handlerEntry = lookupFuseHandlerEntry(header->opcode);
-    processAccessLog_.recordAccess(
-        header->pid,
-        handlerEntry ? handlerEntry->accessType : AccessType::FsChannelOther);
-
-    switch (header->opcode) {
-      case FUSE_INIT:
-        replyError(*header, EPROTO);
-        throw std::runtime_error(
-            "received FUSE_INIT after we have been initialized!?");
-
-      case FUSE_GETLK:
-      case FUSE_SETLK:
-      case FUSE_SETLKW:
-        // Deliberately not handling locking; this causes
-        // the kernel to do it for us
-        XLOG(DBG7) << fuseOpcodeName(header->opcode);
-        replyError(*header, ENOSYS);
-        break;
+  // Sanity check to ensure that the request wasn't from ourself.
+  //
+  // We should never make requests to ourself via normal filesytem
+  // operations going through the kernel.  Otherwise we risk deadlocks if the
+  // kernel calls us while holding an inode lock, and we then end up making a
+  // filesystem call that need the same inode lock.  We will then not be able
+  // to resolve this deadlock on kernel inode locks without rebooting the
+  // system.
+  if (UNLIKELY(static_cast<pid_t>(header.pid) == pid_)) {
+    replyError(target, header, EIO);
+    XLOG(CRITICAL) << "Received FUSE request from our own pid: opcode="
+                   << header.opcode << " nodeid=" << header.nodeid
+                   << " pid=" << header.pid;
+    return true;
+  }
+
+  auto* handlerEntry = lookupFuseHandlerEntry(header.opcode);
+  processAccessLog_.recordAccess(
+      header.pid,
+      handlerEntry ? handlerEntry->accessType : AccessType::FsChannelOther);
+
+  switch (header.opcode) {
+    case FUSE_INIT:
+      replyError(target, header, EPROTO);
+      throw std::runtime_error(
+          "received FUSE_INIT after we have been initialized!?");
+
+    case FUSE_GETLK:
+    case FUSE_SETLK:
+    case FUSE_SETLKW:
+      // Deliberately not handling locking; this causes
+      // the kernel to do it for us
+      XLOG(DBG7) << fuseOpcodeName(header.opcode);
+      replyError(target, header, ENOSYS);
+      break;
 
 #ifdef __linux__
-      case FUSE_LSEEK:
-        // We only support stateless file handles, so lseek() is meaningless
-        // for us.  Returning ENOSYS causes the kernel to implement it for us,
-        // and will cause it to stop sending subsequent FUSE_LSEEK requests.
-        XLOG(DBG7) << "FUSE_LSEEK";
-        replyError(*header, ENOSYS);
-        break;
+    case FUSE_LSEEK:
+      // We only support stateless file handles, so lseek() is meaningless
+      // for us.  Returning ENOSYS causes the kernel to implement it for us,
+      // and will cause it to stop sending subsequent FUSE_LSEEK requests.
+      XLOG(DBG7) << "FUSE_LSEEK";
+      replyError(target, header, ENOSYS);
+      break;
 #endif
 
-      case FUSE_POLL:
-        // We do not currently implement FUSE_POLL.
-        XLOG(DBG7) << "FUSE_POLL";
-        replyError(*header, ENOSYS);
-        break;
+    case FUSE_POLL:
+      // We do not currently implement FUSE_POLL.
+      XLOG(DBG7) << "FUSE_POLL";
+      replyError(target, header, ENOSYS);
+      break;
 
-      case FUSE_INTERRUPT: {
-        // no reply is required
-        XLOG(DBG7) << "FUSE_INTERRUPT";
-        // Ignore it: we don't have a reliable way to guarantee
-        // that interrupting functions correctly.
-        // In addition, the kernel (certainly on macOS) may recycle
-        // ids too quickly for us to safely track by `unique` id.
-        break;
+    case FUSE_INTERRUPT: {
+      XLOG(DBG7) << "FUSE_INTERRUPT";
+#ifdef __linux__
+      // We cannot abort a handler midway, but we can let go of the imports
+      // it is waiting on: they are dropped if nobody else needs them, and
+      // the request then fails with EINTR.
+      const auto* in = reinterpret_cast<const fuse_interrupt_in*>(arg.data());
+      bool found = false;
+      std::shared_ptr<FuseRequestContext> interrupted;
+      {
+        auto state = state_.rlock();
+        auto it = state->interruptibleRequests.find(in->unique);
+        if (it != state->interruptibleRequests.end()) {
+          found = true;
+          interrupted = it->second.lock();
+        }
       }
-
-      case FUSE_DESTROY:
-        XLOG(DBG7) << "FUSE_DESTROY";
-        dispatcher_->destroy();
-        // FUSE on linux doesn't care whether we reply to FUSE_DESTROY
-        // but the macOS implementation blocks the unmount syscall until
-        // we have responded, which in turn blocks our attempt to gracefully
-        // unmount, so we respond here.  It doesn't hurt Linux to respond
-        // so we do it for both platforms.
-        replyError(*header, 0);
-        break;
-
-      case FUSE_NOTIFY_REPLY:
-        XLOG(DBG7) << "FUSE_NOTIFY_REPLY";
-        // Don't strictly need to do anything here, but may want to
-        // turn the kernel notifications in Futures and use this as
-        // a way to fulfil the promise
-        break;
-
-      case FUSE_IOCTL:
-        // Rather than the default ENOSYS, we need to return ENOTTY
-        // to indicate that the requested ioctl is not supported
-        replyError(*header, ENOTTY);
-        break;
-
-      default: {
-        if (handlerEntry && handlerEntry->handler) {
-          auto requestId = generateUniqueID();
-          if (handlerEntry->argRenderer &&
-              traceDetailedArguments_->load(std::memory_order_acquire)) {
-            traceBus_->publish(FuseTraceEvent::start(
-                requestId, *header, handlerEntry->argRenderer(arg)));
-          } else {
-            traceBus_->publish(FuseTraceEvent::start(requestId, *header));
+      if (interrupted) {
+        interrupted->getFsObjectFetchContext().cancel();
+      } else if (!found) {
+        // The request may have just been read by another thread, which has
+        // not registered it yet. Per the FUSE protocol, reply EAGAIN so that
+        // the kernel sends the interrupt again. It fails the reply with
+        // ENOENT if the request was answered in the meantime.
+        try {
+          replyError(target, header, EAGAIN);
+        } catch (const std::system_error& ex) {
+          if (!isEnoent(ex)) {
+            throw;
           }
+        }
+      }
+#else
+      // Ignore it: the kernel (certainly on macOS) may recycle ids too
+      // quickly for us to safely track by `unique` id.
+#endif
+      break;
+    }
 
-          // This is a shared_ptr because, due to timeouts, the internal request
-          // lifetime may not match the FUSE request lifetime, so we capture it
-          // in both. I'm sure this could be improved with some cleverness.
-          auto request = std::make_shared<FuseRequestContext>(this, *header);
-
-          ++state_.wlock()->pendingRequests;
+    case FUSE_DESTROY:
+      XLOG(DBG7) << "FUSE_DESTROY";
+      dispatcher_->destroy();
+      // FUSE on linux doesn't care whether we reply to FUSE_DESTROY
+      // but the macOS implementation blocks the unmount syscall until
+      // we have responded, which in turn blocks our attempt to gracefully
+      // unmount, so we respond here.  It doesn't hurt Linux to respond
+      // so we do it for both platforms.
+      replyError(target, header, 0);
+      break;
+
+    case FUSE_NOTIFY_REPLY:
+      XLOG(DBG7) << "FUSE_NOTIFY_REPLY";
+      // Don't strictly need to do anything here, but may want to
+      // turn the kernel notifications in Futures and use this as
+      // a way to fulfil the promise
+      break;
+
+    case FUSE_IOCTL:
+      // Rather than the default ENOSYS, we need to return ENOTTY
+      // to indicate that the requested ioctl is not supported
+      replyError(target, header, ENOTTY);
+      break;
+
+    default: {
+      if (handlerEntry && handlerEntry->handler) {
+        auto requestId = generateUniqueID();
+        if (handlerEntry->argRenderer &&
+            traceDetailedArguments_->load(std::memory_order_acquire)) {
+          traceBus_->publish(FuseTraceEvent::start(
+              requestId, header, handlerEntry->argRenderer(arg)));
+        } else {
+          traceBus_->publish(FuseTraceEvent::start(requestId, header));
+        }
 
-          auto headerCopy = *header;
+        // This is a shared_ptr because, due to timeouts, the internal request
+        // lifetime may not match the FUSE request lifetime, so we capture it
+        // in both. I'm sure this could be improved with some cleverness.
+        auto request =
+            std::make_shared<FuseRequestContext>(this, target, header);
+#ifdef __linux__
+        if (splicedPayload) {
+          request->setSplicedPayload(std::move(*splicedPayload));
+        }
+#endif
 
-          FB_LOG(*straceLogger_, DBG7, ([&]() -> std::string {
-            std::string rendered;
-            if (handlerEntry->argRenderer) {
-              rendered = handlerEntry->argRenderer(arg);
-            }
-            return fmt::format(
-                "{}({}{}{})",
-                handlerEntry->getShortName(),
-                headerCopy.nodeid,
-                rendered.empty() ? "" : ", ",
-                rendered);
-          })());
-
-          request
-              ->catchErrors(
-                  folly::makeFutureWith([&] {
-                    request->startRequest(
-                        dispatcher_->getStats().copy(),
-                        handlerEntry->stat,
-                        *(liveRequestWatches_.get()));
-                    return (this->*handlerEntry->handler)(
-                               *request, request->getReq(), arg)
-                        .semi()
-                        .via(&folly::QueuedImmediateExecutor::instance());
-                  }).ensure([request] {
-                    }).within(requestTimeout_),
-                  notifier_.get())
-              .ensure([this, request, requestId, headerCopy] {
-                traceBus_->publish(FuseTraceEvent::finish(
-                    requestId, headerCopy, request->getResult()));
-
-                // We may be complete; check to see if all requests are
-                // done and whether there are any threads remaining.
-                auto state = state_.wlock();
-                XCHECK_NE(state->pendingRequests, 0u)
-                    << "pendingRequests double decrement";
-                if (--state->pendingRequests == 0 &&
-                    state->stoppedThreads == numThreads_) {
-                  sessionComplete(std::move(state));
-                }
-              });
-          break;
+        {
+          auto state = state_.wlock();
+          ++state->pendingRequests;
+#ifdef __linux__
+          state->interruptibleRequests[header.unique] = request;
+#endif
         }
+        if (queue) {
+          queue->depth.fetch_add(1, std::memory_order_relaxed);
+        }
+        auto requestStart = std::chrono::steady_clock::now();
+
+        auto headerCopy = header;
 
-        const auto opcode = header->opcode;
-        tryRlockCheckBeforeUpdate<folly::Unit>(
-            unhandledOpcodes_,
-            [&](const auto& unhandledOpcodes) -> std::optional<folly::Unit> {
-              if (unhandledOpcodes.find(opcode) != unhandledOpcodes.end()) {
-                return folly::unit;
+        FB_LOG(*straceLogger_, DBG7, ([&]() -> std::string {
+          std::string rendered;
+          if (handlerEntry->argRenderer) {
+            rendered = handlerEntry->argRenderer(arg);
+          }
+          return fmt::format(
+              "{}({}{}{})",
+              handlerEntry->getShortName(),
+              headerCopy.nodeid,
+              rendered.empty() ? "" : ", ",
+              rendered);
+        })());
+
+        request
+            ->catchErrors(
+                folly::makeFutureWith([&] {
+                  request->startRequest(
+                      dispatcher_->getStats().copy(),
+                      handlerEntry->stat,
+                      *(liveRequestWatches_.get()));
+                  return (this->*handlerEntry->handler)(
+                             *request, request->getReq(), arg)
+                      .semi()
+                      .via(&folly::QueuedImmediateExecutor::instance());
+                }).ensure([request] {
+                  }).within(requestTimeout_),
+                notifier_.get())
+            .ensure([this,
+                     request,
+                     requestId,
+                     headerCopy,
+                     queue,
+                     requestStart] {
+              traceBus_->publish(FuseTraceEvent::finish(
+                  requestId, headerCopy, request->getResult()));
+
+              if (queue) {
+                auto latency =
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - requestStart);
+                queue->latencyUs.fetch_add(
+                    latency.count(), std::memory_order_relaxed);
+                queue->requests.fetch_add(1, std::memory_order_relaxed);
+                queue->depth.fetch_sub(1, std::memory_order_relaxed);
               }
-              return std::nullopt;
-            },
-            [&](auto& unhandledOpcodes) -> folly::Unit {
-              XLOG(WARN) << "unhandled fuse opcode " << opcode << "("
-                         << fuseOpcodeName(opcode) << ")";
-              unhandledOpcodes->insert(opcode);
-              return folly::unit;
-            });
 
-        try {
-          replyError(*header, ENOSYS);
-        } catch (const std::system_error& exc) {
-          XLOG(ERR) << "Failed to write error response to fuse: " << exc.what();
-          requestSessionExit(StopReason::FUSE_WRITE_ERROR);
-          return;
-        }
+              // We may be complete; check to see if all requests are
+              // done and whether there are any threads remaining.
+              auto state = state_.wlock();
+#ifdef __linux__
+              state->interruptibleRequests.erase(headerCopy.unique);
+#endif
+              XCHECK_NE(state->pendingRequests, 0u)
+                  << "pendingRequests double decrement";
+              if (--state->pendingRequests == 0 && allThreadsStopped(*state)) {
+                sessionComplete(std::move(state));
+              }
+            });
         break;
       }
+
+      const auto opcode = header.opcode;
+      tryRlockCheckBeforeUpdate<folly::Unit>(
+          unhandledOpcodes_,
+          [&](const auto& unhandledOpcodes) -> std::optional<folly::Unit> {
+            if (unhandledOpcodes.find(opcode) != unhandledOpcodes.end()) {
+              return folly::unit;
+            }
+            return std::nullopt;
+          },
+          [&](auto& unhandledOpcodes) -> folly::Unit {
+            XLOG(WARN) << "unhandled fuse opcode " << opcode << "("
+                       << fuseOpcodeName(opcode) << ")";
+            unhandledOpcodes->insert(opcode);
+            return folly::unit;
+          });
+
+      try {
+        replyError(target, header, ENOSYS);
+      } catch (const std::system_error& exc) {
+        XLOG(ERR) << "Failed to write error response to fuse: " << exc.what();
+        requestSessionExit(StopReason::FUSE_WRITE_ERROR);
+        return false;
+      }
+      break;
     }
   }
+  return true;
 }
 
 void FuseChannel::sessionComplete(folly::Synchronized<State>::LockedPtr state) {
@@ -1871,6 +2345,53 @@ ImmediateFuture<folly::Unit> FuseChannel::fuseRead(
   XLOG(DBG7) << "FUSE_READ";
 
   auto ino = InodeNumber{header.nodeid};
+#ifdef __linux__
+  // Replies through FUSE-over-io_uring go through the ring's buffers, which
+  // cannot be spliced into.
+  std::optional<Pipe> data;
+  std::optional<Pipe> reply;
+  if (useSplice_ && (connInfo_->flags & FUSE_SPLICE_WRITE) &&
+      !request.getReplyTarget().uringEntry &&
+      read->size >= kMinSplicedPayloadSize &&
+      read->size + sizeof(fuse_out_header) <= bufferSize_) {
+    // Both pipes are acquired before reading anything into the first, so
+    // that running out of them can still fall back to copying the data.
+    try {
+      data.emplace(acquireSplicePipe());
+      reply.emplace(acquireSplicePipe());
+    } catch (const std::exception& ex) {
+      XLOG(WARN) << "unable to create a pipe to splice FUSE reads through, "
+                 << "copying them instead: " << ex.what();
+      if (data) {
+        releaseSplicePipe(std::move(*data));
+        data.reset();
+      }
+    }
+  }
+  if (data && reply) {
+    auto pipeFd = data->write.fd();
+    return dispatcher_
+        ->spliceRead(
+            ino,
+            read->size,
+            read->offset,
+            pipeFd,
+            request.getObjectFetchContext())
+        .thenValue([this,
+                    &request,
+                    data = std::move(*data),
+                    reply = std::move(*reply)](
+                       std::variant<BufVec, size_t>&& result) mutable {
+          if (auto* buf = std::get_if<BufVec>(&result)) {
+            request.sendReply(**buf);
+          } else {
+            request.sendReply(data, std::get<size_t>(result), reply);
+          }
+          releaseSplicePipe(std::move(reply));
+          releaseSplicePipe(std::move(data));
+        });
+  }
+#endif
   return dispatcher_
       ->read(ino, read->size, read->offset, request.getObjectFetchContext())
       .thenValue([&request](BufVec&& buf) { request.sendReply(*buf); });
@@ -1889,6 +2410,26 @@ ImmediateFuture<folly::Unit> FuseChannel::fuseWrite(
   XLOG(DBG7) << "FUSE_WRITE " << write->size << " @" << write->offset;
 
   auto ino = InodeNumber{header.nodeid};
+#ifdef __linux__
+  if (auto payload = request.takeSplicedPayload()) {
+    // The data was left in a pipe by processSession().
+    auto pipeFd = payload->read.fd();
+    return dispatcher_
+        ->spliceWrite(
+            ino,
+            pipeFd,
+            write->size,
+            write->offset,
+            request.getObjectFetchContext())
+        .thenValue([this, &request, payload = std::move(*payload)](
+                       size_t written) mutable {
+          releaseSplicePipe(std::move(payload));
+          fuse_write_out out = {};
+          out.size = written;
+          request.sendReply(out);
+        });
+  }
+#endif
   return dispatcher_
       ->write(
           ino,
@@ -2325,6 +2866,28 @@ ImmediateFuture<folly::Unit> FuseChannel::fuseReadDir(
       });
 }
 
+#ifdef __linux__
+ImmediateFuture<folly::Unit> FuseChannel::fuseReadDirPlus(
+    FuseRequestContext& request,
+    const fuse_in_header& header,
+    ByteRange arg) {
+  auto read = reinterpret_cast<const fuse_read_in*>(arg.data());
+  XLOG(DBG7) << "FUSE_READDIRPLUS";
+  auto ino = InodeNumber{header.nodeid};
+  return dispatcher_
+      ->readdirplus(
+          ino,
+          FuseDirList{read->size, /*plus=*/true},
+          read->offset,
+          read->fh,
+          request.getObjectFetchContext())
+      .thenValue([&request](FuseDirList&& list) {
+        const auto buf = list.getBuf();
+        request.sendReply(StringPiece{buf});
+      });
+}
+#endif
+
 ImmediateFuture<folly::Unit> FuseChannel::fuseReleaseDir(
     FuseRequestContext& request,
     const fuse_in_header& header,
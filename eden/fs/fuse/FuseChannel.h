@@ -17,6 +17,7 @@
 #include <condition_variable>
 #include <iosfwd>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <stdexcept>
 #include <thread>
@@ -25,6 +26,7 @@
 #include <vector>
 
 #include "eden/fs/fuse/FuseDispatcher.h"
+#include "eden/fs/fuse/FuseUring.h"
 #include "eden/fs/inodes/FsChannel.h"
 #include "eden/fs/inodes/InodeNumber.h"
 #include "eden/fs/telemetry/RequestMetricsScope.h"
@@ -33,6 +35,7 @@
 #include "eden/fs/utils/FsChannelTypes.h"
 #include "eden/fs/utils/ImmediateFuture.h"
 #include "eden/fs/utils/PathFuncs.h"
+#include "eden/fs/utils/Pipe.h"
 #include "eden/fs/utils/ProcessAccessLog.h"
 
 #ifndef _WIN32
@@ -216,6 +219,28 @@ class FuseChannel final : public FsChannel {
     std::chrono::steady_clock::time_point requestStartTime;
   };
 
+  /**
+   * Counters of the requests read from one of the FUSE device queues, see
+   * getNumDeviceQueues().
+   */
+  struct DeviceQueueStats {
+    /**
+     * Requests read from the queue that have not finished yet.
+     */
+    size_t depth;
+
+    /**
+     * Requests read from the queue that finished since the channel started.
+     */
+    uint64_t requests;
+
+    /**
+     * Sum of the durations of the finished requests, measured from the time
+     * they were read from the queue.
+     */
+    std::chrono::microseconds totalLatency;
+  };
+
   /**
    * Construct the fuse channel and session structures that are
    * required by libfuse to communicate with the kernel using
@@ -240,7 +265,12 @@ class FuseChannel final : public FsChannel {
       CaseSensitivity caseSensitive,
       bool requireUtf8Path,
       int32_t maximumBackgroundRequests,
-      bool useWriteBackCache);
+      bool useWriteBackCache,
+      bool useReaddirplus,
+      bool useSplice,
+      size_t numDeviceQueues,
+      bool useIoUring,
+      size_t ioUringQueueDepth);
 
   /**
    * Destroy the FuseChannel.
@@ -359,20 +389,37 @@ class FuseChannel final : public FsChannel {
    */
   FOLLY_NODISCARD ImmediateFuture<folly::Unit> completeInvalidations() override;
 
+  /**
+   * Where the reply to a request must go: the kernel only matches replies
+   * against the requests read from the same FUSE device file descriptor, or
+   * against the request held by a FUSE-over-io_uring entry.
+   */
+  struct ReplyTarget {
+    int fuseDevice{-1};
+    FuseUring::Entry* uringEntry{nullptr};
+  };
+
   /**
    * Sends a reply to a kernel request that consists only of the error
    * status (no additional payload).
    * `err` may be 0 (indicating success) or a positive errno value.
    *
+   * Like all the replies below, it is sent to target, which must be where the
+   * request came from.
+   *
    * throws system_error if the write fails.  Writes can fail if the
    * data we send to the kernel is invalid.
    */
-  void replyError(const fuse_in_header& request, int err);
+  void replyError(
+      const ReplyTarget& target,
+      const fuse_in_header& request,
+      int err);
 
   /**
    * Sends a raw data packet to the kernel.
    * The data may be scattered across a number of discrete buffers;
-   * this method uses writev to send them to the kernel as a single unit.
+   * this method uses writev, or gathers them into the io_uring entry, to send
+   * them to the kernel as a single unit.
    * The kernel, and thus this method, assumes that the start of this data
    * is a fuse_out_header instance.  This method will sum the iovec lengths
    * to compute the correct value to store into fuse_out_header::len.
@@ -380,7 +427,8 @@ class FuseChannel final : public FsChannel {
    * throws system_error if the write fails.  Writes can fail if the
    * data we send to the kernel is invalid.
    */
-  void sendRawReply(const iovec iov[], size_t count) const;
+  void sendRawReply(const ReplyTarget& target, const iovec iov[], size_t count)
+      const;
 
   /**
    * Sends a range of contiguous bytes as a reply to the kernel.
@@ -391,11 +439,16 @@ class FuseChannel final : public FsChannel {
    * throws system_error if the write fails.  Writes can fail if the
    * data we send to the kernel is invalid.
    */
-  void sendReply(const fuse_in_header& request, folly::ByteRange bytes) const;
+  void sendReply(
+      const ReplyTarget& target,
+      const fuse_in_header& request,
+      folly::ByteRange bytes) const;
 
-  void sendReply(const fuse_in_header& request, folly::StringPiece bytes)
-      const {
-    sendReply(request, folly::ByteRange{bytes});
+  void sendReply(
+      const ReplyTarget& target,
+      const fuse_in_header& request,
+      folly::StringPiece bytes) const {
+    sendReply(target, request, folly::ByteRange{bytes});
   }
 
   /**
@@ -407,8 +460,10 @@ class FuseChannel final : public FsChannel {
    * throws system_error if the write fails.  Writes can fail if the
    * data we send to the kernel is invalid.
    */
-  void sendReply(const fuse_in_header& request, folly::fbvector<iovec>&& vec)
-      const;
+  void sendReply(
+      const ReplyTarget& target,
+      const fuse_in_header& request,
+      folly::fbvector<iovec>&& vec) const;
 
   /**
    * Sends a reply to a kernel request potentially consisting of multiple
@@ -417,7 +472,28 @@ class FuseChannel final : public FsChannel {
    * throws system_error if the write fails.  Writes can fail if the
    * data we send to the kernel is invalid.
    */
-  void sendReply(const fuse_in_header& request, const folly::IOBuf& buf) const;
+  void sendReply(
+      const ReplyTarget& target,
+      const fuse_in_header& request,
+      const folly::IOBuf& buf) const;
+
+#ifdef __linux__
+  /**
+   * Sends a reply to a kernel request whose payload is the size bytes held in
+   * the pipe data. The payload is moved to the kernel with splice(2) through
+   * reply, another, empty, pipe with room for the whole reply, without being
+   * copied to userspace. target must not be a FUSE-over-io_uring entry.
+   *
+   * throws system_error if the write fails.  The pipes are then left in an
+   * unspecified state.
+   */
+  void sendReply(
+      const ReplyTarget& target,
+      const fuse_in_header& request,
+      Pipe& data,
+      size_t size,
+      Pipe& reply) const;
+#endif
 
   /**
    * Sends a reply to the kernel.
@@ -428,10 +504,14 @@ class FuseChannel final : public FsChannel {
    * data we send to the kernel is invalid.
    */
   template <typename T>
-  void sendReply(const fuse_in_header& request, const T& payload) const {
+  void sendReply(
+      const ReplyTarget& target,
+      const fuse_in_header& request,
+      const T& payload) const {
     static_assert(std::is_standard_layout_v<T>);
     static_assert(std::is_trivial_v<T>);
     sendReply(
+        target,
         request,
         folly::ByteRange{
             reinterpret_cast<const uint8_t*>(&payload), sizeof(T)});
@@ -447,6 +527,22 @@ class FuseChannel final : public FsChannel {
    */
   std::vector<FuseChannel::OutstandingRequest> getOutstandingRequests();
 
+  /**
+   * Returns the number of FUSE device file descriptors the worker threads read
+   * requests from. All but the first are clones of the mount's FUSE device
+   * made with FUSE_DEV_IOC_CLONE, and each is read by its own group of worker
+   * threads, so that they do not all contend on the same descriptor.
+   */
+  size_t getNumDeviceQueues() const {
+    return numDeviceQueues_;
+  }
+
+  /**
+   * Returns the counters of the requests read from the given device queue,
+   * which must be less than getNumDeviceQueues().
+   */
+  DeviceQueueStats getDeviceQueueStats(size_t queue) const;
+
   /**
    * While the returned handle is alive, FuseTraceEvents published on the
    * TraceBus will have detailed argument strings.
@@ -494,6 +590,12 @@ class FuseChannel final : public FsChannel {
      */
     size_t stoppedThreads{0};
 
+    /**
+     * The number of FUSE-over-io_uring threads started, which stop along with
+     * the worker threads.
+     */
+    size_t numUringThreads{0};
+
     /**
      * If destroyPending is true, the FuseChannel object should be
      * automatically destroyed when the last outstanding request finishes.
@@ -506,6 +608,15 @@ class FuseChannel final : public FsChannel {
      * or running.
      */
     StopReason stopReason{StopReason::RUNNING};
+
+#ifdef __linux__
+    /**
+     * Requests that have not completed yet, keyed by their FUSE unique id, so
+     * that FUSE_INTERRUPT can cancel the fetches they are waiting on.
+     */
+    std::unordered_map<uint64_t, std::weak_ptr<FuseRequestContext>>
+        interruptibleRequests;
+#endif
   };
 
   /**
@@ -515,6 +626,23 @@ class FuseChannel final : public FsChannel {
     std::unordered_map<uint64_t, OutstandingRequest> requests;
   };
 
+  /**
+   * A FUSE device file descriptor that a group of worker threads read
+   * requests from, along with the counters behind DeviceQueueStats.
+   */
+  struct DeviceQueue {
+    /**
+     * The clone of fuseDevice_ this queue reads from. It is closed for the
+     * first queue, and for queues whose clone could not be made, which read
+     * from fuseDevice_ itself.
+     */
+    folly::File clone;
+
+    std::atomic<size_t> depth{0};
+    std::atomic<uint64_t> requests{0};
+    std::atomic<uint64_t> latencyUs{0};
+  };
+
   struct DataRange {
     DataRange(int64_t offset, int64_t length);
 
@@ -665,6 +793,12 @@ class FuseChannel final : public FsChannel {
       FuseRequestContext& request,
       const fuse_in_header& header,
       folly::ByteRange arg);
+#ifdef __linux__
+  ImmediateFuture<folly::Unit> fuseReadDirPlus(
+      FuseRequestContext& request,
+      const fuse_in_header& header,
+      folly::ByteRange arg);
+#endif
   ImmediateFuture<folly::Unit> fuseReleaseDir(
       FuseRequestContext& request,
       const fuse_in_header& header,
@@ -697,7 +831,7 @@ class FuseChannel final : public FsChannel {
  private:
   void setThreadSigmask();
   void initWorkerThread() noexcept;
-  void fuseWorkerThread() noexcept;
+  void fuseWorkerThread(DeviceQueue& queue) noexcept;
   void invalidationThread() noexcept;
   void stopInvalidationThread();
   void sendInvalidation(InvalidationEntry& entry);
@@ -706,6 +840,19 @@ class FuseChannel final : public FsChannel {
   void readInitPacket();
   void startWorkerThreads();
 
+  /**
+   * Clone fuseDevice_ for each device queue but the first. Failures are
+   * logged, and leave the queue reading from fuseDevice_.
+   */
+  void cloneDeviceQueues();
+
+  /**
+   * Returns the file descriptor the given queue reads requests from.
+   */
+  int getDeviceFd(const DeviceQueue& queue) const {
+    return queue.clone ? queue.clone.fd() : fuseDevice_.fd();
+  }
+
   /**
    * sessionComplete() will fulfill the sessionCompletePromise_.
    *
@@ -733,7 +880,82 @@ class FuseChannel final : public FsChannel {
    * The intent is that this is called from each of the
    * fuse worker threads provided by the MountPoint.
    */
-  void processSession();
+  void processSession(DeviceQueue& queue);
+
+  /**
+   * Dispatches a request read from queue, or received on a FUSE-over-io_uring
+   * entry when queue is null, and arranges for its reply to go to target.
+   *
+   * Returns false if the session must stop because a reply could not be
+   * written.
+   */
+  bool processRequest(
+      const ReplyTarget& target,
+      DeviceQueue* queue,
+      const fuse_in_header& header,
+      folly::ByteRange arg,
+      std::optional<Pipe> splicedPayload);
+
+  /**
+   * Returns whether every worker and FUSE-over-io_uring thread has stopped.
+   */
+  bool allThreadsStopped(const State& state) const {
+    return state.stoppedThreads == numThreads_ + state.numUringThreads;
+  }
+
+  /**
+   * Returns whether FUSE-over-io_uring was negotiated with the kernel, by us
+   * or by the process we took the mount over from.
+   */
+  bool isUsingIoUring() const;
+
+  /**
+   * Starts a thread serving each queue of the FUSE-over-io_uring connection.
+   * Failures to set up the rings are logged, and leave all requests to the
+   * worker threads.
+   */
+  void startUringThreads(State& state);
+
+  /**
+   * Serves the requests of ring until the session is torn down.
+   */
+  void uringThread(FuseUring& ring) noexcept;
+
+  /**
+   * Records that a worker or FUSE-over-io_uring thread is stopping.
+   *
+   * Beware: this may call sessionComplete(), and must be the very last
+   * statement of the thread.
+   */
+  void threadStopped();
+
+#ifdef __linux__
+  /**
+   * Move the next request from fuseDevice into pipe with splice(2) and read
+   * it into buf, with the same return value and errno as read(2) on the FUSE
+   * device.
+   *
+   * The payload of a large FUSE_WRITE is left in pipe instead, and pipe is
+   * then moved to splicedPayload and replaced with another pipe, for the data
+   * to be spliced again to its destination.
+   */
+  ssize_t spliceRequest(
+      int fuseDevice,
+      Pipe& pipe,
+      folly::MutableByteRange buf,
+      std::optional<Pipe>& splicedPayload);
+
+  /**
+   * Returns an empty pipe with room for bufferSize_ bytes, from
+   * splicePipes_ when one is available.
+   */
+  Pipe acquireSplicePipe() const;
+
+  /**
+   * Put pipe back in splicePipes_, unless it is not empty or the pool is full.
+   */
+  void releaseSplicePipe(Pipe&& pipe) const;
+#endif
 
   /**
    * Requests that the worker threads terminate their processing loop.
@@ -757,6 +979,15 @@ class FuseChannel final : public FsChannel {
   bool requireUtf8Path_;
   int32_t maximumBackgroundRequests_;
   bool useWriteBackCache_;
+  bool useReaddirplus_;
+  bool useSplice_;
+  bool useIoUring_;
+  const size_t ioUringQueueDepth_;
+  const size_t numDeviceQueues_;
+
+  // Saved to check that requests do not come from ourself without a syscall
+  // per request.
+  const pid_t pid_;
 
   /*
    * connInfo_ is modified during the initialization process,
@@ -782,6 +1013,20 @@ class FuseChannel final : public FsChannel {
    */
   folly::File fuseDevice_;
 
+  /*
+   * The queues worker threads read requests from, numDeviceQueues_ of them.
+   * Their clones are made before the worker threads beyond the first are
+   * started, and are not modified afterwards.
+   */
+  std::unique_ptr<DeviceQueue[]> deviceQueues_;
+
+  /*
+   * The FUSE-over-io_uring rings, one per queue of the connection when it was
+   * negotiated. They are set up before their threads are started, and are not
+   * modified afterwards.
+   */
+  std::vector<std::unique_ptr<FuseUring>> urings_;
+
   /*
    * Mutable state that is accessed from the worker threads.
    * All of this state uses locking or other synchronization.
@@ -797,6 +1042,14 @@ class FuseChannel final : public FsChannel {
   // To prevent logging unsupported opcodes twice.
   folly::Synchronized<std::unordered_set<FuseOpcode>> unhandledOpcodes_;
 
+#ifdef __linux__
+  /**
+   * Pipes to splice requests and replies through, kept to avoid creating
+   * them for every request. Only empty pipes are put back.
+   */
+  mutable folly::Synchronized<std::vector<Pipe>, std::mutex> splicePipes_;
+#endif
+
   // State for sending inode invalidation requests to the kernel
   // These are processed in their own dedicated thread.
   folly::Synchronized<InvalidationQueue, std::mutex> invalidationQueue_;
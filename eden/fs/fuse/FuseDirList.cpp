@@ -16,18 +16,22 @@ using folly::StringPiece;
 
 namespace facebook::eden {
 
-FuseDirList::FuseDirList(size_t maxSize)
-    : buf_(new char[maxSize]), end_(buf_.get() + maxSize), cur_(buf_.get()) {}
+FuseDirList::FuseDirList(size_t maxSize, bool plus)
+    : buf_(new char[maxSize]),
+      end_(buf_.get() + maxSize),
+      cur_(buf_.get()),
+      plus_(plus) {}
 
-bool FuseDirList::add(StringPiece name, ino_t inode, dtype_t type, off_t off) {
-  const size_t avail = end_ - cur_;
+namespace {
+void fillDirent(
+    char* p,
+    StringPiece name,
+    ino_t inode,
+    dtype_t type,
+    off_t off,
+    size_t fullSize) {
   const auto entLength = FUSE_NAME_OFFSET + name.size();
-  const auto fullSize = FUSE_DIRENT_ALIGN(entLength);
-  if (fullSize > avail) {
-    return false;
-  }
-
-  fuse_dirent* const dirent = reinterpret_cast<fuse_dirent*>(cur_);
+  fuse_dirent* const dirent = reinterpret_cast<fuse_dirent*>(p);
   dirent->ino = inode;
   dirent->off = off;
   dirent->namelen = name.size();
@@ -35,14 +39,62 @@ bool FuseDirList::add(StringPiece name, ino_t inode, dtype_t type, off_t off) {
   memcpy(dirent->name, name.data(), name.size());
   if (fullSize > entLength) {
     // 0 out any padding
-    memset(cur_ + entLength, 0, fullSize - entLength);
+    memset(p + entLength, 0, fullSize - entLength);
+  }
+}
+} // namespace
+
+bool FuseDirList::add(StringPiece name, ino_t inode, dtype_t type, off_t off) {
+  XDCHECK(!plus_);
+  const size_t avail = end_ - cur_;
+  const auto fullSize = FUSE_DIRENT_ALIGN(FUSE_NAME_OFFSET + name.size());
+  if (fullSize > avail) {
+    return false;
+  }
+
+  fillDirent(cur_, name, inode, type, off, fullSize);
+  cur_ += fullSize;
+  XDCHECK_LE(cur_, end_);
+  return true;
+}
+
+#ifdef __linux__
+bool FuseDirList::addPlus(
+    StringPiece name,
+    ino_t inode,
+    dtype_t type,
+    off_t off) {
+  XDCHECK(plus_);
+  const size_t avail = end_ - cur_;
+  const auto fullSize =
+      FUSE_DIRENT_ALIGN(FUSE_NAME_OFFSET_DIRENTPLUS + name.size());
+  if (fullSize > avail) {
+    return false;
   }
 
+  auto* const direntplus = reinterpret_cast<fuse_direntplus*>(cur_);
+  direntplus->entry_out = {};
+  fillDirent(
+      reinterpret_cast<char*>(&direntplus->dirent),
+      name,
+      inode,
+      type,
+      off,
+      fullSize - offsetof(fuse_direntplus, dirent));
+  plusEntries_.push_back(cur_ - buf_.get());
+
   cur_ += fullSize;
   XDCHECK_LE(cur_, end_);
   return true;
 }
 
+void FuseDirList::setEntry(size_t index, const fuse_entry_out& entry) {
+  XDCHECK_LT(index, plusEntries_.size());
+  reinterpret_cast<fuse_direntplus*>(buf_.get() + plusEntries_[index])
+      ->entry_out = entry;
+}
+#endif
+
 StringPiece FuseDirList::getBuf() const {
   return StringPiece(buf_.get(), cur_ - buf_.get());
 }
@@ -52,14 +104,23 @@ std::vector<FuseDirList::ExtractedEntry> FuseDirList::extract() const {
 
   char* p = buf_.get();
   while (p != cur_) {
-    auto entry = reinterpret_cast<fuse_dirent*>(p);
+    uint64_t entryNodeId = 0;
+    size_t direntOffset = 0;
+#ifdef __linux__
+    if (plus_) {
+      entryNodeId = reinterpret_cast<fuse_direntplus*>(p)->entry_out.nodeid;
+      direntOffset = offsetof(fuse_direntplus, dirent);
+    }
+#endif
+    auto entry = reinterpret_cast<fuse_dirent*>(p + direntOffset);
     result.emplace_back(ExtractedEntry{
         std::string{entry->name, entry->name + entry->namelen},
         entry->ino,
         static_cast<dtype_t>(entry->type),
-        static_cast<off_t>(entry->off)});
+        static_cast<off_t>(entry->off),
+        entryNodeId});
 
-    p += FUSE_DIRENT_ALIGN(FUSE_NAME_OFFSET + entry->namelen);
+    p += FUSE_DIRENT_ALIGN(direntOffset + FUSE_NAME_OFFSET + entry->namelen);
   }
   return result;
 }
@@ -9,17 +9,30 @@
 #include <folly/Range.h>
 #include <sys/stat.h>
 #include <memory>
+#include <vector>
 #include "eden/fs/utils/DirType.h"
 
+struct fuse_entry_out;
+
 namespace facebook::eden {
 
 /**
  * Helper for populating directory listings.
+ *
+ * A list holds either plain dirents, for FUSE_READDIR replies, or dirents
+ * preceded by the entry attributes of the child, for FUSE_READDIRPLUS
+ * replies.
  */
 class FuseDirList {
   std::unique_ptr<char[]> buf_;
   char* end_;
   char* cur_;
+  bool plus_;
+
+  /**
+   * Offsets in buf_ of the entries added with addPlus(), in order.
+   */
+  std::vector<size_t> plusEntries_;
 
  public:
   struct ExtractedEntry {
@@ -27,9 +40,14 @@ class FuseDirList {
     ino_t inode;
     dtype_t type;
     off_t offset;
+    /**
+     * The nodeid of the entry attributes of a READDIRPLUS list, 0 when they
+     * were not set.
+     */
+    uint64_t entryNodeId{0};
   };
 
-  explicit FuseDirList(size_t maxSize);
+  explicit FuseDirList(size_t maxSize, bool plus = false);
 
   FuseDirList(const FuseDirList&) = delete;
   FuseDirList& operator=(const FuseDirList&) = delete;
@@ -42,6 +60,28 @@ class FuseDirList {
    */
   bool add(folly::StringPiece name, ino_t inode, dtype_t type, off_t off);
 
+#ifdef __linux__
+  /**
+   * Add a new dirent to a READDIRPLUS list, with zeroed entry attributes. The
+   * kernel does not treat such an entry as looked up until setEntry() is
+   * called for it.
+   * Returns true on success or false if the list is full.
+   */
+  bool addPlus(folly::StringPiece name, ino_t inode, dtype_t type, off_t off);
+
+  /**
+   * Set the entry attributes of the index-th dirent added with addPlus().
+   *
+   * The kernel counts every entry with a non-zero nodeid as a lookup, which
+   * the caller must account for as with FUSE_LOOKUP replies.
+   */
+  void setEntry(size_t index, const fuse_entry_out& entry);
+#endif
+
+  bool isPlus() const {
+    return plus_;
+  }
+
   folly::StringPiece getBuf() const;
 
   /**
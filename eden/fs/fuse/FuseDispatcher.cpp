@@ -10,6 +10,7 @@
 #include "eden/fs/fuse/FuseDispatcher.h"
 
 #include <folly/Exception.h>
+#include <folly/FileUtil.h>
 #include <folly/executors/GlobalExecutor.h>
 #include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
@@ -188,6 +189,34 @@ ImmediateFuture<size_t> FuseDispatcher::write(
   FUSELL_NOT_IMPL();
 }
 
+#ifdef __linux__
+ImmediateFuture<std::variant<BufVec, size_t>> FuseDispatcher::spliceRead(
+    InodeNumber ino,
+    size_t size,
+    off_t off,
+    int /*pipeFd*/,
+    const ObjectFetchContextPtr& context) {
+  return read(ino, size, off, context).thenValue([](BufVec&& buf) {
+    return std::variant<BufVec, size_t>{std::move(buf)};
+  });
+}
+
+ImmediateFuture<size_t> FuseDispatcher::spliceWrite(
+    InodeNumber ino,
+    int pipeFd,
+    size_t size,
+    off_t off,
+    const ObjectFetchContextPtr& context) {
+  std::string data(size, '\0');
+  auto res = folly::readFull(pipeFd, data.data(), size);
+  folly::checkUnixError(res, "unable to read write payload from pipe");
+  if (static_cast<size_t>(res) != size) {
+    throwSystemErrorExplicit(EIO, "short read of write payload from pipe");
+  }
+  return write(ino, data, off, context);
+}
+#endif
+
 ImmediateFuture<folly::Unit> FuseDispatcher::flush(InodeNumber, uint64_t) {
   FUSELL_NOT_IMPL();
 }
@@ -217,6 +246,17 @@ ImmediateFuture<FuseDirList> FuseDispatcher::readdir(
   FUSELL_NOT_IMPL();
 }
 
+#ifdef __linux__
+ImmediateFuture<FuseDirList> FuseDispatcher::readdirplus(
+    InodeNumber,
+    FuseDirList&&,
+    off_t,
+    uint64_t,
+    const ObjectFetchContextPtr&) {
+  FUSELL_NOT_IMPL();
+}
+#endif
+
 ImmediateFuture<struct fuse_kstatfs> FuseDispatcher::statfs(
     InodeNumber /*ino*/) {
   struct fuse_kstatfs info = {};
@@ -9,6 +9,7 @@
 
 #include <folly/Portability.h>
 #include <folly/Range.h>
+#include <variant>
 #include "eden/fs/inodes/InodeNumber.h"
 #include "eden/fs/store/IObjectStore.h"
 #include "eden/fs/utils/BufVec.h"
@@ -328,6 +329,41 @@ class FuseDispatcher {
       off_t off,
       const ObjectFetchContextPtr& context);
 
+#ifdef __linux__
+  /**
+   * Read data, moving it into a pipe when possible.
+   *
+   * When the data is backed by a file, up to size bytes of it are moved into
+   * pipeFd with splice(2), and their count is returned. Otherwise, the data is
+   * returned as read() does. pipeFd has room for size bytes.
+   *
+   * The default implementation calls read().
+   */
+  virtual ImmediateFuture<std::variant<BufVec, size_t>> spliceRead(
+      InodeNumber ino,
+      size_t size,
+      off_t off,
+      int pipeFd,
+      const ObjectFetchContextPtr& context);
+
+  /**
+   * Write data held in a pipe.
+   *
+   * Same as write(), except that the size bytes of data are to be read from
+   * pipeFd, which lets them be moved to their destination with splice(2)
+   * rather than copied through userspace. pipeFd remains valid until the
+   * returned future completes.
+   *
+   * The default implementation reads the data and calls write().
+   */
+  FOLLY_NODISCARD virtual ImmediateFuture<size_t> spliceWrite(
+      InodeNumber ino,
+      int pipeFd,
+      size_t size,
+      off_t off,
+      const ObjectFetchContextPtr& context);
+#endif
+
   /**
    * This is called on each close() of the opened file.
    *
@@ -397,6 +433,25 @@ class FuseDispatcher {
       uint64_t fh,
       const ObjectFetchContextPtr& context);
 
+#ifdef __linux__
+  /**
+   * Read directory, along with the attributes of its entries.
+   *
+   * Send a FuseDirList filled using FuseDirList::addPlus(), with
+   * FuseDirList::setEntry() called for the entries whose attributes are
+   * returned. Each of these counts as a lookup of the entry, to be released
+   * by a forget().
+   *
+   * The fh parameter contains opendir's result.
+   */
+  virtual ImmediateFuture<FuseDirList> readdirplus(
+      InodeNumber ino,
+      FuseDirList&& dirList,
+      off_t offset,
+      uint64_t fh,
+      const ObjectFetchContextPtr& context);
+#endif
+
   /**
    * Get file system statistics
    *
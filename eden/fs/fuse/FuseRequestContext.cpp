@@ -21,6 +21,7 @@ namespace facebook::eden {
 
 FuseRequestContext::FuseRequestContext(
     FuseChannel* channel,
+    const FuseChannel::ReplyTarget& replyTarget,
     const fuse_in_header& fuseHeader)
     : RequestContext(
           channel->getProcessAccessLog(),
@@ -28,6 +29,7 @@ FuseRequestContext::FuseRequestContext(
               static_cast<pid_t>(fuseHeader.pid),
               fuseHeader.opcode)),
       channel_(channel),
+      replyTarget_(replyTarget),
       fuseHeader_(fuseHeader) {}
 
 fuse_in_header FuseRequestContext::stealReqWithResult(int64_t result) {
@@ -74,6 +76,9 @@ void FuseRequestContext::timeoutErrorHandler(
     Notifier* FOLLY_NULLABLE notifier) {
   XLOG_EVERY_MS(WARN, 1000)
       << "FUSE request timed out: " << folly::exceptionStr(err);
+  // The handler keeps running, but the imports it is waiting on are no longer
+  // needed by this request.
+  getFsObjectFetchContext().cancel();
   replyError(ETIMEDOUT);
   if (notifier) {
     notifier->showNetworkNotification(err);
@@ -82,7 +87,7 @@ void FuseRequestContext::timeoutErrorHandler(
 
 void FuseRequestContext::replyError(int err) {
   XCHECK(err >= 0) << "errno values are positive";
-  channel_->replyError(stealReqWithResult(-err), err);
+  channel_->replyError(replyTarget_, stealReqWithResult(-err), err);
 }
 
 void FuseRequestContext::replyNone() {
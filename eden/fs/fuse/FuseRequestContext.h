@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <folly/CancellationToken.h>
 #include <folly/futures/Future.h>
 #include <atomic>
 #include <utility>
@@ -18,6 +19,7 @@
 #include "eden/fs/telemetry/EdenStats.h"
 #include "eden/fs/telemetry/RequestMetricsScope.h"
 #include "eden/fs/utils/FsChannelTypes.h"
+#include "eden/fs/utils/Pipe.h"
 
 namespace facebook::eden {
 
@@ -48,8 +50,12 @@ class FuseObjectFetchContext : public FsObjectFetchContext {
  */
 class FuseRequestContext : public RequestContext {
  public:
-  explicit FuseRequestContext(
+  /**
+   * replyTarget is where the request came from, which its reply is sent to.
+   */
+  FuseRequestContext(
       FuseChannel* channel,
+      const FuseChannel::ReplyTarget& replyTarget,
       const fuse_in_header& fuseHeader);
 
   FuseRequestContext(const FuseRequestContext&) = delete;
@@ -74,6 +80,10 @@ class FuseRequestContext : public RequestContext {
    */
   const fuse_in_header& getReq() const;
 
+  const FuseChannel::ReplyTarget& getReplyTarget() const {
+    return replyTarget_;
+  }
+
   /**
    * Append error handling clauses to a future chain. These clauses result in
    * reporting a fuse request error back to the kernel.
@@ -86,6 +96,10 @@ class FuseRequestContext : public RequestContext {
       if (try_.hasException()) {
         if (auto* err = try_.tryGetExceptionObject<folly::FutureTimeout>()) {
           timeoutErrorHandler(*err, notifier);
+        } else if (try_.tryGetExceptionObject<folly::OperationCancelled>()) {
+          // The request was interrupted and the imports it waited on were
+          // dropped.
+          replyError(EINTR);
         } else if (
             auto* err = try_.tryGetExceptionObject<std::system_error>()) {
           systemErrorHandler(*err, notifier);
@@ -111,7 +125,8 @@ class FuseRequestContext : public RequestContext {
 
   template <typename... T>
   void sendReply(T&&... payload) {
-    channel_->sendReply(stealReqWithResult(0), std::forward<T>(payload)...);
+    channel_->sendReply(
+        replyTarget_, stealReqWithResult(0), std::forward<T>(payload)...);
   }
 
   /**
@@ -121,7 +136,8 @@ class FuseRequestContext : public RequestContext {
    */
   template <typename T>
   void sendReplyWithInode(uint64_t nodeid, T&& reply) {
-    channel_->sendReply(stealReqWithResult(nodeid), std::forward<T>(reply));
+    channel_->sendReply(
+        replyTarget_, stealReqWithResult(nodeid), std::forward<T>(reply));
   }
 
   // Reply with a negative errno value or 0 for success
@@ -130,15 +146,34 @@ class FuseRequestContext : public RequestContext {
   // Don't send a reply, just release req_
   void replyNone();
 
+#ifdef __linux__
+  /**
+   * Record that the payload of this FUSE_WRITE request was left in pipe
+   * rather than read along with the request, see FuseChannel::processSession.
+   */
+  void setSplicedPayload(Pipe&& pipe) {
+    splicedPayload_ = std::move(pipe);
+  }
+
+  std::optional<Pipe> takeSplicedPayload() {
+    return std::exchange(splicedPayload_, std::nullopt);
+  }
+#endif
+
  private:
   // Returns the header and sets result_ to indicate
   // that the request has been released.
   fuse_in_header stealReqWithResult(int64_t result);
 
   FuseChannel* channel_;
+  const FuseChannel::ReplyTarget replyTarget_;
   const fuse_in_header fuseHeader_;
 
   std::optional<int64_t> result_;
+
+#ifdef __linux__
+  std::optional<Pipe> splicedPayload_;
+#endif
 };
 
 } // namespace facebook::eden
@@ -0,0 +1,496 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#ifndef _WIN32
+
+#include "eden/fs/fuse/FuseUring.h"
+
+#include <folly/Exception.h>
+#include <folly/String.h>
+#include <folly/logging/xlog.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <system_error>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/sysinfo.h>
+#include <unistd.h>
+#endif
+
+namespace facebook::eden {
+
+FuseUring::Entry::Entry(FuseUring* ring, uint64_t index, size_t payloadSize)
+    : ring{ring},
+      index{index},
+      payloadSize{payloadSize},
+      buffer{std::make_unique<uint8_t[]>(kFuseUringOpInSize + payloadSize)} {
+  iov[0] = {&header, sizeof(header)};
+  iov[1] = {payload(), payloadSize};
+}
+
+std::optional<folly::ByteRange> FuseUring::unpackRequest(
+    Entry& entry,
+    const fuse_in_header& header) {
+  const size_t payloadSize = entry.header.ringEntInOut.payloadSize;
+  const size_t argSize = header.len >= sizeof(fuse_in_header)
+      ? header.len - sizeof(fuse_in_header)
+      : 0;
+  if (argSize < payloadSize || argSize - payloadSize > kFuseUringOpInSize ||
+      payloadSize > entry.payloadSize) {
+    return std::nullopt;
+  }
+
+  // Put the per-opcode arguments back in front of the payload, as the
+  // handlers expect them.
+  const size_t opInSize = argSize - payloadSize;
+  auto* arg = entry.payload() - opInSize;
+  memcpy(arg, entry.header.opIn, opInSize);
+  return folly::ByteRange{arg, argSize};
+}
+
+void FuseUring::packReply(Entry& entry, const iovec iov[], size_t count) {
+  fuse_out_header out;
+  XCHECK_GE(iov[0].iov_len, sizeof(out));
+  memcpy(&out, iov[0].iov_base, sizeof(out));
+
+  size_t payloadSize = 0;
+  for (size_t i = 1; i < count; ++i) {
+    payloadSize += iov[i].iov_len;
+  }
+  if (payloadSize > entry.payloadSize) {
+    XLOG(ERR) << "FUSE reply of " << payloadSize
+              << " bytes does not fit io_uring entries of "
+              << entry.payloadSize << " bytes";
+    out.error = -EIO;
+    payloadSize = 0;
+  } else {
+    auto* payload = entry.payload();
+    for (size_t i = 1; i < count; ++i) {
+      memcpy(payload, iov[i].iov_base, iov[i].iov_len);
+      payload += iov[i].iov_len;
+    }
+  }
+
+  out.len = sizeof(out) + payloadSize;
+  memcpy(entry.header.inOut, &out, sizeof(out));
+  entry.header.ringEntInOut.payloadSize = payloadSize;
+}
+
+// FUSE-over-io_uring commands need 128 byte SQEs, and IORING_OP_URING_CMD
+// came along with them in Linux 5.19.
+#ifdef IORING_SETUP_SQE128
+
+namespace {
+
+/**
+ * The FUSE-over-io_uring commands of include/uapi/linux/fuse.h.
+ */
+constexpr uint32_t kFuseUringCmdRegister = 1;
+constexpr uint32_t kFuseUringCmdCommitAndFetch = 2;
+
+/**
+ * Sends the reply without making the entry available again, so that no
+ * request can be put into it anymore. Kernels without it reject the command
+ * with EINVAL, leaving the entry and its reply untouched.
+ */
+constexpr uint32_t kFuseUringCmdCommit = 3;
+
+struct FuseUringCmdReq {
+  uint64_t flags;
+  uint64_t commitId;
+  uint16_t qid;
+  uint8_t padding[6];
+};
+
+constexpr uint64_t kWakeupUserData = ~uint64_t{0};
+
+int ioUringSetup(uint32_t entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, uint32_t toSubmit, uint32_t minComplete) {
+  return static_cast<int>(syscall(
+      __NR_io_uring_enter,
+      fd,
+      toSubmit,
+      minComplete,
+      minComplete ? IORING_ENTER_GETEVENTS : 0,
+      nullptr,
+      0));
+}
+
+} // namespace
+
+struct FuseUring::Mapping {
+  void* ring{MAP_FAILED};
+  size_t ringSize{0};
+  io_uring_sqe* sqes{static_cast<io_uring_sqe*>(MAP_FAILED)};
+  size_t sqesSize{0};
+
+  uint32_t* sqHead{nullptr};
+  uint32_t* sqTail{nullptr};
+  uint32_t* sqArray{nullptr};
+  uint32_t sqMask{0};
+  uint32_t sqEntries{0};
+  /**
+   * The tail of the SQEs prepared, which sqTail catches up with on submit.
+   */
+  uint32_t sqLocalTail{0};
+
+  uint32_t* cqHead{nullptr};
+  uint32_t* cqTail{nullptr};
+  uint32_t cqMask{0};
+  io_uring_cqe* cqes{nullptr};
+
+  ~Mapping() {
+    if (sqes != MAP_FAILED) {
+      munmap(sqes, sqesSize);
+    }
+    if (ring != MAP_FAILED) {
+      munmap(ring, ringSize);
+    }
+  }
+
+  template <typename T>
+  T* at(uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+  }
+};
+
+bool FuseUring::isSupported() {
+  return true;
+}
+
+size_t FuseUring::getNumQueues() {
+  return static_cast<size_t>(get_nprocs_conf());
+}
+
+FuseUring::FuseUring(
+    int fuseDevice,
+    uint16_t qid,
+    size_t depth,
+    size_t payloadSize)
+    : fuseDevice_{fuseDevice},
+      qid_{qid},
+      payloadSize_{payloadSize},
+      mapping_{std::make_unique<Mapping>()} {
+  if (depth == 0) {
+    throw std::invalid_argument("FUSE io_uring queue depth must not be zero");
+  }
+
+  for (size_t i = 0; i < depth; ++i) {
+    entries_.push_back(std::make_unique<Entry>(this, i, payloadSize_));
+  }
+
+  auto wakeup = eventfd(0, EFD_CLOEXEC);
+  folly::checkUnixError(wakeup, "eventfd() failed");
+  wakeup_ = folly::File{wakeup, /*ownsFd=*/true};
+
+  // One SQE per entry, for its commit, and one for the wakeup read.
+  io_uring_params params{};
+  params.flags = IORING_SETUP_SQE128;
+  auto ring = ioUringSetup(depth + 1, &params);
+  folly::checkUnixError(ring, "io_uring_setup() failed");
+  ring_ = folly::File{ring, /*ownsFd=*/true};
+  if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+    throw std::system_error(
+        ENOSYS, std::generic_category(), "io_uring is too old");
+  }
+
+  auto& m = *mapping_;
+  m.ringSize = std::max(
+      params.sq_off.array + params.sq_entries * sizeof(uint32_t),
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+  m.ring = mmap(
+      nullptr,
+      m.ringSize,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      ring,
+      IORING_OFF_SQ_RING);
+  folly::checkUnixError(
+      m.ring == MAP_FAILED ? -1 : 0, "mmap() of the io_uring failed");
+  // With IORING_SETUP_SQE128, each SQE takes the room of two.
+  m.sqesSize = params.sq_entries * 2 * sizeof(io_uring_sqe);
+  m.sqes = static_cast<io_uring_sqe*>(mmap(
+      nullptr,
+      m.sqesSize,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      ring,
+      IORING_OFF_SQES));
+  folly::checkUnixError(
+      m.sqes == MAP_FAILED ? -1 : 0, "mmap() of the io_uring SQEs failed");
+
+  m.sqHead = m.at<uint32_t>(params.sq_off.head);
+  m.sqTail = m.at<uint32_t>(params.sq_off.tail);
+  m.sqArray = m.at<uint32_t>(params.sq_off.array);
+  m.sqMask = *m.at<uint32_t>(params.sq_off.ring_mask);
+  m.sqEntries = params.sq_entries;
+  m.sqLocalTail = *m.sqTail;
+  m.cqHead = m.at<uint32_t>(params.cq_off.head);
+  m.cqTail = m.at<uint32_t>(params.cq_off.tail);
+  m.cqMask = *m.at<uint32_t>(params.cq_off.ring_mask);
+  m.cqes = m.at<io_uring_cqe>(params.cq_off.cqes);
+}
+
+FuseUring::~FuseUring() = default;
+
+void FuseUring::run(const std::atomic<bool>& stop, RequestCallback callback) {
+  ringThread_ = std::this_thread::get_id();
+  RequestCallback refuse =
+      [](Entry& entry, const fuse_in_header& header, folly::ByteRange) {
+        fuse_out_header out{};
+        out.error = -EINTR;
+        out.unique = header.unique;
+        iovec iov{&out, sizeof(out)};
+        commit(entry, &iov, 1);
+      };
+
+  for (auto& entry : entries_) {
+    prepareCommand(*entry, kFuseUringCmdRegister);
+  }
+  liveEntries_ = entries_.size();
+  prepareWakeupRead();
+
+  while (liveEntries_ > 0) {
+    bool stopping = stop.load(std::memory_order_acquire);
+    auto commits = std::exchange(*commits_.lock(), {});
+    for (auto* entry : commits) {
+      // Once stopping, replies retire their entries, so that fewer and fewer
+      // entries can receive requests that nobody would answer.
+      if (stopping && plainCommitSupported_) {
+        entry->fetching = false;
+        ++entriesCommitting_;
+        prepareCommand(*entry, kFuseUringCmdCommit);
+      } else {
+        entry->fetching = true;
+        prepareCommand(*entry, kFuseUringCmdCommitAndFetch);
+      }
+      --entriesInUse_;
+    }
+
+    // Requests may keep coming in while we wait for the replies to the ones
+    // in flight. They are answered too, and run() returns once no reply is
+    // outstanding and no request is waiting in the completion queue. Entries
+    // still available then may yet receive a request before the ring is
+    // closed, which leaves its caller waiting: retiring the entries only
+    // narrows that window.
+    //
+    // Kernels without the plain COMMIT command re-arm every entry that
+    // replies. Requests that arrive once nothing else is outstanding are
+    // then answered with EINTR, otherwise run() might never return.
+    if (stopping && entriesInUse_ == 0 && entriesCommitting_ == 0) {
+      submitAndWait(/*wait=*/false);
+      if (!hasCompletions()) {
+        break;
+      }
+      reapCompletions(plainCommitSupported_ ? callback : refuse);
+      continue;
+    }
+
+    submitAndWait(/*wait=*/true);
+    reapCompletions(callback);
+  }
+}
+
+void FuseUring::commit(Entry& entry, const iovec iov[], size_t count) {
+  packReply(entry, iov, count);
+  entry.ring->pushCommit(entry);
+}
+
+void FuseUring::pushCommit(Entry& entry) {
+  bool wasEmpty;
+  {
+    auto commits = commits_.lock();
+    wasEmpty = commits->empty();
+    commits->push_back(&entry);
+  }
+
+  // The ring's thread gathers the commits before waiting, so only other
+  // threads need to wake it up, and only the first of a batch.
+  if (wasEmpty && std::this_thread::get_id() != ringThread_) {
+    uint64_t one = 1;
+    if (write(wakeup_.fd(), &one, sizeof(one)) < 0) {
+      XLOG(ERR) << "failed to wake up FUSE io_uring queue " << qid_ << ": "
+                << folly::errnoStr(errno);
+    }
+  }
+}
+
+void FuseUring::prepareCommand(Entry& entry, uint32_t cmdOp) {
+  auto& m = *mapping_;
+  if (m.sqLocalTail - __atomic_load_n(m.sqHead, __ATOMIC_ACQUIRE) ==
+      m.sqEntries) {
+    submitAndWait(/*wait=*/false);
+  }
+
+  auto index = m.sqLocalTail & m.sqMask;
+  auto* sqe = &m.sqes[index * 2];
+  memset(sqe, 0, 2 * sizeof(io_uring_sqe));
+  sqe->opcode = IORING_OP_URING_CMD;
+  sqe->fd = fuseDevice_;
+  sqe->cmd_op = cmdOp;
+  // Only registration reads the buffers, but every command carries them.
+  sqe->addr = reinterpret_cast<uint64_t>(entry.iov.data());
+  sqe->len = entry.iov.size();
+  sqe->user_data = entry.index;
+
+  auto* req = reinterpret_cast<FuseUringCmdReq*>(sqe->cmd);
+  req->commitId = entry.commitId;
+  req->qid = qid_;
+
+  m.sqArray[index] = index;
+  ++m.sqLocalTail;
+  __atomic_store_n(m.sqTail, m.sqLocalTail, __ATOMIC_RELEASE);
+}
+
+void FuseUring::prepareWakeupRead() {
+  auto& m = *mapping_;
+  auto index = m.sqLocalTail & m.sqMask;
+  auto* sqe = &m.sqes[index * 2];
+  memset(sqe, 0, 2 * sizeof(io_uring_sqe));
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = wakeup_.fd();
+  sqe->addr = reinterpret_cast<uint64_t>(&wakeupValue_);
+  sqe->len = sizeof(wakeupValue_);
+  sqe->user_data = kWakeupUserData;
+
+  m.sqArray[index] = index;
+  ++m.sqLocalTail;
+  __atomic_store_n(m.sqTail, m.sqLocalTail, __ATOMIC_RELEASE);
+}
+
+void FuseUring::submitAndWait(bool wait) {
+  auto& m = *mapping_;
+  auto toSubmit = m.sqLocalTail - __atomic_load_n(m.sqHead, __ATOMIC_ACQUIRE);
+  if (toSubmit == 0 && !wait) {
+    return;
+  }
+
+  if (ioUringEnter(ring_.fd(), toSubmit, wait ? 1 : 0) < 0) {
+    auto err = errno;
+    // EINTR is how FuseChannel tells us to look at the stop flag, and
+    // EAGAIN or EBUSY that the completions must be reaped before more
+    // commands can be submitted.
+    if (err != EINTR && err != EAGAIN && err != EBUSY) {
+      folly::throwSystemErrorExplicit(err, "io_uring_enter() failed");
+    }
+  }
+}
+
+bool FuseUring::hasCompletions() const {
+  auto& m = *mapping_;
+  return *m.cqHead != __atomic_load_n(m.cqTail, __ATOMIC_ACQUIRE);
+}
+
+void FuseUring::reapCompletions(RequestCallback& callback) {
+  auto& m = *mapping_;
+  auto head = *m.cqHead;
+  auto tail = __atomic_load_n(m.cqTail, __ATOMIC_ACQUIRE);
+  while (head != tail) {
+    const auto cqe = m.cqes[head & m.cqMask];
+    ++head;
+    __atomic_store_n(m.cqHead, head, __ATOMIC_RELEASE);
+
+    if (cqe.user_data == kWakeupUserData) {
+      prepareWakeupRead();
+      continue;
+    }
+
+    auto& entry = *entries_[cqe.user_data];
+    if (!entry.fetching) {
+      --entriesCommitting_;
+      if (cqe.res == -EINVAL && plainCommitSupported_) {
+        XLOG(DBG2) << "FUSE io_uring queue " << qid_
+                   << " cannot retire entries on stop";
+        plainCommitSupported_ = false;
+      }
+      if (cqe.res == -EINVAL && !plainCommitSupported_) {
+        // The reply was not sent: send it the usual way.
+        entry.fetching = true;
+        prepareCommand(entry, kFuseUringCmdCommitAndFetch);
+        continue;
+      }
+      // The entry is retired, or the connection is going away.
+      if (entry.live) {
+        entry.live = false;
+        --liveEntries_;
+      }
+      continue;
+    }
+
+    if (cqe.res < 0) {
+      // The kernel refused the entry, or the connection is going away.
+      if (entry.live) {
+        entry.live = false;
+        if (--liveEntries_ == 0) {
+          XLOG(DBG2) << "FUSE io_uring queue " << qid_
+                     << " stopped: " << folly::errnoStr(-cqe.res);
+        }
+      }
+      continue;
+    }
+
+    ++entriesInUse_;
+    entry.commitId = entry.header.ringEntInOut.commitId;
+    const auto header =
+        *reinterpret_cast<const fuse_in_header*>(entry.header.inOut);
+    auto arg = unpackRequest(entry, header);
+    if (!arg) {
+      XLOG(ERR) << "malformed FUSE request on io_uring queue " << qid_
+                << ": len=" << header.len
+                << " payload=" << entry.header.ringEntInOut.payloadSize;
+      fuse_out_header out{};
+      out.error = -EIO;
+      out.unique = header.unique;
+      iovec iov{&out, sizeof(out)};
+      commit(entry, &iov, 1);
+      continue;
+    }
+    callback(entry, header, *arg);
+  }
+}
+
+#else
+
+struct FuseUring::Mapping {};
+
+bool FuseUring::isSupported() {
+  return false;
+}
+
+size_t FuseUring::getNumQueues() {
+  return 0;
+}
+
+FuseUring::FuseUring(int fuseDevice, uint16_t qid, size_t, size_t)
+    : fuseDevice_{fuseDevice}, qid_{qid}, payloadSize_{0} {
+  throw std::system_error(
+      ENOSYS,
+      std::generic_category(),
+      "FUSE-over-io_uring is not supported on this platform");
+}
+
+FuseUring::~FuseUring() = default;
+
+void FuseUring::run(const std::atomic<bool>&, RequestCallback) {}
+
+void FuseUring::commit(Entry&, const iovec[], size_t) {
+  XLOG(FATAL) << "FUSE-over-io_uring is not supported on this platform";
+}
+
+#endif
+
+} // namespace facebook::eden
+
+#endif
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/File.h>
+#include <folly/Function.h>
+#include <folly/Range.h>
+#include <folly/Synchronized.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "eden/fs/utils/FsChannelTypes.h"
+
+#ifndef _WIN32
+#include <sys/uio.h>
+#endif
+
+namespace facebook::eden {
+
+#ifndef _WIN32
+
+/**
+ * FUSE_INIT flags that negotiate FUSE-over-io_uring. They come from protocol
+ * 7.42, which is newer than our copy of fuse_kernel_linux.h.
+ * kFuseOverIoUring belongs in flags2, the word that follows the fields our
+ * copy knows of fuse_init_in, and that fuse_init_out::unused[0] holds.
+ */
+constexpr uint32_t kFuseInitExt = 1u << 30;
+constexpr uint32_t kFuseOverIoUring = 1u << (41 - 32);
+
+/**
+ * The layout of the headers of a FUSE-over-io_uring entry, from
+ * include/uapi/linux/fuse.h, which our copy of the FUSE protocol headers
+ * predates.
+ */
+constexpr size_t kFuseUringInOutHeaderSize = 128;
+constexpr size_t kFuseUringOpInSize = 128;
+
+struct FuseUringEntInOut {
+  uint64_t flags;
+  uint64_t commitId;
+  uint32_t payloadSize;
+  uint32_t padding;
+  uint64_t reserved;
+};
+
+/**
+ * Holds the fuse_in_header of a request, then the fuse_out_header of its
+ * reply, in inOut. The per-opcode arguments of the request are in opIn, and
+ * the rest of it, or of the reply, in the entry's payload buffer.
+ */
+struct FuseUringReqHeader {
+  char inOut[kFuseUringInOutHeaderSize];
+  char opIn[kFuseUringOpInSize];
+  FuseUringEntInOut ringEntInOut;
+};
+
+static_assert(sizeof(fuse_in_header) <= kFuseUringInOutHeaderSize);
+static_assert(sizeof(fuse_out_header) <= kFuseUringInOutHeaderSize);
+
+/**
+ * An io_uring serving one of the queues of a FUSE connection.
+ *
+ * With FUSE-over-io_uring, the kernel has one queue per CPU. Each request
+ * goes to the queue of the CPU that issued it. The daemon registers entries
+ * with a queue, each a pair of buffers. The kernel copies a request into an
+ * available entry and completes that entry's command. The daemon writes the
+ * reply into the same entry, and a single COMMIT_AND_FETCH command sends
+ * the reply and makes the entry available again. Requests and replies thus
+ * need no read(2) or write(2) on the FUSE device, and the commands of all
+ * the replies ready at once go to the kernel in one io_uring_enter(2) call.
+ *
+ * The kernel only uses the rings once every queue has an entry. Until then,
+ * and for requests that never go through them, like FUSE_FORGET and
+ * FUSE_INTERRUPT, requests are still read from the FUSE device.
+ */
+class FuseUring {
+ public:
+  struct Entry;
+
+  /**
+   * Called on the ring's thread with each request received and the entry
+   * holding it. arg holds the request's arguments, laid out as they would be
+   * read from the FUSE device. It stays valid until the entry's reply is
+   * committed, and a reply must be committed for every request.
+   */
+  using RequestCallback = folly::Function<
+      void(Entry& entry, const fuse_in_header& header, folly::ByteRange arg)>;
+
+  /**
+   * Returns whether EdenFS was built with FUSE-over-io_uring support. Whether
+   * the kernel supports it is only known from FUSE_INIT.
+   */
+  static bool isSupported();
+
+  /**
+   * Returns the number of queues of a FUSE-over-io_uring connection, one per
+   * possible CPU.
+   */
+  static size_t getNumQueues();
+
+  /**
+   * Set up an io_uring for the queue qid of the FUSE connection on
+   * fuseDevice. The ring gets depth entries, whose payload buffers hold
+   * payloadSize bytes.
+   *
+   * Throws std::system_error if io_uring is not available.
+   */
+  FuseUring(int fuseDevice, uint16_t qid, size_t depth, size_t payloadSize);
+  ~FuseUring();
+
+  FuseUring(const FuseUring&) = delete;
+  FuseUring& operator=(const FuseUring&) = delete;
+
+  uint16_t getQueueId() const {
+    return qid_;
+  }
+
+  /**
+   * Register the entries with the kernel. Then call callback for each
+   * request received, and send the replies committed meanwhile, until stop
+   * is set and every request received has been replied to. Once stop is
+   * set, replies are sent with a plain COMMIT, which does not make their
+   * entries available again, and requests still arriving in the remaining
+   * entries are answered too. A request the kernel puts into an entry after
+   * run() returns is left unanswered until the connection goes away. On
+   * kernels without the plain COMMIT, the requests arriving once nothing
+   * else is outstanding are answered with EINTR instead. Entries the kernel
+   * refuses or tears down are dropped, and run() returns early once none is
+   * left.
+   *
+   * The calling thread becomes the ring's thread. It must be able to be
+   * interrupted by a signal once stop is set.
+   */
+  void run(const std::atomic<bool>& stop, RequestCallback callback);
+
+  /**
+   * Reply to the request held by entry. May be called from any thread, and
+   * wakes up the ring's thread to send the reply.
+   *
+   * Like FuseChannel::sendRawReply(), iov must start with a fuse_out_header.
+   * Its len is filled in. A reply too large for the entry is replaced with an
+   * EIO error.
+   */
+  static void commit(Entry& entry, const iovec iov[], size_t count);
+
+  /**
+   * Copy the per-opcode arguments of the request held by entry back in front
+   * of its payload, recreating the layout of a request read from the FUSE
+   * device. Returns the request's arguments, or std::nullopt if the sizes
+   * the kernel gave do not fit the entry.
+   */
+  static std::optional<folly::ByteRange> unpackRequest(
+      Entry& entry,
+      const fuse_in_header& header);
+
+  /**
+   * Write the reply in iov into entry, the way commit() does, without
+   * sending it.
+   */
+  static void packReply(Entry& entry, const iovec iov[], size_t count);
+
+ private:
+  struct Mapping;
+
+  void pushCommit(Entry& entry);
+  void prepareCommand(Entry& entry, uint32_t cmdOp);
+  void prepareWakeupRead();
+  void submitAndWait(bool wait);
+  bool hasCompletions() const;
+  void reapCompletions(RequestCallback& callback);
+
+  const int fuseDevice_;
+  const uint16_t qid_;
+  const size_t payloadSize_;
+
+  // The entries' buffers must outlive the ring, which the kernel may write
+  // into until it is closed.
+  std::vector<std::unique_ptr<Entry>> entries_;
+  folly::File wakeup_;
+  folly::File ring_;
+  std::unique_ptr<Mapping> mapping_;
+
+  /**
+   * Only accessed by the ring's thread.
+   */
+  size_t liveEntries_{0};
+  size_t entriesInUse_{0};
+  size_t entriesCommitting_{0};
+  bool plainCommitSupported_{true};
+  uint64_t wakeupValue_{0};
+  std::thread::id ringThread_;
+
+  /**
+   * Entries whose replies were committed but not yet sent to the kernel.
+   */
+  folly::Synchronized<std::vector<Entry*>, std::mutex> commits_;
+};
+
+/**
+ * An entry of a FuseUring: the buffers a request is copied into, and its
+ * reply written to.
+ */
+struct FuseUring::Entry {
+  /**
+   * ring may be null for an entry that is never committed.
+   */
+  Entry(FuseUring* ring, uint64_t index, size_t payloadSize);
+
+  FuseUring* const ring;
+  const uint64_t index;
+  const size_t payloadSize;
+  FuseUringReqHeader header{};
+  /**
+   * The payload, preceded by room for the per-opcode arguments, which are
+   * copied in front of it to recreate the layout of a request read from the
+   * FUSE device.
+   */
+  std::unique_ptr<uint8_t[]> buffer;
+  std::array<iovec, 2> iov{};
+  uint64_t commitId{0};
+  bool live{true};
+  /**
+   * Whether the command in flight for the entry fetches a request, rather
+   * than only committing a reply.
+   */
+  bool fetching{true};
+
+  uint8_t* payload() {
+    return buffer.get() + kFuseUringOpInSize;
+  }
+};
+
+#endif
+
+} // namespace facebook::eden
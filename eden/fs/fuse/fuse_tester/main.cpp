@@ -34,6 +34,14 @@ using folly::exceptionStr;
 using std::string;
 
 DEFINE_int32(numFuseThreads, 4, "The number of FUSE worker threads");
+DEFINE_bool(
+    ioUring,
+    false,
+    "Receive FUSE requests through io_uring rather than the FUSE device");
+DEFINE_uint64(
+    ioUringQueueDepth,
+    8,
+    "The number of requests each FUSE io_uring can hold at once");
 
 namespace {
 class TestDispatcher : public FuseDispatcher {
@@ -141,7 +149,12 @@ int main(int argc, char** argv) {
       CaseSensitivity::Sensitive,
       /*requireUtf8Path=*/true,
       /*maximumBackgroundRequests=*/12 /* the default on Linux */,
-      /*useWriteBackCache=*/false));
+      /*useWriteBackCache=*/false,
+      /*useReaddirplus=*/false,
+      /*useSplice=*/false,
+      /*numDeviceQueues=*/1,
+      FLAGS_ioUring,
+      FLAGS_ioUringQueueDepth));
 
   XLOG(INFO) << "Starting FUSE...";
   auto completionFuture = channel->initialize().get();
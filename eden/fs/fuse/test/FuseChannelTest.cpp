@@ -11,6 +11,7 @@
 #include <folly/logging/xlog.h>
 #include <folly/portability/GTest.h>
 #include <folly/test/TestUtils.h>
+#include <thread>
 #include <unordered_map>
 #include "eden/common/utils/ProcessNameCache.h"
 #include "eden/fs/fuse/FuseDispatcher.h"
@@ -66,7 +67,8 @@ fuse_entry_out genRandomLookupResponse(uint64_t nodeid) {
 class FuseChannelTest : public ::testing::Test {
  protected:
   unique_ptr<FuseChannel, FuseChannelDeleter> createChannel(
-      size_t numThreads = 2) {
+      size_t numThreads = 2,
+      size_t numDeviceQueues = 1) {
     auto testDispatcher = std::make_unique<TestDispatcher>(stats_.copy());
     dispatcher_ = testDispatcher.get();
     return unique_ptr<FuseChannel, FuseChannelDeleter>(new FuseChannel(
@@ -82,7 +84,12 @@ class FuseChannelTest : public ::testing::Test {
         CaseSensitivity::Sensitive,
         /*requireUtf8Path=*/true,
         /*maximumBackgroundRequests=*/12,
-        /*useWriteBackCache=*/false));
+        /*useWriteBackCache=*/false,
+        /*useReaddirplus=*/false,
+        /*useSplice=*/false,
+        numDeviceQueues,
+        /*useIoUring=*/false,
+        /*ioUringQueueDepth=*/8));
   }
 
   FuseChannel::StopFuture performInit(
@@ -342,6 +349,43 @@ TEST_F(FuseChannelTest, testDestroyWithPendingRequests) {
   std::move(completeFuture).get(kTimeout);
 }
 
+TEST_F(FuseChannelTest, deviceQueueStats) {
+  // FakeFuse is not a FUSE device and cannot be cloned, so both queues end up
+  // reading from it, but each keeps its own counters.
+  auto channel = createChannel(/*numThreads=*/2, /*numDeviceQueues=*/2);
+  auto completeFuture = performInit(channel.get());
+  ASSERT_EQ(2, channel->getNumDeviceQueues());
+
+  auto sumStats = [&] {
+    FuseChannel::DeviceQueueStats sum{0, 0, std::chrono::microseconds{0}};
+    for (size_t queue = 0; queue < channel->getNumDeviceQueues(); ++queue) {
+      auto stats = channel->getDeviceQueueStats(queue);
+      sum.depth += stats.depth;
+      sum.requests += stats.requests;
+      sum.totalLatency += stats.totalLatency;
+    }
+    return sum;
+  };
+
+  auto id = fuse_.sendLookup(FUSE_ROOT_ID, "foobar");
+  auto req = dispatcher_->waitForLookup(id);
+  EXPECT_EQ(1, sumStats().depth);
+  EXPECT_EQ(0, sumStats().requests);
+
+  req.promise.setValue(genRandomLookupResponse(9));
+  EXPECT_EQ(id, fuse_.recvResponse().header.unique);
+
+  // The counters are updated right after the reply is sent.
+  auto deadline = std::chrono::steady_clock::now() + kTimeout;
+  while (sumStats().requests == 0 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+  auto stats = sumStats();
+  EXPECT_EQ(0, stats.depth);
+  EXPECT_EQ(1, stats.requests);
+}
+
 TEST_F(FuseChannelTest, interruptLookups) {
   auto channel = createChannel();
   auto completeFuture = performInit(channel.get());
@@ -370,7 +414,28 @@ TEST_F(FuseChannelTest, interruptLookups) {
     auto response = genRandomLookupResponse(nodeId);
     req.promise.setValue(response);
 
+    // Interrupts handled while their lookup is not registered, before it
+    // starts or once it is done, are answered with EAGAIN.
     auto received = fuse_.recvResponse();
-    EXPECT_EQ(requestId, received.header.unique);
+    while (received.header.unique != requestId) {
+      EXPECT_EQ(-EAGAIN, received.header.error);
+      received = fuse_.recvResponse();
+    }
   }
 }
+
+#ifdef __linux__
+TEST_F(FuseChannelTest, interruptOfUnknownRequestIsRetried) {
+  auto channel = createChannel();
+  auto completeFuture = performInit(channel.get());
+
+  fuse_interrupt_in interruptData{};
+  interruptData.unique = 12345;
+  auto interruptId =
+      fuse_.sendRequest(FUSE_INTERRUPT, FUSE_ROOT_ID, interruptData);
+
+  auto received = fuse_.recvResponse();
+  EXPECT_EQ(interruptId, received.header.unique);
+  EXPECT_EQ(-EAGAIN, received.header.error);
+}
+#endif
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/fuse/FuseUring.h"
+
+#include <folly/portability/GTest.h>
+#include <cstring>
+
+using namespace facebook::eden;
+
+namespace {
+
+constexpr size_t kPayloadSize = 4096;
+
+/**
+ * Fill in entry the way the kernel does for a request with the given
+ * per-opcode arguments and payload.
+ */
+fuse_in_header putRequest(
+    FuseUring::Entry& entry,
+    folly::StringPiece opIn,
+    folly::StringPiece payload) {
+  fuse_in_header header{};
+  header.len = sizeof(header) + opIn.size() + payload.size();
+  header.opcode = FUSE_WRITE;
+  header.unique = 42;
+  memcpy(entry.header.inOut, &header, sizeof(header));
+  memcpy(entry.header.opIn, opIn.data(), opIn.size());
+  memcpy(entry.payload(), payload.data(), payload.size());
+  entry.header.ringEntInOut.payloadSize = payload.size();
+  return header;
+}
+
+fuse_out_header getReplyHeader(const FuseUring::Entry& entry) {
+  fuse_out_header out;
+  memcpy(&out, entry.header.inOut, sizeof(out));
+  return out;
+}
+
+} // namespace
+
+TEST(FuseUring, unpacks_arguments_in_front_of_payload) {
+  FuseUring::Entry entry{nullptr, 0, kPayloadSize};
+  fuse_write_in write{};
+  write.offset = 100;
+  write.size = 5;
+  auto header = putRequest(
+      entry,
+      folly::StringPiece{reinterpret_cast<const char*>(&write), sizeof(write)},
+      "hello");
+
+  auto arg = FuseUring::unpackRequest(entry, header);
+  ASSERT_TRUE(arg.has_value());
+  ASSERT_EQ(sizeof(write) + 5, arg->size());
+  EXPECT_EQ(entry.payload() - sizeof(write), arg->data());
+
+  fuse_write_in parsed;
+  memcpy(&parsed, arg->data(), sizeof(parsed));
+  EXPECT_EQ(100, parsed.offset);
+  EXPECT_EQ(5, parsed.size);
+  EXPECT_EQ("hello", folly::StringPiece{arg->subpiece(sizeof(write))});
+}
+
+TEST(FuseUring, unpacks_request_without_payload) {
+  FuseUring::Entry entry{nullptr, 0, kPayloadSize};
+  auto header = putRequest(entry, "name", {});
+
+  auto arg = FuseUring::unpackRequest(entry, header);
+  ASSERT_TRUE(arg.has_value());
+  EXPECT_EQ("name", folly::StringPiece{*arg});
+}
+
+TEST(FuseUring, rejects_requests_that_do_not_fit_the_entry) {
+  FuseUring::Entry entry{nullptr, 0, kPayloadSize};
+  auto header = putRequest(entry, {}, "payload");
+
+  // The payload is longer than the request.
+  auto shortHeader = header;
+  shortHeader.len = sizeof(fuse_in_header) + 1;
+  EXPECT_FALSE(FuseUring::unpackRequest(entry, shortHeader).has_value());
+
+  // The arguments overflow the room in front of the payload.
+  auto longHeader = header;
+  longHeader.len += kFuseUringOpInSize + 1;
+  EXPECT_FALSE(FuseUring::unpackRequest(entry, longHeader).has_value());
+
+  // The payload overflows its buffer.
+  entry.header.ringEntInOut.payloadSize = kPayloadSize + 1;
+  header.len = sizeof(fuse_in_header) + kPayloadSize + 1;
+  EXPECT_FALSE(FuseUring::unpackRequest(entry, header).has_value());
+}
+
+TEST(FuseUring, packs_reply_into_entry) {
+  FuseUring::Entry entry{nullptr, 0, kPayloadSize};
+  fuse_out_header out{};
+  out.unique = 42;
+  std::string first = "hello ";
+  std::string second = "world";
+  iovec iov[] = {
+      {&out, sizeof(out)},
+      {first.data(), first.size()},
+      {second.data(), second.size()}};
+  FuseUring::packReply(entry, iov, 3);
+
+  auto reply = getReplyHeader(entry);
+  EXPECT_EQ(42, reply.unique);
+  EXPECT_EQ(0, reply.error);
+  EXPECT_EQ(sizeof(out) + 11, reply.len);
+  EXPECT_EQ(11, entry.header.ringEntInOut.payloadSize);
+  EXPECT_EQ(
+      "hello world",
+      folly::StringPiece(reinterpret_cast<char*>(entry.payload()), 11));
+}
+
+TEST(FuseUring, replaces_oversized_reply_with_eio) {
+  FuseUring::Entry entry{nullptr, 0, kPayloadSize};
+  fuse_out_header out{};
+  out.unique = 42;
+  std::string data(kPayloadSize + 1, 'x');
+  iovec iov[] = {{&out, sizeof(out)}, {data.data(), data.size()}};
+  FuseUring::packReply(entry, iov, 2);
+
+  auto reply = getReplyHeader(entry);
+  EXPECT_EQ(42, reply.unique);
+  EXPECT_EQ(-EIO, reply.error);
+  EXPECT_EQ(sizeof(out), reply.len);
+  EXPECT_EQ(0, entry.header.ringEntInOut.payloadSize);
+}
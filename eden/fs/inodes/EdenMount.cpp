@@ -2058,7 +2058,12 @@ std::unique_ptr<FuseChannel, FuseChannelDeleter> makeFuseChannel(
       mount->getCheckoutConfig()->getCaseSensitive(),
       mount->getCheckoutConfig()->getRequireUtf8Path(),
       edenConfig->fuseMaximumRequests.getValue(),
-      mount->getCheckoutConfig()->getUseWriteBackCache())};
+      mount->getCheckoutConfig()->getUseWriteBackCache(),
+      edenConfig->fuseUseReaddirplus.getValue(),
+      edenConfig->fuseUseSplice.getValue(),
+      edenConfig->fuseDeviceQueues.getValue(),
+      edenConfig->fuseUseIoUring.getValue(),
+      edenConfig->fuseIoUringQueueDepth.getValue())};
 }
 } // namespace
 #endif
@@ -2542,9 +2547,9 @@ void EdenMount::subscribeInodeActivityBuffer() {
           // Use full path name for the inode event if available, otherwise
           // default to the filename already stored
           try {
-            // Note calling getPathForInode acquires the InodeMap data_ lock
-            // and an InodeBase's location_ lock. This is safe since we ensure
-            // to never publish to tracebus holding the data_ or a location_
+            // Note calling getPathForInode acquires the InodeMap locks and
+            // an InodeBase's location_ lock. This is safe since we ensure to
+            // never publish to tracebus holding the InodeMap or a location_
             // lock. However, we do still publish holding the EdenMount's
             // Rename and TreeInode's contents_ locks, so we must make sure to
             // NEVER aquire those locks in this subscriber.
@@ -949,7 +949,7 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
    * exception is caught and telemetry is lost.
    *
    * Note: we must make sure to NEVER call this while holding the InodeMap's
-   * data_ lock or an InodeBase's location_ lock since subscribers will also
+   * locks or an InodeBase's location_ lock since subscribers will also
    * attempt to acquire those locks, causing a deadlock if capacity is reached
    * and tracebus starts to block.
    */
@@ -499,6 +499,21 @@ Hash20 FileInodeState::MaterializedState::getSha1(FileInode& inode) {
   return sha1;
 }
 
+Hash32 FileInodeState::MaterializedState::getBlake3(FileInode& inode) {
+  if (blake3_.has_value()) {
+    return blake3_.value();
+  }
+
+#ifdef _WIN32
+  auto blake3 = getFileBlake3(inode.getMaterializedFilePath());
+#else
+  auto blake3 = inode.getMount()->getOverlayFileAccess()->getBlake3(inode);
+#endif // _WIN32
+
+  blake3_ = blake3;
+  return blake3;
+}
+
 uint64_t FileInodeState::MaterializedState::getSize(FileInode& inode) {
   if (size_ != FileInodeState::kUnknownSize) {
     return size_;
@@ -516,6 +531,7 @@ uint64_t FileInodeState::MaterializedState::getSize(FileInode& inode) {
 
 void FileInodeState::MaterializedState::invalidate() {
   sha1_ = std::nullopt;
+  blake3_ = std::nullopt;
   size_ = FileInodeState::kUnknownSize;
 }
 
@@ -832,6 +848,24 @@ ImmediateFuture<Hash20> FileInode::getSha1(
   XLOG(FATAL) << "FileInode in illegal state: " << state->tag;
 }
 
+ImmediateFuture<Hash32> FileInode::getBlake3(
+    const ObjectFetchContextPtr& fetchContext) {
+  auto state = LockedState{this};
+
+  logAccess(*fetchContext);
+  switch (state->tag) {
+    case State::BLOB_NOT_LOADING:
+    case State::BLOB_LOADING:
+      return getObjectStore().getBlobBlake3(
+          state->nonMaterializedState.hash, fetchContext);
+    case State::MATERIALIZED_IN_OVERLAY:
+      return makeImmediateFutureWith(
+          [&] { return state->materializedState.getBlake3(*this); });
+  }
+
+  XLOG(FATAL) << "FileInode in illegal state: " << state->tag;
+}
+
 ImmediateFuture<BlobMetadata> FileInode::getBlobMetadata(
     const ObjectFetchContextPtr& fetchContext) {
   auto state = LockedState{this};
@@ -997,8 +1031,12 @@ ImmediateFuture<std::tuple<BufVec, bool>>
 FileInode::read(size_t size, off_t off, const ObjectFetchContextPtr& context) {
 #ifndef _WIN32
   XDCHECK_GE(off, 0);
+  auto state = LockedState{this};
+  if (auto chunked = tryReadChunked(state, size, off, context)) {
+    return std::move(*chunked);
+  }
   return runWhileDataLoaded(
-      LockedState{this},
+      std::move(state),
       BlobCache::Interest::WantHandle,
       // This function is only called by FUSE.
       context,
@@ -1060,6 +1098,90 @@ FileInode::read(size_t size, off_t off, const ObjectFetchContextPtr& context) {
 #endif
 }
 
+#ifndef _WIN32
+std::optional<ImmediateFuture<std::tuple<BufVec, bool>>>
+FileInode::tryReadChunked(
+    LockedState& state,
+    size_t size,
+    off_t off,
+    const ObjectFetchContextPtr& context) {
+  auto threshold = getMount()->getEdenConfig()->chunkedReadThreshold.getValue();
+  if (threshold == 0 || state->tag != State::BLOB_NOT_LOADING) {
+    return std::nullopt;
+  }
+  auto fileSize = state->nonMaterializedState.size;
+  if (fileSize == FileInodeState::kUnknownSize || fileSize < threshold) {
+    return std::nullopt;
+  }
+  if (state->interestHandle.getObject()) {
+    // The whole blob is still in memory, no need to fetch anything.
+    return std::nullopt;
+  }
+
+  auto start = static_cast<uint64_t>(off);
+  if (start >= fileSize || size == 0) {
+    return ImmediateFuture<std::tuple<BufVec, bool>>{std::tuple<BufVec, bool>{
+        BufVec{folly::IOBuf::wrapBuffer("", 0)}, start >= fileSize}};
+  }
+  auto end = std::min<uint64_t>(start + size, fileSize);
+  auto hash = state->nonMaterializedState.hash;
+  state.unlock();
+  logAccess(*context);
+
+  auto firstChunk = start / BlobCache::kChunkSize;
+  auto lastChunk = (end - 1) / BlobCache::kChunkSize;
+  std::vector<folly::Future<std::shared_ptr<const Blob>>> chunkFutures;
+  chunkFutures.reserve(lastChunk - firstChunk + 1);
+  for (auto index = firstChunk; index <= lastChunk; ++index) {
+    chunkFutures.push_back(
+        getMount()->getBlobAccess()->getBlobChunk(hash, index, context));
+  }
+
+  return ImmediateFuture<std::vector<std::shared_ptr<const Blob>>>{
+      folly::collect(std::move(chunkFutures))}
+      .thenValue(
+          [self = inodePtrFromThis(),
+           hash = std::move(hash),
+           size,
+           off,
+           start,
+           end,
+           fileSize,
+           firstChunk,
+           context = context.copy()](
+              std::vector<std::shared_ptr<const Blob>> chunks)
+              -> ImmediateFuture<std::tuple<BufVec, bool>> {
+            {
+              auto state = LockedState{self};
+              if (state->isMaterialized() ||
+                  !state->nonMaterializedState.hash.bytesEqual(hash)) {
+                // Modified while the chunks were loading, start over.
+                state.unlock();
+                return self->read(size, off, context);
+              }
+              self->updateAtimeLocked(*state);
+            }
+
+            std::unique_ptr<folly::IOBuf> result;
+            for (size_t i = 0; i < chunks.size(); ++i) {
+              auto chunkStart = (firstChunk + i) * BlobCache::kChunkSize;
+              auto chunkEnd = chunkStart + BlobCache::kChunkSize;
+              auto from = std::max(start, chunkStart) - chunkStart;
+              auto to = std::min(end, chunkEnd) - chunkStart;
+              auto piece = std::make_unique<folly::IOBuf>(
+                  chunks[i]->getRange(from, to - from));
+              if (result) {
+                result->appendToChain(std::move(piece));
+              } else {
+                result = std::move(piece);
+              }
+            }
+            return std::tuple<BufVec, bool>{
+                BufVec{std::move(result)}, end == fileSize};
+          });
+}
+#endif
+
 ImmediateFuture<size_t> FileInode::write(
     BufVec&& buf,
     off_t off,
@@ -1193,6 +1315,43 @@ ImmediateFuture<size_t> FileInode::write(
       },
       fetchContext);
 }
+
+#ifdef __linux__
+std::optional<size_t>
+FileInode::spliceRead(size_t size, off_t off, int pipeFd) {
+  XDCHECK_GE(off, 0);
+  auto state = LockedState{this};
+  if (!state->isMaterialized()) {
+    return std::nullopt;
+  }
+  auto spliced =
+      getOverlayFileAccess(state)->spliceRead(*this, pipeFd, size, off);
+  updateAtimeLocked(*state);
+  return spliced;
+}
+
+ImmediateFuture<size_t> FileInode::spliceWrite(
+    int pipeFd,
+    size_t size,
+    off_t off,
+    const ObjectFetchContextPtr& fetchContext) {
+  return runWhileMaterialized(
+      LockedState{this},
+      nullptr,
+      [pipeFd, size, off, self = inodePtrFromThis()](LockedState&& state) {
+        state->materializedState.invalidate();
+        auto xfer = self->getOverlayFileAccess(state)->spliceWrite(
+            *self, pipeFd, size, off);
+
+        self->updateMtimeAndCtimeLocked(*state, self->getNow());
+        state.unlock();
+        self->updateJournal();
+
+        return xfer;
+      },
+      fetchContext);
+}
+#endif
 #endif
 
 ImmediateFuture<std::shared_ptr<const Blob>> FileInode::startLoadingData(
@@ -102,6 +102,11 @@ struct FileInodeState {
      */
     Hash20 getSha1(FileInode& inode);
 
+    /**
+     * Get the BLAKE3 hash for this inode, cached like the sha1.
+     */
+    Hash32 getBlake3(FileInode& inode);
+
     /**
      * Get the file size for this inode.
      *
@@ -111,7 +116,7 @@ struct FileInodeState {
     uint64_t getSize(FileInode& inode);
 
     /**
-     * Reset the cached sha1 and size.
+     * Reset the cached hashes and size.
      *
      * This must be used for every write operation to this inode to ensure that
      * the cache is not out of sync with the Overlay/on-disk state.
@@ -120,6 +125,7 @@ struct FileInodeState {
 
    private:
     std::optional<Hash20> sha1_;
+    std::optional<Hash32> blake3_;
     /**
      * See NonMaterializedState::size.
      * TODO: We probably want to merge NonMaterializedState::size and this one.
@@ -215,6 +221,8 @@ class FileInode final : public InodeBaseMetadata<FileInodeState> {
 
   ImmediateFuture<Hash20> getSha1(const ObjectFetchContextPtr& fetchContext);
 
+  ImmediateFuture<Hash32> getBlake3(const ObjectFetchContextPtr& fetchContext);
+
   ImmediateFuture<BlobMetadata> getBlobMetadata(
       const ObjectFetchContextPtr& fetchContext);
 
@@ -317,6 +325,27 @@ class FileInode final : public InodeBaseMetadata<FileInodeState> {
       off_t off,
       const ObjectFetchContextPtr& fetchContext);
 
+#ifdef __linux__
+  /**
+   * If the file is materialized, move up to size bytes at the specified
+   * offset from its overlay file into the pipe pipeFd, which must have room
+   * for them, and return how many were moved. Returns std::nullopt without
+   * reading anything otherwise, read() is then to be used instead.
+   */
+  std::optional<size_t> spliceRead(size_t size, off_t off, int pipeFd);
+
+  /**
+   * Same as write(), except that the size bytes of data are moved from the
+   * pipe pipeFd to the overlay file rather than copied from a buffer. pipeFd
+   * must remain valid until the returned future completes.
+   */
+  ImmediateFuture<size_t> spliceWrite(
+      int pipeFd,
+      size_t size,
+      off_t off,
+      const ObjectFetchContextPtr& fetchContext);
+#endif
+
   void fsync(bool datasync);
 
   FOLLY_NODISCARD ImmediateFuture<folly::Unit> fallocate(
@@ -333,6 +362,11 @@ class FileInode final : public InodeBaseMetadata<FileInodeState> {
   ImmediateFuture<struct stat> stat(
       const ObjectFetchContextPtr& context) override;
 
+  /**
+   * Update the st_blocks field in a stat structure based on the st_size value.
+   */
+  static void updateBlockCount(struct stat& st);
+
  private:
   using State = FileInodeState;
   class LockedState;
@@ -432,6 +466,21 @@ class FileInode final : public InodeBaseMetadata<FileInodeState> {
    */
   void truncateInOverlay(LockedState& state);
 
+  /**
+   * Serve read() BlobCache::kChunkSize bytes at a time, without loading the
+   * entire blob first.
+   *
+   * Only applies when the file is not materialized nor being loaded, its size
+   * is known and at least blobcache:chunked-read-threshold. Otherwise returns
+   * std::nullopt, with the state still locked, and the caller should use the
+   * regular read path.
+   */
+  std::optional<ImmediateFuture<std::tuple<BufVec, bool>>> tryReadChunked(
+      LockedState& state,
+      size_t size,
+      off_t off,
+      const ObjectFetchContextPtr& context);
+
 #endif // !_WIN32
 
   /**
@@ -502,11 +551,6 @@ class FileInode final : public InodeBaseMetadata<FileInodeState> {
       off_t off);
 #endif // !_WIN32
 
-  /**
-   * Update the st_blocks field in a stat structure based on the st_size value.
-   */
-  static void updateBlockCount(struct stat& st);
-
 #ifdef _WIN32
   /**
    * The getMaterializedFilePath() will return the Absolute path to the file in
@@ -269,6 +269,40 @@ ImmediateFuture<size_t> FuseDispatcherImpl::write(
       });
 }
 
+#ifdef __linux__
+ImmediateFuture<std::variant<BufVec, size_t>> FuseDispatcherImpl::spliceRead(
+    InodeNumber ino,
+    size_t size,
+    off_t off,
+    int pipeFd,
+    const ObjectFetchContextPtr& context) {
+  return inodeMap_->lookupFileInode(ino).thenValue(
+      [context = context.copy(), size, off, pipeFd](FileInodePtr&& inode)
+          -> ImmediateFuture<std::variant<BufVec, size_t>> {
+        if (auto spliced = inode->spliceRead(size, off, pipeFd)) {
+          return std::variant<BufVec, size_t>{*spliced};
+        }
+        return inode->read(size, off, context)
+            .thenValue([](std::tuple<BufVec, bool>&& readRes) {
+              return std::variant<BufVec, size_t>{
+                  std::get<BufVec>(std::move(readRes))};
+            });
+      });
+}
+
+ImmediateFuture<size_t> FuseDispatcherImpl::spliceWrite(
+    InodeNumber ino,
+    int pipeFd,
+    size_t size,
+    off_t off,
+    const ObjectFetchContextPtr& context) {
+  return inodeMap_->lookupFileInode(ino).thenValue(
+      [pipeFd, size, off, context = context.copy()](FileInodePtr&& inode) {
+        return inode->spliceWrite(pipeFd, size, off, context);
+      });
+}
+#endif
+
 ImmediateFuture<Unit> FuseDispatcherImpl::flush(
     InodeNumber /* ino */,
     uint64_t /* lock_owner */) {
@@ -335,6 +369,44 @@ ImmediateFuture<FuseDirList> FuseDispatcherImpl::readdir(
       });
 }
 
+#ifdef __linux__
+ImmediateFuture<FuseDirList> FuseDispatcherImpl::readdirplus(
+    InodeNumber ino,
+    FuseDirList&& dirList,
+    off_t offset,
+    uint64_t /*fh*/,
+    const ObjectFetchContextPtr& context) {
+  return inodeMap_->lookupTreeInode(ino).thenValue(
+      [dirList = std::move(dirList), offset, context = context.copy()](
+          TreeInodePtr inode) mutable {
+        auto children = inode->fuseReaddirplus(dirList, offset, context);
+        std::vector<size_t> indices;
+        std::vector<ImmediateFuture<struct stat>> stats;
+        indices.reserve(children.size());
+        stats.reserve(children.size());
+        for (auto& [index, stat] : children) {
+          indices.push_back(index);
+          stats.push_back(std::move(stat));
+        }
+        return collectAll(std::move(stats))
+            .thenValue([dirList = std::move(dirList),
+                        indices = std::move(indices)](
+                           std::vector<folly::Try<struct stat>> st) mutable {
+              for (size_t i = 0; i < st.size(); ++i) {
+                // Entries whose attributes could not be computed are returned
+                // without them, the kernel then looks them up on its own.
+                if (st[i].hasValue()) {
+                  dirList.setEntry(
+                      indices[i],
+                      computeEntryParam(FuseDispatcher::Attr{st[i].value()}));
+                }
+              }
+              return std::move(dirList);
+            });
+      });
+}
+#endif
+
 ImmediateFuture<fuse_entry_out> FuseDispatcherImpl::mknod(
     InodeNumber parent,
     PathComponentPiece name,
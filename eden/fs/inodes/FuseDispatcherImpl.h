@@ -100,6 +100,20 @@ class FuseDispatcherImpl : public FuseDispatcher {
       folly::StringPiece data,
       off_t off,
       const ObjectFetchContextPtr& context) override;
+#ifdef __linux__
+  ImmediateFuture<std::variant<BufVec, size_t>> spliceRead(
+      InodeNumber ino,
+      size_t size,
+      off_t off,
+      int pipeFd,
+      const ObjectFetchContextPtr& context) override;
+  ImmediateFuture<size_t> spliceWrite(
+      InodeNumber ino,
+      int pipeFd,
+      size_t size,
+      off_t off,
+      const ObjectFetchContextPtr& context) override;
+#endif
 
   ImmediateFuture<folly::Unit> flush(InodeNumber ino, uint64_t lock_owner)
       override;
@@ -119,6 +133,15 @@ class FuseDispatcherImpl : public FuseDispatcher {
       uint64_t fh,
       const ObjectFetchContextPtr& context) override;
 
+#ifdef __linux__
+  ImmediateFuture<FuseDirList> readdirplus(
+      InodeNumber ino,
+      FuseDirList&& dirList,
+      off_t offset,
+      uint64_t fh,
+      const ObjectFetchContextPtr& context) override;
+#endif
+
   ImmediateFuture<std::string> getxattr(
       InodeNumber ino,
       folly::StringPiece name,
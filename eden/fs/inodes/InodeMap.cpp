@@ -119,45 +119,71 @@ InodeMap::~InodeMap() {
   // destroy the EdenMount.
 }
 
-inline void InodeMap::insertLoadedInode(
-    const folly::Synchronized<Members>::LockedPtr& data,
-    InodeBase* inode) {
-  auto ret = data->loadedInodes_.emplace(inode->getNodeId(), inode);
+InodeMap::Shard& InodeMap::getShard(
+    InodeNumber number,
+    const ExclusiveMapLock& mapLock) {
+  XDCHECK(mapLock.owns_lock() && mapLock.mutex() == &mapLock_);
+  return getShard(number).unsafeGetUnlocked();
+}
+
+inline void InodeMap::insertLoadedInode(Shard& shard, InodeBase* inode) {
+  auto ret = shard.loadedInodes_.emplace(inode->getNodeId(), inode);
   XCHECK(ret.second);
   if (inode->getType() == dtype_t::Dir) {
-    ++data->numTreeInodes_;
+    ++shard.numTreeInodes_;
   } else {
-    ++data->numFileInodes_;
+    ++shard.numFileInodes_;
+  }
+}
+
+size_t InodeMap::countLoaded(const ExclusiveMapLock& /* mapLock */) const {
+  size_t count = 0;
+  for (const auto& syncShard : shards_) {
+    count += syncShard.unsafeGetUnlocked().loadedInodes_.size();
   }
+  return count;
+}
+
+size_t InodeMap::countUnloaded(const ExclusiveMapLock& /* mapLock */) const {
+  size_t count = 0;
+  for (const auto& syncShard : shards_) {
+    count += syncShard.unsafeGetUnlocked().unloadedInodes_.size();
+  }
+  return count;
 }
 
 void InodeMap::initializeRoot(
-    const folly::Synchronized<Members>::LockedPtr& data,
+    const ExclusiveMapLock& mapLock,
     TreeInodePtr root) {
-  XCHECK_EQ(data->loadedInodes_.size(), 0ul)
-      << "cannot load InodeMap data over a populated instance";
-  XCHECK_EQ(data->unloadedInodes_.size(), 0ul)
-      << "cannot load InodeMap data over a populated instance";
+  for (auto& syncShard : shards_) {
+    const auto& shard = syncShard.unsafeGetUnlocked();
+    XCHECK_EQ(shard.loadedInodes_.size(), 0ul)
+        << "cannot load InodeMap data over a populated instance";
+    XCHECK_EQ(shard.unloadedInodes_.size(), 0ul)
+        << "cannot load InodeMap data over a populated instance";
+  }
 
   XCHECK(!root_);
   root_ = std::move(root);
-  insertLoadedInode(data, root_.get());
-  XDCHECK_EQ(1ul, data->numTreeInodes_);
-  XDCHECK_EQ(0ul, data->numFileInodes_);
+  auto& shard = getShard(root_->getNodeId(), mapLock);
+  insertLoadedInode(shard, root_.get());
+  XDCHECK_EQ(1ul, shard.numTreeInodes_);
+  XDCHECK_EQ(0ul, shard.numFileInodes_);
 }
 
 void InodeMap::initialize(TreeInodePtr root) {
-  initializeRoot(data_.wlock(), std::move(root));
+  initializeRoot(ExclusiveMapLock{mapLock_}, std::move(root));
 }
 
 template <class... Args>
 void InodeMap::initializeUnloadedInode(
-    const folly::Synchronized<Members>::LockedPtr& data,
+    const ExclusiveMapLock& mapLock,
     InodeNumber parentIno,
     InodeNumber ino,
     Args&&... args) {
   auto unloadedEntry = UnloadedInode(parentIno, std::forward<Args>(args)...);
-  auto result = data->unloadedInodes_.emplace(ino, std::move(unloadedEntry));
+  auto result = getShard(ino, mapLock)
+                    .unloadedInodes_.emplace(ino, std::move(unloadedEntry));
   if (!result.second) {
     auto message = fmt::format(
         "failed to emplace inode number {}; is it already present in the InodeMap?",
@@ -170,8 +196,8 @@ void InodeMap::initializeUnloadedInode(
 void InodeMap::initializeFromTakeover(
     TreeInodePtr root,
     const SerializedInodeMap& takeover) {
-  auto data = data_.wlock();
-  initializeRoot(data, std::move(root));
+  ExclusiveMapLock mapLock{mapLock_};
+  initializeRoot(mapLock, std::move(root));
 
   for (const auto& entry : *takeover.unloadedInodes_ref()) {
     if (*entry.numFsReferences_ref() < 0) {
@@ -196,7 +222,7 @@ void InodeMap::initializeFromTakeover(
       }
     }
     initializeUnloadedInode(
-        data,
+        mapLock,
         InodeNumber::fromThrift(*entry.parentInode_ref()),
         InodeNumber::fromThrift(*entry.inodeNumber_ref()),
         PathComponentPiece{*entry.name_ref()},
@@ -207,7 +233,7 @@ void InodeMap::initializeFromTakeover(
   }
 
   XLOG(DBG2) << "InodeMap initialized mount " << mount_->getPath()
-             << " from takeover, " << data->unloadedInodes_.size()
+             << " from takeover, " << takeover.unloadedInodes_ref()->size()
              << " inodes registered";
 }
 
@@ -216,8 +242,9 @@ void InodeMap::initializeFromOverlay(TreeInodePtr root, Overlay& overlay) {
 
   XLOG(DBG2) << "Initializing InodeMap for " << mount_->getPath();
 
-  auto data = data_.wlock();
-  initializeRoot(data, std::move(root));
+  ExclusiveMapLock mapLock{mapLock_};
+  initializeRoot(mapLock, std::move(root));
+  size_t numUnloaded = 0;
 
   std::vector<std::tuple<AbsolutePath, InodeNumber>> pending;
   pending.emplace_back(mount_->getPath(), root_->getNodeId());
@@ -244,7 +271,7 @@ void InodeMap::initializeFromOverlay(TreeInodePtr root, Overlay& overlay) {
       }
 
       initializeUnloadedInode(
-          data,
+          mapLock,
           dirInode,
           ino,
           name,
@@ -252,30 +279,38 @@ void InodeMap::initializeFromOverlay(TreeInodePtr root, Overlay& overlay) {
           dirent.getInitialMode(),
           dirent.getOptionalHash(),
           1);
+      ++numUnloaded;
     }
   }
 
   XLOG(DBG2) << "InodeMap initialized mount " << mount_->getPath()
-             << " from overlay, " << data->unloadedInodes_.size()
+             << " from overlay, " << numUnloaded
              << " inodes registered";
 }
 
 ImmediateFuture<InodePtr> InodeMap::lookupInode(InodeNumber number) {
-  // Lock the data.
+  // Check to see if this Inode is already loaded, which only needs its shard.
+  if (auto inode = lookupLoadedInode(number)) {
+    return inode;
+  }
+
+  // Otherwise lock the whole map, as we may need to walk up through unloaded
+  // parents.
   // We hold it while doing most of our work below, but explicitly unlock it
   // before triggering inode loading or before fulfilling any Promises.
-  auto data = data_.wlock();
+  ExclusiveMapLock mapLock{mapLock_};
   std::vector<InodeTraceEvent> startLoadEvents;
 
-  // Check to see if this Inode is already loaded
-  auto loadedIter = data->loadedInodes_.find(number);
-  if (loadedIter != data->loadedInodes_.end()) {
+  // Check again, the inode may have been loaded since we looked.
+  auto* shard = &getShard(number, mapLock);
+  auto loadedIter = shard->loadedInodes_.find(number);
+  if (loadedIter != shard->loadedInodes_.end()) {
     return loadedIter->second.getPtr();
   }
 
   // Look up the data in the unloadedInodes_ map.
-  auto unloadedIter = data->unloadedInodes_.find(number);
-  if (UNLIKELY(unloadedIter == data->unloadedInodes_.end())) {
+  auto unloadedIter = shard->unloadedInodes_.find(number);
+  if (UNLIKELY(unloadedIter == shard->unloadedInodes_.end())) {
     if (mount_->throwEstaleIfInodeIsMissing()) {
       XLOG(DBG3) << "NFS inode " << number << " stale";
       // windows does not have ESTALE. We need some other error to turn into the
@@ -297,8 +332,7 @@ ImmediateFuture<InodePtr> InodeMap::lookupInode(InodeNumber number) {
   bool alreadyLoading = !unloadedData->promises.empty();
 
   if (!alreadyLoading) {
-    startLoadEvents.push_back(
-        createInodeLoadStartEvent(number, *unloadedData, data));
+    startLoadEvents.push_back(createInodeLoadStartEvent(number, *unloadedData));
   }
 
   // Add a new entry to the promises list.
@@ -325,8 +359,9 @@ ImmediateFuture<InodePtr> InodeMap::lookupInode(InodeNumber number) {
   auto childInodeNumber = number;
   while (true) {
     // Check to see if this parent is loaded
-    loadedIter = data->loadedInodes_.find(unloadedData->parent);
-    if (loadedIter != data->loadedInodes_.end()) {
+    shard = &getShard(unloadedData->parent, mapLock);
+    loadedIter = shard->loadedInodes_.find(unloadedData->parent);
+    if (loadedIter != shard->loadedInodes_.end()) {
       // We found a loaded parent.
       // Grab copies of the arguments we need for startChildLookup(),
       // with the lock still held.
@@ -335,8 +370,9 @@ ImmediateFuture<InodePtr> InodeMap::lookupInode(InodeNumber number) {
       bool isUnlinked = unloadedData->isUnlinked;
       std::optional<ObjectId> optionalHash = unloadedData->hash;
       auto mode = unloadedData->mode;
-      // Unlock data and publish load events before starting the child lookup
-      data.unlock();
+      // Unlock the map and publish load events before starting the child
+      // lookup
+      mapLock.unlock();
       for (auto& event : startLoadEvents) {
         mount_->publishInodeTraceEvent(std::move(event));
       }
@@ -352,16 +388,16 @@ ImmediateFuture<InodePtr> InodeMap::lookupInode(InodeNumber number) {
     }
 
     // Look up the parent in unloadedInodes_
-    unloadedIter = data->unloadedInodes_.find(unloadedData->parent);
-    if (UNLIKELY(unloadedIter == data->unloadedInodes_.end())) {
+    unloadedIter = shard->unloadedInodes_.find(unloadedData->parent);
+    if (UNLIKELY(unloadedIter == shard->unloadedInodes_.end())) {
       // This shouldn't happen.  We must know about the parent inode number if
       // we knew about the child.
       auto bug = EDEN_BUG_EXCEPTION()
           << "unknown parent inode " << unloadedData->parent << " (of "
           << unloadedData->name << ")";
-      // Unlock our data before publishing any stored load start events and
+      // Unlock the map before publishing any stored load start events and
       // calling inodeLoadFailed()
-      data.unlock();
+      mapLock.unlock();
       for (auto& event : startLoadEvents) {
         mount_->publishInodeTraceEvent(std::move(event));
       }
@@ -374,7 +410,7 @@ ImmediateFuture<InodePtr> InodeMap::lookupInode(InodeNumber number) {
 
     if (!alreadyLoading) {
       startLoadEvents.push_back(
-          createInodeLoadStartEvent(unloadedData->parent, *parentData, data));
+          createInodeLoadStartEvent(unloadedData->parent, *parentData));
     }
 
     // Add a new entry to the promises list.
@@ -392,7 +428,7 @@ ImmediateFuture<InodePtr> InodeMap::lookupInode(InodeNumber number) {
     if (alreadyLoading) {
       // This parent is already being loaded.
       // We don't need to trigger any new loads ourself.
-      data.unlock();
+      mapLock.unlock();
       for (auto& event : startLoadEvents) {
         mount_->publishInodeTraceEvent(std::move(event));
       }
@@ -467,9 +503,10 @@ InodeMap::PromiseVector InodeMap::inodeLoadComplete(InodeBase* inode) {
   try {
     std::optional<InodeTraceEvent> endLoadEvent;
     {
-      auto data = data_.wlock();
-      auto it = data->unloadedInodes_.find(number);
-      XCHECK(it != data->unloadedInodes_.end())
+      SharedMapLock mapLock{mapLock_};
+      auto shard = getShard(number).lock();
+      auto it = shard->unloadedInodes_.find(number);
+      XCHECK(it != shard->unloadedInodes_.end())
           << "failed to find unloaded inode data when finishing load of inode "
           << number << ": " << inode->getLogPath();
       swap(promises, it->second.promises);
@@ -477,10 +514,10 @@ InodeMap::PromiseVector InodeMap::inodeLoadComplete(InodeBase* inode) {
       inode->setChannelRefcount(it->second.numFsReferences);
 
       // Insert the entry into loadedInodes_ and remove it from unloadedInodes_
-      insertLoadedInode(data, inode);
+      insertLoadedInode(*shard, inode);
       // Before removing from unloadedInodes_, create an inode end event (for
-      // which we need the data_ lock to read attributes) and publish the event
-      // after releasing the data_ lock
+      // which we need the shard lock to read attributes) and publish the event
+      // after releasing the locks
       endLoadEvent = std::make_optional<InodeTraceEvent>(
           it->second.loadStartTime,
           number,
@@ -488,7 +525,7 @@ InodeMap::PromiseVector InodeMap::inodeLoadComplete(InodeBase* inode) {
           InodeEventType::LOAD,
           InodeEventProgress::END,
           it->second.name);
-      data->unloadedInodes_.erase(it);
+      shard->unloadedInodes_.erase(it);
     }
     mount_->publishInodeTraceEvent(std::move(endLoadEvent.value()));
     return promises;
@@ -523,8 +560,7 @@ void InodeMap::inodeLoadFailed(
 
 InodeTraceEvent InodeMap::createInodeLoadStartEvent(
     InodeNumber number,
-    UnloadedInode& unloadedData,
-    const folly::Synchronized<Members>::LockedPtr& /* data */) {
+    UnloadedInode& unloadedData) {
   unloadedData.loadStartTime = std::chrono::system_clock::now();
   return InodeTraceEvent(
       unloadedData.loadStartTime,
@@ -537,9 +573,10 @@ InodeTraceEvent InodeMap::createInodeLoadStartEvent(
 
 std::optional<InodeTraceEvent> InodeMap::createInodeLoadFailEvent(
     InodeNumber number) {
-  auto data = data_.rlock();
-  auto it = data->unloadedInodes_.find(number);
-  if (it != data->unloadedInodes_.end()) {
+  SharedMapLock mapLock{mapLock_};
+  auto shard = getShard(number).lock();
+  auto it = shard->unloadedInodes_.find(number);
+  if (it != shard->unloadedInodes_.end()) {
     XLOG(ERR)
         << "failed to find unloaded inode data when finishing load of inode "
         << number;
@@ -557,9 +594,10 @@ std::optional<InodeTraceEvent> InodeMap::createInodeLoadFailEvent(
 InodeMap::PromiseVector InodeMap::extractPendingPromises(InodeNumber number) {
   PromiseVector promises;
   {
-    auto data = data_.wlock();
-    auto it = data->unloadedInodes_.find(number);
-    XCHECK(it != data->unloadedInodes_.end())
+    SharedMapLock mapLock{mapLock_};
+    auto shard = getShard(number).lock();
+    auto it = shard->unloadedInodes_.find(number);
+    XCHECK(it != shard->unloadedInodes_.end())
         << "failed to find unloaded inode data when finishing load of inode "
         << number;
     swap(promises, it->second.promises);
@@ -578,9 +616,10 @@ ImmediateFuture<FileInodePtr> InodeMap::lookupFileInode(InodeNumber number) {
 }
 
 InodePtr InodeMap::lookupLoadedInode(InodeNumber number) {
-  auto data = data_.rlock();
-  auto it = data->loadedInodes_.find(number);
-  if (it == data->loadedInodes_.end()) {
+  SharedMapLock mapLock{mapLock_};
+  auto shard = getShard(number).lock();
+  auto it = shard->loadedInodes_.find(number);
+  if (it == shard->loadedInodes_.end()) {
     return nullptr;
   }
   return it->second.getPtr();
@@ -603,20 +642,21 @@ FileInodePtr InodeMap::lookupLoadedFile(InodeNumber number) {
 }
 
 std::optional<RelativePath> InodeMap::getPathForInode(InodeNumber inodeNumber) {
-  auto data = data_.rlock();
-  return getPathForInodeHelper(inodeNumber, data);
+  ExclusiveMapLock mapLock{mapLock_};
+  return getPathForInodeHelper(inodeNumber, mapLock);
 }
 
 std::optional<RelativePath> InodeMap::getPathForInodeHelper(
     InodeNumber inodeNumber,
-    const folly::Synchronized<Members>::RLockedPtr& data) {
-  auto loadedIt = data->loadedInodes_.find(inodeNumber);
-  if (loadedIt != data->loadedInodes_.cend()) {
+    const ExclusiveMapLock& mapLock) {
+  auto& shard = getShard(inodeNumber, mapLock);
+  auto loadedIt = shard.loadedInodes_.find(inodeNumber);
+  if (loadedIt != shard.loadedInodes_.cend()) {
     // If the inode is loaded, return its RelativePath
     return loadedIt->second->getPath();
   } else {
-    auto unloadedIt = data->unloadedInodes_.find(inodeNumber);
-    if (unloadedIt != data->unloadedInodes_.cend()) {
+    auto unloadedIt = shard.unloadedInodes_.find(inodeNumber);
+    if (unloadedIt != shard.unloadedInodes_.cend()) {
       if (unloadedIt->second.isUnlinked) {
         return std::nullopt;
       }
@@ -627,7 +667,7 @@ std::optional<RelativePath> InodeMap::getPathForInodeHelper(
         // The parent is the Eden mount root, just return its name (base case)
         return RelativePath(unloadedIt->second.name);
       }
-      auto dir = getPathForInodeHelper(parent, data);
+      auto dir = getPathForInodeHelper(parent, mapLock);
       if (!dir) {
         EDEN_BUG() << "unlinked parent inode " << parent
                    << "appears to contain non-unlinked child " << inodeNumber;
@@ -641,8 +681,8 @@ std::optional<RelativePath> InodeMap::getPathForInodeHelper(
 void InodeMap::decFsRefcount(InodeNumber number, uint32_t count) {
   InodePtr inodePtr;
   {
-    auto data = data_.wlock();
-    inodePtr = decFsRefcountHelper(data, number, count);
+    SharedMapLock mapLock{mapLock_};
+    inodePtr = decFsRefcountHelper(*getShard(number).lock(), number, count);
   }
   // Now release our lock before decrementing the inode's FS reference
   // count and immediately releasing our pointer reference.
@@ -652,7 +692,7 @@ void InodeMap::decFsRefcount(InodeNumber number, uint32_t count) {
 }
 
 InodePtr InodeMap::decFsRefcountHelper(
-    folly::Synchronized<Members>::LockedPtr& data,
+    Shard& shard,
     InodeNumber number,
     uint32_t count,
     bool clearRefCount) {
@@ -661,8 +701,8 @@ InodePtr InodeMap::decFsRefcountHelper(
   }
 
   // First check in the loaded inode map
-  auto loadedIter = data->loadedInodes_.find(number);
-  if (loadedIter != data->loadedInodes_.end()) {
+  auto loadedIter = shard.loadedInodes_.find(number);
+  if (loadedIter != shard.loadedInodes_.end()) {
     // Acquire an InodePtr, so that we are always holding a pointer reference
     // on the inode when we decrement the fs refcount.
     //
@@ -673,8 +713,8 @@ InodePtr InodeMap::decFsRefcountHelper(
   }
 
   // If it wasn't loaded, it should be in the unloaded map
-  auto unloadedIter = data->unloadedInodes_.find(number);
-  if (UNLIKELY(unloadedIter == data->unloadedInodes_.end())) {
+  auto unloadedIter = shard.unloadedInodes_.find(number);
+  if (UNLIKELY(unloadedIter == shard.unloadedInodes_.end())) {
     EDEN_BUG() << "InodeMap::decFsRefcount() called on unknown inode number "
                << number;
   }
@@ -694,7 +734,7 @@ InodePtr InodeMap::decFsRefcountHelper(
     // We can completely forget about this unloaded inode now.
     XLOG(DBG5) << "forgetting unloaded inode " << number << ": "
                << unloadedEntry.parent << ":" << unloadedEntry.name;
-    data->unloadedInodes_.erase(unloadedIter);
+    shard.unloadedInodes_.erase(unloadedIter);
   }
   return nullptr;
 }
@@ -718,7 +758,7 @@ void InodeMap::forgetStaleInodes() {
   // TODO: this will unload by atime, atime is not updated by stat -- fix it
 
   XLOG(DBG2) << "forgetting stale inodes";
-  // We have to destroy InodePtrs outside of the data lock. These hold all the
+  // We have to destroy InodePtrs outside of the map lock. These hold all the
   // InodePtrs we created.
   std::vector<InodePtr> toClearFSRef;
   std::vector<InodePtr> justToHoldBeyondScopeOfLock;
@@ -728,23 +768,25 @@ void InodeMap::forgetStaleInodes() {
   std::vector<InodeNumber> unloadedInodesToClearFSRef;
 
   {
-    auto data = data_.wlock();
-
-    for (auto& inode : data->unloadedInodes_) {
-      XLOG(DBG9) << "Considering forgetting unloaded inode " << inode.first;
-      if (inode.second.isUnlinked) {
-        // We can't directly call decFsRefcountHelper here because it will
-        // invalidate the iterator we are using for this for loop.
-        unloadedInodesToClearFSRef.push_back(inode.first);
-      } else {
-        XLOG(DBG9) << "Not forgetting unloaded inode " << inode.first
-                   << " because inode is still linked";
+    ExclusiveMapLock mapLock{mapLock_};
+
+    for (auto& syncShard : shards_) {
+      for (auto& inode : syncShard.unsafeGetUnlocked().unloadedInodes_) {
+        XLOG(DBG9) << "Considering forgetting unloaded inode " << inode.first;
+        if (inode.second.isUnlinked) {
+          // We can't directly call decFsRefcountHelper here because it will
+          // invalidate the iterator we are using for this for loop.
+          unloadedInodesToClearFSRef.push_back(inode.first);
+        } else {
+          XLOG(DBG9) << "Not forgetting unloaded inode " << inode.first
+                     << " because inode is still linked";
+        }
       }
     }
 
     for (auto& inodeNumber : unloadedInodesToClearFSRef) {
       auto inodePtr = decFsRefcountHelper(
-          data,
+          getShard(inodeNumber, mapLock),
           inodeNumber,
           /*count=*/0, // Doesn't matter what we set this to because we are
                        // going to clear the ref count.
@@ -757,41 +799,45 @@ void InodeMap::forgetStaleInodes() {
     // we do this second because dereferencing a loaded inode will cause it to
     // be unloaded. Thus this will create lots of unloaded inodes. we don't want
     // to double decRef them, so we decref loaded inodes after unloaded ones.
-    for (auto& inode : data->loadedInodes_) {
-      XLOG(DBG9) << "Considering forgetting loaded inode " << inode.first;
-      auto inodePtr = decFsRefcountHelper(
-          data,
-          inode.first,
-          /*count=*/0, // Doesn't matter what we set this to because we are
-                       // going to clear the ref count.
-          /*clearRefCount=*/true);
-      if (inodePtr) {
-        auto unlinked = inodePtr->isUnlinked();
-        if (unlinked &&
-            inode.second->getMetadata().timestamps.atime < cutoff_ts) {
-          XLOG(DBG9) << "Will forget loaded inode " << inode.first;
-          toClearFSRef.push_back(inodePtr);
-        } else {
-          // even though we are not going to do anything with these inodes we
-          // need to keep them around until we let go of the lock. It is not
-          // safe to drop an inodePtr while holding the lock.
-          if (!unlinked) {
-            XLOG(DBG9) << "Not forgetting loaded inode " << inode.first
-                       << " because it is still linked";
+    for (auto& syncShard : shards_) {
+      auto& shard = syncShard.unsafeGetUnlocked();
+      for (auto& inode : shard.loadedInodes_) {
+        XLOG(DBG9) << "Considering forgetting loaded inode " << inode.first;
+        auto inodePtr = decFsRefcountHelper(
+            shard,
+            inode.first,
+            /*count=*/0, // Doesn't matter what we set this to because we are
+                         // going to clear the ref count.
+            /*clearRefCount=*/true);
+        if (inodePtr) {
+          auto unlinked = inodePtr->isUnlinked();
+          if (unlinked &&
+              inode.second->getMetadata().timestamps.atime < cutoff_ts) {
+            XLOG(DBG9) << "Will forget loaded inode " << inode.first;
+            toClearFSRef.push_back(inodePtr);
           } else {
-            XLOG(DBG9) << "Not forgetting loaded inode " << inode.first
-                       << " because it was referenced."
-                       << durationStr(
-                              config_->getEdenConfig()
-                                  ->postCheckoutDelayToUnloadInodes.getValue() -
-                              std::chrono::nanoseconds{
-                                  inode.second->getMetadata()
-                                      .timestamps.atime.toTimespec()
-                                      .tv_nsec -
-                                  cutoff_ts.tv_nsec})
-                       << " ago";
+            // even though we are not going to do anything with these inodes we
+            // need to keep them around until we let go of the lock. It is not
+            // safe to drop an inodePtr while holding the lock.
+            if (!unlinked) {
+              XLOG(DBG9) << "Not forgetting loaded inode " << inode.first
+                         << " because it is still linked";
+            } else {
+              XLOG(DBG9) << "Not forgetting loaded inode " << inode.first
+                         << " because it was referenced."
+                         << durationStr(
+                                config_->getEdenConfig()
+                                    ->postCheckoutDelayToUnloadInodes
+                                    .getValue() -
+                                std::chrono::nanoseconds{
+                                    inode.second->getMetadata()
+                                        .timestamps.atime.toTimespec()
+                                        .tv_nsec -
+                                    cutoff_ts.tv_nsec})
+                         << " ago";
+            }
+            justToHoldBeyondScopeOfLock.push_back(inodePtr);
           }
-          justToHoldBeyondScopeOfLock.push_back(inodePtr);
         }
       }
     }
@@ -808,9 +854,9 @@ void InodeMap::forgetStaleInodes() {
 }
 
 void InodeMap::setUnmounted() {
-  auto data = data_.wlock();
-  XDCHECK(!data->isUnmounted_);
-  data->isUnmounted_ = true;
+  ExclusiveMapLock mapLock{mapLock_};
+  XDCHECK(!isUnmounted_);
+  isUnmounted_ = true;
 }
 
 Future<SerializedInodeMap> InodeMap::shutdown(
@@ -818,16 +864,16 @@ Future<SerializedInodeMap> InodeMap::shutdown(
   // Record that we are in the process of shutting down.
   auto future = Future<folly::Unit>::makeEmpty();
   {
-    auto data = data_.wlock();
-    XCHECK(!data->shutdownPromise.has_value())
+    ExclusiveMapLock mapLock{mapLock_};
+    XCHECK(!shutdownPromise_.has_value())
         << "shutdown() invoked more than once on InodeMap for "
         << mount_->getPath();
-    data->shutdownPromise.emplace(Promise<Unit>{});
-    future = data->shutdownPromise->getFuture();
+    shutdownPromise_.emplace(Promise<Unit>{});
+    future = shutdownPromise_->getFuture();
 
     XLOG(DBG3) << "starting InodeMap::shutdown: loadedCount="
-               << data->loadedInodes_.size()
-               << " unloadedCount=" << data->unloadedInodes_.size();
+               << countLoaded(mapLock)
+               << " unloadedCount=" << countUnloaded(mapLock);
   }
 
   // If an error occurs during mount point initialization, shutdown() can be
@@ -864,19 +910,21 @@ Future<SerializedInodeMap> InodeMap::shutdown(
     // to them, then let the normal pointer release process be responsible for
     // unloading them.
     std::vector<InodePtr> inodesToUnload;
-    auto data = data_.wlock();
-    for (const auto& entry : data->loadedInodes_) {
-      if (!entry.second->isPtrAcquireCountZero()) {
-        continue;
-      }
-      if (!entry.second->isUnlinked()) {
-        continue;
+    ExclusiveMapLock mapLock{mapLock_};
+    for (const auto& syncShard : shards_) {
+      for (const auto& entry : syncShard.unsafeGetUnlocked().loadedInodes_) {
+        if (!entry.second->isPtrAcquireCountZero()) {
+          continue;
+        }
+        if (!entry.second->isUnlinked()) {
+          continue;
+        }
+        inodesToUnload.push_back(entry.second.getPtr());
       }
-      inodesToUnload.push_back(entry.second.getPtr());
     }
     // Release the lock, then release all of our InodePtrs to unload
     // the inodes.
-    data.unlock();
+    mapLock.unlock();
     inodesToUnload.clear();
   }
 
@@ -893,76 +941,82 @@ Future<SerializedInodeMap> InodeMap::shutdown(
       return SerializedInodeMap{};
     }
 
-    auto data = data_.wlock();
+    ExclusiveMapLock mapLock{mapLock_};
+    auto loadedCount = countLoaded(mapLock);
+    auto unloadedCount = countUnloaded(mapLock);
     XLOG(DBG3)
         << "InodeMap::shutdown after releasing inodesToClear: loadedCount="
-        << data->loadedInodes_.size()
-        << " unloadedCount=" << data->unloadedInodes_.size();
+        << loadedCount << " unloadedCount=" << unloadedCount;
 
-    if (!data->loadedInodes_.empty()) {
-      EDEN_BUG() << "After InodeMap::shutdown() finished, "
-                 << data->loadedInodes_.size()
+    if (loadedCount != 0) {
+      EDEN_BUG() << "After InodeMap::shutdown() finished, " << loadedCount
                  << " inodes still loaded; they must all "
                  << "have been unloaded for this to succeed!";
     }
 
     SerializedInodeMap result;
-    result.unloadedInodes_ref()->reserve(data->unloadedInodes_.size());
-    for (const auto& [inodeNumber, entry] : data->unloadedInodes_) {
-      SerializedInodeMapEntry serializedEntry;
-
-      XLOG(DBG5) << "  serializing unloaded inode " << inodeNumber
-                 << " parent=" << entry.parent.get() << " name=" << entry.name;
-
-      serializedEntry.inodeNumber_ref() = inodeNumber.get();
-      serializedEntry.parentInode_ref() = entry.parent.get();
-      serializedEntry.name() = entry.name.asString();
-      serializedEntry.isUnlinked_ref() = entry.isUnlinked;
-      serializedEntry.numFsReferences_ref() = entry.numFsReferences;
-      if (entry.hash.has_value()) {
-        serializedEntry.hash_ref() = entry.hash.value().asString();
-      }
-      // If entry.hash is empty, the inode is materialized.
-      serializedEntry.mode_ref() = entry.mode;
+    result.unloadedInodes_ref()->reserve(unloadedCount);
+    for (const auto& syncShard : shards_) {
+      for (const auto& [inodeNumber, entry] :
+           syncShard.unsafeGetUnlocked().unloadedInodes_) {
+        SerializedInodeMapEntry serializedEntry;
+
+        XLOG(DBG5) << "  serializing unloaded inode " << inodeNumber
+                   << " parent=" << entry.parent.get()
+                   << " name=" << entry.name;
+
+        serializedEntry.inodeNumber_ref() = inodeNumber.get();
+        serializedEntry.parentInode_ref() = entry.parent.get();
+        serializedEntry.name() = entry.name.asString();
+        serializedEntry.isUnlinked_ref() = entry.isUnlinked;
+        serializedEntry.numFsReferences_ref() = entry.numFsReferences;
+        if (entry.hash.has_value()) {
+          serializedEntry.hash_ref() = entry.hash.value().asString();
+        }
+        // If entry.hash is empty, the inode is materialized.
+        serializedEntry.mode_ref() = entry.mode;
 
-      result.unloadedInodes_ref()->emplace_back(std::move(serializedEntry));
+        result.unloadedInodes_ref()->emplace_back(std::move(serializedEntry));
+      }
     }
 
     return result;
   });
 }
 
-void InodeMap::shutdownComplete(
-    folly::Synchronized<Members>::LockedPtr&& data) {
+void InodeMap::shutdownComplete(ExclusiveMapLock&& mapLock) {
   // We manually dropped our reference count to the root inode in
   // shutdown().  Destroy it now, remove it from the loadedInodes, and call
   // resetNoDecRef() on our pointer to make sure it doesn't try to decrement the
   // reference count again when the pointer is destroyed. Note: we don't add
   // the root to unloadedInodes here as it has been freed and we don't want to
   // serialize the freed root during graceful shutdown for takeover.
-  auto numErased = data->loadedInodes_.erase(kRootNodeId);
+  auto& shard = getShard(kRootNodeId, mapLock);
+  auto numErased = shard.loadedInodes_.erase(kRootNodeId);
   XCHECK_EQ(numErased, 1u) << "inconsistent loaded inodes data: "
                            << kRootNodeId;
-  --data->numTreeInodes_;
+  --shard.numTreeInodes_;
   delete root_.get();
   root_.resetNoDecRef();
 
-  // Unlock data_ before fulfilling the shutdown promise, just in case the
+  // Unlock the map before fulfilling the shutdown promise, just in case the
   // promise invokes a callback that calls some of our other methods that
   // may need to acquire this lock.
-  auto* shutdownPromise = &data->shutdownPromise.value();
-  data.unlock();
+  auto* shutdownPromise = &shutdownPromise_.value();
+  mapLock.unlock();
   shutdownPromise->setValue();
 }
 
 bool InodeMap::isInodeRemembered(InodeNumber ino) const {
-  return data_.rlock()->unloadedInodes_.count(ino) > 0;
+  SharedMapLock mapLock{mapLock_};
+  return getShard(ino).lock()->unloadedInodes_.count(ino) > 0;
 }
 
 bool InodeMap::isInodeLoadedOrRemembered(InodeNumber ino) const {
-  auto members = data_.rlock();
-  return members->unloadedInodes_.count(ino) > 0 ||
-      members->loadedInodes_.count(ino) > 0;
+  SharedMapLock mapLock{mapLock_};
+  auto shard = getShard(ino).lock();
+  return shard->unloadedInodes_.count(ino) > 0 ||
+      shard->loadedInodes_.count(ino) > 0;
 }
 
 void InodeMap::onInodeUnreferenced(
@@ -970,8 +1024,21 @@ void InodeMap::onInodeUnreferenced(
     ParentInodeInfo&& parentInfo) {
   XLOG(DBG8) << "inode " << inode->getNodeId()
              << " unreferenced: " << inode->getLogPath();
+  {
+    // Most unreferenced inodes stay loaded, which only needs the inode's
+    // shard.  Only take the whole map when the inode may get unloaded below.
+    SharedMapLock mapLock{mapLock_};
+    bool mayUnload = shutdownPromise_.has_value() ||
+        (parentInfo.isUnlinked() && inode->getFsRefcount() == 0);
+    if (!mayUnload) {
+      auto shard = getShard(inode->getNodeId()).lock();
+      inode->decPtrAcquireCount();
+      return;
+    }
+  }
+
   // Acquire our lock.
-  auto data = data_.wlock();
+  ExclusiveMapLock mapLock{mapLock_};
 
   // Decrement the Inode's acquire count
   auto acquireCount = inode->decPtrAcquireCount();
@@ -983,13 +1050,13 @@ void InodeMap::onInodeUnreferenced(
 
   // Decide if we should unload the inode now, or wait until later.
   bool unloadNow = false;
-  bool shuttingDown = data->shutdownPromise.has_value();
+  bool shuttingDown = shutdownPromise_.has_value();
   XDCHECK(shuttingDown || inode != root_.get());
   if (shuttingDown) {
     // Check to see if this was the root inode that got unloaded.
     // This indicates that the shutdown is complete.
     if (inode == root_.get()) {
-      shutdownComplete(std::move(data));
+      shutdownComplete(std::move(mapLock));
       return;
     }
 
@@ -1013,7 +1080,7 @@ void InodeMap::onInodeUnreferenced(
         parentInfo.getParent().get(),
         parentInfo.getName(),
         parentInfo.isUnlinked(),
-        data);
+        mapLock);
     if (!parentInfo.isUnlinked()) {
       const auto& parentContents = parentInfo.getParentContents();
       auto it = parentContents->entries.find(parentInfo.getName());
@@ -1027,7 +1094,7 @@ void InodeMap::onInodeUnreferenced(
   // Deleting it may cause its parent TreeInode to become unreferenced, causing
   // another recursive call to onInodeUnreferenced(), which will need to
   // reacquire the lock.
-  data.unlock();
+  mapLock.unlock();
   parentInfo.reset();
   if (unloadNow) {
     delete inode;
@@ -1035,7 +1102,7 @@ void InodeMap::onInodeUnreferenced(
 }
 
 InodeMapLock InodeMap::lockForUnload() {
-  return InodeMapLock{data_.wlock()};
+  return InodeMapLock{ExclusiveMapLock{mapLock_}};
 }
 
 void InodeMap::unloadInode(
@@ -1044,7 +1111,7 @@ void InodeMap::unloadInode(
     PathComponentPiece name,
     bool isUnlinked,
     const InodeMapLock& lock) {
-  return unloadInode(inode, parent, name, isUnlinked, lock.data_);
+  return unloadInode(inode, parent, name, isUnlinked, lock.mapLock_);
 }
 
 void InodeMap::unloadInode(
@@ -1052,27 +1119,28 @@ void InodeMap::unloadInode(
     TreeInode* parent,
     PathComponentPiece name,
     bool isUnlinked,
-    const folly::Synchronized<Members>::LockedPtr& data) {
+    const ExclusiveMapLock& mapLock) {
   // Call updateOverlayForUnload() to update the overlay and compute
   // if we need to remember an UnloadedInode entry.
   auto unloadedEntry =
-      updateOverlayForUnload(inode, parent, name, isUnlinked, data);
+      updateOverlayForUnload(inode, parent, name, isUnlinked, mapLock);
+  auto& shard = getShard(inode->getNodeId(), mapLock);
   if (unloadedEntry) {
     // Insert the unloaded entry
     XLOG(DBG7) << "inserting unloaded map entry for inode "
                << inode->getNodeId();
-    auto ret = data->unloadedInodes_.emplace(
+    auto ret = shard.unloadedInodes_.emplace(
         inode->getNodeId(), std::move(unloadedEntry.value()));
     XCHECK(ret.second);
   }
 
-  auto numErased = data->loadedInodes_.erase(inode->getNodeId());
+  auto numErased = shard.loadedInodes_.erase(inode->getNodeId());
   XCHECK_EQ(numErased, 1u) << "inconsistent loaded inodes data: "
                            << inode->getLogPath();
   if (inode->getType() == dtype_t::Dir) {
-    --data->numTreeInodes_;
+    --shard.numTreeInodes_;
   } else {
-    --data->numFileInodes_;
+    --shard.numFileInodes_;
   }
 }
 
@@ -1081,9 +1149,9 @@ optional<InodeMap::UnloadedInode> InodeMap::updateOverlayForUnload(
     TreeInode* parent,
     PathComponentPiece name,
     bool isUnlinked,
-    const folly::Synchronized<Members>::LockedPtr& data) {
+    const ExclusiveMapLock& mapLock) {
   auto fsCount = inode->getFsRefcount();
-  if (isUnlinked && (data->isUnmounted_ || fsCount == 0)) {
+  if (isUnlinked && (isUnmounted_ || fsCount == 0)) {
     try {
       if (inode->getType() == dtype_t::Dir) {
         mount_->getOverlay()->removeOverlayDir(inode->getNodeId());
@@ -1110,7 +1178,7 @@ optional<InodeMap::UnloadedInode> InodeMap::updateOverlayForUnload(
   // refcounts on inodes that still existed before it was unmounted.
   // Everything is unreferenced by FS after an unmount operation, and we no
   // longer need to remember anything in the unloadedInodes_ map.
-  if (data->isUnmounted_) {
+  if (isUnmounted_) {
     XLOG(DBG5) << "forgetting unreferenced inode " << inode->getNodeId()
                << " after unmount: " << inode->getLogPath();
     return std::nullopt;
@@ -1147,7 +1215,8 @@ optional<InodeMap::UnloadedInode> InodeMap::updateOverlayForUnload(
     for (const auto& pair : treeContents.entries) {
       const auto& childName = pair.first;
       const auto& entry = pair.second;
-      if (data->unloadedInodes_.count(entry.getInodeNumber())) {
+      auto childNumber = entry.getInodeNumber();
+      if (getShard(childNumber, mapLock).unloadedInodes_.count(childNumber)) {
         XLOG(DBG5) << "remembering inode " << asTree->getNodeId() << " ("
                    << asTree->getLogPath() << ") because its child "
                    << childName << " was remembered";
@@ -1181,17 +1250,18 @@ bool InodeMap::startLoadingChildIfNotLoading(
   bool isFirstPromise;
   std::optional<InodeTraceEvent> startLoadEvent;
   {
-    auto data = data_.wlock();
+    SharedMapLock mapLock{mapLock_};
+    auto shard = getShard(childInode).lock();
     UnloadedInode* unloadedData{nullptr};
-    auto iter = data->unloadedInodes_.find(childInode);
-    if (iter == data->unloadedInodes_.end()) {
+    auto iter = shard->unloadedInodes_.find(childInode);
+    if (iter == shard->unloadedInodes_.end()) {
       InodeNumber parentNumber = parent->getNodeId();
       // T127459236: not all attributes of the UnloadedInode are set here. For
       // example, isUnlinked, hash, and numFsReferences are set to default
       // values
       auto newUnloadedData = UnloadedInode(parentNumber, name, mode);
-      auto ret =
-          data->unloadedInodes_.emplace(childInode, std::move(newUnloadedData));
+      auto ret = shard->unloadedInodes_.emplace(
+          childInode, std::move(newUnloadedData));
       XDCHECK(ret.second);
       unloadedData = &ret.first->second;
     } else {
@@ -1202,7 +1272,7 @@ bool InodeMap::startLoadingChildIfNotLoading(
 
     if (isFirstPromise) {
       startLoadEvent = std::make_optional<InodeTraceEvent>(
-          createInodeLoadStartEvent(childInode, *unloadedData, data));
+          createInodeLoadStartEvent(childInode, *unloadedData));
     }
 
     // Add the promise to the existing list for this inode.
@@ -1220,8 +1290,31 @@ bool InodeMap::startLoadingChildIfNotLoading(
 void InodeMap::inodeCreated(const InodePtr& inode) {
   XLOG(DBG4) << "created new inode " << inode->getNodeId() << ": "
              << inode->getLogPath();
-  auto data = data_.wlock();
-  insertLoadedInode(data, inode.get());
+  SharedMapLock mapLock{mapLock_};
+  insertLoadedInode(*getShard(inode->getNodeId()).lock(), inode.get());
+}
+
+void InodeMap::incUnloadedChildFsRefcount(
+    const TreeInode* parent,
+    PathComponentPiece name,
+    InodeNumber childInode,
+    mode_t mode,
+    const std::optional<ObjectId>& hash) {
+  SharedMapLock mapLock{mapLock_};
+  auto shard = getShard(childInode).lock();
+  XDCHECK_EQ(shard->loadedInodes_.count(childInode), 0u)
+      << "inode " << childInode << " referenced as unloaded while loaded";
+  auto [it, inserted] = shard->unloadedInodes_.try_emplace(
+      childInode,
+      parent->getNodeId(),
+      name,
+      /*isUnlinked=*/false,
+      mode,
+      hash,
+      /*fsRefcount=*/1);
+  if (!inserted) {
+    ++it->second.numFsReferences;
+  }
 }
 
 void InodeMap::recordPeriodicInodeUnload(size_t numInodesToUnload) {
@@ -1231,12 +1324,16 @@ void InodeMap::recordPeriodicInodeUnload(size_t numInodesToUnload) {
 
 InodeMap::InodeCounts InodeMap::getInodeCounts() const {
   InodeCounts counts;
-  auto data = data_.rlock();
-  XDCHECK_EQ(
-      data->numTreeInodes_ + data->numFileInodes_, data->loadedInodes_.size());
-  counts.treeCount = data->numTreeInodes_;
-  counts.fileCount = data->numFileInodes_;
-  counts.unloadedInodeCount = data->unloadedInodes_.size();
+  SharedMapLock mapLock{mapLock_};
+  for (const auto& syncShard : shards_) {
+    auto shard = syncShard.lock();
+    XDCHECK_EQ(
+        shard->numTreeInodes_ + shard->numFileInodes_,
+        shard->loadedInodes_.size());
+    counts.treeCount += shard->numTreeInodes_;
+    counts.fileCount += shard->numFileInodes_;
+    counts.unloadedInodeCount += shard->unloadedInodes_.size();
+  }
   counts.periodicUnlinkedUnloadInodeCount =
       numPeriodicallyUnloadedUnlinkedInodes_.load(std::memory_order_relaxed);
   counts.periodicLinkedUnloadInodeCount =
@@ -1246,16 +1343,17 @@ InodeMap::InodeCounts InodeMap::getInodeCounts() const {
 
 std::vector<InodeNumber> InodeMap::getReferencedInodes() const {
   std::vector<InodeNumber> inodes;
-  {
-    auto data = data_.rlock();
+  SharedMapLock mapLock{mapLock_};
+  for (const auto& syncShard : shards_) {
+    auto shard = syncShard.lock();
 
-    for (auto& kv : data->loadedInodes_) {
+    for (auto& kv : shard->loadedInodes_) {
       auto& loadedInode = kv.second;
 
       inodes.push_back(loadedInode->getNodeId());
     }
 
-    for (const auto& [ino, unloadedInode] : data->unloadedInodes_) {
+    for (const auto& [ino, unloadedInode] : shard->unloadedInodes_) {
       if (unloadedInode.numFsReferences > 0) {
         inodes.push_back(ino);
       }
@@ -7,12 +7,16 @@
 
 #pragma once
 
+#include <folly/SharedMutex.h>
 #include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
 #include <folly/futures/Future.h>
+#include <array>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <optional>
-#include <unordered_map>
+#include <shared_mutex>
 
 #include "eden/fs/inodes/EdenMount.h"
 #include "eden/fs/inodes/InodeNumber.h"
@@ -93,6 +97,15 @@ class InodeMapLock;
  *
  *   We currently always allocate a InodeNumber value for any new Inode object
  *   even if it is not needed yet by the FUSE APIs.
+ *
+ * Locking:
+ * - Both maps are split into shards by InodeNumber, each with its own lock, so
+ *   that the frequent operations on a single inode number (lookups of loaded
+ *   inodes, FUSE forgets, load completion, ...) on different inodes do not
+ *   contend. These hold mapLock_ in shared mode along with the shard lock.
+ * - Operations that span several inode numbers, such as walking up unloaded
+ *   parents in lookupInode(), unloading inodes, or shutting down, hold
+ *   mapLock_ exclusively instead, which gives them access to every shard.
  */
 class InodeMap {
  public:
@@ -389,6 +402,24 @@ class InodeMap {
 
   void inodeCreated(const InodePtr& inode);
 
+  /**
+   * Record a reference from the FS on childInode, the unloaded child name of
+   * parent, as a FUSE_READDIRPLUS reply returning its attributes without
+   * loading it does.
+   *
+   * The child is remembered in unloadedInodes_ if it was not already, so that
+   * it can be looked up by number later on.
+   *
+   * The TreeInode must be holding its contents lock when calling this method,
+   * which guarantees that the child does not get loaded meanwhile.
+   */
+  void incUnloadedChildFsRefcount(
+      const TreeInode* parent,
+      PathComponentPiece name,
+      InodeNumber childInode,
+      mode_t mode,
+      const std::optional<ObjectId>& hash);
+
   struct InodeCounts {
     size_t fileCount = 0;
     size_t treeCount = 0;
@@ -488,7 +519,7 @@ class InodeMap {
      *
      * (We could use folly::SharedPromise here instead, but it has extra
      * overhead that we don't really need.  It performs its own locking, but we
-     * are already protected by the data_ lock.)
+     * are already protected by the InodeMap locks.)
      */
     PromiseVector promises;
 
@@ -523,7 +554,7 @@ class InodeMap {
 
     InodePtr getPtr() const {
       // Calling InodePtr::newPtrLocked is safe because interacting with
-      // LoadedInode implies the data_ lock is held.
+      // LoadedInode implies the InodeMap locks covering it are held.
       return InodePtr::newPtrLocked(inode_);
     }
 
@@ -542,7 +573,10 @@ class InodeMap {
     InodeBase* inode_{nullptr};
   };
 
-  struct Members {
+  /**
+   * The inodes whose numbers fall in one shard, see getShard().
+   */
+  struct Shard {
     /**
      * The map of loaded inodes
      *
@@ -551,20 +585,12 @@ class InodeMap {
      * looked up the InodeMap will wrap the Inode in an InodePtr so that the
      * caller acquires a reference.
      */
-    std::unordered_map<InodeNumber, LoadedInode> loadedInodes_;
+    folly::F14NodeMap<InodeNumber, LoadedInode> loadedInodes_;
 
     /**
      * The map of currently unloaded inodes
      */
-    std::unordered_map<InodeNumber, UnloadedInode> unloadedInodes_;
-
-    /**
-     * Indicates if the FS mount point has been unmounted.
-     *
-     * If this is true then the FS refcount on all inodes should be treated
-     * as 0, and we can forget all inodes while shutting down.
-     */
-    bool isUnmounted_{false};
+    folly::F14NodeMap<InodeNumber, UnloadedInode> unloadedInodes_;
 
     /**
      * The number of loaded TreeInode objects
@@ -579,25 +605,47 @@ class InodeMap {
      * hold true to make sure our calculations are correct.
      */
     size_t numFileInodes_{0};
-
-    /**
-     * A promise to fulfill once shutdown() completes.
-     *
-     * This is only initialized when shutdown() is called, and will be
-     * std::nullopt until we are shutting down.
-     *
-     * In the future we could update this to just use an empty promise to
-     * indicate that we are not shutting down yet.  However, currently
-     * folly::Promise does not have a simple API to check if it is empty or not,
-     * so we have to wrap it in a std::optional.
-     */
-    std::optional<folly::Promise<folly::Unit>> shutdownPromise;
   };
 
+  using SyncShard = folly::Synchronized<Shard, std::mutex>;
+
+  /**
+   * mapLock_ held in shared mode, for operations on a single inode number
+   * that then lock its shard.
+   */
+  using SharedMapLock = std::shared_lock<folly::SharedMutex>;
+
+  /**
+   * mapLock_ held exclusively, which gives access to every shard without
+   * locking them.
+   */
+  using ExclusiveMapLock = std::unique_lock<folly::SharedMutex>;
+
+  static constexpr size_t kNumShards = 64;
+
+  SyncShard& getShard(InodeNumber number) {
+    return shards_[number.get() % kNumShards];
+  }
+  const SyncShard& getShard(InodeNumber number) const {
+    return shards_[number.get() % kNumShards];
+  }
+
+  /**
+   * Returns the shard of number, which the caller may access without locking
+   * it since it holds mapLock_ exclusively.
+   */
+  Shard& getShard(InodeNumber number, const ExclusiveMapLock& mapLock);
+
+  /**
+   * Returns the number of loaded, respectively unloaded, inodes.
+   */
+  size_t countLoaded(const ExclusiveMapLock& mapLock) const;
+  size_t countUnloaded(const ExclusiveMapLock& mapLock) const;
+
   InodeMap(InodeMap const&) = delete;
   InodeMap& operator=(InodeMap const&) = delete;
 
-  void shutdownComplete(folly::Synchronized<Members>::LockedPtr&& data);
+  void shutdownComplete(ExclusiveMapLock&& mapLock);
 
   void setupParentLookupPromise(
       folly::Promise<InodePtr>& promise,
@@ -618,18 +666,17 @@ class InodeMap {
    * Create and return inode load start event that will later be published to
    * tracebus for telemetry. Additionally sets the unloaded inode's
    * loadStartTime timestamp for when the start event began. This function
-   * should be called while holding the data_ write lock, and the event should
-   * be published after releasing the lock.
+   * should be called while holding the locks covering unloadedData, and the
+   * event should be published after releasing them.
    */
   InodeTraceEvent createInodeLoadStartEvent(
       InodeNumber number,
-      UnloadedInode& unloadedData,
-      const folly::Synchronized<Members>::WLockedPtr& data);
+      UnloadedInode& unloadedData);
 
   /**
    * Create and return an inode load failure event that will later be published
-   * to tracebus for telemetry. This method acquires a read lock on data_. It
-   * should never be called while already holding the lock. The function returns
+   * to tracebus for telemetry. This method acquires the InodeMap locks. It
+   * should never be called while already holding them. The function returns
    * std::nullopt if failing to find the inode number passed in.
    */
   std::optional<InodeTraceEvent> createInodeLoadFailEvent(InodeNumber number);
@@ -638,14 +685,14 @@ class InodeMap {
    * Extract the list of promises waiting on the specified inode number to be
    * loaded.
    *
-   * This method acquires the data_ lock internally.
-   * It should never be called while already holding the lock.
+   * This method acquires the InodeMap locks internally.
+   * It should never be called while already holding them.
    */
   PromiseVector extractPendingPromises(InodeNumber number);
 
   std::optional<RelativePath> getPathForInodeHelper(
       InodeNumber inodeNumber,
-      const folly::Synchronized<Members>::RLockedPtr& data);
+      const ExclusiveMapLock& mapLock);
 
   /**
    * Unload an inode
@@ -661,7 +708,7 @@ class InodeMap {
       TreeInode* parent,
       PathComponentPiece name,
       bool isUnlinked,
-      const folly::Synchronized<Members>::LockedPtr& lock);
+      const ExclusiveMapLock& mapLock);
 
   /**
    * Update the overlay data for an inode before unloading it.
@@ -675,18 +722,14 @@ class InodeMap {
       TreeInode* parent,
       PathComponentPiece name,
       bool isUnlinked,
-      const folly::Synchronized<Members>::LockedPtr& lock);
+      const ExclusiveMapLock& mapLock);
 
-  void insertLoadedInode(
-      const folly::Synchronized<Members>::LockedPtr& data,
-      InodeBase* inode);
+  static void insertLoadedInode(Shard& shard, InodeBase* inode);
 
   /**
    * Verify the InodeMap precondition and initialize the root_ member.
    */
-  void initializeRoot(
-      const folly::Synchronized<Members>::LockedPtr& data,
-      TreeInodePtr root);
+  void initializeRoot(const ExclusiveMapLock& mapLock, TreeInodePtr root);
 
   /**
    * Construct an UnloadedInode and insert it onto the unloadedInodes_ map.
@@ -699,7 +742,7 @@ class InodeMap {
    */
   template <class... Args>
   void initializeUnloadedInode(
-      const folly::Synchronized<Members>::LockedPtr& data,
+      const ExclusiveMapLock& mapLock,
       InodeNumber parentIno,
       InodeNumber ino,
       Args&&... args);
@@ -707,12 +750,14 @@ class InodeMap {
   /**
    * For unloaded inodes, this decrements the inode fs refcount.
    * For loaded inodes this returns the inode to decrement the FS refcount on
-   * because it is not safe to decrement the refcount while holding the data
-   * lock. For loaded inodes this does not decrement the fs refcount!
-   * WARNING: The returned inodePtr must be destroyed OUTSIDE of the data lock!
+   * because it is not safe to decrement the refcount while holding the
+   * InodeMap locks. For loaded inodes this does not decrement the fs refcount!
+   * WARNING: The returned inodePtr must be destroyed OUTSIDE of the locks!
+   *
+   * shard must be the shard of number, locked by the caller.
    */
-  InodePtr decFsRefcountHelper(
-      folly::Synchronized<Members>::LockedPtr& data,
+  static InodePtr decFsRefcountHelper(
+      Shard& shard,
       InodeNumber number,
       uint32_t count = 0,
       bool clearRefCount = false);
@@ -733,16 +778,44 @@ class InodeMap {
   TreeInodePtr root_;
 
   /**
-   * The locked data.
+   * Held in shared mode along with a shard lock by the operations on a single
+   * inode number, and exclusively by those that span several.
    *
-   * Note: be very careful to hold this lock only when necessary.  No other
-   * locks should be acquired when holding this lock.  In particular this means
-   * that we should never access any InodeBase objects while holding the lock,
-   * since we should not hold our lock while an InodeBase acquires its own
+   * Note: be very careful to hold these locks only when necessary.  No other
+   * locks should be acquired when holding them.  In particular this means
+   * that we should never access any InodeBase objects while holding the locks,
+   * since we should not hold our locks while an InodeBase acquires its own
    * internal lock.  (This makes it safe for InodeBase to perform operations on
    * the InodeMap while holding their own lock.)
    */
-  folly::Synchronized<Members> data_;
+  mutable folly::SharedMutex mapLock_;
+
+  std::array<SyncShard, kNumShards> shards_;
+
+  /**
+   * Indicates if the FS mount point has been unmounted.
+   *
+   * If this is true then the FS refcount on all inodes should be treated
+   * as 0, and we can forget all inodes while shutting down.
+   *
+   * Written with mapLock_ held exclusively, read with it held in any mode.
+   */
+  bool isUnmounted_{false};
+
+  /**
+   * A promise to fulfill once shutdown() completes.
+   *
+   * This is only initialized when shutdown() is called, and will be
+   * std::nullopt until we are shutting down.
+   *
+   * In the future we could update this to just use an empty promise to
+   * indicate that we are not shutting down yet.  However, currently
+   * folly::Promise does not have a simple API to check if it is empty or not,
+   * so we have to wrap it in a std::optional.
+   *
+   * Written with mapLock_ held exclusively, read with it held in any mode.
+   */
+  std::optional<folly::Promise<folly::Unit>> shutdownPromise_;
 
   /**
    * The number of inodes that we have unloaded with our periodic
@@ -772,16 +845,15 @@ class InodeMap {
  */
 class InodeMapLock {
  public:
-  explicit InodeMapLock(
-      folly::Synchronized<InodeMap::Members>::LockedPtr&& data)
-      : data_(std::move(data)) {}
+  explicit InodeMapLock(InodeMap::ExclusiveMapLock&& mapLock)
+      : mapLock_(std::move(mapLock)) {}
 
   void unlock() {
-    data_.unlock();
+    mapLock_.unlock();
   }
 
  private:
   friend class InodeMap;
-  folly::Synchronized<InodeMap::Members>::LockedPtr data_;
+  InodeMap::ExclusiveMapLock mapLock_;
 };
 } // namespace facebook::eden
@@ -9,6 +9,7 @@
 
 #include "eden/fs/inodes/OverlayFile.h"
 
+#include <fcntl.h>
 #include <folly/FileUtil.h>
 
 #include "eden/fs/inodes/Overlay.h"
@@ -76,6 +77,64 @@ OverlayFile::pwritev(const iovec* iov, int iovcnt, off_t offset) const {
   return ret;
 }
 
+#ifdef __linux__
+folly::Expected<ssize_t, int>
+OverlayFile::spliceTo(int pipeFd, size_t n, off_t offset) const {
+  std::shared_ptr<Overlay> overlay = overlay_.lock();
+  if (!overlay) {
+    return folly::makeUnexpected(EIO);
+  }
+  IORequest req{overlay.get()};
+
+  size_t total = 0;
+  while (total < n) {
+    loff_t off = offset + total;
+    auto ret =
+        splice(file_.fd(), &off, pipeFd, nullptr, n - total, SPLICE_F_MOVE);
+    if (ret == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return folly::makeUnexpected(errno);
+    }
+    if (ret == 0) {
+      // End of file.
+      break;
+    }
+    total += ret;
+  }
+  return total;
+}
+
+folly::Expected<ssize_t, int>
+OverlayFile::spliceFrom(int pipeFd, size_t n, off_t offset) const {
+  std::shared_ptr<Overlay> overlay = overlay_.lock();
+  if (!overlay) {
+    return folly::makeUnexpected(EIO);
+  }
+  IORequest req{overlay.get()};
+
+  size_t total = 0;
+  while (total < n) {
+    loff_t off = offset + total;
+    auto ret =
+        splice(pipeFd, nullptr, file_.fd(), &off, n - total, SPLICE_F_MOVE);
+    if (ret == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return folly::makeUnexpected(errno);
+    }
+    if (ret == 0) {
+      // The pipe held less than announced.
+      return folly::makeUnexpected(EIO);
+    }
+    total += ret;
+  }
+  return total;
+}
+#endif
+
 folly::Expected<int, int> OverlayFile::ftruncate(off_t length) const {
   std::shared_ptr<Overlay> overlay = overlay_.lock();
   if (!overlay) {
@@ -33,6 +33,21 @@ class OverlayFile {
   folly::Expected<off_t, int> lseek(off_t offset, int whence) const;
   folly::Expected<ssize_t, int>
   pwritev(const iovec* iov, int iovcnt, off_t offset) const;
+#ifdef __linux__
+  /**
+   * Move up to n bytes at offset from the file into the pipe pipeFd with
+   * splice(2), stopping short at the end of the file. The pipe must have room
+   * for n bytes.
+   */
+  folly::Expected<ssize_t, int> spliceTo(int pipeFd, size_t n, off_t offset)
+      const;
+  /**
+   * Move n bytes from the pipe pipeFd into the file at offset with splice(2).
+   * The pipe must hold at least n bytes.
+   */
+  folly::Expected<ssize_t, int> spliceFrom(int pipeFd, size_t n, off_t offset)
+      const;
+#endif
   folly::Expected<int, int> ftruncate(off_t length) const;
   folly::Expected<int, int> fsync() const;
   folly::Expected<int, int> fallocate(off_t offset, off_t length) const;
@@ -14,6 +14,7 @@
 #include <folly/logging/xlog.h>
 #include <folly/portability/OpenSSL.h>
 
+#include "eden/fs/digest/Blake3.h"
 #include "eden/fs/inodes/FileInode.h"
 #include "eden/fs/inodes/InodeError.h"
 #include "eden/fs/inodes/InodePtr.h"
@@ -36,6 +37,7 @@ void OverlayFileAccess::Entry::Info::invalidateMetadata() {
   ++version;
   size = std::nullopt;
   sha1 = std::nullopt;
+  blake3 = std::nullopt;
 }
 
 OverlayFileAccess::State::State(size_t cacheSize) : entries{cacheSize} {
@@ -119,20 +121,38 @@ off_t OverlayFileAccess::getFileSize(InodeNumber ino, InodeBase* inode) {
 
 Hash20 OverlayFileAccess::getSha1(FileInode& inode) {
   auto entry = getEntryForInode(inode.getNodeId());
-  uint64_t version;
   {
     auto info = entry->info.rlock();
     if (info->sha1.has_value()) {
       return *info->sha1;
     }
-    version = info->version;
   }
+  return computeHashes(inode, *entry).first;
+}
 
-  // SHA-1 is not known, so recompute it. Do so while the lock is not held to
-  // improve concurrency.
+Hash32 OverlayFileAccess::getBlake3(FileInode& inode) {
+  auto entry = getEntryForInode(inode.getNodeId());
+  {
+    auto info = entry->info.rlock();
+    if (info->blake3.has_value()) {
+      return *info->blake3;
+    }
+  }
+  return computeHashes(inode, *entry).second;
+}
+
+std::pair<Hash20, Hash32> OverlayFileAccess::computeHashes(
+    FileInode& inode,
+    Entry& entry) {
+  uint64_t version = entry.info.rlock()->version;
+
+  // The hashes are not known, so recompute them. Do so while the lock is not
+  // held to improve concurrency. Both are computed in a single pass, since
+  // reading the file is the expensive part for large files.
 
   SHA_CTX ctx;
   SHA1_Init(&ctx);
+  Blake3 blake3Hasher;
 
   off_t off = FileContentStore::kHeaderLength;
   while (true) {
@@ -142,31 +162,35 @@ Hash20 OverlayFileAccess::getSha1(FileInode& inode) {
     // like a good property of this function to avoid changing that
     // state.
     uint8_t buf[8192];
-    auto ret = entry->file.preadNoInt(&buf, sizeof(buf), off);
+    auto ret = entry.file.preadNoInt(&buf, sizeof(buf), off);
     if (ret.hasError()) {
       throw InodeError(
           ret.error(),
           inode.inodePtrFromThis(),
-          "pread failed during SHA-1 calculation");
+          "pread failed during hash calculation");
     }
     auto len = ret.value();
     if (len == 0) {
       break;
     }
     SHA1_Update(&ctx, buf, len);
+    blake3Hasher.update(buf, len);
     off += len;
   }
 
   static_assert(Hash20::RAW_SIZE == SHA_DIGEST_LENGTH);
   Hash20 sha1;
   SHA1_Final(sha1.mutableBytes().begin(), &ctx);
+  Hash32 blake3;
+  blake3Hasher.finalize(blake3.mutableBytes());
 
   // Update the cache if the version still matches.
-  auto info = entry->info.wlock();
+  auto info = entry.info.wlock();
   if (version == info->version) {
     info->sha1 = sha1;
+    info->blake3 = blake3;
   }
-  return sha1;
+  return {sha1, blake3};
 }
 
 std::string OverlayFileAccess::readAllContents(FileInode& inode) {
@@ -240,6 +264,47 @@ size_t OverlayFileAccess::write(
   return xfer.value();
 }
 
+#ifdef __linux__
+size_t OverlayFileAccess::spliceRead(
+    FileInode& inode,
+    int pipeFd,
+    size_t size,
+    off_t off) {
+  auto entry = getEntryForInode(inode.getNodeId());
+
+  auto res = entry->file.spliceTo(
+      pipeFd, size, off + FileContentStore::kHeaderLength);
+  if (res.hasError()) {
+    throw InodeError(
+        res.error(),
+        inode.inodePtrFromThis(),
+        "splice failed during overlay file read");
+  }
+  return res.value();
+}
+
+size_t OverlayFileAccess::spliceWrite(
+    FileInode& inode,
+    int pipeFd,
+    size_t size,
+    off_t off) {
+  auto entry = getEntryForInode(inode.getNodeId());
+
+  auto xfer = entry->file.spliceFrom(
+      pipeFd, size, off + FileContentStore::kHeaderLength);
+  if (xfer.hasError()) {
+    throw InodeError(
+        xfer.error(),
+        inode.inodePtrFromThis(),
+        "splice failed during file write");
+  }
+  auto info = entry->info.wlock();
+  info->invalidateMetadata();
+
+  return xfer.value();
+}
+#endif
+
 void OverlayFileAccess::truncate(FileInode& inode, off_t size) {
   auto entry = getEntryForInode(inode.getNodeId());
   auto result = entry->file.ftruncate(size + FileContentStore::kHeaderLength);
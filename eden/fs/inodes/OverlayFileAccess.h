@@ -70,6 +70,11 @@ class OverlayFileAccess {
    */
   Hash20 getSha1(FileInode& inode);
 
+  /**
+   * Returns the BLAKE3 hash of the file contents for the given inode number.
+   */
+  Hash32 getBlake3(FileInode& inode);
+
   /**
    * Reads the entire file's contents into memory and returns it.
    */
@@ -88,6 +93,21 @@ class OverlayFileAccess {
   size_t
   write(FileInode& inode, const struct iovec* iov, size_t iovcnt, off_t off);
 
+#ifdef __linux__
+  /**
+   * Same as read(), except that the data is moved into the pipe pipeFd with
+   * splice(2) rather than copied to a buffer. Returns the number of bytes
+   * moved into the pipe, which must have room for size bytes.
+   */
+  size_t spliceRead(FileInode& inode, int pipeFd, size_t size, off_t off);
+
+  /**
+   * Same as write(), except that the size bytes of data are moved from the
+   * pipe pipeFd with splice(2).
+   */
+  size_t spliceWrite(FileInode& inode, int pipeFd, size_t size, off_t off);
+#endif
+
   /**
    * Sets the size of the file in the overlay.
    */
@@ -108,7 +128,7 @@ class OverlayFileAccess {
   /*
    * OverlayFileAccess can be accessed concurrently. There are two types of data
    * to serialize under locks: the LRU cache (State::entries) and the per-inode,
-   * in-memory size and SHA-1 caches.
+   * in-memory size and hash caches.
    *
    * A lock around the size and hash is necessary because they can be read and
    * updated by concurrent getFileSize and getSha1 calls. (And write() and
@@ -139,6 +159,7 @@ class OverlayFileAccess {
 
       std::optional<size_t> size;
       std::optional<Hash20> sha1;
+      std::optional<Hash32> blake3;
       uint64_t version{0};
     };
 
@@ -162,6 +183,12 @@ class OverlayFileAccess {
    */
   EntryPtr getEntryForInode(InodeNumber);
 
+  /**
+   * Reads the file once to compute both its SHA-1 and BLAKE3 hashes, and
+   * caches them.
+   */
+  std::pair<Hash20, Hash32> computeHashes(FileInode& inode, Entry& entry);
+
   Overlay* overlay_ = nullptr;
   folly::Synchronized<State> state_;
 };
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <folly/CancellationToken.h>
 #include <folly/futures/Future.h>
 #include <atomic>
 #include <utility>
@@ -71,8 +72,22 @@ class FsObjectFetchContext : public ObjectFetchContext {
     }
   }
 
+  folly::CancellationToken getCancellationToken() const override {
+    return cancellationSource_.getToken();
+  }
+
+  /**
+   * Signal that the filesystem request no longer needs the objects it is
+   * fetching, as it was interrupted or timed out. Imports that only this
+   * request waits on are then dropped. Safe to call from any thread.
+   */
+  void cancel() {
+    cancellationSource_.requestCancellation();
+  }
+
  private:
   EdenTopStats edenTopStats_;
+  folly::CancellationSource cancellationSource_;
 
   /**
    * Normally, one requestData is created for only one fetch request,
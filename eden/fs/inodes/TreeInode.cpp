@@ -2357,6 +2357,108 @@ FuseDirList TreeInode::fuseReaddir(
 
 #endif // _WIN32
 
+#ifdef __linux__
+std::vector<std::pair<size_t, ImmediateFuture<struct stat>>>
+TreeInode::fuseReaddirplus(
+    FuseDirList& list,
+    off_t off,
+    const ObjectFetchContextPtr& context) {
+  XDCHECK(list.isPlus());
+
+  std::vector<std::pair<size_t, InodePtr>> loaded;
+  std::vector<std::pair<size_t, struct stat>> unloaded;
+
+  auto* inodeMap = getInodeMap();
+  auto& objectStore = getObjectStore();
+  // Attributes of unloaded children only come from what is already known
+  // locally. The others are left for the kernel to LOOKUP, so that listing a
+  // directory never loads its children nor fetches from the BackingStore.
+  auto statUnloaded =
+      [&](const DirEntry& entry) -> std::optional<struct stat> {
+    if (entry.isMaterialized()) {
+      return std::nullopt;
+    }
+    auto st = getMount()->initStatData();
+    if (entry.isDirectory()) {
+      auto tree =
+          objectStore.getTreeFromInMemoryCache(entry.getHash(), context);
+      if (!tree) {
+        return std::nullopt;
+      }
+      st.st_nlink = tree->size() + 2;
+    } else {
+      auto metadata = objectStore.getBlobMetadataFromInMemoryCache(
+          entry.getHash(), context);
+      if (!metadata) {
+        return std::nullopt;
+      }
+      st.st_nlink = 1; // Eden does not support hard links yet.
+      st.st_size = metadata->size;
+    }
+    auto ino = entry.getInodeNumber();
+    st.st_ino = ino.get();
+    auto* metadataTable = getMount()->getInodeMetadataTable();
+    metadataTable->populateIfNotSet(ino, [&] {
+      return getMount()->getInitialInodeMetadata(entry.getInitialMode());
+    });
+    metadataTable->getOrThrow(ino).applyToStat(st);
+    if (!entry.isDirectory()) {
+      FileInode::updateBlockCount(st);
+    }
+    return st;
+  };
+
+  size_t index = 0;
+  readdirImpl(
+      off,
+      context,
+      [&](StringPiece name, const DirEntry& entry, uint64_t offset) {
+        if (!list.addPlus(
+                name, entry.getInodeNumber().get(), entry.getDtype(), offset)) {
+          return false;
+        }
+        auto entryIndex = index++;
+        if (name == "." || name == "..") {
+          // The kernel ignores the attributes of these.
+          return true;
+        }
+
+        if (auto inode = entry.getInodePtr()) {
+          loaded.emplace_back(entryIndex, std::move(inode));
+        } else if (auto st = statUnloaded(entry)) {
+          // The contents lock is held, so the inode cannot be loaded until
+          // its reference is recorded.
+          inodeMap->incUnloadedChildFsRefcount(
+              this,
+              PathComponentPiece{name},
+              entry.getInodeNumber(),
+              entry.getInitialMode(),
+              entry.getOptionalHash());
+          unloaded.emplace_back(entryIndex, *st);
+        }
+        return true;
+      });
+
+  std::vector<std::pair<size_t, ImmediateFuture<struct stat>>> result;
+  result.reserve(loaded.size() + unloaded.size());
+
+  for (auto& [entryIndex, inode] : loaded) {
+    result.emplace_back(
+        entryIndex,
+        makeImmediateFutureWith([&] { return inode->stat(context); })
+            .thenValue([inode = std::move(inode)](struct stat st) {
+              inode->incFsRefcount();
+              return st;
+            }));
+  }
+  for (auto& [entryIndex, st] : unloaded) {
+    result.emplace_back(entryIndex, ImmediateFuture<struct stat>{st});
+  }
+
+  return result;
+}
+#endif // __linux__
+
 std::tuple<NfsDirList, bool> TreeInode::nfsReaddir(
     NfsDirList&& list,
     off_t off,
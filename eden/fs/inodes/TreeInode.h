@@ -196,6 +196,26 @@ class TreeInode final : public InodeBaseMetadata<DirContents> {
       off_t off,
       const ObjectFetchContextPtr& context);
 #endif
+#ifdef __linux__
+  /**
+   * Fill list, which must have been created for READDIRPLUS, with as many
+   * directory entries as possible starting from off.
+   *
+   * Returns, for each entry of list whose attributes are to be returned, its
+   * index in list along with a future of its attributes. Once a future
+   * completes successfully, the FS holds a reference on the entry's inode, to
+   * be released by a FUSE_FORGET: the caller must then reply with the entry.
+   *
+   * Children that are not loaded are not loaded for this, and nothing is
+   * fetched for them: only the unmaterialized ones whose blob metadata or
+   * tree is in memory get their attributes returned. The kernel looks up
+   * the other entries when it needs them.
+   */
+  std::vector<std::pair<size_t, ImmediateFuture<struct stat>>> fuseReaddirplus(
+      FuseDirList& list,
+      off_t off,
+      const ObjectFetchContextPtr& context);
+#endif // __linux__
   /**
    * Populate the list with as many directory entries as possible starting from
    * the inode start.
@@ -124,6 +124,41 @@ ImmediateFuture<Hash20> VirtualInode::getSHA1(
       variant_);
 }
 
+ImmediateFuture<Hash32> VirtualInode::getBlake3(
+    RelativePathPiece path,
+    ObjectStore* objectStore,
+    const ObjectFetchContextPtr& fetchContext) const {
+  switch (getDtype()) {
+    case dtype_t::Dir:
+      return makeImmediateFuture<Hash32>(PathError(EISDIR, path));
+    case dtype_t::Symlink:
+      return makeImmediateFuture<Hash32>(
+          PathError(EINVAL, path, "file is a symlink"));
+    case dtype_t::Regular:
+      break;
+    default:
+      return makeImmediateFuture<Hash32>(
+          PathError(EINVAL, path, "variant is of unhandled type"));
+  }
+
+  return std::visit(
+      [&](auto&& arg) -> ImmediateFuture<Hash32> {
+        using T = std::decay_t<decltype(arg)>;
+        if constexpr (std::is_same_v<T, InodePtr>) {
+          return arg.asFilePtr()->getBlake3(fetchContext);
+        } else if constexpr (
+            std::is_same_v<T, UnmaterializedUnloadedBlobDirEntry> ||
+            std::is_same_v<T, TreeEntry>) {
+          return objectStore->getBlobBlake3(arg.getHash(), fetchContext);
+        } else if constexpr (std::is_same_v<T, TreePtr>) {
+          return makeImmediateFuture<Hash32>(PathError(EISDIR, path));
+        } else {
+          static_assert(always_false_v<T>, "non-exhaustive visitor!");
+        }
+      },
+      variant_);
+}
+
 ImmediateFuture<std::optional<TreeEntryType>> VirtualInode::getTreeEntryType(
     RelativePathPiece path,
     const ObjectFetchContextPtr& fetchContext) const {
@@ -198,10 +233,15 @@ EntryAttributes getEntryAttributesForNonFile(
   std::optional<folly::Try<Hash20>> sha1;
   std::optional<folly::Try<uint64_t>> size;
   std::optional<folly::Try<std::optional<TreeEntryType>>> type;
+  std::optional<folly::Try<Hash32>> blake3;
   if (requestedAttributes.contains(ENTRY_ATTRIBUTE_SHA1)) {
     sha1 =
         folly::Try<Hash20>{PathError{errorCode, path, additionalErrorContext}};
   }
+  if (requestedAttributes.contains(ENTRY_ATTRIBUTE_BLAKE3)) {
+    blake3 =
+        folly::Try<Hash32>{PathError{errorCode, path, additionalErrorContext}};
+  }
   if (requestedAttributes.contains(ENTRY_ATTRIBUTE_SIZE)) {
     size = folly::Try<uint64_t>{
         PathError{errorCode, path, std::move(additionalErrorContext)}};
@@ -209,7 +249,8 @@ EntryAttributes getEntryAttributesForNonFile(
   if (requestedAttributes.contains(ENTRY_ATTRIBUTE_SOURCE_CONTROL_TYPE)) {
     type = folly::Try<std::optional<TreeEntryType>>{entryType};
   }
-  return EntryAttributes{std::move(sha1), std::move(size), std::move(type)};
+  return EntryAttributes{
+      std::move(sha1), std::move(size), std::move(type), std::move(blake3)};
 }
 
 ImmediateFuture<EntryAttributes> VirtualInode::getEntryAttributes(
@@ -262,17 +303,29 @@ ImmediateFuture<EntryAttributes> VirtualInode::getEntryAttributes(
           ENTRY_ATTRIBUTE_SIZE | ENTRY_ATTRIBUTE_SHA1)) {
     blobMetadataFuture = getBlobMetadata(path, objectStore, fetchContext);
   }
+  // The blake3 is not always part of the metadata, and computing it may
+  // require fetching the blob, so it is only looked up when requested.
+  auto blake3Future = ImmediateFuture<Hash32>{
+      PathError{EINVAL, path, "blake3 not requested"}};
+  if (requestedAttributes.contains(ENTRY_ATTRIBUTE_BLAKE3)) {
+    blake3Future = getBlake3(path, objectStore, fetchContext);
+  }
 
-  return collectAll(std::move(entryTypeFuture), std::move(blobMetadataFuture))
+  return collectAll(
+             std::move(entryTypeFuture),
+             std::move(blobMetadataFuture),
+             std::move(blake3Future))
       .thenValue(
           [requestedAttributes](
               std::tuple<
                   folly::Try<std::optional<TreeEntryType>>,
-                  folly::Try<BlobMetadata>> rawAttributeData) mutable
+                  folly::Try<BlobMetadata>,
+                  folly::Try<Hash32>> rawAttributeData) mutable
           -> EntryAttributes {
             std::optional<folly::Try<Hash20>> sha1;
             std::optional<folly::Try<uint64_t>> size;
             std::optional<folly::Try<std::optional<TreeEntryType>>> type;
+            std::optional<folly::Try<Hash32>> blake3;
             if (requestedAttributes.contains(
                     ENTRY_ATTRIBUTE_SOURCE_CONTROL_TYPE)) {
               type =
@@ -292,8 +345,15 @@ ImmediateFuture<EntryAttributes> VirtualInode::getEntryAttributes(
                   ? folly::Try<uint64_t>(blobMetadata.exception())
                   : folly::Try<uint64_t>(blobMetadata.value().size);
             }
+            if (requestedAttributes.contains(ENTRY_ATTRIBUTE_BLAKE3)) {
+              blake3 =
+                  std::move(std::get<folly::Try<Hash32>>(rawAttributeData));
+            }
             return EntryAttributes{
-                std::move(sha1), std::move(size), std::move(type)};
+                std::move(sha1),
+                std::move(size),
+                std::move(type),
+                std::move(blake3)};
           });
 }
 
@@ -125,14 +125,20 @@ class VirtualInode {
       ObjectStore* objectStore,
       const ObjectFetchContextPtr& fetchContext) const;
 
+  ImmediateFuture<Hash32> getBlake3(
+      RelativePathPiece path,
+      ObjectStore* objectStore,
+      const ObjectFetchContextPtr& fetchContext) const;
+
   /**
    * Get all the available attributes for a file entry in this tree. Available
    * attributes are currently:
    * - sha1
    * - size
    * - source control type
+   * - blake3
    *
-   * Note that we return error values for sha1s and sizes of directories and
+   * Note that we return error values for hashes and sizes of directories and
    * symlinks.
    */
   ImmediateFuture<EntryAttributes> getEntryAttributes(
@@ -174,7 +180,8 @@ class VirtualInode {
    * - sha1
    * - size
    * - source control type
-   * Note that we return error values for sha1s and sizes of directories and
+   * - blake3
+   * Note that we return error values for hashes and sizes of directories and
    * symlinks.
    */
   ImmediateFuture<
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include <fmt/format.h>
+
+#include "eden/common/utils/benchharness/Bench.h"
+#include "eden/fs/inodes/EdenMount.h"
+#include "eden/fs/inodes/InodeMap.h"
+#include "eden/fs/testharness/FakeTreeBuilder.h"
+#include "eden/fs/testharness/TestMount.h"
+
+/**
+ * Measures how InodeMap scales with the number of threads issuing the
+ * requests FUSE sends the most: lookups of loaded inodes by number, and
+ * forgets.
+ */
+
+namespace {
+using namespace facebook::eden;
+using namespace std::chrono_literals;
+
+constexpr size_t kNumDirs = 64;
+constexpr size_t kFilesPerDir = 64;
+
+struct BenchMount {
+  std::unique_ptr<TestMount> mount;
+  InodeMap* inodeMap{nullptr};
+  std::vector<InodePtr> inodes;
+};
+
+std::unique_ptr<BenchMount> makeBenchMount() {
+  FakeTreeBuilder builder;
+  for (size_t dir = 0; dir < kNumDirs; ++dir) {
+    for (size_t file = 0; file < kFilesPerDir; ++file) {
+      builder.setFile(fmt::format("dir{}/file{}", dir, file), "contents");
+    }
+  }
+
+  auto bench = std::make_unique<BenchMount>();
+  bench->mount = std::make_unique<TestMount>(builder);
+  bench->inodeMap = bench->mount->getEdenMount()->getInodeMap();
+  // Keep every inode loaded, so that lookups take the loaded inode path.
+  for (size_t dir = 0; dir < kNumDirs; ++dir) {
+    for (size_t file = 0; file < kFilesPerDir; ++file) {
+      bench->inodes.push_back(
+          bench->mount->getInode(fmt::format("dir{}/file{}", dir, file)));
+    }
+  }
+  return bench;
+}
+
+void lookup(benchmark::State& state) {
+  static std::unique_ptr<BenchMount> bench;
+  if (state.thread_index() == 0) {
+    bench = makeBenchMount();
+  }
+
+  // Other threads only see bench once they have entered the loop.
+  size_t i = state.thread_index() * 7919;
+  for (auto _ : state) {
+    const auto& inodes = bench->inodes;
+    auto ino = inodes[i++ % inodes.size()]->getNodeId();
+    benchmark::DoNotOptimize(bench->inodeMap->lookupInode(ino).get(0ms));
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    bench.reset();
+  }
+}
+
+void lookupAndForget(benchmark::State& state) {
+  static std::unique_ptr<BenchMount> bench;
+  if (state.thread_index() == 0) {
+    bench = makeBenchMount();
+  }
+
+  size_t i = state.thread_index() * 7919;
+  for (auto _ : state) {
+    const auto& inodes = bench->inodes;
+    auto ino = inodes[i++ % inodes.size()]->getNodeId();
+    // Reference the inode the way a FUSE lookup does, then drop it the way
+    // FUSE forget does.
+    bench->inodeMap->lookupInode(ino).get(0ms)->incFsRefcount();
+    bench->inodeMap->decFsRefcount(ino);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    bench.reset();
+  }
+}
+
+BENCHMARK(lookup)->Threads(1)->Threads(4)->Threads(16);
+
+BENCHMARK(lookupAndForget)->Threads(1)->Threads(4)->Threads(16);
+
+} // namespace
+
+EDEN_BENCHMARK_MAIN();
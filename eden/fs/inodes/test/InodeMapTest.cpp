@@ -10,6 +10,7 @@
 #include <folly/String.h>
 #include <folly/portability/GTest.h>
 #include <folly/test/TestUtils.h>
+#include <thread>
 
 #include "eden/fs/inodes/EdenMount.h"
 #include "eden/fs/inodes/FileInode.h"
@@ -558,6 +559,62 @@ TEST(InodeMap, unloadedFileMetadataIsForgotten) {
   EXPECT_FALSE(mount.hasMetadata(file1ino));
   EXPECT_FALSE(mount.hasMetadata(file2ino));
 }
+
+TEST(InodeMap, concurrentLookupsAndForgets) {
+  constexpr size_t kNumDirs = 8;
+  constexpr size_t kFilesPerDir = 32;
+  constexpr size_t kNumThreads = 8;
+  constexpr size_t kIterations = 200;
+
+  FakeTreeBuilder builder;
+  for (size_t dir = 0; dir < kNumDirs; ++dir) {
+    for (size_t file = 0; file < kFilesPerDir; ++file) {
+      builder.setFile(fmt::format("dir{}/file{}.txt", dir, file), "contents");
+    }
+  }
+  TestMount testMount{builder};
+  auto* inodeMap = testMount.getEdenMount()->getInodeMap();
+
+  std::vector<InodePtr> inodes;
+  for (size_t dir = 0; dir < kNumDirs; ++dir) {
+    inodes.push_back(testMount.getInode(fmt::format("dir{}", dir)));
+    for (size_t file = 0; file < kFilesPerDir; ++file) {
+      inodes.push_back(
+          testMount.getInode(fmt::format("dir{}/file{}.txt", dir, file)));
+    }
+  }
+  auto countsBefore = inodeMap->getInodeCounts();
+
+  // Every thread looks up all the inodes, and references then forgets them
+  // the way FUSE lookup and forget requests do.
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (size_t i = 0; i < kIterations; ++i) {
+        for (size_t j = 0; j < inodes.size(); ++j) {
+          auto ino = inodes[(j + t * 37) % inodes.size()]->getNodeId();
+          auto inode = inodeMap->lookupInode(ino).get(0ms);
+          EXPECT_EQ(ino, inode->getNodeId());
+          inode->incFsRefcount();
+          inode.reset();
+          inodeMap->decFsRefcount(ino);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto countsAfter = inodeMap->getInodeCounts();
+  EXPECT_EQ(countsBefore.treeCount, countsAfter.treeCount);
+  EXPECT_EQ(countsBefore.fileCount, countsAfter.fileCount);
+  EXPECT_EQ(countsBefore.unloadedInodeCount, countsAfter.unloadedInodeCount);
+  for (const auto& inode : inodes) {
+    EXPECT_EQ(0, inode->debugGetFsRefcount());
+    EXPECT_EQ(inode, inodeMap->lookupLoadedInode(inode->getNodeId()));
+  }
+}
 #endif
 
 struct InodePersistenceTreeTest : ::testing::Test {
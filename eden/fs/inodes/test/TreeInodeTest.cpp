@@ -22,6 +22,7 @@
 #include "eden/fs/nfs/NfsDirList.h"
 #include "eden/fs/prjfs/Enumerator.h"
 #include "eden/fs/store/ObjectFetchContext.h"
+#include "eden/fs/store/ObjectStore.h"
 #include "eden/fs/testharness/FakeBackingStore.h"
 #include "eden/fs/testharness/FakeTreeBuilder.h"
 #include "eden/fs/testharness/TestChecks.h"
@@ -213,6 +214,84 @@ TEST(TreeInode, fuseReaddirIgnoresWildOffsets) {
   EXPECT_EQ(0, result.size());
 }
 
+#ifdef __linux__
+TEST(TreeInode, fuseReaddirplusDoesNotLoadFiles) {
+  FakeTreeBuilder builder;
+  builder.setFiles({{"file", "contents"}});
+  TestMount mount{builder};
+
+  auto root = mount.getEdenMount()->getRootInode();
+  auto* inodeMap = mount.getEdenMount()->getInodeMap();
+  auto fileIno = root->getChildInodeNumber("file"_pc);
+
+  // Only files whose metadata is already cached get their attributes.
+  mount.getEdenMount()
+      ->getObjectStore()
+      ->getBlobMetadata(
+          ObjectId::sha1("contents"), ObjectFetchContext::getNullContext())
+      .get(kFutureTimeout);
+
+  FuseDirList list{4096, /*plus=*/true};
+  auto children =
+      root->fuseReaddirplus(list, 0, ObjectFetchContext::getNullContext());
+  auto entries = list.extract();
+  ASSERT_EQ(4, entries.size());
+  EXPECT_EQ("file", entries[2].name);
+
+  // . and .. are returned without attributes.
+  bool sawFile = false;
+  for (auto& [index, future] : children) {
+    ASSERT_GE(index, 2);
+    auto st = std::move(future).get(kFutureTimeout);
+    EXPECT_EQ(entries[index].inode, st.st_ino);
+    if (index == 2) {
+      sawFile = true;
+      EXPECT_TRUE(S_ISREG(st.st_mode));
+      EXPECT_EQ(8, st.st_size);
+    }
+  }
+  EXPECT_TRUE(sawFile);
+  EXPECT_FALSE(inodeMap->lookupLoadedInode(fileIno));
+  EXPECT_TRUE(inodeMap->isInodeRemembered(fileIno));
+
+  // The reference returned to the kernel carries over once the file is loaded.
+  auto file = mount.getFileInode("file");
+  EXPECT_EQ(fileIno, file->getNodeId());
+  EXPECT_EQ(1, file->getFsRefcount());
+}
+
+TEST(TreeInode, fuseReaddirplusDoesNotFetchChildren) {
+  FakeTreeBuilder builder;
+  builder.setFiles({{"file", "contents"}, {"dir/sub", "sub contents"}});
+  TestMount mount{builder};
+
+  auto root = mount.getEdenMount()->getRootInode();
+  auto* inodeMap = mount.getEdenMount()->getInodeMap();
+  auto fileIno = root->getChildInodeNumber("file"_pc);
+  auto dirIno = root->getChildInodeNumber("dir"_pc);
+  auto fileHash = ObjectId::sha1("contents");
+  auto dirHash = builder.getStoredTree("dir"_relpath)->get().getHash();
+  auto& backingStore = *mount.getBackingStore();
+  auto fileAccesses = backingStore.getAccessCount(fileHash);
+  auto dirAccesses = backingStore.getAccessCount(dirHash);
+
+  FuseDirList list{4096, /*plus=*/true};
+  auto children =
+      root->fuseReaddirplus(list, 0, ObjectFetchContext::getNullContext());
+
+  for (auto& child : children) {
+    auto st = std::move(child.second).get(kFutureTimeout);
+    // The file's metadata is not cached, so the kernel has to look it up.
+    EXPECT_NE(fileIno.get(), st.st_ino);
+  }
+  EXPECT_EQ(fileAccesses, backingStore.getAccessCount(fileHash));
+  EXPECT_EQ(dirAccesses, backingStore.getAccessCount(dirHash));
+  EXPECT_FALSE(inodeMap->lookupLoadedInode(fileIno));
+  EXPECT_FALSE(inodeMap->lookupLoadedInode(dirIno));
+  EXPECT_FALSE(inodeMap->isInodeRemembered(fileIno));
+}
+#endif // __linux__
+
 TEST(TreeInode, nfsReaddirEofIsCorrect) {
   FakeTreeBuilder builder;
   builder.setFiles({{"foo", ""}, {"bar", ""}, {"baz", ""}});
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <folly/io/Cursor.h>
 #include <folly/io/IOBuf.h>
 #include <string>
 #include "eden/fs/model/Hash.h"
@@ -53,6 +54,22 @@ class Blob {
     return size_;
   }
 
+  /**
+   * Returns up to length bytes of the contents starting at offset. The
+   * returned IOBuf shares this blob's buffers rather than copying them, and is
+   * empty if offset is past the end of the blob.
+   */
+  folly::IOBuf getRange(uint64_t offset, uint64_t length) const {
+    if (offset >= size_) {
+      return folly::IOBuf{};
+    }
+    folly::io::Cursor cursor{&contents_};
+    cursor.skip(offset);
+    folly::IOBuf result;
+    cursor.cloneAtMost(result, length);
+    return result;
+  }
+
   size_t getSizeBytes() const {
     return size_;
   }
@@ -8,20 +8,31 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 #include "eden/fs/model/Hash.h"
 
 namespace facebook::eden {
 
 /**
- * A small struct containing both the size and the SHA-1 hash of
- * a Blob's contents.
+ * A small struct containing the size and the SHA-1 hash of a Blob's contents,
+ * and their BLAKE3 hash when it is known.
+ *
+ * Metadata imported from a backing store, or stored by older versions of
+ * EdenFS, only carries the SHA-1.
  */
 class BlobMetadata {
  public:
   BlobMetadata(Hash20 contentsHash, uint64_t fileLength)
       : sha1(contentsHash), size(fileLength) {}
 
+  BlobMetadata(
+      Hash20 contentsHash,
+      std::optional<Hash32> contentsBlake3,
+      uint64_t fileLength)
+      : sha1(contentsHash), blake3(contentsBlake3), size(fileLength) {}
+
   Hash20 sha1;
+  std::optional<Hash32> blake3;
   uint64_t size;
 };
 
@@ -26,10 +26,12 @@ using namespace folly::io;
 EntryAttributes::EntryAttributes(
     std::optional<folly::Try<Hash20>> contentsHash,
     std::optional<folly::Try<uint64_t>> fileLength,
-    std::optional<folly::Try<std::optional<TreeEntryType>>> fileType)
+    std::optional<folly::Try<std::optional<TreeEntryType>>> fileType,
+    std::optional<folly::Try<Hash32>> contentsBlake3)
     : sha1(std::move(contentsHash)),
       size(std::move(fileLength)),
-      type(std::move(fileType)) {}
+      type(std::move(fileType)),
+      blake3(std::move(contentsBlake3)) {}
 
 template <typename T>
 bool checkValueEqual(
@@ -47,7 +49,8 @@ bool checkValueEqual(
 bool operator==(const EntryAttributes& lhs, const EntryAttributes& rhs) {
   return checkValueEqual(lhs.sha1, rhs.sha1) &&
       checkValueEqual(lhs.size, rhs.size) &&
-      checkValueEqual(lhs.type, rhs.type);
+      checkValueEqual(lhs.type, rhs.type) &&
+      checkValueEqual(lhs.blake3, rhs.blake3);
 }
 
 bool operator!=(const EntryAttributes& lhs, const EntryAttributes& rhs) {
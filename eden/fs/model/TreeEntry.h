@@ -39,7 +39,8 @@ class EntryAttributes {
   EntryAttributes(
       std::optional<folly::Try<Hash20>> contentsHash,
       std::optional<folly::Try<uint64_t>> fileLength,
-      std::optional<folly::Try<std::optional<TreeEntryType>>> fileType);
+      std::optional<folly::Try<std::optional<TreeEntryType>>> fileType,
+      std::optional<folly::Try<Hash32>> contentsBlake3 = std::nullopt);
 
   // for each requested attribute the member here should be set. If the
   // attribute was not requested, then the member will be nullopt.
@@ -51,6 +52,7 @@ class EntryAttributes {
   std::optional<folly::Try<Hash20>> sha1;
   std::optional<folly::Try<uint64_t>> size;
   std::optional<folly::Try<std::optional<TreeEntryType>>> type;
+  std::optional<folly::Try<Hash32>> blake3;
 };
 
 /**
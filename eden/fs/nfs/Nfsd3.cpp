@@ -9,6 +9,7 @@
 
 #include <memory>
 
+#include <folly/CancellationToken.h>
 #include <folly/Utility.h>
 #include <folly/executors/SerialExecutor.h>
 #include <folly/futures/Future.h>
@@ -250,7 +251,9 @@ nfsstat3 exceptionToNfsError(const folly::exception_wrapper& ex) {
         return nfsstat3::NFS3ERR_SERVERFAULT;
     }
     return nfsstat3::NFS3ERR_SERVERFAULT;
-  } else if (ex.get_exception<folly::FutureTimeout>()) {
+  } else if (
+      ex.get_exception<folly::FutureTimeout>() ||
+      ex.get_exception<folly::OperationCancelled>()) {
     return nfsstat3::NFS3ERR_JUKEBOX;
   } else {
     return nfsstat3::NFS3ERR_SERVERFAULT;
@@ -167,8 +167,13 @@ void EdenMain::registerStandardBackingStores() {
       [](const CreateParams& params) -> std::shared_ptr<BackingStore> {
 #ifdef EDEN_HAVE_GIT
         const auto repoPath = realpath(params.name);
+        auto edenConfig = params.serverState->getEdenConfig();
         return std::make_shared<LocalStoreCachedBackingStore>(
-            std::make_shared<GitBackingStore>(repoPath),
+            std::make_shared<GitBackingStore>(
+                repoPath,
+                &params.serverState->getFaultInjector(),
+                edenConfig->gitImportThreads.getValue(),
+                edenConfig->gitImportBatchSize.getValue()),
             params.localStore,
             params.sharedStats.copy());
 #else // EDEN_HAVE_GIT
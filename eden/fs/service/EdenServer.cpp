@@ -11,6 +11,8 @@
 #include <chrono>
 
 #include <sys/stat.h>
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <fstream>
 #include <functional>
@@ -58,7 +60,10 @@
 #include "eden/fs/service/gen-cpp2/eden_types.h"
 #include "eden/fs/store/BackingStoreLogger.h"
 #include "eden/fs/store/BlobCache.h"
+#include "eden/fs/store/BlobHasher.h"
+#include "eden/fs/store/DiskBlobCache.h"
 #include "eden/fs/store/EmptyBackingStore.h"
+#include "eden/fs/store/GroupCommitLocalStore.h"
 #include "eden/fs/store/LocalStore.h"
 #include "eden/fs/store/LocalStoreCachedBackingStore.h"
 #include "eden/fs/store/MemoryLocalStore.h"
@@ -194,6 +199,7 @@ std::shared_ptr<Notifier> getPlatformNotifier(
 
 constexpr StringPiece kRocksDBPath{"storage/rocks-db"};
 constexpr StringPiece kSqlitePath{"storage/sqlite.db"};
+constexpr StringPiece kDiskBlobCachePath{"storage/blob-cache"};
 constexpr StringPiece kHgStorePrefix{"store.hg"};
 #ifndef _WIN32
 constexpr StringPiece kFuseRequestPrefix{"fuse"};
@@ -249,6 +255,21 @@ std::string getCounterNameForFuseRequests(
 #endif
 
 #ifdef __linux__
+constexpr std::array<StringPiece, 3> kFuseDeviceQueueStats{
+    "depth",
+    "requests",
+    "latency_us"};
+
+std::string getCounterNameForFuseDeviceQueue(
+    const EdenMount* mount,
+    size_t queue,
+    StringPiece stat) {
+  auto mountName = basename(mount->getPath().view());
+  // prefix . mount . queue . stat
+  return folly::to<std::string>(
+      kFuseRequestPrefix, ".", mountName, ".queue", queue, ".", stat);
+}
+
 // **not safe to call this function from a fuse thread**
 // this gets the kernels view of the number of pending requests, to do this, it
 // stats the fuse mount root in the filesystem which could call into the FUSE
@@ -339,6 +360,22 @@ class EdenServer::ThriftServerEventHandler
 
 static constexpr folly::StringPiece kBlobCacheMemory{"blob_cache.memory"};
 
+/**
+ * The effective import batch size of each type of object, the largest of
+ * every repository's.
+ */
+static constexpr std::array<
+    std::pair<folly::StringPiece, HgBackingStore::HgImportObject>,
+    3>
+    kHgImportBatchSizeCounters{{
+        {"store.hg.import_batch_size.blob",
+         HgBackingStore::HgImportObject::BLOB},
+        {"store.hg.import_batch_size.tree",
+         HgBackingStore::HgImportObject::TREE},
+        {"store.hg.import_batch_size.blob_metadata",
+         HgBackingStore::HgImportObject::BLOBMETA},
+    }};
+
 EdenServer::EdenServer(
     std::vector<std::string> originalCommandLine,
     UserInfo userInfo,
@@ -393,6 +430,18 @@ EdenServer::EdenServer(
 
   registerInodePopulationReportsCallback();
 
+  for (const auto& [counterName, object] : kHgImportBatchSizeCounters) {
+    counters->registerCallback(counterName, [this, object = object] {
+      auto batchSizes = this->collectHgQueuedBackingStoreCounters(
+          [object](const HgQueuedBackingStore& store) {
+            return store.getImportBatchSize(object);
+          });
+      return batchSizes.empty()
+          ? 0
+          : *std::max_element(batchSizes.begin(), batchSizes.end());
+    });
+  }
+
   for (auto stage : RequestMetricsScope::requestStages) {
     for (auto metric : RequestMetricsScope::requestMetrics) {
       for (auto object : HgBackingStore::hgImportObjects) {
@@ -432,6 +481,10 @@ EdenServer::~EdenServer() {
 
   unregisterInodePopulationReportsCallback();
 
+  for (const auto& counter : kHgImportBatchSizeCounters) {
+    counters->unregisterCallback(counter.first);
+  }
+
   for (auto stage : RequestMetricsScope::requestStages) {
     for (auto metric : RequestMetricsScope::requestMetrics) {
       for (auto object : HgBackingStore::hgImportObjects) {
@@ -1026,7 +1079,9 @@ bool EdenServer::createStorageEngine(cpptoml::table& config) {
     ensureDirectoryExists(parentDir);
     XLOG(DBG2) << "Creating local SQLite store " << path << "...";
     folly::stop_watch<std::chrono::milliseconds> watch;
-    localStore_ = make_shared<SqliteLocalStore>(path);
+    localStore_ = make_shared<SqliteLocalStore>(
+        path,
+        serverState_->getEdenConfig()->localStoreSqliteReaders.getValue());
     XLOG(DBG2) << "Opened SQLite store in " << watch.elapsed().count() / 1000.0
                << " seconds.";
   } else if (storageEngine == "rocksdb") {
@@ -1037,7 +1092,9 @@ bool EdenServer::createStorageEngine(cpptoml::table& config) {
     localStore_ = make_shared<RocksDbLocalStore>(
         rocksPath,
         serverState_->getStructuredLogger(),
-        &serverState_->getFaultInjector());
+        &serverState_->getFaultInjector(),
+        RocksDBOpenMode::ReadWrite,
+        serverState_->getEdenConfig()->rocksDbProfile.getValue());
     localStore_->enableBlobCaching.store(
         serverState_->getEdenConfig()->enableBlobCaching.getValue(),
         std::memory_order_relaxed);
@@ -1048,6 +1105,38 @@ bool EdenServer::createStorageEngine(cpptoml::table& config) {
         folly::to<string>("invalid storage engine: ", storageEngine));
   }
 
+  auto edenConfig = serverState_->getEdenConfig();
+  if (edenConfig->localStoreGroupCommit.getValue()) {
+    XLOG(DBG2) << "Enabling group commit of local store writes.";
+    localStore_ = make_shared<GroupCommitLocalStore>(
+        std::move(localStore_), *edenConfig, getStats().copy());
+  }
+
+  if (storageEngine != "memory" && edenConfig->enableDiskBlobCache.getValue()) {
+    XLOG(DBG2) << "Creating on-disk blob cache...";
+    folly::stop_watch<std::chrono::milliseconds> watch;
+    const auto path =
+        edenDir_.getPath() + RelativePathPiece{kDiskBlobCachePath};
+    ensureDirectoryExists(path);
+    // The cache itself bounds the bytes queued on the writer, dropping the
+    // writes that would exceed blobcache:disk-cache-max-pending-write-bytes.
+    diskBlobCache_ = DiskBlobCache::create(
+        path,
+        *edenConfig,
+        std::make_shared<UnboundedQueueExecutor>(1, "DiskBlobCacheWriter"));
+    // Large blobs now live in the disk cache; keep them out of the local
+    // store to avoid compacting them over and over.
+    localStore_->blobCachingSizeLimit.store(
+        diskBlobCache_->getMinimumBlobSize(), std::memory_order_relaxed);
+    XLOG(DBG2) << "Created on-disk blob cache in "
+               << watch.elapsed().count() / 1000.0 << " seconds.";
+  }
+
+  blobHasher_ = std::make_shared<BlobHasher>(
+      std::make_shared<UnboundedQueueExecutor>(
+          edenConfig->blobHashingThreads.getValue(), "BlobHashing"),
+      edenConfig->blobHashingParallelThreshold.getValue());
+
   return configUpdated;
 }
 
@@ -1364,6 +1453,23 @@ void EdenServer::registerStats(std::shared_ptr<EdenMount> edenMount) {
           }
         });
   }
+  if (auto* channel = edenMount->getFuseChannel()) {
+    for (size_t queue = 0; queue < channel->getNumDeviceQueues(); ++queue) {
+      for (auto stat : kFuseDeviceQueueStats) {
+        counters->registerCallback(
+            getCounterNameForFuseDeviceQueue(edenMount.get(), queue, stat),
+            [edenMount, channel, queue, stat]() -> int64_t {
+              auto stats = channel->getDeviceQueueStats(queue);
+              if (stat == "depth") {
+                return stats.depth;
+              } else if (stat == "requests") {
+                return stats.requests;
+              }
+              return stats.totalLatency.count();
+            });
+      }
+    }
+  }
 #endif // __linux__
 }
 
@@ -1402,6 +1508,14 @@ void EdenServer::unregisterStats(EdenMount* edenMount) {
         RequestMetricsScope::RequestMetric::COUNT,
         edenMount));
   }
+  if (auto* channel = edenMount->getFuseChannel()) {
+    for (size_t queue = 0; queue < channel->getNumDeviceQueues(); ++queue) {
+      for (auto stat : kFuseDeviceQueueStats) {
+        counters->unregisterCallback(
+            getCounterNameForFuseDeviceQueue(edenMount, queue, stat));
+      }
+    }
+  }
 #endif // __linux__
 }
 
@@ -1510,7 +1624,9 @@ folly::Future<std::shared_ptr<EdenMount>> EdenServer::mount(
       serverState_->getProcessNameCache(),
       serverState_->getStructuredLogger(),
       serverState_->getReloadableConfig()->getEdenConfig(),
-      initialConfig->getCaseSensitive());
+      initialConfig->getCaseSensitive(),
+      diskBlobCache_,
+      blobHasher_);
   auto journal = std::make_unique<Journal>(getStats().copy());
 
   // Create the EdenMount object and insert the mount into the mountPoints_ map.
@@ -65,6 +65,8 @@ class BackingStore;
 class HgQueuedBackingStore;
 class IHiveLogger;
 class BlobCache;
+class BlobHasher;
+class DiskBlobCache;
 class TreeCache;
 class Dirstate;
 class EdenServiceHandler;
@@ -663,6 +665,15 @@ class EdenServer : private TakeoverHandler {
   BackingStoreFactory* const backingStoreFactory_;
 
   std::shared_ptr<LocalStore> localStore_;
+  /**
+   * On-disk cache of large blobs, or nullptr when blobcache:enable-disk-cache
+   * is off.
+   */
+  std::shared_ptr<DiskBlobCache> diskBlobCache_;
+  /**
+   * Hashes the blobs fetched by every mount, large ones on a dedicated pool.
+   */
+  std::shared_ptr<BlobHasher> blobHasher_;
   folly::Synchronized<BackingStoreMap> backingStores_;
   std::shared_ptr<ReloadableConfig> config_;
 
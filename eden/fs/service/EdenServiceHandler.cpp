@@ -2097,6 +2097,15 @@ FileAttributeDataOrErrorV2 serializeEntryAttributes(
       }
       fileData.sourceControlType() = std::move(type);
     }
+
+    if (requestedAttributes.contains(ENTRY_ATTRIBUTE_BLAKE3)) {
+      Blake3OrError blake3;
+      if (!fillErrorRef<Blake3OrError, Hash32>(
+              blake3, attributes->blake3, entryPath, "blake3")) {
+        blake3.blake3_ref() = thriftHash32(attributes->blake3.value().value());
+      }
+      fileData.blake3() = std::move(blake3);
+    }
     fileResult.fileAttributeData_ref() = fileData;
   }
   return fileResult;
@@ -2233,8 +2242,14 @@ EdenServiceHandler::semifuture_getAttributesFromFiles(
   // TODO(kmancini): When Buck2 migrates to our
   // explicit type information, we can get shape up
   // this API better.
+  // The blake3 may require fetching the blob, so it is only computed when
+  // explicitly requested.
+  auto fetchedAttributes = kAllEntryAttributes;
+  if (reqBitmask.contains(ENTRY_ATTRIBUTE_BLAKE3)) {
+    fetchedAttributes = fetchedAttributes | ENTRY_ATTRIBUTE_BLAKE3;
+  }
   auto entryAttributesFuture = getEntryAttributes(
-      mountPath, paths, kAllEntryAttributes, *params->sync(), fetchContext);
+      mountPath, paths, fetchedAttributes, *params->sync(), fetchContext);
 
   return wrapImmediateFuture(
              std::move(helper),
@@ -2288,6 +2303,20 @@ EdenServiceHandler::semifuture_getAttributesFromFiles(
                        } else if (attributes.type.value().hasException()) {
                          file_res.error_ref() =
                              newEdenError(attributes.type.value().exception());
+                       } else if (
+                           reqBitmask.contains(ENTRY_ATTRIBUTE_BLAKE3) &&
+                           (!attributes.blake3.has_value() ||
+                            attributes.blake3.value().hasException())) {
+                         file_res.error_ref() =
+                             attributes.blake3.has_value()
+                             ? newEdenError(
+                                   attributes.blake3.value().exception())
+                             : newEdenError(
+                                   EdenErrorType::GENERIC_ERROR,
+                                   fmt::format(
+                                       "{}: blake3 requested, but no blake3 "
+                                       "available",
+                                       paths.at(index)));
                        } else {
                          // Only fill in requested fields
                          if (reqBitmask.contains(ENTRY_ATTRIBUTE_SHA1)) {
@@ -2303,6 +2332,10 @@ EdenServiceHandler::semifuture_getAttributesFromFiles(
                            file_data.type_ref() = entryTypeToThriftType(
                                attributes.type.value().value());
                          }
+                         if (reqBitmask.contains(ENTRY_ATTRIBUTE_BLAKE3)) {
+                           file_data.blake3_ref() =
+                               thriftHash32(attributes.blake3.value().value());
+                         }
                          file_res.data_ref() = file_data;
                        }
                      }
@@ -2778,15 +2811,41 @@ folly::SemiFuture<folly::Unit> EdenServiceHandler::semifuture_prefetchFiles(
   auto [mount, rootInode] = server_->getMountAndRootInode(
       absolutePathFromThrift(*params->mountPoint()));
 
+  // Background prefetches outlive the Thrift request, so they are only
+  // cancelled when the client goes away if they are not backgrounded.
+  folly::CancellationToken cancellation;
+  if (!isBackground) {
+    cancellation =
+        getRequestContext()->getConnectionContext()->getCancellationToken();
+  }
+
   auto globFut =
       std::move(backgroundFuture)
           .thenValue([mount = std::move(mount),
                       serverState = server_->getServerState(),
                       globs = std::move(*params->globs()),
                       globber = std::move(globber),
-                      context = helper->getPrefetchFetchContext().copy()](
+                      context = helper->getPrefetchFetchContext().copy(),
+                      cancellation = std::move(cancellation)](
                          auto&&) mutable {
-            return globber.glob(mount, serverState, std::move(globs), context);
+            // Fetching the trees level by level first lets the backing store
+            // import them in large batches, rather than one at a time as the
+            // glob walks down the directories.
+            ImmediateFuture<folly::Unit> treesFuture{std::in_place};
+            if (serverState->getEdenConfig()
+                    ->prefetchFilesPrefetchTrees.getValue()) {
+              treesFuture = globber.prefetchTrees(
+                  mount, serverState, globs, context, std::move(cancellation));
+            }
+            return std::move(treesFuture)
+                .thenValue([mount = std::move(mount),
+                            serverState = std::move(serverState),
+                            globs = std::move(globs),
+                            globber = std::move(globber),
+                            context = context.copy()](auto&&) mutable {
+                  return globber.glob(
+                      mount, serverState, std::move(globs), context);
+                });
           })
           .ensure([rootInode = std::move(rootInode)] {})
           .thenValue([](std::unique_ptr<Glob>) { return folly::unit; });
@@ -3598,15 +3657,12 @@ void EdenServiceHandler::getAccessCounts(
     auto& mountStr = mount->getPath().value();
     auto& pal = mount->getProcessAccessLog();
 
-    auto& pidFetches = mount->getObjectStore()->getPidFetches();
-
     MountAccesses& ma = result.accessesByMount_ref()[mountStr];
     for (auto& [pid, accessCounts] : pal.getAccessCounts(seconds)) {
       ma.accessCountsByPid_ref()[pid] = accessCounts;
     }
 
-    auto pidFetchesLockedPtr = pidFetches.rlock();
-    for (auto& [pid, fetchCount] : *pidFetchesLockedPtr) {
+    for (auto& [pid, fetchCount] : mount->getObjectStore()->getPidFetches()) {
       ma.fetchCountsByPid_ref()[pid] = fetchCount;
     }
   }
@@ -7,6 +7,7 @@
 
 #include "eden/fs/service/ThriftGlobImpl.h"
 
+#include <folly/String.h>
 #include <folly/futures/Future.h>
 #include <folly/logging/LogLevel.h>
 #include <folly/logging/xlog.h>
@@ -15,8 +16,10 @@
 #include "eden/fs/inodes/ServerState.h"
 #include "eden/fs/inodes/TreeInode.h"
 #include "eden/fs/model/RootId.h"
+#include "eden/fs/model/Tree.h"
 #include "eden/fs/service/gen-cpp2/eden_types.h"
 #include "eden/fs/store/ObjectFetchContext.h"
+#include "eden/fs/store/ObjectStore.h"
 #include "eden/fs/store/PathLoader.h"
 #include "eden/fs/utils/EdenError.h"
 #include "eden/fs/utils/UnboundedQueueExecutor.h"
@@ -244,6 +247,160 @@ ImmediateFuture<std::unique_ptr<Glob>> ThriftGlobImpl::glob(
   return prefetchFuture;
 }
 
+namespace {
+/**
+ * Whether the component of a glob pattern may match several names.
+ */
+bool hasSpecials(folly::StringPiece component) {
+  return component.find_first_of("*?[\\") != folly::StringPiece::npos;
+}
+
+/**
+ * The directory components of each glob, and how deep under the search root
+ * the globs can reach.
+ */
+struct GlobDirectories {
+  std::vector<std::vector<std::string>> globs;
+  size_t depth{0};
+};
+
+GlobDirectories getGlobDirectories(const std::vector<std::string>& globs) {
+  GlobDirectories result;
+  for (const auto& glob : globs) {
+    std::vector<std::string> components;
+    folly::split('/', glob, components, /*ignoreEmpty=*/true);
+    // The last component names the entries of the deepest directory, unless
+    // it is a "**", which matches entries at any depth below it.
+    if (!components.empty() &&
+        !folly::StringPiece{components.back()}.startsWith("**")) {
+      components.pop_back();
+    }
+    for (const auto& component : components) {
+      if (folly::StringPiece{component}.startsWith("**")) {
+        result.depth = ObjectStore::kUnlimitedDepth;
+      }
+    }
+    if (result.depth != ObjectStore::kUnlimitedDepth) {
+      result.depth = std::max(result.depth, components.size());
+    }
+    result.globs.push_back(std::move(components));
+  }
+  return result;
+}
+
+/**
+ * Whether one of the globs can descend into path. Components with wildcards
+ * are assumed to match any name.
+ */
+bool globsCanDescendInto(
+    const GlobDirectories& directories,
+    RelativePathPiece path,
+    CaseSensitivity caseSensitive) {
+  for (const auto& glob : directories.globs) {
+    size_t index = 0;
+    bool matches = true;
+    for (auto component : path.components()) {
+      if (index < glob.size() &&
+          folly::StringPiece{glob[index]}.startsWith("**")) {
+        return true;
+      }
+      if (index >= glob.size()) {
+        matches = false;
+        break;
+      }
+      const auto& pattern = glob[index++];
+      if (hasSpecials(pattern)) {
+        continue;
+      }
+      bool equal = caseSensitive == CaseSensitivity::Sensitive
+          ? folly::StringPiece{pattern} == component.view()
+          : folly::StringPiece{pattern}.equals(
+                component.view(), folly::AsciiCaseInsensitive{});
+      if (!equal) {
+        matches = false;
+        break;
+      }
+    }
+    if (matches) {
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace
+
+ImmediateFuture<folly::Unit> ThriftGlobImpl::prefetchTrees(
+    std::shared_ptr<EdenMount> edenMount,
+    std::shared_ptr<ServerState> serverState,
+    const std::vector<std::string>& globs,
+    const ObjectFetchContextPtr& fetchContext,
+    folly::CancellationToken cancellation) {
+  auto directories =
+      std::make_shared<GlobDirectories>(getGlobDirectories(globs));
+  auto caseSensitive =
+      serverState->getEdenConfig()->globUseMountCaseSensitivity.getValue()
+      ? edenMount->getCheckoutConfig()->getCaseSensitive()
+      : CaseSensitivity::Sensitive;
+
+  RelativePath searchRoot;
+  if (!(searchRootUser_.empty() || searchRootUser_ == ".")) {
+    searchRoot = RelativePath{searchRootUser_};
+  }
+
+  std::vector<RootId> rootIds;
+  if (rootHashes_.empty()) {
+    rootIds.push_back(edenMount->getCheckedOutRootId());
+  } else {
+    for (const auto& rootHash : rootHashes_) {
+      rootIds.push_back(edenMount->getObjectStore()->parseRootId(rootHash));
+    }
+  }
+
+  std::vector<ImmediateFuture<folly::Unit>> futures;
+  futures.reserve(rootIds.size());
+  for (const auto& rootId : rootIds) {
+    auto objectStore = edenMount->getObjectStore();
+    futures.push_back(
+        objectStore->getRootTree(rootId, fetchContext)
+            .thenValue([objectStore,
+                        fetchContext = fetchContext.copy(),
+                        searchRoot](std::shared_ptr<const Tree>&& rootTree) {
+              return resolveTree(
+                  *objectStore, fetchContext, std::move(rootTree), searchRoot);
+            })
+            .thenValue([objectStore,
+                        directories,
+                        caseSensitive,
+                        fetchContext = fetchContext.copy(),
+                        cancellation](std::shared_ptr<const Tree>&& tree) {
+              return objectStore->prefetchTrees(
+                  tree->getHash(),
+                  directories->depth,
+                  [directories, caseSensitive](
+                      RelativePathPiece path, const TreeEntry&) {
+                    return globsCanDescendInto(
+                        *directories, path, caseSensitive);
+                  },
+                  fetchContext,
+                  cancellation);
+            }));
+  }
+
+  return collectAll(std::move(futures))
+      .thenValue([](std::vector<folly::Try<folly::Unit>>&& tries) {
+        for (auto& try_ : tries) {
+          if (try_.hasException<folly::OperationCancelled>()) {
+            try_.throwUnlessValue();
+          }
+          if (try_.hasException()) {
+            XLOG(DBG3) << "failed to prefetch trees for glob: "
+                       << try_.exception().what();
+          }
+        }
+        return folly::unit;
+      });
+}
+
 std::string ThriftGlobImpl::logString() {
   return fmt::format(
       "ThriftGlobImpl {{ includeDotFiles={}, prefetchFiles={}, suppressFileList={}, wantDtype={}, listOnlyFiles={}, rootHashes={}, searchRootUser={} }}",
@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 
+#include <folly/CancellationToken.h>
 #include <folly/Range.h>
 #include "eden/fs/utils/ImmediateFuture.h"
 #include "eden/fs/utils/RefPtr.h"
@@ -36,6 +37,18 @@ class ThriftGlobImpl {
       std::vector<std::string> globs,
       const ObjectFetchContextPtr& fetchContext);
 
+  /**
+   * Fetch, level by level, the trees under the search root that the globs
+   * can descend into, so that evaluating them afterwards does not have to
+   * fetch the trees one at a time. Failures are left for glob() to report.
+   */
+  ImmediateFuture<folly::Unit> prefetchTrees(
+      std::shared_ptr<EdenMount> edenMount,
+      std::shared_ptr<ServerState> serverState,
+      const std::vector<std::string>& globs,
+      const ObjectFetchContextPtr& fetchContext,
+      folly::CancellationToken cancellation);
+
   std::string logString();
   std::string logString(const std::vector<std::string>& globs) const;
 
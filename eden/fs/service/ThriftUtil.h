@@ -25,6 +25,14 @@ inline std::string thriftHash20(const Hash20& hash) {
   return folly::StringPiece{hash.getBytes()}.str();
 }
 
+/**
+ * Convert a Hash32 to a std::string to be returned via thrift as a thrift
+ * BinaryHash data type.
+ */
+inline std::string thriftHash32(const Hash32& hash) {
+  return folly::StringPiece{hash.getBytes()}.str();
+}
+
 /**
  * Convert thrift BinaryHash data type into a Hash20 object.
  *
@@ -297,6 +297,7 @@ enum FileAttributes {
   SHA1_HASH = 1,
   FILE_SIZE = 2,
   SOURCE_CONTROL_TYPE = 4,
+  BLAKE3_HASH = 8,
 /* NEXT_ATTR = 2^x */
 } (cpp2.enum_type = 'uint64_t')
 
@@ -307,6 +308,7 @@ struct FileAttributeData {
   1: optional BinaryHash sha1;
   2: optional i64 fileSize;
   3: optional SourceControlType type;
+  4: optional BinaryHash blake3;
 }
 
 /**
@@ -339,6 +341,11 @@ union SourceControlTypeOrError {
   2: EdenError error;
 }
 
+union Blake3OrError {
+  1: BinaryHash blake3;
+  2: EdenError error;
+}
+
 /**
  * Subset of attributes for a single file returned by getAttributesFromFiles()
  *
@@ -350,6 +357,7 @@ struct FileAttributeDataV2 {
   1: optional Sha1OrError sha1;
   2: optional SizeOrError size;
   3: optional SourceControlTypeOrError sourceControlType;
+  4: optional Blake3OrError blake3;
 }
 
 /**
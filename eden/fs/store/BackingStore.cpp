@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/BackingStore.h"
+
+#include <folly/io/Cursor.h>
+
+#include "eden/fs/model/Blob.h"
+
+namespace facebook::eden {
+
+folly::SemiFuture<BackingStore::GetBlobResult> BackingStore::getBlobRange(
+    const ObjectId& id,
+    uint64_t offset,
+    uint64_t length,
+    const ObjectFetchContextPtr& context) {
+  return getBlob(id, context).deferValue(
+      [id, offset, length](GetBlobResult result) {
+        if (!result.blob) {
+          return result;
+        }
+        auto range = result.blob->getRange(offset, length);
+        auto rangeLength = range.computeChainDataLength();
+        auto buf = folly::IOBuf::create(rangeLength);
+        folly::io::Cursor cursor{&range};
+        cursor.pull(buf->writableData(), rangeLength);
+        buf->append(rangeLength);
+        result.blob = std::make_shared<const Blob>(id, std::move(*buf));
+        return result;
+      });
+}
+
+} // namespace facebook::eden
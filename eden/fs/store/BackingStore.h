@@ -86,8 +86,11 @@ class BackingStore : public RootIdCodec, public ObjectIdCodec {
    * Return value of the getTree method.
    */
   struct GetTreeResult {
-    /** The retrieved tree. */
-    std::unique_ptr<Tree> tree;
+    /**
+     * The retrieved tree. Trees are immutable, so a BackingStore may hand the
+     * same instance to several concurrent callers.
+     */
+    std::shared_ptr<const Tree> tree;
     /** The fetch origin of the tree. */
     ObjectFetchContext::Origin origin;
   };
@@ -105,8 +108,11 @@ class BackingStore : public RootIdCodec, public ObjectIdCodec {
    * Return value of the getBlob method.
    */
   struct GetBlobResult {
-    /** The retrieved blob. */
-    std::unique_ptr<Blob> blob;
+    /**
+     * The retrieved blob. Like trees, blobs are immutable and may be shared
+     * between concurrent callers.
+     */
+    std::shared_ptr<const Blob> blob;
     /** The fetch origin of the blob. */
     ObjectFetchContext::Origin origin;
   };
@@ -120,6 +126,31 @@ class BackingStore : public RootIdCodec, public ObjectIdCodec {
       const ObjectId& id,
       const ObjectFetchContextPtr& context) = 0;
 
+  /**
+   * Whether getBlobRange() fetches only the requested range. When it does
+   * not, readers of huge blobs are better off fetching the whole blob once,
+   * through getBlob(), than fetching it again for every range.
+   */
+  virtual bool supportsBlobRange() const {
+    return false;
+  }
+
+  /**
+   * Fetch up to length bytes of a blob, starting at offset.
+   *
+   * The returned Blob carries the ID of the whole blob but only holds the
+   * requested range, and is empty if offset is past the end of the blob.
+   *
+   * Backing stores that can only return whole blobs use this default, which
+   * fetches the entire blob and copies the range out of it so the rest can be
+   * released. Callers should check supportsBlobRange() first.
+   */
+  virtual folly::SemiFuture<GetBlobResult> getBlobRange(
+      const ObjectId& id,
+      uint64_t offset,
+      uint64_t length,
+      const ObjectFetchContextPtr& context);
+
   /**
    * Return value of the getBlobMetadata method.
    */
@@ -40,4 +40,46 @@ folly::Future<BlobCache::GetResult> BlobAccess::getBlob(
       .via(&folly::QueuedImmediateExecutor::instance());
 }
 
+folly::Future<std::shared_ptr<const Blob>> BlobAccess::getBlobChunk(
+    const ObjectId& hash,
+    uint64_t index,
+    const ObjectFetchContextPtr& context) {
+  auto offset = index * BlobCache::kChunkSize;
+
+  auto whole = blobCache_->get(hash, BlobCache::Interest::UnlikelyNeededAgain);
+  if (whole.object) {
+    return folly::makeFuture<std::shared_ptr<const Blob>>(
+        std::make_shared<const Blob>(
+            hash, whole.object->getRange(offset, BlobCache::kChunkSize)));
+  }
+
+  if (auto chunk = blobCache_->getChunk(hash, index)) {
+    return folly::makeFuture(std::move(chunk));
+  }
+
+  if (!objectStore_->supportsBlobRange(hash)) {
+    // Fetching each chunk would fetch the whole blob every time. Fetch it
+    // once instead, sharing the fetch with concurrent readers, and cache it
+    // whole so that its other chunks are sliced out of it.
+    return objectStore_->getBlob(hash, context)
+        .thenValue([blobCache = blobCache_, hash, offset](
+                       std::shared_ptr<const Blob> blob) {
+          blobCache->insert(blob, BlobCache::Interest::UnlikelyNeededAgain);
+          return std::make_shared<const Blob>(
+              hash, blob->getRange(offset, BlobCache::kChunkSize));
+        })
+        .semi()
+        .via(&folly::QueuedImmediateExecutor::instance());
+  }
+
+  return objectStore_
+      ->getBlobRange(hash, offset, BlobCache::kChunkSize, context)
+      .thenValue([blobCache = blobCache_, hash, index](
+                     std::shared_ptr<const Blob> chunk) {
+        return blobCache->insertChunk(hash, index, *chunk);
+      })
+      .semi()
+      .via(&folly::QueuedImmediateExecutor::instance());
+}
+
 } // namespace facebook::eden
@@ -23,10 +23,9 @@ class IObjectStore;
  * cache for every read() request that makes into the edenfs process. Thus,
  * centralize blob access through this interface.
  *
- * TODO: To support large files, they should be split into a series of blobs,
- * and those blobs should get their own blob IDs, which could then be used
- * in this API. Splitting large blobs into a series of smaller blobs has the
- * benefit of helping bound Eden's memory usage here.
+ * Huge files need not be loaded in their entirety: getBlobChunk() loads and
+ * caches them BlobCache::kChunkSize bytes at a time, which bounds Eden's
+ * memory usage and the latency of the first read.
  */
 class BlobAccess {
  public:
@@ -58,6 +57,21 @@ class BlobAccess {
       const ObjectFetchContextPtr& context,
       BlobCache::Interest interest = BlobCache::Interest::LikelyNeededAgain);
 
+  /**
+   * Loads and returns chunk number index of the blob, i.e. the bytes
+   * [index * BlobCache::kChunkSize, (index + 1) * BlobCache::kChunkSize).
+   *
+   * If the whole blob is already cached, the chunk is sliced out of it.
+   * Otherwise, when the IObjectStore supports it for this blob, only the
+   * chunk is fetched, through IObjectStore::getBlobRange, and cached on its
+   * own. Else the whole blob is fetched and cached, and this chunk and the
+   * following ones are sliced out of it.
+   */
+  folly::Future<std::shared_ptr<const Blob>> getBlobChunk(
+      const ObjectId& hash,
+      uint64_t index,
+      const ObjectFetchContextPtr& context);
+
  private:
   BlobAccess(const BlobAccess&) = delete;
   BlobAccess& operator=(const BlobAccess&) = delete;
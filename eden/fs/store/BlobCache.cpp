@@ -6,6 +6,7 @@
  */
 
 #include "eden/fs/store/BlobCache.h"
+#include <folly/lang/Bits.h>
 #include "eden/fs/config/EdenConfig.h"
 #include "eden/fs/config/ReloadableConfig.h"
 
@@ -15,11 +16,53 @@ BlobCache::BlobCache(PrivateTag, std::shared_ptr<ReloadableConfig> config)
     : BlobCache{
           PrivateTag{},
           config->getEdenConfig()->inMemoryBlobCacheSize.getValue(),
-          config->getEdenConfig()->inMemoryBlobCacheMinimumItems.getValue()} {}
+          config->getEdenConfig()->inMemoryBlobCacheMinimumItems.getValue(),
+          config->getEdenConfig()->inMemoryBlobCacheShards.getValue(),
+          config->getEdenConfig()->inMemoryBlobChunkCacheSize.getValue(),
+          config->getEdenConfig()->inMemoryBlobCacheTinyLfu.getValue()
+              ? ObjectCachePolicy::TinyLFU
+              : ObjectCachePolicy::LRU} {}
 
-BlobCache::BlobCache(PrivateTag, size_t maximumSize, size_t minimumCount)
+BlobCache::BlobCache(
+    PrivateTag,
+    size_t maximumSize,
+    size_t minimumCount,
+    size_t numShards,
+    size_t maximumChunkCacheSize,
+    ObjectCachePolicy policy)
     : ObjectCache<Blob, ObjectCacheFlavor::InterestHandle>{
           maximumSize,
-          minimumCount} {}
+          minimumCount,
+          numShards,
+          policy},
+      chunks_{ObjectCache<Blob, ObjectCacheFlavor::Simple>::create(
+          maximumChunkCacheSize,
+          /*minimumEntryCount=*/0,
+          numShards)} {}
+
+ObjectId BlobCache::makeChunkId(const ObjectId& hash, uint64_t index) {
+  auto bytes = hash.getBytes();
+  folly::fbstring key{
+      reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+  auto bigEndianIndex = folly::Endian::big(index);
+  key.append(reinterpret_cast<const char*>(&bigEndianIndex), sizeof(uint64_t));
+  return ObjectId{std::move(key)};
+}
+
+std::shared_ptr<const Blob> BlobCache::getChunk(
+    const ObjectId& hash,
+    uint64_t index) {
+  return chunks_->getSimple(makeChunkId(hash, index));
+}
+
+std::shared_ptr<const Blob> BlobCache::insertChunk(
+    const ObjectId& hash,
+    uint64_t index,
+    const Blob& chunk) {
+  auto cached = std::make_shared<const Blob>(
+      makeChunkId(hash, index), chunk.getContents());
+  chunks_->insertSimple(cached);
+  return cached;
+}
 
 } // namespace facebook::eden
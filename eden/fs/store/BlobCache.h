@@ -26,6 +26,13 @@ using BlobInterestHandle = ObjectInterestHandle<Blob>;
  * frequently-accessed large blobs when they are larger than the maximum cache
  * size.
  *
+ * With blobcache:enable-tiny-lfu, blobs are instead evicted following the
+ * scan-resistant ObjectCachePolicy::TinyLFU policy.
+ *
+ * Huge blobs can instead be read kChunkSize bytes at a time. Such chunks are
+ * kept in a separate cache, bounded by its own size, so that reading a few
+ * pages of a multi-gigabyte file does not evict whole small blobs.
+ *
  * It is safe to use this object from arbitrary threads.
  */
 class BlobCache : public ObjectCache<Blob, ObjectCacheFlavor::InterestHandle> {
@@ -38,12 +45,32 @@ class BlobCache : public ObjectCache<Blob, ObjectCacheFlavor::InterestHandle> {
   }
   static std::shared_ptr<BlobCache> create(
       size_t maximumSize,
-      size_t minimumCount) {
-    return std::make_shared<BlobCache>(PrivateTag{}, maximumSize, minimumCount);
+      size_t minimumCount,
+      size_t numShards = 1,
+      ObjectCachePolicy policy = ObjectCachePolicy::LRU) {
+    return std::make_shared<BlobCache>(
+        PrivateTag{},
+        maximumSize,
+        minimumCount,
+        numShards,
+        maximumSize,
+        policy);
   }
 
+  /**
+   * Granularity of chunked blob reads. Chunk i covers the bytes
+   * [i * kChunkSize, (i + 1) * kChunkSize) of its blob.
+   */
+  static constexpr uint64_t kChunkSize = 1024 * 1024;
+
   explicit BlobCache(PrivateTag, std::shared_ptr<ReloadableConfig> config);
-  explicit BlobCache(PrivateTag, size_t maximumSize, size_t minimumCount);
+  explicit BlobCache(
+      PrivateTag,
+      size_t maximumSize,
+      size_t minimumCount,
+      size_t numShards,
+      size_t maximumChunkCacheSize,
+      ObjectCachePolicy policy);
   ~BlobCache() = default;
 
   /**
@@ -77,6 +104,29 @@ class BlobCache : public ObjectCache<Blob, ObjectCacheFlavor::InterestHandle> {
       Interest interest = Interest::LikelyNeededAgain) {
     return insertInterestHandle(blob, interest);
   }
+
+  /**
+   * Return chunk number index of the blob with the given hash, or nullptr if
+   * that chunk is not cached. The returned Blob's hash identifies the chunk,
+   * not the whole blob.
+   */
+  std::shared_ptr<const Blob> getChunk(const ObjectId& hash, uint64_t index);
+
+  /**
+   * Cache chunk number index of the blob with the given hash. Returns the
+   * cached chunk.
+   */
+  std::shared_ptr<const Blob>
+  insertChunk(const ObjectId& hash, uint64_t index, const Blob& chunk);
+
+ private:
+  /**
+   * Derive the key of a chunk from the blob hash and chunk index. Appending a
+   * fixed-size suffix keeps keys of different blobs from colliding.
+   */
+  static ObjectId makeChunkId(const ObjectId& hash, uint64_t index);
+
+  const std::shared_ptr<ObjectCache<Blob, ObjectCacheFlavor::Simple>> chunks_;
 };
 
 } // namespace facebook::eden
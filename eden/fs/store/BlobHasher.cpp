@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/BlobHasher.h"
+
+#include <folly/futures/Future.h>
+
+#include "eden/fs/model/Blob.h"
+
+namespace facebook::eden {
+
+BlobHasher::BlobHasher(
+    std::shared_ptr<folly::Executor> executor,
+    size_t parallelThreshold)
+    : executor_{std::move(executor)}, parallelThreshold_{parallelThreshold} {}
+
+BlobMetadata BlobHasher::computeMetadata(const Blob& blob) {
+  return BlobMetadata{Hash20::sha1(blob.getContents()), blob.getSize()};
+}
+
+Hash32 BlobHasher::computeBlake3(const Blob& blob) {
+  return Hash32::blake3(blob.getContents());
+}
+
+bool BlobHasher::isLarge(const Blob& blob) const {
+  return executor_ && blob.getSize() >= parallelThreshold_;
+}
+
+folly::Future<BlobMetadata> BlobHasher::computeMetadataAsync(
+    std::shared_ptr<const Blob> blob) const {
+  if (!isLarge(*blob)) {
+    return computeMetadata(*blob);
+  }
+  return folly::via(folly::getKeepAliveToken(*executor_), [blob] {
+    return computeMetadata(*blob);
+  });
+}
+
+folly::Future<Hash32> BlobHasher::computeBlake3Async(
+    std::shared_ptr<const Blob> blob) const {
+  if (!isLarge(*blob)) {
+    return computeBlake3(*blob);
+  }
+  return folly::via(folly::getKeepAliveToken(*executor_), [blob] {
+    return computeBlake3(*blob);
+  });
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/Executor.h>
+#include <folly/futures/Future.h>
+#include <memory>
+
+#include "eden/fs/model/BlobMetadata.h"
+
+namespace facebook::eden {
+
+class Blob;
+
+/**
+ * Computes the metadata of blob contents.
+ *
+ * Hashing is single-threaded and takes a while for large blobs, so blobs of
+ * at least parallelThreshold bytes are hashed on the given executor, and the
+ * thread that asked for the digest, often a FUSE or Thrift worker, is not held
+ * up meanwhile. Smaller blobs are hashed inline.
+ *
+ * The metadata only holds the SHA-1 digest. BLAKE3 is computed separately,
+ * when it is asked for, since most blobs are never asked for theirs.
+ */
+class BlobHasher {
+ public:
+  BlobHasher(
+      std::shared_ptr<folly::Executor> executor,
+      size_t parallelThreshold);
+
+  /**
+   * Compute the metadata of blob on the calling thread.
+   */
+  static BlobMetadata computeMetadata(const Blob& blob);
+
+  /**
+   * Compute the BLAKE3 digest of blob on the calling thread.
+   */
+  static Hash32 computeBlake3(const Blob& blob);
+
+  /**
+   * Whether the async methods would hash blob on the executor.
+   */
+  bool isLarge(const Blob& blob) const;
+
+  /**
+   * Compute the metadata of blob, on the executor if blob is large. The
+   * returned future is already complete otherwise.
+   */
+  folly::Future<BlobMetadata> computeMetadataAsync(
+      std::shared_ptr<const Blob> blob) const;
+
+  /**
+   * Compute the BLAKE3 digest of blob, on the executor if blob is large.
+   */
+  folly::Future<Hash32> computeBlake3Async(
+      std::shared_ptr<const Blob> blob) const;
+
+ private:
+  const std::shared_ptr<folly::Executor> executor_;
+  const size_t parallelThreshold_;
+};
+
+} // namespace facebook::eden
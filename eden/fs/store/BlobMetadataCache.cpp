@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/BlobMetadataCache.h"
+
+#include <folly/hash/Hash.h>
+
+namespace facebook::eden {
+
+namespace {
+size_t computeShardCapacity(size_t maximumEntries, size_t numShards) {
+  // Round up so that the cache as a whole holds at least maximumEntries.
+  return std::max((maximumEntries + numShards - 1) / numShards, size_t{1});
+}
+} // namespace
+
+BlobMetadataCache::BlobMetadataCache(size_t maximumEntries, size_t numShards)
+    : shardCapacity_{
+          computeShardCapacity(maximumEntries, std::max(numShards, size_t{1}))} {
+  numShards = std::max(numShards, size_t{1});
+  shards_.reserve(numShards);
+  for (size_t i = 0; i < numShards; ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+BlobMetadataCache::Shard& BlobMetadataCache::getShard(const ObjectId& id) {
+  auto index = folly::hash::twang_mix64(id.getHashCode()) % shards_.size();
+  return *shards_[index];
+}
+
+const BlobMetadataCache::Shard& BlobMetadataCache::getShard(
+    const ObjectId& id) const {
+  auto index = folly::hash::twang_mix64(id.getHashCode()) % shards_.size();
+  return *shards_[index];
+}
+
+std::optional<BlobMetadata> BlobMetadataCache::get(const ObjectId& id) const {
+  auto state = getShard(id).state.rlock();
+  auto it = state->index.find(id);
+  if (it == state->index.end()) {
+    return std::nullopt;
+  }
+  state->referenced[it->second].store(true, std::memory_order_relaxed);
+  return state->entries[it->second].metadata;
+}
+
+bool BlobMetadataCache::contains(const ObjectId& id) const {
+  auto state = getShard(id).state.rlock();
+  return state->index.count(id) != 0;
+}
+
+size_t BlobMetadataCache::insert(
+    const ObjectId& id,
+    const BlobMetadata& metadata) {
+  auto state = getShard(id).state.wlock();
+
+  auto it = state->index.find(id);
+  if (it != state->index.end()) {
+    state->entries[it->second].metadata = metadata;
+    state->referenced[it->second].store(true, std::memory_order_relaxed);
+    return 0;
+  }
+
+  if (state->entries.size() < shardCapacity_) {
+    auto slot = state->entries.size();
+    state->entries.push_back(Entry{id, metadata});
+    state->index.emplace(id, slot);
+    // New entries start unreferenced so that an entry only ever inserted and
+    // never read again is the first to go.
+    state->referenced.emplace_back(false);
+    return 0;
+  }
+
+  // The shard is full: advance the clock hand, giving every referenced entry a
+  // second chance, until an unreferenced victim is found. This terminates
+  // within two sweeps since each step clears a reference bit.
+  while (state->referenced[state->hand].exchange(
+      false, std::memory_order_relaxed)) {
+    state->hand = (state->hand + 1) % shardCapacity_;
+  }
+  auto slot = state->hand;
+  state->hand = (state->hand + 1) % shardCapacity_;
+
+  state->index.erase(state->entries[slot].id);
+  state->entries[slot] = Entry{id, metadata};
+  state->index.emplace(id, slot);
+  return 1;
+}
+
+void BlobMetadataCache::clear() {
+  for (auto& shard : shards_) {
+    auto state = shard->state.wlock();
+    state->index.clear();
+    state->entries.clear();
+    state->referenced.clear();
+    state->hand = 0;
+  }
+}
+
+BlobMetadataCache::Stats BlobMetadataCache::getStats() const {
+  Stats stats;
+  for (const auto& shard : shards_) {
+    stats.entryCount += shard->state.rlock()->entries.size();
+    stats.capacity += shardCapacity_;
+  }
+  return stats;
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/SharedMutex.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <folly/lang/Align.h>
+#include <atomic>
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include "eden/fs/model/BlobMetadata.h"
+#include "eden/fs/model/ObjectId.h"
+
+namespace facebook::eden {
+
+/**
+ * A bounded, concurrent cache of BlobMetadata keyed by blob ID.
+ *
+ * Unlike an LRU, a cache hit does not need to reorder anything: the cache is
+ * split into shards, each using the CLOCK approximation of LRU. A hit only
+ * sets the entry's reference bit, which is an atomic, so lookups take the
+ * shard lock in shared mode and never contend with each other. Only inserts
+ * take the shard lock exclusively, sweeping the clock hand over the entries
+ * and evicting the first one that was not referenced since the last sweep.
+ *
+ * It is safe to use this object from arbitrary threads.
+ */
+class BlobMetadataCache {
+ public:
+  struct Stats {
+    size_t entryCount{0};
+    size_t capacity{0};
+  };
+
+  /**
+   * Create a cache holding at most maximumEntries entries, split evenly
+   * between numShards shards.
+   */
+  BlobMetadataCache(size_t maximumEntries, size_t numShards);
+
+  BlobMetadataCache(const BlobMetadataCache&) = delete;
+  BlobMetadataCache& operator=(const BlobMetadataCache&) = delete;
+
+  /**
+   * Return the cached metadata for this blob, or std::nullopt if not cached.
+   */
+  std::optional<BlobMetadata> get(const ObjectId& id) const;
+
+  /**
+   * Returns true if the cache holds metadata for this blob. Unlike get(), this
+   * does not count as a use of the entry.
+   */
+  bool contains(const ObjectId& id) const;
+
+  /**
+   * Insert or overwrite the metadata for this blob. Returns the number of
+   * entries that had to be evicted to make room for it.
+   */
+  size_t insert(const ObjectId& id, const BlobMetadata& metadata);
+
+  /**
+   * Evict everything.
+   */
+  void clear();
+
+  Stats getStats() const;
+
+ private:
+  struct Entry {
+    ObjectId id;
+    BlobMetadata metadata;
+  };
+
+  /**
+   * The containers grow as entries are inserted, up to the shard's capacity,
+   * rather than being allocated up front: most caches never fill up.
+   */
+  struct State {
+    /// Index into entries of each cached ID.
+    folly::F14FastMap<ObjectId, size_t> index;
+    std::vector<Entry> entries;
+
+    /// One reference bit per entry. Set by readers holding the lock in shared
+    /// mode, hence atomic and mutable. A deque, since atomics cannot be moved
+    /// when a vector grows.
+    mutable std::deque<std::atomic<bool>> referenced;
+
+    /// Next entry the clock hand will consider for eviction.
+    size_t hand{0};
+  };
+
+  struct alignas(folly::hardware_destructive_interference_size) Shard {
+    folly::Synchronized<State, folly::SharedMutex> state;
+  };
+
+  Shard& getShard(const ObjectId& id);
+  const Shard& getShard(const ObjectId& id) const;
+
+  const size_t shardCapacity_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace facebook::eden
@@ -0,0 +1,433 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/DiskBlobCache.h"
+
+#include <boost/filesystem.hpp>
+#include <fmt/format.h>
+#include <folly/File.h>
+#include <folly/FileUtil.h>
+#include <folly/Random.h>
+#include <folly/String.h>
+#include <folly/io/IOBuf.h>
+#include <folly/logging/xlog.h>
+#include <folly/portability/SysMman.h>
+#include <folly/portability/SysStat.h>
+#include <algorithm>
+#include <cstring>
+
+#include "eden/fs/config/EdenConfig.h"
+#include "eden/fs/model/Blob.h"
+#include "eden/fs/utils/FileUtils.h"
+
+namespace facebook::eden {
+
+namespace {
+
+/**
+ * Every cache file starts with this header, followed by the blob contents.
+ */
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t length;
+};
+static_assert(sizeof(FileHeader) == 16);
+
+constexpr uint32_t kMagic = 0x43424445; // "EDBC"
+constexpr uint32_t kVersion = 1;
+
+// Leave room for the temporary file suffix added by insert() within
+// the usual 255 byte file name limit.
+constexpr size_t kMaxFileNameLength = 200;
+
+bool isValidHeader(const FileHeader& header, uint64_t fileSize) {
+  return header.magic == kMagic && header.version == kVersion &&
+      header.length == fileSize - sizeof(FileHeader);
+}
+
+#ifndef _WIN32
+void unmapBlob(void* buf, void* userData) {
+  munmap(buf, reinterpret_cast<uintptr_t>(userData));
+}
+
+/**
+ * Map the cache file into memory and wrap the blob contents in an IOBuf that
+ * unmaps it once the last reference goes away.
+ */
+std::optional<folly::IOBuf> readCacheFile(AbsolutePathPiece path) {
+  int fd = folly::openNoInt(path.asString().c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return std::nullopt;
+  }
+  folly::File file{fd, /*ownsFd=*/true};
+
+  struct stat st;
+  if (fstat(file.fd(), &st) != 0 ||
+      static_cast<uint64_t>(st.st_size) < sizeof(FileHeader)) {
+    return std::nullopt;
+  }
+  auto fileSize = static_cast<size_t>(st.st_size);
+
+  void* addr = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, file.fd(), 0);
+  if (addr == MAP_FAILED) {
+    XLOG(WARN) << "Failed to map " << path << ": " << folly::errnoStr(errno);
+    return std::nullopt;
+  }
+
+  FileHeader header;
+  memcpy(&header, addr, sizeof(FileHeader));
+  if (!isValidHeader(header, fileSize)) {
+    munmap(addr, fileSize);
+    return std::nullopt;
+  }
+
+  return folly::IOBuf{
+      folly::IOBuf::TAKE_OWNERSHIP,
+      addr,
+      fileSize,
+      sizeof(FileHeader),
+      header.length,
+      unmapBlob,
+      reinterpret_cast<void*>(static_cast<uintptr_t>(fileSize))};
+}
+#else
+std::optional<folly::IOBuf> readCacheFile(AbsolutePathPiece path) {
+  auto contents = readFile(path);
+  if (contents.hasException() ||
+      contents.value().size() < sizeof(FileHeader)) {
+    return std::nullopt;
+  }
+
+  FileHeader header;
+  memcpy(&header, contents.value().data(), sizeof(FileHeader));
+  if (!isValidHeader(header, contents.value().size())) {
+    return std::nullopt;
+  }
+  return folly::IOBuf{
+      folly::IOBuf::COPY_BUFFER,
+      contents.value().data() + sizeof(FileHeader),
+      header.length};
+}
+#endif
+
+/**
+ * Write the cache file for blob to the temporary file tmpPath, to be renamed
+ * into place by the caller. The file is synced so that a crash after the
+ * rename cannot expose a partially written blob.
+ */
+folly::Try<void> writeTempFile(AbsolutePathPiece tmpPath, const Blob& blob) {
+  FileHeader header{kMagic, kVersion, blob.getSize()};
+#ifndef _WIN32
+  auto iov = blob.getContents().getIov();
+  iov.insert(iov.begin(), iovec{&header, sizeof(FileHeader)});
+  int fd = folly::openNoInt(
+      tmpPath.asString().c_str(),
+      O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+      0644);
+  if (fd < 0) {
+    return folly::Try<void>{folly::makeSystemError(
+        fmt::format(FMT_STRING("couldn't create {}"), tmpPath))};
+  }
+  folly::File file{fd, /*ownsFd=*/true};
+  if (folly::writevFull(fd, iov.data(), iov.size()) < 0 ||
+      folly::fsyncNoInt(fd) != 0) {
+    return folly::Try<void>{folly::makeSystemError(
+        fmt::format(FMT_STRING("couldn't write {}"), tmpPath))};
+  }
+  return folly::Try<void>{};
+#else
+  auto buf = folly::IOBuf::copyBuffer(&header, sizeof(FileHeader));
+  buf->appendToChain(blob.getContents().clone());
+  buf->coalesce();
+  return writeFile(tmpPath, folly::ByteRange{buf->data(), buf->length()});
+#endif
+}
+
+} // namespace
+
+DiskBlobCache::DiskBlobCache(
+    AbsolutePath root,
+    uint64_t maximumBytes,
+    uint64_t minimumBlobSize,
+    std::shared_ptr<folly::Executor> writeExecutor,
+    uint64_t maximumPendingWriteBytes)
+    : root_{std::move(root)},
+      maximumBytes_{maximumBytes},
+      minimumBlobSize_{minimumBlobSize},
+      writeExecutor_{std::move(writeExecutor)},
+      maximumPendingWriteBytes_{maximumPendingWriteBytes} {
+  for (unsigned i = 0; i < 256; ++i) {
+    ensureDirectoryExists(root_ + PathComponent{fmt::format("{:02x}", i)});
+  }
+  loadIndex();
+}
+
+std::shared_ptr<DiskBlobCache> DiskBlobCache::create(
+    AbsolutePath root,
+    const EdenConfig& config,
+    std::shared_ptr<folly::Executor> writeExecutor) {
+  return std::make_shared<DiskBlobCache>(
+      std::move(root),
+      config.diskBlobCacheSize.getValue(),
+      config.diskBlobCacheMinimumBlobSize.getValue(),
+      std::move(writeExecutor),
+      config.diskBlobCacheMaximumPendingWriteBytes.getValue());
+}
+
+bool DiskBlobCache::accepts(const Blob& blob) const {
+  return blob.getSize() >= minimumBlobSize_ &&
+      sizeof(FileHeader) + blob.getSize() <= maximumBytes_;
+}
+
+std::optional<AbsolutePath> DiskBlobCache::getPath(const ObjectId& id) const {
+  auto hex = id.asHexString();
+  if (hex.size() < 3 || hex.size() > kMaxFileNameLength) {
+    return std::nullopt;
+  }
+  return root_ + PathComponentPiece{std::string_view{hex}.substr(0, 2)} +
+      PathComponentPiece{std::string_view{hex}.substr(2)};
+}
+
+void DiskBlobCache::loadIndex() {
+  struct FoundFile {
+    ObjectId id;
+    uint64_t size;
+    std::time_t lastWrite;
+  };
+  std::vector<FoundFile> found;
+  std::vector<AbsolutePath> garbage;
+
+  for (unsigned i = 0; i < 256; ++i) {
+    auto prefix = fmt::format("{:02x}", i);
+    auto dir = boost::filesystem::path{
+        (root_ + PathComponentPiece{prefix}).asString()};
+    boost::system::error_code ec;
+    for (auto iter = boost::filesystem::directory_iterator{dir, ec};
+         !ec && iter != boost::filesystem::directory_iterator{};
+         iter.increment(ec)) {
+      auto path = canonicalPath(iter->path().string());
+      auto name = iter->path().filename().string();
+      std::optional<ObjectId> id;
+      try {
+        id = ObjectId::fromHex(prefix + name);
+      } catch (const std::invalid_argument&) {
+        // Most likely a temporary file left behind by a crash during a write.
+      }
+      boost::system::error_code statError;
+      auto size = boost::filesystem::file_size(iter->path(), statError);
+      auto lastWrite =
+          boost::filesystem::last_write_time(iter->path(), statError);
+      if (!id || statError || size < sizeof(FileHeader)) {
+        garbage.push_back(std::move(path));
+        continue;
+      }
+      found.push_back(FoundFile{std::move(*id), size, lastWrite});
+    }
+  }
+
+  // Insert from oldest to newest so that the most recently written blobs end
+  // up at the front of the LRU.
+  std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) {
+    return a.lastWrite < b.lastWrite;
+  });
+
+  std::vector<AbsolutePath> evicted;
+  {
+    auto state = state_.wlock();
+    for (auto& file : found) {
+      state->totalBytes += file.size;
+      state->entries.set(
+          std::move(file.id), Entry{file.size, state->nextGeneration++});
+    }
+    evicted = evictUntilFits(*state);
+  }
+
+  XLOG(DBG2) << "Indexed " << found.size() << " blobs in " << root_
+             << ", removing " << garbage.size() << " stray files and "
+             << evicted.size() << " blobs over budget";
+  removeFiles(garbage);
+  removeFiles(evicted);
+}
+
+std::shared_ptr<const Blob> DiskBlobCache::get(const ObjectId& id) {
+  // Misses are by far the most common, and must not contend with each other.
+  auto generation = lookup(id);
+  if (!generation) {
+    return nullptr;
+  }
+
+  auto path = getPath(id);
+  auto contents = readCacheFile(*path);
+  if (!contents) {
+    // The file vanished or is corrupted. Forget about it so the blob is
+    // fetched and cached again, unless the file was replaced meanwhile: the
+    // entry was then evicted, and maybe cached again with a new file.
+    XLOG(DBG3) << "Dropping unreadable disk cache entry for " << id;
+    auto state = state_.wlock();
+    auto it = state->entries.findWithoutPromotion(id);
+    if (it != state->entries.end() && it->second.generation == *generation) {
+      state->totalBytes -= it->second.size;
+      state->entries.erase(id);
+      removeFiles({*path});
+    }
+    return nullptr;
+  }
+
+  // Only hits, which read a large file anyway, mark the entry as recently
+  // used.
+  state_.wlock()->entries.find(id);
+  return std::make_shared<const Blob>(id, std::move(*contents));
+}
+
+bool DiskBlobCache::contains(const ObjectId& id) const {
+  return lookup(id).has_value();
+}
+
+std::optional<uint64_t> DiskBlobCache::lookup(const ObjectId& id) const {
+  auto state = state_.rlock();
+  auto it = state->entries.findWithoutPromotion(id);
+  if (it == state->entries.end()) {
+    return std::nullopt;
+  }
+  return it->second.generation;
+}
+
+size_t DiskBlobCache::insert(const Blob& blob) {
+  if (!accepts(blob)) {
+    return 0;
+  }
+  const auto& id = blob.getHash();
+  auto path = getPath(id);
+  if (!path || contains(id)) {
+    return 0;
+  }
+
+  // Only the rename into place happens under the lock, the slow write and
+  // sync do not.
+  auto tmpPath = path->dirname() +
+      PathComponent{fmt::format(
+          "{}.tmp{:016x}", path->basename(), folly::Random::rand64())};
+  auto result = writeTempFile(tmpPath, blob);
+  if (result.hasException()) {
+    XLOG(WARN) << "Failed to cache blob " << id
+               << " on disk: " << result.exception().what();
+    removeFiles({tmpPath});
+    return 0;
+  }
+
+  auto state = state_.wlock();
+  if (state->entries.findWithoutPromotion(id) != state->entries.end()) {
+    // Raced with another insert of the same blob, which wrote the same
+    // contents.
+    removeFiles({tmpPath});
+    return 0;
+  }
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmpPath.asString(), path->asString(), ec);
+  if (ec) {
+    XLOG(WARN) << "Failed to cache blob " << id
+               << " on disk: " << ec.message();
+    removeFiles({tmpPath});
+    return 0;
+  }
+  state->totalBytes += sizeof(FileHeader) + blob.getSize();
+  state->entries.set(
+      id,
+      Entry{sizeof(FileHeader) + blob.getSize(), state->nextGeneration++});
+  // Unlink while holding the lock: otherwise, an insert of a blob that was
+  // just evicted could rename its new file into place before the unlink,
+  // which would then remove the file of a cached blob.
+  auto evicted = evictUntilFits(*state);
+  removeFiles(evicted);
+  return evicted.size();
+}
+
+void DiskBlobCache::insertInBackground(
+    std::shared_ptr<const Blob> blob,
+    folly::Function<void(size_t evicted)> onInserted) {
+  if (!accepts(*blob)) {
+    return;
+  }
+  auto id = blob->getHash();
+  auto size = blob->getSize();
+  {
+    auto state = state_.wlock();
+    if (state->entries.findWithoutPromotion(id) != state->entries.end() ||
+        state->pendingWrites.count(id)) {
+      return;
+    }
+    if (size > maximumPendingWriteBytes_ - state->pendingWriteBytes) {
+      XLOG(DBG3) << "Not caching blob " << id
+                 << " on disk: too many pending writes";
+      return;
+    }
+    state->pendingWrites.insert(id);
+    state->pendingWriteBytes += size;
+  }
+
+  auto write = [self = shared_from_this(),
+                blob = std::move(blob),
+                onInserted = std::move(onInserted)]() mutable {
+    auto evicted = self->insert(*blob);
+    {
+      auto state = self->state_.wlock();
+      state->pendingWrites.erase(blob->getHash());
+      state->pendingWriteBytes -= blob->getSize();
+    }
+    onInserted(evicted);
+  };
+  if (writeExecutor_) {
+    writeExecutor_->add(std::move(write));
+  } else {
+    write();
+  }
+}
+
+std::vector<AbsolutePath> DiskBlobCache::evictUntilFits(State& state) const {
+  std::vector<AbsolutePath> evicted;
+  while (state.totalBytes > maximumBytes_ && !state.entries.empty()) {
+    auto lru = state.entries.rbegin();
+    auto id = lru->first;
+    state.totalBytes -= lru->second.size;
+    if (auto path = getPath(id)) {
+      evicted.push_back(std::move(*path));
+    }
+    state.entries.erase(id);
+  }
+  return evicted;
+}
+
+void DiskBlobCache::removeFiles(const std::vector<AbsolutePath>& paths) const {
+  for (const auto& path : paths) {
+    boost::system::error_code ec;
+    boost::filesystem::remove(path.asString(), ec);
+    if (ec) {
+      XLOG(WARN) << "Failed to remove " << path << ": " << ec.message();
+    }
+  }
+}
+
+void DiskBlobCache::clear() {
+  std::vector<AbsolutePath> evicted;
+  auto state = state_.wlock();
+  for (const auto& [id, entry] : state->entries) {
+    if (auto path = getPath(id)) {
+      evicted.push_back(std::move(*path));
+    }
+  }
+  state->entries.clear();
+  state->totalBytes = 0;
+  removeFiles(evicted);
+}
+
+DiskBlobCache::Stats DiskBlobCache::getStats() const {
+  auto state = state_.rlock();
+  return Stats{state->entries.size(), state->totalBytes};
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/Executor.h>
+#include <folly/Function.h>
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
+#include <folly/container/F14Set.h>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "eden/fs/model/ObjectId.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+namespace facebook::eden {
+
+class Blob;
+class EdenConfig;
+
+/**
+ * A size-bounded, on-disk cache of large blobs, kept outside of the
+ * LocalStore.
+ *
+ * Storing large blobs as RocksDB values causes a lot of compaction write
+ * amplification and pushes small objects out of the block cache. Instead,
+ * each blob at least getMinimumBlobSize() bytes long is written to its own
+ * file under the cache directory, named after its ObjectId:
+ *
+ *   <root>/<first byte of id in hex>/<remaining bytes of id in hex>
+ *
+ * Reads map the file into memory, so the returned Blob does not copy its
+ * contents. Writes go through a temporary file that is fsynced and renamed
+ * into place, and every file starts with a header recording the length of
+ * the blob, so a crash can never expose a partially written blob.
+ *
+ * The cache keeps an in-memory LRU index of the files it holds, rebuilt from
+ * the directory at construction, and unlinks the least recently used ones
+ * whenever the total size exceeds its budget.
+ *
+ * It is safe to use this object from arbitrary threads.
+ */
+class DiskBlobCache : public std::enable_shared_from_this<DiskBlobCache> {
+ public:
+  struct Stats {
+    size_t entryCount{0};
+    uint64_t totalBytes{0};
+  };
+
+  /**
+   * Create a cache rooted at root, holding at most maximumBytes worth of
+   * files and only accepting blobs at least minimumBlobSize bytes long.
+   * insertInBackground() writes blobs on writeExecutor, or inline if it is
+   * null, and drops the blobs that would take the ones queued there over
+   * maximumPendingWriteBytes.
+   *
+   * Creates the directory structure if needed and indexes the blobs left by
+   * a previous run.
+   */
+  DiskBlobCache(
+      AbsolutePath root,
+      uint64_t maximumBytes,
+      uint64_t minimumBlobSize,
+      std::shared_ptr<folly::Executor> writeExecutor = nullptr,
+      uint64_t maximumPendingWriteBytes =
+          std::numeric_limits<uint64_t>::max());
+
+  /**
+   * Create a cache from the blobcache:disk-cache-* settings.
+   */
+  static std::shared_ptr<DiskBlobCache> create(
+      AbsolutePath root,
+      const EdenConfig& config,
+      std::shared_ptr<folly::Executor> writeExecutor);
+
+  DiskBlobCache(const DiskBlobCache&) = delete;
+  DiskBlobCache& operator=(const DiskBlobCache&) = delete;
+
+  uint64_t getMinimumBlobSize() const {
+    return minimumBlobSize_;
+  }
+
+  /**
+   * Return the cached blob, or nullptr if it is not cached.
+   */
+  std::shared_ptr<const Blob> get(const ObjectId& id);
+
+  /**
+   * Returns true if the cache holds this blob. Unlike get(), this does not
+   * count as a use of the entry.
+   */
+  bool contains(const ObjectId& id) const;
+
+  /**
+   * Write the blob to the cache if it is large enough to belong there.
+   * Returns the number of blobs that had to be evicted to make room for it.
+   */
+  size_t insert(const Blob& blob);
+
+  /**
+   * Like insert(), but the blob is written on the write executor, so that
+   * the fetch that produced it is not held up by the disk. onInserted is
+   * called there with the number of blobs evicted. Nothing is scheduled for a
+   * blob that does not belong in the cache, is already cached, or is already
+   * being written.
+   *
+   * Queued blobs are kept alive until written, so a blob that would take
+   * them over the pending write budget is dropped instead: the disk is not
+   * keeping up, and the blob is simply fetched again the next time.
+   *
+   * The cache must be owned by a std::shared_ptr.
+   */
+  void insertInBackground(
+      std::shared_ptr<const Blob> blob,
+      folly::Function<void(size_t evicted)> onInserted);
+
+  /**
+   * Evict everything.
+   */
+  void clear();
+
+  Stats getStats() const;
+
+ private:
+  struct Entry {
+    /// Size of the file on disk.
+    uint64_t size;
+    /// Distinguishes the file from the ones cached earlier or later for the
+    /// same blob, whose entries would have the same id.
+    uint64_t generation;
+  };
+
+  struct State {
+    /// The cached blobs, most recently used first.
+    folly::EvictingCacheMap<ObjectId, Entry> entries{0};
+    uint64_t totalBytes{0};
+    uint64_t nextGeneration{0};
+    /// Blobs queued by insertInBackground() and not yet written.
+    folly::F14FastSet<ObjectId> pendingWrites;
+    /// Total size of the blobs in pendingWrites.
+    uint64_t pendingWriteBytes{0};
+  };
+
+  /**
+   * Returns the generation of the blob's entry, or std::nullopt if it is not
+   * cached.
+   */
+  std::optional<uint64_t> lookup(const ObjectId& id) const;
+
+  /**
+   * Whether the blob is large enough to be cached, yet fits the budget.
+   */
+  bool accepts(const Blob& blob) const;
+
+  /**
+   * Returns the path of the file backing this blob, or std::nullopt if the id
+   * is too long to be used as a file name.
+   */
+  std::optional<AbsolutePath> getPath(const ObjectId& id) const;
+
+  void loadIndex();
+
+  /**
+   * Drop least recently used entries until the total size fits the budget.
+   * Returns the paths of the files to unlink, which callers do before
+   * releasing the lock.
+   */
+  std::vector<AbsolutePath> evictUntilFits(State& state) const;
+
+  void removeFiles(const std::vector<AbsolutePath>& paths) const;
+
+  const AbsolutePath root_;
+  const uint64_t maximumBytes_;
+  const uint64_t minimumBlobSize_;
+  const std::shared_ptr<folly::Executor> writeExecutor_;
+  const uint64_t maximumPendingWriteBytes_;
+  folly::Synchronized<State> state_;
+};
+
+} // namespace facebook::eden
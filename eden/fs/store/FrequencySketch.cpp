@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/FrequencySketch.h"
+
+#include <folly/hash/Hash.h>
+#include <folly/lang/Bits.h>
+#include <algorithm>
+
+namespace facebook::eden {
+
+void FrequencySketch::ensureCapacity(size_t capacity) {
+  auto width = std::clamp(
+      folly::nextPowTwo(capacity) * kCountersPerKey,
+      kMinimumWidth,
+      kMaximumWidth);
+  if (width <= width_) {
+    return;
+  }
+
+  // A key's position in a row is its hash masked by the width, so counter j
+  // of a wider row covers a subset of the keys of counter j % width_ of the
+  // narrower one. Copying the counts over keeps every estimate an upper
+  // bound.
+  std::vector<uint64_t> table(kDepth * width / kCountersPerWord, 0);
+  for (size_t row = 0; row < kDepth && width_ != 0; ++row) {
+    for (size_t j = 0; j < width; ++j) {
+      uint64_t counter = getCounter(row * width_ + (j & (width_ - 1)));
+      auto index = row * width + j;
+      table[index / kCountersPerWord] |= counter
+          << ((index % kCountersPerWord) * 4);
+    }
+  }
+
+  table_ = std::move(table);
+  width_ = width;
+  sampleSize_ = 10 * width_ / kCountersPerKey;
+}
+
+size_t FrequencySketch::indexOf(uint64_t keyHash, size_t row) const {
+  // Callers may hand in hashes whose mix also picked a shard or a bucket, so
+  // remix them with a seed to get bits independent of those choices.
+  auto hash = folly::hash::hash_128_to_64(keyHash, 0x9e3779b97f4a7c15ull);
+  // Double hashing: one 64-bit hash gives an independent position in each
+  // row.
+  auto h1 = static_cast<uint32_t>(hash);
+  auto h2 = static_cast<uint32_t>(hash >> 32) | 1;
+  return row * width_ + ((h1 + row * h2) & (width_ - 1));
+}
+
+uint8_t FrequencySketch::getCounter(size_t index) const {
+  auto shift = (index % kCountersPerWord) * 4;
+  return (table_[index / kCountersPerWord] >> shift) & 0xf;
+}
+
+void FrequencySketch::increment(uint64_t keyHash) {
+  if (width_ == 0) {
+    ensureCapacity(kMinimumWidth);
+  }
+
+  bool added = false;
+  for (size_t row = 0; row < kDepth; ++row) {
+    auto index = indexOf(keyHash, row);
+    if (getCounter(index) < kMaximumFrequency) {
+      auto shift = (index % kCountersPerWord) * 4;
+      table_[index / kCountersPerWord] += uint64_t{1} << shift;
+      added = true;
+    }
+  }
+
+  if (added && ++additions_ >= sampleSize_) {
+    reset();
+  }
+}
+
+uint8_t FrequencySketch::frequency(uint64_t keyHash) const {
+  if (width_ == 0) {
+    return 0;
+  }
+
+  uint8_t frequency = kMaximumFrequency;
+  for (size_t row = 0; row < kDepth; ++row) {
+    frequency = std::min(frequency, getCounter(indexOf(keyHash, row)));
+  }
+  return frequency;
+}
+
+void FrequencySketch::reset() {
+  for (auto& word : table_) {
+    word = (word >> 1) & 0x7777777777777777ull;
+  }
+  additions_ /= 2;
+}
+
+} // namespace facebook::eden
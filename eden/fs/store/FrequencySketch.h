@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace facebook::eden {
+
+/**
+ * Approximate access counts of a set of keys, identified by a 64-bit hash,
+ * in a fixed amount of memory: a count-min sketch of 4-bit counters.
+ *
+ * Counts saturate at 15 and every counter is halved once the number of
+ * increments reaches ten times the capacity, so that the sketch reflects
+ * recent popularity rather than all-time popularity. Each row has 4 counters
+ * per key of capacity to keep collisions rare.
+ *
+ * Estimates never under-count, but may over-count when keys collide.
+ *
+ * This class is not thread-safe.
+ */
+class FrequencySketch {
+ public:
+  static constexpr uint8_t kMaximumFrequency = 15;
+
+  FrequencySketch() = default;
+
+  /**
+   * Make the sketch able to track about capacity keys without too many
+   * collisions. Counts recorded so far are kept. Never shrinks the sketch.
+   */
+  void ensureCapacity(size_t capacity);
+
+  /**
+   * Record an access to the key with the given hash.
+   */
+  void increment(uint64_t keyHash);
+
+  /**
+   * Returns the estimated number of recent accesses to the key with the given
+   * hash, at most kMaximumFrequency.
+   */
+  uint8_t frequency(uint64_t keyHash) const;
+
+  /**
+   * Returns the number of counters of each row of the sketch.
+   */
+  size_t getWidth() const {
+    return width_;
+  }
+
+ private:
+  static constexpr size_t kDepth = 4;
+  static constexpr size_t kCountersPerWord = 16;
+  static constexpr size_t kCountersPerKey = 4;
+  static constexpr size_t kMinimumWidth = 64;
+  static constexpr size_t kMaximumWidth = size_t{1} << 24;
+
+  /**
+   * Returns the position of the counter of row i for the key with the given
+   * hash, as an index into counters.
+   */
+  size_t indexOf(uint64_t keyHash, size_t row) const;
+
+  uint8_t getCounter(size_t index) const;
+
+  /**
+   * Halve every counter.
+   */
+  void reset();
+
+  /**
+   * kDepth rows of width_ counters each, packed 16 per word.
+   */
+  std::vector<uint64_t> table_;
+  size_t width_{0};
+  size_t additions_{0};
+  size_t sampleSize_{0};
+};
+
+} // namespace facebook::eden
@@ -0,0 +1,395 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/GroupCommitLocalStore.h"
+
+#include <folly/String.h>
+#include <folly/futures/Future.h>
+#include <folly/logging/xlog.h>
+#include <folly/stop_watch.h>
+#include <folly/system/ThreadName.h>
+
+#include "eden/fs/config/EdenConfig.h"
+#include "eden/fs/store/StoreResult.h"
+
+namespace facebook::eden {
+
+using folly::StringPiece;
+
+namespace {
+/**
+ * Queued writes may take up to this many batches worth of memory before
+ * writers are paused.
+ */
+constexpr size_t kMaximumQueuedBatches = 4;
+
+class GroupCommitWriteBatch : public LocalStore::WriteBatch {
+ public:
+  GroupCommitWriteBatch(GroupCommitLocalStore* store, size_t bufSize)
+      : store_(store), bufSize_(bufSize) {}
+
+  void put(KeySpace keySpace, folly::ByteRange key, folly::ByteRange value)
+      override {
+    bufferedBytes_ += key.size() + value.size();
+    writes_.push_back(GroupCommitLocalStore::Write{
+        keySpace, StringPiece{key}.str(), StringPiece{value}.str()});
+    if (bufSize_ > 0 && bufferedBytes_ >= bufSize_) {
+      flush();
+    }
+  }
+
+  void put(
+      KeySpace keySpace,
+      folly::ByteRange key,
+      std::vector<folly::ByteRange> valueSlices) override {
+    std::string value;
+    for (const auto& slice : valueSlices) {
+      value.append(reinterpret_cast<const char*>(slice.data()), slice.size());
+    }
+    put(keySpace, key, StringPiece{value});
+  }
+
+  void flush() override {
+    bufferedBytes_ = 0;
+    store_->enqueue(std::move(writes_));
+    writes_.clear();
+  }
+
+ private:
+  GroupCommitLocalStore* store_;
+  size_t bufSize_;
+  size_t bufferedBytes_{0};
+  std::vector<GroupCommitLocalStore::Write> writes_;
+};
+} // namespace
+
+GroupCommitLocalStore::GroupCommitLocalStore(
+    std::shared_ptr<LocalStore> store,
+    size_t batchBytes,
+    std::chrono::nanoseconds batchInterval,
+    EdenStatsPtr stats)
+    : store_{std::move(store)},
+      batchBytes_{batchBytes},
+      batchInterval_{batchInterval},
+      stats_{std::move(stats)} {
+  enableBlobCaching.store(
+      store_->enableBlobCaching.load(std::memory_order_relaxed),
+      std::memory_order_relaxed);
+  blobCachingSizeLimit.store(
+      store_->blobCachingSizeLimit.load(std::memory_order_relaxed),
+      std::memory_order_relaxed);
+
+  {
+    auto state = state_.lock();
+    state->waiting.resize(KeySpace::kTotalCount);
+    state->inflight.resize(KeySpace::kTotalCount);
+  }
+
+  workerThread_ = std::thread{[this] {
+    folly::setThreadName("LocalStoreWriter");
+    processOnWorkerThread();
+  }};
+}
+
+GroupCommitLocalStore::GroupCommitLocalStore(
+    std::shared_ptr<LocalStore> store,
+    const EdenConfig& config,
+    EdenStatsPtr stats)
+    : GroupCommitLocalStore{
+          std::move(store),
+          config.localStoreGroupCommitBatchBytes.getValue(),
+          config.localStoreGroupCommitInterval.getValue(),
+          std::move(stats)} {}
+
+GroupCommitLocalStore::~GroupCommitLocalStore() {
+  stopWorkerThread();
+}
+
+void GroupCommitLocalStore::stopWorkerThread() {
+  // Check first that the thread is still running, so that this can be called
+  // both from close() and from the destructor.
+  if (!workerThread_.joinable()) {
+    return;
+  }
+
+  state_.lock()->stopRequested = true;
+  workCV_.notify_one();
+  doneCV_.notify_all();
+  workerThread_.join();
+}
+
+void GroupCommitLocalStore::open() {
+  store_->open();
+}
+
+void GroupCommitLocalStore::close() {
+  stopWorkerThread();
+  store_->close();
+}
+
+void GroupCommitLocalStore::clearKeySpace(KeySpace keySpace) {
+  {
+    auto state = state_.lock();
+    auto& waiting = state->waiting[keySpace->index];
+    for (const auto& [key, value] : waiting) {
+      state->waitingBytes -= key.size() + value.size();
+    }
+    state->waitingCount -= waiting.size();
+    waiting.clear();
+  }
+  // The writer thread may be committing values of this KeySpace.
+  flush();
+  store_->clearKeySpace(keySpace);
+}
+
+void GroupCommitLocalStore::compactKeySpace(KeySpace keySpace) {
+  store_->compactKeySpace(keySpace);
+}
+
+const std::string* GroupCommitLocalStore::findPending(
+    const State& state,
+    KeySpace keySpace,
+    folly::ByteRange key) {
+  auto keyStr = StringPiece{key};
+  for (const auto* maps : {&state.waiting, &state.inflight}) {
+    const auto& pending = (*maps)[keySpace->index];
+    if (auto it = pending.find(keyStr); it != pending.end()) {
+      return &it->second;
+    }
+  }
+  return nullptr;
+}
+
+StoreResult GroupCommitLocalStore::get(KeySpace keySpace, folly::ByteRange key)
+    const {
+  {
+    auto state = state_.lock();
+    if (auto* value = findPending(*state, keySpace, key)) {
+      return StoreResult(std::string(*value));
+    }
+  }
+  return store_->get(keySpace, key);
+}
+
+folly::Future<std::vector<StoreResult>> GroupCommitLocalStore::getBatch(
+    KeySpace keySpace,
+    const std::vector<folly::ByteRange>& keys) const {
+  std::vector<std::optional<StoreResult>> pending;
+  std::vector<folly::ByteRange> missingKeys;
+  pending.reserve(keys.size());
+  {
+    auto state = state_.lock();
+    for (const auto& key : keys) {
+      if (auto* value = findPending(*state, keySpace, key)) {
+        pending.emplace_back(StoreResult(std::string(*value)));
+      } else {
+        pending.emplace_back(std::nullopt);
+        missingKeys.push_back(key);
+      }
+    }
+  }
+
+  if (missingKeys.empty()) {
+    std::vector<StoreResult> results;
+    results.reserve(keys.size());
+    for (auto& result : pending) {
+      results.push_back(std::move(*result));
+    }
+    return folly::makeFuture(std::move(results));
+  }
+
+  return store_->getBatch(keySpace, missingKeys)
+      .thenValue([pending = std::move(pending)](
+                     std::vector<StoreResult>&& fetched) mutable {
+        std::vector<StoreResult> results;
+        results.reserve(pending.size());
+        auto fetchedIt = fetched.begin();
+        for (auto& result : pending) {
+          if (result.has_value()) {
+            results.push_back(std::move(*result));
+          } else {
+            results.push_back(std::move(*fetchedIt++));
+          }
+        }
+        return results;
+      });
+}
+
+bool GroupCommitLocalStore::hasKey(KeySpace keySpace, folly::ByteRange key)
+    const {
+  if (findPending(*state_.lock(), keySpace, key)) {
+    return true;
+  }
+  return store_->hasKey(keySpace, key);
+}
+
+void GroupCommitLocalStore::put(
+    KeySpace keySpace,
+    folly::ByteRange key,
+    folly::ByteRange value) {
+  std::vector<Write> writes;
+  writes.push_back(
+      Write{keySpace, StringPiece{key}.str(), StringPiece{value}.str()});
+  enqueue(std::move(writes));
+}
+
+std::unique_ptr<LocalStore::WriteBatch> GroupCommitLocalStore::beginWrite(
+    size_t bufSize) {
+  return std::make_unique<GroupCommitWriteBatch>(this, bufSize);
+}
+
+void GroupCommitLocalStore::periodicManagementTask(const EdenConfig& config) {
+  store_->periodicManagementTask(config);
+  // The wrapped store may decide to stop caching blobs, and the blob caching
+  // decision is made by the LocalStore receiving putBlob, that is this one.
+  enableBlobCaching.store(
+      store_->enableBlobCaching.load(std::memory_order_relaxed),
+      std::memory_order_relaxed);
+}
+
+void GroupCommitLocalStore::flush() {
+  auto state = state_.lock();
+  auto target = state->waitingCount > 0 ? state->nextBatch
+                                        : state->nextBatch - 1;
+  if (state->writtenBatch >= target) {
+    return;
+  }
+  state->flushRequested = true;
+  workCV_.notify_one();
+  // The writer thread commits every queued write before exiting, so this
+  // terminates even if the store is concurrently closed.
+  doneCV_.wait(
+      state.as_lock(), [&] { return state->writtenBatch >= target; });
+}
+
+void GroupCommitLocalStore::enqueue(std::vector<Write> writes) {
+  if (writes.empty()) {
+    return;
+  }
+
+  auto state = state_.lock();
+  doneCV_.wait(state.as_lock(), [&] {
+    return state->waitingBytes < kMaximumQueuedBatches * batchBytes_ ||
+        state->stopRequested;
+  });
+
+  if (state->stopRequested) {
+    // The writer thread is gone, write directly to the store.
+    state.unlock();
+    auto batch = store_->beginWrite();
+    for (const auto& write : writes) {
+      batch->put(
+          write.keySpace, StringPiece{write.key}, StringPiece{write.value});
+    }
+    batch->flush();
+    return;
+  }
+
+  bool wasEmpty = state->waitingCount == 0;
+  if (wasEmpty) {
+    state->oldestWaiting = std::chrono::steady_clock::now();
+  }
+  for (auto& write : writes) {
+    auto bytes = write.key.size() + write.value.size();
+    auto& waiting = state->waiting[write.keySpace->index];
+    auto [it, inserted] = waiting.try_emplace(std::move(write.key));
+    if (inserted) {
+      ++state->waitingCount;
+    } else {
+      state->waitingBytes -= it->first.size() + it->second.size();
+    }
+    it->second = std::move(write.value);
+    state->waitingBytes += bytes;
+  }
+
+  // The writer thread only needs to be woken up to arm its timer, or when a
+  // batch is full.
+  if (wasEmpty || state->waitingBytes >= batchBytes_) {
+    workCV_.notify_one();
+  }
+}
+
+void GroupCommitLocalStore::processOnWorkerThread() {
+  for (;;) {
+    const PendingMaps* batch;
+    size_t count;
+    size_t bytes;
+    uint64_t batchNumber;
+
+    {
+      auto state = state_.lock();
+      for (;;) {
+        if (state->waitingCount == 0) {
+          state->flushRequested = false;
+          if (state->stopRequested) {
+            return;
+          }
+          workCV_.wait(state.as_lock());
+          continue;
+        }
+
+        auto deadline = state->oldestWaiting + batchInterval_;
+        if (state->stopRequested || state->flushRequested ||
+            state->waitingBytes >= batchBytes_ ||
+            std::chrono::steady_clock::now() >= deadline) {
+          break;
+        }
+        workCV_.wait_until(state.as_lock(), deadline);
+      }
+
+      // inflight was emptied after the previous batch was committed.
+      std::swap(state->waiting, state->inflight);
+      batch = &state->inflight;
+      count = std::exchange(state->waitingCount, 0);
+      bytes = std::exchange(state->waitingBytes, 0);
+      batchNumber = state->nextBatch++;
+      state->flushRequested = false;
+    }
+    // Writers paused for queue space can now proceed.
+    doneCV_.notify_all();
+
+    // inflight is only modified by this thread, so it can be read without
+    // holding the lock.
+    writeBatch(*batch, count, bytes);
+
+    {
+      auto state = state_.lock();
+      for (auto& pending : state->inflight) {
+        pending.clear();
+      }
+      state->writtenBatch = batchNumber;
+    }
+    doneCV_.notify_all();
+  }
+}
+
+void GroupCommitLocalStore::writeBatch(
+    const PendingMaps& batch,
+    size_t count,
+    size_t bytes) {
+  folly::stop_watch<std::chrono::microseconds> watch;
+  try {
+    auto writeBatch = store_->beginWrite();
+    for (const auto& ks : KeySpace::kAll) {
+      for (const auto& [key, value] : batch[ks->index]) {
+        writeBatch->put(ks, StringPiece{key}, StringPiece{value});
+      }
+    }
+    writeBatch->flush();
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Failed to commit a batch of " << count
+              << " LocalStore writes: " << folly::exceptionStr(ex);
+    stats_->increment(&LocalStoreStats::groupCommitWriteFailure);
+    return;
+  }
+
+  stats_->addDuration(&LocalStoreStats::groupCommitWrite, watch.elapsed());
+  stats_->increment(&LocalStoreStats::groupCommitBatchSize, count);
+  stats_->increment(&LocalStoreStats::groupCommitBatchBytes, bytes);
+}
+
+} // namespace facebook::eden
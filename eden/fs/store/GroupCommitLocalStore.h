@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "eden/fs/store/LocalStore.h"
+#include "eden/fs/telemetry/EdenStats.h"
+
+namespace facebook::eden {
+
+class EdenConfig;
+
+/**
+ * A LocalStore that funnels the writes of every thread through a single
+ * writer thread, which commits them to the wrapped LocalStore in large
+ * batches.
+ *
+ * Importing a tree or a blob writes a handful of small values to the
+ * LocalStore. Committing each of them separately from every import thread
+ * makes the threads contend on the underlying database's write lock and pay
+ * its per-commit overhead for every object. Here, writes are only queued,
+ * and a batch is committed once the queued values reach batchBytes, or
+ * batchInterval after the oldest of them was queued, whichever comes first.
+ *
+ * Until a value is committed, it is served from the queue, so readers always
+ * see the writes that were made before, from any thread.
+ *
+ * A value whose batch failed to commit is dropped: the LocalStore is a cache
+ * and the object will be fetched again from the backing store.
+ */
+class GroupCommitLocalStore final : public LocalStore {
+ public:
+  GroupCommitLocalStore(
+      std::shared_ptr<LocalStore> store,
+      size_t batchBytes,
+      std::chrono::nanoseconds batchInterval,
+      EdenStatsPtr stats);
+
+  GroupCommitLocalStore(
+      std::shared_ptr<LocalStore> store,
+      const EdenConfig& config,
+      EdenStatsPtr stats);
+
+  ~GroupCommitLocalStore() override;
+
+  void open() override;
+
+  /**
+   * Commit every queued write, stop the writer thread and close the wrapped
+   * store. Writes made after this are forwarded to the wrapped store.
+   */
+  void close() override;
+
+  void clearKeySpace(KeySpace keySpace) override;
+  void compactKeySpace(KeySpace keySpace) override;
+  StoreResult get(KeySpace keySpace, folly::ByteRange key) const override;
+  folly::Future<std::vector<StoreResult>> getBatch(
+      KeySpace keySpace,
+      const std::vector<folly::ByteRange>& keys) const override;
+  bool hasKey(KeySpace keySpace, folly::ByteRange key) const override;
+  void put(KeySpace keySpace, folly::ByteRange key, folly::ByteRange value)
+      override;
+  std::unique_ptr<LocalStore::WriteBatch> beginWrite(
+      size_t bufSize = 0) override;
+  void periodicManagementTask(const EdenConfig& config) override;
+
+  /**
+   * Wait until every write queued before this call has been committed to the
+   * wrapped store.
+   */
+  void flush();
+
+  struct Write {
+    KeySpace keySpace;
+    std::string key;
+    std::string value;
+  };
+
+  /**
+   * Queue writes for the writer thread. Blocks while too many bytes are
+   * already queued.
+   */
+  void enqueue(std::vector<Write> writes);
+
+ private:
+  /**
+   * Pending values indexed by KeySpace index, then by key.
+   */
+  using PendingMaps = std::vector<folly::F14NodeMap<std::string, std::string>>;
+
+  struct State {
+    /**
+     * Writes that the writer thread has not picked up yet. A newer write of
+     * a key replaces the older one.
+     */
+    PendingMaps waiting;
+    size_t waitingBytes{0};
+    size_t waitingCount{0};
+    std::chrono::steady_clock::time_point oldestWaiting;
+
+    /**
+     * Writes currently being committed by the writer thread. Only modified by
+     * the writer thread, which can thus read it without holding the lock.
+     */
+    PendingMaps inflight;
+
+    /**
+     * Batches are numbered in order. waiting will be committed as batch
+     * nextBatch, and every batch up to writtenBatch has been committed.
+     */
+    uint64_t nextBatch{1};
+    uint64_t writtenBatch{0};
+
+    bool flushRequested{false};
+    bool stopRequested{false};
+  };
+
+  /**
+   * Returns the pending value of key, if any, looking at the most recent
+   * writes first. Must be called with the state locked.
+   */
+  static const std::string*
+  findPending(const State& state, KeySpace keySpace, folly::ByteRange key);
+
+  void processOnWorkerThread();
+  void writeBatch(const PendingMaps& batch, size_t count, size_t bytes);
+  void stopWorkerThread();
+
+  std::shared_ptr<LocalStore> store_;
+  const size_t batchBytes_;
+  const std::chrono::nanoseconds batchInterval_;
+  EdenStatsPtr stats_;
+
+  folly::Synchronized<State, std::mutex> state_;
+
+  /**
+   * Signaled when writes are queued, a flush is requested or the writer
+   * thread must stop.
+   */
+  std::condition_variable workCV_;
+
+  /**
+   * Signaled when the writer thread picks up or commits a batch, for threads
+   * waiting for queue space or for a flush.
+   */
+  std::condition_variable doneCV_;
+
+  std::thread workerThread_;
+};
+
+} // namespace facebook::eden
@@ -55,6 +55,23 @@ class IObjectStore {
       const ObjectId& id,
       const ObjectFetchContextPtr& context) const = 0;
 
+  /**
+   * Whether getBlobRange() avoids loading the whole blob with this id. When
+   * it does not, callers needing several ranges of the blob should use
+   * getBlob() instead.
+   */
+  virtual bool supportsBlobRange(const ObjectId& id) const = 0;
+
+  /**
+   * Return up to length bytes of the blob starting at offset, without
+   * necessarily loading the whole blob into memory.
+   */
+  virtual ImmediateFuture<std::shared_ptr<const Blob>> getBlobRange(
+      const ObjectId& id,
+      uint64_t offset,
+      uint64_t length,
+      const ObjectFetchContextPtr& context) const = 0;
+
   /**
    * Prefetch all the blobs represented by the HashRange.
    *
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <folly/executors/QueuedImmediateExecutor.h>
+#include <folly/futures/Future.h>
+#include <folly/futures/SharedPromise.h>
+#include <memory>
+#include <utility>
+
+#include "eden/fs/model/ObjectId.h"
+
+namespace facebook::eden {
+
+/**
+ * Tracks the fetches that are currently in flight, keyed by ObjectId, so that
+ * concurrent requests for the same object share a single fetch instead of
+ * each doing their own.
+ *
+ * Entries only live as long as their fetch: once it completes, the result is
+ * handed to every waiter and forgotten. Caching results is left to the
+ * caller.
+ *
+ * Result must be copyable, as every waiter receives its own copy.
+ *
+ * It is safe to use this object from arbitrary threads.
+ */
+template <typename Result>
+class InFlightFetchTable {
+ public:
+  struct GetResult {
+    folly::SemiFuture<Result> future;
+    /**
+     * True if the request joined a fetch that was already in flight, false
+     * if it started a new one.
+     */
+    bool joined;
+  };
+
+  /**
+   * If a fetch of id is in flight, return a future for its result without
+   * calling fetch. Otherwise, start one by calling fetch, which must return a
+   * SemiFuture<Result>, and share its result with every caller asking for id
+   * until it completes.
+   *
+   * The fetch is driven to completion even if the caller that started it
+   * drops its future, so that other waiters are not left hanging.
+   */
+  template <typename Fetch>
+  GetResult getOrFetch(const ObjectId& id, Fetch&& fetch) {
+    std::shared_ptr<folly::SharedPromise<Result>> promise;
+    {
+      auto fetches = fetches_->wlock();
+      auto [it, inserted] = fetches->try_emplace(id);
+      if (!inserted) {
+        return GetResult{it->second->getSemiFuture(), true};
+      }
+      promise = it->second =
+          std::make_shared<folly::SharedPromise<Result>>();
+    }
+
+    auto future = promise->getSemiFuture();
+    folly::makeSemiFutureWith(std::forward<Fetch>(fetch))
+        .via(&folly::QueuedImmediateExecutor::instance())
+        .thenTry([fetches = fetches_, id, promise = std::move(promise)](
+                     folly::Try<Result>&& result) {
+          // Forget the fetch before fulfilling it: waiters that arrive from
+          // now on must not get a future that will never complete.
+          fetches->wlock()->erase(id);
+          promise->setTry(std::move(result));
+        });
+    return GetResult{std::move(future), false};
+  }
+
+  /**
+   * Returns the number of fetches currently in flight.
+   */
+  size_t size() const {
+    return fetches_->rlock()->size();
+  }
+
+ private:
+  using Map = folly::F14NodeMap<
+      ObjectId,
+      std::shared_ptr<folly::SharedPromise<Result>>>;
+
+  // Shared with the fetch callbacks, which may outlive this table.
+  std::shared_ptr<folly::Synchronized<Map>> fetches_ =
+      std::make_shared<folly::Synchronized<Map>>();
+};
+
+} // namespace facebook::eden
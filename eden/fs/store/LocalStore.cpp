@@ -131,6 +131,22 @@ ImmediateFuture<std::unique_ptr<BlobMetadata>> LocalStore::getBlobMetadata(
       });
 }
 
+ImmediateFuture<std::optional<Hash32>> LocalStore::getBlobBlake3(
+    const ObjectId& id) const {
+  return makeImmediateFutureWith([&] {
+           auto key = SerializedBlobMetadata::blake3Key(id);
+           return get(
+               KeySpace::BlobMetaDataFamily,
+               folly::ByteRange{folly::StringPiece{key}});
+         })
+      .thenValue([id](StoreResult&& data) -> std::optional<Hash32> {
+        if (!data.isValid()) {
+          return std::nullopt;
+        }
+        return SerializedBlobMetadata::parseBlake3(id, data);
+      });
+}
+
 folly::IOBuf LocalStore::serializeTree(const Tree& tree) {
   return tree.serialize();
 }
@@ -157,6 +173,9 @@ void LocalStore::putBlob(const ObjectId& id, const Blob* blob) {
   if (!enableBlobCaching) {
     XLOG(DBG8) << "Skipping caching " << id
                << " because blob cache is disabled via config";
+  } else if (blob->getSize() >= blobCachingSizeLimit) {
+    XLOG(DBG8) << "Skipping caching " << id << " because it is too large ("
+               << blob->getSize() << " bytes)";
   } else {
     // Since blob serialization is moderately complex, just delegate
     // the immediate putBlob to the method on the WriteBatch.
@@ -176,6 +195,16 @@ void LocalStore::putBlobMetadata(
   SerializedBlobMetadata metadataBytes(metadata);
 
   put(KeySpace::BlobMetaDataFamily, hashBytes, metadataBytes.slice());
+  if (metadata.blake3) {
+    putBlobBlake3(id, *metadata.blake3);
+  }
+}
+
+void LocalStore::putBlobBlake3(const ObjectId& id, const Hash32& blake3) {
+  auto key = SerializedBlobMetadata::blake3Key(id);
+  put(KeySpace::BlobMetaDataFamily,
+      folly::ByteRange{folly::StringPiece{key}},
+      blake3.getBytes());
 }
 
 void LocalStore::WriteBatch::putBlobMetadata(
@@ -185,6 +214,12 @@ void LocalStore::WriteBatch::putBlobMetadata(
   SerializedBlobMetadata metadataBytes(metadata);
 
   put(KeySpace::BlobMetaDataFamily, hashBytes, metadataBytes.slice());
+  if (metadata.blake3) {
+    auto key = SerializedBlobMetadata::blake3Key(id);
+    put(KeySpace::BlobMetaDataFamily,
+        folly::ByteRange{folly::StringPiece{key}},
+        metadata.blake3->getBytes());
+  }
 }
 
 void LocalStore::put(
@@ -9,6 +9,7 @@
 
 #include <folly/Range.h>
 #include <atomic>
+#include <limits>
 #include <memory>
 #include <optional>
 #include "eden/fs/model/BlobMetadata.h"
@@ -152,6 +153,15 @@ class LocalStore : public std::enable_shared_from_this<LocalStore> {
   ImmediateFuture<std::unique_ptr<BlobMetadata>> getBlobMetadata(
       const ObjectId& id) const;
 
+  /**
+   * Get the BLAKE3 hash of a blob stored by putBlobBlake3().
+   *
+   * Returns std::nullopt if it is not present in the store. getBlobMetadata()
+   * does not look it up.
+   */
+  ImmediateFuture<std::optional<Hash32>> getBlobBlake3(
+      const ObjectId& id) const;
+
   /**
    * Test whether the key is stored.
    */
@@ -169,10 +179,16 @@ class LocalStore : public std::enable_shared_from_this<LocalStore> {
   void putBlob(const ObjectId& id, const Blob* blob);
 
   /**
-   * Store a blob metadata.
+   * Store a blob metadata, along with its BLAKE3 hash if known.
    */
   void putBlobMetadata(const ObjectId& id, const BlobMetadata& metadata);
 
+  /**
+   * Store the BLAKE3 hash of a blob, which is kept apart from the rest of
+   * its metadata. See SerializedBlobMetadata::blake3Key().
+   */
+  void putBlobBlake3(const ObjectId& id, const Hash32& blake3);
+
   /**
    * Put arbitrary data in the store.
    */
@@ -267,6 +283,14 @@ class LocalStore : public std::enable_shared_from_this<LocalStore> {
    */
   std::atomic<bool> enableBlobCaching = true;
 
+  /**
+   * Blobs at least this large are not written to the store. Lowered when a
+   * DiskBlobCache takes care of large blobs, to spare the store the compaction
+   * cost of large values.
+   */
+  std::atomic<uint64_t> blobCachingSizeLimit =
+      std::numeric_limits<uint64_t>::max();
+
  private:
   /**
    * Compute the serialized version of the tree in a (not coalesced) IOBuf.
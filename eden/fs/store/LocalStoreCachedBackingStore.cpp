@@ -8,6 +8,7 @@
 #include "eden/fs/store/LocalStoreCachedBackingStore.h"
 #include "eden/fs/model/Blob.h"
 #include "eden/fs/model/Tree.h"
+#include "eden/fs/store/BlobHasher.h"
 #include "eden/fs/store/LocalStore.h"
 #include "eden/fs/telemetry/EdenStats.h"
 #include "eden/fs/utils/ImmediateFuture.h"
@@ -139,8 +140,7 @@ LocalStoreCachedBackingStore::getBlobMetadata(
 
                         return GetBlobMetaResult{
                             std::make_unique<BlobMetadata>(
-                                Hash20::sha1(result.blob->getContents()),
-                                result.blob->getSize()),
+                                BlobHasher::computeMetadata(*result.blob)),
                             result.origin};
                       });
                 })
@@ -6,6 +6,7 @@
  */
 
 #include <folly/MapUtil.h>
+#include <folly/hash/Hash.h>
 #include <folly/logging/xlog.h>
 #include <utility>
 
@@ -61,20 +62,55 @@ template <typename ObjectType, ObjectCacheFlavor Flavor>
 std::shared_ptr<ObjectCache<ObjectType, Flavor>>
 ObjectCache<ObjectType, Flavor>::create(
     size_t maximumCacheSizeBytes,
-    size_t minimumEntryCount) {
+    size_t minimumEntryCount,
+    size_t numShards,
+    ObjectCachePolicy policy) {
   // Allow make_shared with private constructor.
   struct OC : ObjectCache<ObjectType, Flavor> {
-    OC(size_t x, size_t y) : ObjectCache<ObjectType, Flavor>{x, y} {}
+    OC(size_t x, size_t y, size_t z, ObjectCachePolicy p)
+        : ObjectCache<ObjectType, Flavor>{x, y, z, p} {}
   };
-  return std::make_shared<OC>(maximumCacheSizeBytes, minimumEntryCount);
+  return std::make_shared<OC>(
+      maximumCacheSizeBytes, minimumEntryCount, numShards, policy);
 }
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 ObjectCache<ObjectType, Flavor>::ObjectCache(
     size_t maximumCacheSizeBytes,
-    size_t minimumEntryCount)
-    : maximumCacheSizeBytes_{maximumCacheSizeBytes},
-      minimumEntryCount_{minimumEntryCount} {}
+    size_t minimumEntryCount,
+    size_t numShards,
+    ObjectCachePolicy policy)
+    : shards_(std::max(numShards, size_t{1})),
+      shardMaximumCacheSizeBytes_{maximumCacheSizeBytes / shards_.size()},
+      // Round up so that the cache as a whole keeps at least
+      // minimumEntryCount entries.
+      shardMinimumEntryCount_{
+          (minimumEntryCount + shards_.size() - 1) / shards_.size()},
+      policy_{policy},
+      // The proportions suggested by the W-TinyLFU paper: a window of 1% of
+      // the cache, and 80% of the main space protected.
+      shardWindowMaximumSizeBytes_{shardMaximumCacheSizeBytes_ / 100},
+      shardProtectedMaximumSizeBytes_{
+          (shardMaximumCacheSizeBytes_ - shardWindowMaximumSizeBytes_) / 5 *
+          4} {}
+
+template <typename ObjectType, ObjectCacheFlavor Flavor>
+typename ObjectCache<ObjectType, Flavor>::Shard&
+ObjectCache<ObjectType, Flavor>::getShard(const ObjectId& hash) {
+  if (shards_.size() == 1) {
+    return shards_[0];
+  }
+  // ObjectId::getHashCode returns raw hash bytes which F14 also consumes, mix
+  // them so the shard choice is independent of the in-shard bucket.
+  auto index = folly::hash::twang_mix64(hash.getHashCode()) % shards_.size();
+  return shards_[index];
+}
+
+template <typename ObjectType, ObjectCacheFlavor Flavor>
+const typename ObjectCache<ObjectType, Flavor>::Shard&
+ObjectCache<ObjectType, Flavor>::getShard(const ObjectId& hash) const {
+  return const_cast<ObjectCache<ObjectType, Flavor>*>(this)->getShard(hash);
+}
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 template <ObjectCacheFlavor F>
@@ -90,7 +126,7 @@ ObjectCache<ObjectType, Flavor>::getInterestHandle(
   // runs after the lock is released.
   ObjectInterestHandle<ObjectType> interestHandle;
 
-  auto state = state_.lock();
+  auto state = getShard(hash).state.lock();
 
   auto item = getImpl(hash, *state);
   if (!item) {
@@ -129,7 +165,7 @@ typename std::enable_if_t<
     typename ObjectCache<ObjectType, Flavor>::ObjectPtr>
 ObjectCache<ObjectType, Flavor>::getSimple(const ObjectId& hash) {
   XLOG(DBG6) << "BlobCache::getSimple " << hash;
-  auto state = state_.lock();
+  auto state = getShard(hash).state.lock();
 
   if (auto item = getImpl(hash, *state)) {
     return item->object;
@@ -151,10 +187,7 @@ ObjectCache<ObjectType, Flavor>::getImpl(const ObjectId& hash, State& state) {
 
     // TODO: Should we avoid promoting if interest is UnlikelyNeededAgain?
     // For now, we'll try not to be too clever.
-    state.evictionQueue.splice(
-        state.evictionQueue.end(),
-        state.evictionQueue,
-        state.evictionQueue.iterator_to(*item));
+    promote(state, *item);
     ++state.hitCount;
   }
 
@@ -190,8 +223,13 @@ ObjectCache<ObjectType, Flavor>::insertInterestHandle(
 
   XLOG(DBG6) << "  creating entry with generation=" << cacheItemGeneration;
 
-  auto state = state_.lock();
+  auto state = getShard(object->getHash()).state.lock();
   auto [item, inserted] = insertImpl(std::move(object), *state);
+  if (!item) {
+    // Evicted right away, being larger than the whole cache. There is no
+    // entry to reference.
+    return interestHandle;
+  }
   switch (interest) {
     case Interest::UnlikelyNeededAgain:
       break;
@@ -219,7 +257,7 @@ typename std::enable_if_t<F == ObjectCacheFlavor::Simple, void>
 ObjectCache<ObjectType, Flavor>::insertSimple(
     ObjectCache<ObjectType, Flavor>::ObjectPtr object) {
   XLOG(DBG6) << "ObjectCache::insertSimple " << object->getHash();
-  auto state = state_.lock();
+  auto state = getShard(object->getHash()).state.lock();
   insertImpl(std::move(object), *state);
 }
 
@@ -233,54 +271,138 @@ ObjectCache<ObjectType, Flavor>::insertImpl(ObjectPtr object, State& state) {
 
   // the following should be no except
 
-  auto [iter, inserted] =
-      state.items.try_emplace(std::move(hash), std::move(object));
+  auto [iter, inserted] = state.items.try_emplace(hash, std::move(object));
 
   auto* itemPtr = &iter->second;
   if (inserted) {
     try {
-      state.evictionQueue.push_back(*itemPtr);
+      if (policy_ == ObjectCachePolicy::TinyLFU) {
+        state.sketch.ensureCapacity(state.items.size());
+        itemPtr->segment = Segment::Window;
+        state.windowQueue.push_back(*itemPtr);
+      } else {
+        state.evictionQueue.push_back(*itemPtr);
+      }
     } catch (const std::exception&) {
       state.items.erase(iter);
       throw;
     }
+    if (policy_ == ObjectCachePolicy::TinyLFU) {
+      state.sketch.increment(hash.getHashCode());
+      state.windowSize += size;
+    }
     state.totalSize += size;
     evictUntilFits(state);
+    if (policy_ == ObjectCachePolicy::TinyLFU) {
+      // The new entry may have been evicted right away if it is larger than
+      // the whole shard.
+      itemPtr = folly::get_ptr(state.items, hash);
+    }
   } else {
+    promote(state, *itemPtr);
+  }
+  return std::make_pair(itemPtr, inserted);
+}
+
+template <typename ObjectType, ObjectCacheFlavor Flavor>
+void ObjectCache<ObjectType, Flavor>::promote(
+    State& state,
+    CacheItem& item) noexcept {
+  if (policy_ == ObjectCachePolicy::LRU) {
     state.evictionQueue.splice(
         state.evictionQueue.end(),
         state.evictionQueue,
-        state.evictionQueue.iterator_to(*itemPtr));
+        state.evictionQueue.iterator_to(item));
+    return;
+  }
+
+  state.sketch.increment(item.object->getHash().getHashCode());
+  switch (item.segment) {
+    case Segment::Window:
+      state.windowQueue.splice(
+          state.windowQueue.end(),
+          state.windowQueue,
+          state.windowQueue.iterator_to(item));
+      break;
+    case Segment::Probation: {
+      // Accessed again since its admission, protect it. Make room by moving
+      // the least recently used protected entries back to probation.
+      state.evictionQueue.erase(state.evictionQueue.iterator_to(item));
+      item.segment = Segment::Protected;
+      state.protectedQueue.push_back(item);
+      state.protectedSize += item.object->getSizeBytes();
+      while (state.protectedSize > shardProtectedMaximumSizeBytes_ &&
+             state.protectedQueue.size() > 1) {
+        auto& demoted = state.protectedQueue.front();
+        state.protectedQueue.pop_front();
+        state.protectedSize -= demoted.object->getSizeBytes();
+        demoted.segment = Segment::Probation;
+        state.evictionQueue.push_back(demoted);
+      }
+      break;
+    }
+    case Segment::Protected:
+      state.protectedQueue.splice(
+          state.protectedQueue.end(),
+          state.protectedQueue,
+          state.protectedQueue.iterator_to(item));
+      break;
+  }
+}
+
+template <typename ObjectType, ObjectCacheFlavor Flavor>
+void ObjectCache<ObjectType, Flavor>::unlink(
+    State& state,
+    CacheItem& item) noexcept {
+  switch (item.segment) {
+    case Segment::Window:
+      state.windowQueue.erase(state.windowQueue.iterator_to(item));
+      state.windowSize -= item.object->getSizeBytes();
+      break;
+    case Segment::Probation:
+      state.evictionQueue.erase(state.evictionQueue.iterator_to(item));
+      break;
+    case Segment::Protected:
+      state.protectedQueue.erase(state.protectedQueue.iterator_to(item));
+      state.protectedSize -= item.object->getSizeBytes();
+      break;
   }
-  return std::make_pair(itemPtr, inserted);
 }
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 bool ObjectCache<ObjectType, Flavor>::contains(const ObjectId& hash) const {
-  auto state = state_.lock();
+  auto state = getShard(hash).state.lock();
   return 1 == state->items.count(hash);
 }
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 void ObjectCache<ObjectType, Flavor>::clear() {
   XLOG(DBG6) << "ObjectCache::clear";
-  auto state = state_.lock();
-  state->totalSize = 0;
-  state->evictionQueue.clear();
-  state->items.clear();
+  for (auto& shard : shards_) {
+    auto state = shard.state.lock();
+    state->totalSize = 0;
+    state->evictionQueue.clear();
+    state->windowQueue.clear();
+    state->windowSize = 0;
+    state->protectedQueue.clear();
+    state->protectedSize = 0;
+    state->items.clear();
+  }
 }
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 typename ObjectCache<ObjectType, Flavor>::Stats
 ObjectCache<ObjectType, Flavor>::getStats() const {
-  auto state = state_.lock();
   Stats stats;
-  stats.objectCount = state->items.size();
-  stats.totalSizeInBytes = state->totalSize;
-  stats.hitCount = state->hitCount;
-  stats.missCount = state->missCount;
-  stats.evictionCount = state->evictionCount;
-  stats.dropCount = state->dropCount;
+  for (const auto& shard : shards_) {
+    auto state = shard.state.lock();
+    stats.objectCount += state->items.size();
+    stats.totalSizeInBytes += state->totalSize;
+    stats.hitCount += state->hitCount;
+    stats.missCount += state->missCount;
+    stats.evictionCount += state->evictionCount;
+    stats.dropCount += state->dropCount;
+  }
   return stats;
 }
 
@@ -289,7 +411,7 @@ void ObjectCache<ObjectType, Flavor>::dropInterestHandle(
     const ObjectId& hash,
     uint64_t generation) noexcept {
   XLOG(DBG6) << "dropInterestHandle " << hash << " generation=" << generation;
-  auto state = state_.lock();
+  auto state = getShard(hash).state.lock();
 
   auto* item = folly::get_ptr(state->items, hash);
   if (!item) {
@@ -311,7 +433,7 @@ void ObjectCache<ObjectType, Flavor>::dropInterestHandle(
   }
 
   if (--item->referenceCount == 0) {
-    state->evictionQueue.erase(state->evictionQueue.iterator_to(*item));
+    unlink(*state, *item);
     ++state->dropCount;
     evictItem(*state, *item);
   }
@@ -321,15 +443,97 @@ template <typename ObjectType, ObjectCacheFlavor Flavor>
 void ObjectCache<ObjectType, Flavor>::evictUntilFits(State& state) noexcept {
   XLOG(DBG6) << "ObjectCache::evictUntilFits "
              << "state.totalSize=" << state.totalSize
-             << ", maximumCacheSizeBytes_=" << maximumCacheSizeBytes_
-             << ", evictionQueue.size()=" << state.evictionQueue.size()
-             << ", minimumEntryCount_=" << minimumEntryCount_;
-  while (state.totalSize > maximumCacheSizeBytes_ &&
-         state.evictionQueue.size() > minimumEntryCount_) {
+             << ", shardMaximumCacheSizeBytes_="
+             << shardMaximumCacheSizeBytes_
+             << ", items.size()=" << state.items.size()
+             << ", shardMinimumEntryCount_=" << shardMinimumEntryCount_;
+  if (policy_ == ObjectCachePolicy::TinyLFU) {
+    evictUntilFitsTinyLFU(state);
+    return;
+  }
+  while (state.totalSize > shardMaximumCacheSizeBytes_ &&
+         state.items.size() > shardMinimumEntryCount_) {
     evictOne(state);
   }
 }
 
+template <typename ObjectType, ObjectCacheFlavor Flavor>
+void ObjectCache<ObjectType, Flavor>::evictUntilFitsTinyLFU(
+    State& state) noexcept {
+  // Entries overflowing the window move to the back of the probation queue,
+  // the first of them being the next candidate for admission.
+  //
+  // Entries larger than the whole window overflow it as soon as they are
+  // inserted, before they could ever be read again, so the sketch has
+  // nothing to judge them by. They are admitted without a contest, ahead of
+  // the candidates, lest every insertion of a large object be rejected.
+  CacheItem* candidate = nullptr;
+  while (state.windowSize > shardWindowMaximumSizeBytes_ &&
+         !state.windowQueue.empty()) {
+    auto& item = state.windowQueue.front();
+    state.windowQueue.pop_front();
+    auto size = item.object->getSizeBytes();
+    state.windowSize -= size;
+    item.segment = Segment::Probation;
+    if (size <= shardWindowMaximumSizeBytes_) {
+      state.evictionQueue.push_back(item);
+      if (!candidate) {
+        candidate = &item;
+      }
+    } else if (candidate) {
+      state.evictionQueue.insert(
+          state.evictionQueue.iterator_to(*candidate), item);
+    } else {
+      state.evictionQueue.push_back(item);
+    }
+  }
+
+  auto nextCandidate = [&](CacheItem& item) -> CacheItem* {
+    auto next = std::next(state.evictionQueue.iterator_to(item));
+    return next == state.evictionQueue.end() ? nullptr : &*next;
+  };
+  auto evict = [&](CacheItem& item) {
+    unlink(state, item);
+    ++state.evictionCount;
+    evictItem(state, item);
+  };
+
+  while (state.totalSize > shardMaximumCacheSizeBytes_ &&
+         state.items.size() > shardMinimumEntryCount_) {
+    if (state.evictionQueue.empty()) {
+      // Nothing is on probation, so there are no candidates either.
+      evict(
+          state.protectedQueue.empty() ? state.windowQueue.front()
+                                       : state.protectedQueue.front());
+      continue;
+    }
+
+    auto& victim = state.evictionQueue.front();
+    if (!candidate || candidate == &victim) {
+      if (candidate) {
+        candidate = nextCandidate(*candidate);
+      }
+      evict(victim);
+      continue;
+    }
+
+    // Admit the candidate only if it is more popular than the entry it
+    // would displace. Ties go to the victim, so that a scan of objects that
+    // are each accessed once cannot flush the cache.
+    auto candidateFrequency =
+        state.sketch.frequency(candidate->object->getHash().getHashCode());
+    auto victimFrequency =
+        state.sketch.frequency(victim.object->getHash().getHashCode());
+    if (candidateFrequency > victimFrequency) {
+      evict(victim);
+    } else {
+      auto* rejected = candidate;
+      candidate = nextCandidate(*candidate);
+      evict(*rejected);
+    }
+  }
+}
+
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 void ObjectCache<ObjectType, Flavor>::evictOne(State& state) noexcept {
   const auto& front = state.evictionQueue.front();
@@ -10,16 +10,39 @@
 #include <folly/IntrusiveList.h>
 #include <folly/Synchronized.h>
 #include <folly/container/F14Map.h>
+#include <folly/lang/Align.h>
 #include <folly/synchronization/DistributedMutex.h>
 #include <list>
 #include <mutex>
+#include <vector>
 
 #include "eden/fs/model/ObjectId.h"
+#include "eden/fs/store/FrequencySketch.h"
 
 namespace facebook::eden {
 
 enum class ObjectCacheFlavor { Simple, InterestHandle };
 
+/**
+ * How an ObjectCache chooses the entries to evict when it is full.
+ */
+enum class ObjectCachePolicy {
+  /**
+   * Evict the least recently used entry.
+   */
+  LRU,
+
+  /**
+   * W-TinyLFU: new entries go through a small LRU window, and only displace
+   * an entry of the main space if they have been accessed more often
+   * recently, as estimated by a FrequencySketch. Entries larger than the
+   * whole window skip the comparison. Entries of the main space accessed
+   * again are protected from eviction by newcomers. This keeps a single scan
+   * over many objects from flushing the working set.
+   */
+  TinyLFU,
+};
+
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 class ObjectCache;
 
@@ -101,6 +124,16 @@ class ObjectInterestHandle {
  * be used that only allow clients to use one flavor of get and insert. See
  * BlobCache and TreeCache for examples of each flavor.
  *
+ * The cache may be split into a number of shards, selected by ObjectId. Each
+ * shard has its own lock, eviction queue and an equal fraction of the size
+ * budget and minimum entry count, so that lookups of unrelated objects do not
+ * contend with each other. With more than one shard, the LRU order is only
+ * maintained per shard.
+ *
+ * By default entries are evicted in LRU order. ObjectCachePolicy::TinyLFU
+ * instead makes the cache resistant to scans, at the cost of keeping access
+ * counts in each shard.
+ *
  * It is safe to use this object from arbitrary threads.
  */
 template <typename ObjectType, ObjectCacheFlavor Flavor>
@@ -149,7 +182,9 @@ class ObjectCache
 
   static std::shared_ptr<ObjectCache<ObjectType, Flavor>> create(
       size_t maximumCacheSizeBytes,
-      size_t minimumEntryCount);
+      size_t minimumEntryCount,
+      size_t numShards = 1,
+      ObjectCachePolicy policy = ObjectCachePolicy::LRU);
   ~ObjectCache() {
     clear();
   }
@@ -221,12 +256,24 @@ class ObjectCache
 
   /**
    * Return information about the current size of the cache and the total number
-   * of hits and misses.
+   * of hits and misses, summed over all shards.
    */
   Stats getStats() const;
 
+  size_t getNumShards() const {
+    return shards_.size();
+  }
+
+  ObjectCachePolicy getPolicy() const {
+    return policy_;
+  }
+
  protected:
-  explicit ObjectCache(size_t maximumCacheSizeBytes, size_t minimumEntryCount);
+  explicit ObjectCache(
+      size_t maximumCacheSizeBytes,
+      size_t minimumEntryCount,
+      size_t numShards = 1,
+      ObjectCachePolicy policy = ObjectCachePolicy::LRU);
 
  private:
   /*
@@ -240,6 +287,12 @@ class ObjectCache
    * could be smaller than a pointer.
    */
 
+  /**
+   * The queue a CacheItem is in. Only the TinyLFU policy uses the window and
+   * protected queues.
+   */
+  enum class Segment : uint8_t { Window, Probation, Protected };
+
   struct CacheItem {
     // WARNING: leaves index unset. Since the items map and evictionQueue are
     // circular, initialization of index must happen after the CacheItem is
@@ -264,21 +317,47 @@ class ObjectCache
     /// Given a unique value upon allocation. Used to verify InterestHandle
     /// matches this specific item.
     uint64_t generation{std::numeric_limits<uint64_t>::max()};
+
+    Segment segment{Segment::Probation};
   };
 
   struct State {
     size_t totalSize{0};
     folly::F14NodeMap<ObjectId, CacheItem> items;
 
-    /// Entries are evicted from the front of the queue.
+    /// Entries are evicted from the front of the queue. With the TinyLFU
+    /// policy, this is the probation queue of the main space.
     folly::CountedIntrusiveList<CacheItem, &CacheItem::hook> evictionQueue;
 
+    /// TinyLFU only: recently inserted entries, not yet admitted into the main
+    /// space, and the total size of their objects.
+    folly::CountedIntrusiveList<CacheItem, &CacheItem::hook> windowQueue;
+    size_t windowSize{0};
+
+    /// TinyLFU only: entries of the main space that were accessed again after
+    /// their admission, and the total size of their objects.
+    folly::CountedIntrusiveList<CacheItem, &CacheItem::hook> protectedQueue;
+    size_t protectedSize{0};
+
+    /// TinyLFU only: recent access counts, by ObjectId hash code.
+    FrequencySketch sketch;
+
     uint64_t hitCount{0};
     uint64_t missCount{0};
     uint64_t evictionCount{0};
     uint64_t dropCount{0};
   };
 
+  /**
+   * Padded to a cache line so that neighbouring shard locks do not share one.
+   */
+  struct alignas(folly::hardware_destructive_interference_size) Shard {
+    folly::Synchronized<State, folly::DistributedMutex> state;
+  };
+
+  Shard& getShard(const ObjectId& hash);
+  const Shard& getShard(const ObjectId& hash) const;
+
   /**
    * If an object for the given hash is in cache, return it. If the object is
    * not in cache, return nullptr (and an empty interest handle).
@@ -292,7 +371,9 @@ class ObjectCache
    * exceeds the maximum cache size and the minimum entry count, old entries are
    * evicted. Returns the item inserted (or already in the cache if this is a
    * duplicate insert) and a boolean indicating if this item was freshly
-   * inserted (returns false if this is a duplicate insert).
+   * inserted (returns false if this is a duplicate insert). With the TinyLFU
+   * policy, the item is null if the object alone exceeds the shard's size
+   * and was evicted right away.
    *
    * Does not do anything related to InterestHandles
    */
@@ -300,13 +381,34 @@ class ObjectCache
 
   void dropInterestHandle(const ObjectId& hash, uint64_t generation) noexcept;
 
+  /**
+   * Record an access to a cached item, moving it towards the end of the
+   * queues it is evicted from last.
+   */
+  void promote(State& state, CacheItem& item) noexcept;
+
+  /**
+   * Remove item from the queue it is in, leaving it in the items map.
+   */
+  void unlink(State& state, CacheItem& item) noexcept;
+
   void evictUntilFits(State& state) noexcept;
+  void evictUntilFitsTinyLFU(State& state) noexcept;
   void evictOne(State& state) noexcept;
   void evictItem(State&, const CacheItem& item) noexcept;
 
-  const size_t maximumCacheSizeBytes_;
-  const size_t minimumEntryCount_;
-  folly::Synchronized<State, folly::DistributedMutex> state_;
+  std::vector<Shard> shards_;
+
+  /// Size budget and minimum entry count of each individual shard.
+  const size_t shardMaximumCacheSizeBytes_;
+  const size_t shardMinimumEntryCount_;
+
+  const ObjectCachePolicy policy_;
+
+  /// TinyLFU only: size budgets of the window and protected queues of each
+  /// shard.
+  const size_t shardWindowMaximumSizeBytes_;
+  const size_t shardProtectedMaximumSizeBytes_;
 
   friend class ObjectInterestHandle<ObjectType>;
 };
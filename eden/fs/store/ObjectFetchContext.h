@@ -11,6 +11,7 @@
 #include <string_view>
 #include <unordered_map>
 
+#include <folly/CancellationToken.h>
 #include <folly/portability/SysTypes.h>
 
 #include "eden/fs/store/ImportPriority.h"
@@ -102,6 +103,18 @@ class ObjectFetchContext : public RefCounted {
    */
   virtual void deprioritize(uint64_t) {}
 
+  /**
+   * Returns a token that is cancelled once the originator of this fetch no
+   * longer needs its result, e.g. because the filesystem request it serves
+   * was interrupted or timed out. Imports that nobody waits on anymore are
+   * dropped before they run.
+   *
+   * By default, fetches are never cancelled.
+   */
+  virtual folly::CancellationToken getCancellationToken() const {
+    return {};
+  }
+
   /**
    * Return a no-op fetch context suitable when no tracking is desired.
    */
@@ -7,16 +7,22 @@
 
 #include "ObjectStore.h"
 
+#include <folly/CancellationToken.h>
 #include <folly/Conv.h>
 #include <folly/futures/Future.h>
 #include <folly/io/IOBuf.h>
 
+#include <algorithm>
 #include <stdexcept>
 
 #include "eden/common/utils/ProcessNameCache.h"
 #include "eden/fs/model/Blob.h"
 #include "eden/fs/model/Tree.h"
+#include "eden/fs/config/EdenConfig.h"
 #include "eden/fs/store/BackingStore.h"
+#include "eden/fs/store/BlobHasher.h"
+#include "eden/fs/store/BlobMetadataCache.h"
+#include "eden/fs/store/DiskBlobCache.h"
 #include "eden/fs/store/LocalStore.h"
 #include "eden/fs/store/ObjectFetchContext.h"
 #include "eden/fs/store/TreeCache.h"
@@ -36,7 +42,29 @@ namespace facebook::eden {
 
 namespace {
 constexpr uint64_t kImportPriorityDeprioritizeAmount = 1;
+
+/**
+ * Imports are dropped once every fetch context waiting on them is cancelled,
+ * but only the context that started a fetch is known to the BackingStore.
+ * Requests that joined the fetch in flight, and are still live when it is
+ * cancelled, fetch the object again on their own.
+ */
+template <typename Result, typename Fetch>
+folly::SemiFuture<Result> refetchIfCancelled(
+    folly::SemiFuture<Result> future,
+    const ObjectFetchContextPtr& context,
+    Fetch fetch) {
+  return std::move(future).deferError(
+      folly::tag_t<folly::OperationCancelled>{},
+      [token = context->getCancellationToken(), fetch = std::move(fetch)](
+          auto&& error) mutable -> folly::SemiFuture<Result> {
+        if (token.isCancellationRequested()) {
+          return folly::makeSemiFuture<Result>(error);
+        }
+        return fetch();
+      });
 }
+} // namespace
 
 std::shared_ptr<ObjectStore> ObjectStore::create(
     shared_ptr<LocalStore> localStore,
@@ -46,7 +74,9 @@ std::shared_ptr<ObjectStore> ObjectStore::create(
     std::shared_ptr<ProcessNameCache> processNameCache,
     std::shared_ptr<StructuredLogger> structuredLogger,
     std::shared_ptr<const EdenConfig> edenConfig,
-    CaseSensitivity caseSensitive) {
+    CaseSensitivity caseSensitive,
+    std::shared_ptr<DiskBlobCache> diskBlobCache,
+    std::shared_ptr<BlobHasher> blobHasher) {
   return std::shared_ptr<ObjectStore>{new ObjectStore{
       std::move(localStore),
       std::move(backingStore),
@@ -55,7 +85,9 @@ std::shared_ptr<ObjectStore> ObjectStore::create(
       processNameCache,
       structuredLogger,
       edenConfig,
-      caseSensitive}};
+      caseSensitive,
+      std::move(diskBlobCache),
+      std::move(blobHasher)}};
 }
 
 ObjectStore::ObjectStore(
@@ -66,13 +98,20 @@ ObjectStore::ObjectStore(
     std::shared_ptr<ProcessNameCache> processNameCache,
     std::shared_ptr<StructuredLogger> structuredLogger,
     std::shared_ptr<const EdenConfig> edenConfig,
-    CaseSensitivity caseSensitive)
-    : metadataCache_{folly::in_place, kCacheSize},
+    CaseSensitivity caseSensitive,
+    std::shared_ptr<DiskBlobCache> diskBlobCache,
+    std::shared_ptr<BlobHasher> blobHasher)
+    : metadataCache_{std::make_unique<BlobMetadataCache>(
+          edenConfig->blobMetadataCacheSize.getValue(),
+          edenConfig->blobMetadataCacheShards.getValue())},
       treeCache_{std::move(treeCache)},
+      diskBlobCache_{std::move(diskBlobCache)},
+      blobHasher_{std::move(blobHasher)},
       localStore_{std::move(localStore)},
       backingStore_{std::move(backingStore)},
       stats_{std::move(stats)},
-      pidFetchCounts_{std::make_unique<PidFetchCounts>()},
+      pidFetchCounts_{std::make_unique<PidFetchCounts>(
+          edenConfig->fetchCountsMaximumPids.getValue())},
       processNameCache_(processNameCache),
       structuredLogger_(structuredLogger),
       edenConfig_(edenConfig),
@@ -100,13 +139,15 @@ void ObjectStore::sendFetchHeavyEvent(pid_t pid, uint64_t fetch_count) const {
   auto processName = processNameCache_->getProcessName(pid);
   if (processName) {
     std::replace(processName->begin(), processName->end(), '\0', ' ');
-    XLOG(WARN) << "Heavy fetches (" << fetch_count << ") from process "
-               << *processName << "(pid=" << pid << ")";
+    XLOG(WARN) << "Heavy fetches (" << fetch_count << ", at most "
+               << pidFetchCounts_->getOverestimatedCountByPid(pid)
+               << ") from process " << *processName << "(pid=" << pid << ")";
     structuredLogger_->logEvent(
         FetchHeavy{processName.value(), pid, fetch_count});
   } else {
-    XLOG(WARN) << "Heavy fetches (" << fetch_count << ") from pid " << pid
-               << ")";
+    XLOG(WARN) << "Heavy fetches (" << fetch_count << ", at most "
+               << pidFetchCounts_->getOverestimatedCountByPid(pid)
+               << ") from pid " << pid << ")";
   }
 }
 
@@ -164,10 +205,6 @@ std::shared_ptr<const Tree> changeCaseSensitivity(
   }
 }
 
-BlobMetadata computeBlobMetadata(const Blob& blob) {
-  return BlobMetadata{Hash20::sha1(blob.getContents()), blob.getSize()};
-}
-
 } // namespace
 
 ImmediateFuture<shared_ptr<const Tree>> ObjectStore::getRootTree(
@@ -207,19 +244,6 @@ ImmediateFuture<shared_ptr<const Tree>> ObjectStore::getTree(
   TaskTraceBlock block{"ObjectStore::getTree"};
   DurationScope statScope{stats_, &ObjectStoreStats::getTree};
 
-  // Check in the LocalStore first
-
-  // TODO: We should consider checking if we have in flight BackingStore
-  // requests on this layer instead of only in the BackingStore. Consider the
-  // case in which thread A and thread B both request a Tree at the same time.
-  // Let's say thread A checks the LocalStore, then thread B checks the
-  // LocalStore, gets the file from the BackingStore (making a request to the
-  // server), then writes the Tree to the LocalStore. Now when thread A checks
-  // for in flight requests in the BackingStore, it will not see any since
-  // thread B has completely finished, so thread A will make a duplicate
-  // request. If we we're to mark here that we got a request on this layer, then
-  // we could avoid that case.
-
   if (auto maybeTree = treeCache_->get(id)) {
     fetchContext->didFetch(
         ObjectFetchContext::Tree, id, ObjectFetchContext::FromMemoryCache);
@@ -231,7 +255,22 @@ ImmediateFuture<shared_ptr<const Tree>> ObjectStore::getTree(
 
   deprioritizeWhenFetchHeavy(*fetchContext);
 
-  return ImmediateFuture{backingStore_->getTree(id, fetchContext)}.thenValue(
+  // Requests that miss the cache while another request for the same tree is
+  // in flight wait for that request rather than racing it to the LocalStore
+  // and BackingStore.
+  auto fetch = inFlightTrees_.getOrFetch(
+      id, [&] { return backingStore_->getTree(id, fetchContext); });
+  if (fetch.joined) {
+    stats_->increment(&ObjectStoreStats::getTreeInFlight);
+    fetch.future = refetchIfCancelled(
+        std::move(fetch.future),
+        fetchContext,
+        [self = shared_from_this(), id, fetchContext = fetchContext.copy()] {
+          return self->backingStore_->getTree(id, fetchContext);
+        });
+  }
+
+  return ImmediateFuture{std::move(fetch.future)}.thenValue(
       [self = shared_from_this(),
        statScope = std::move(statScope),
        id,
@@ -244,8 +283,7 @@ ImmediateFuture<shared_ptr<const Tree>> ObjectStore::getTree(
           throwf<std::domain_error>("tree {} not found", id);
         }
 
-        // promote to shared_ptr so we can store in the cache and return
-        auto sharedTree = std::shared_ptr<const Tree>(std::move(result.tree));
+        auto sharedTree = std::move(result.tree);
         self->treeCache_->insert(sharedTree);
         fetchContext->didFetch(ObjectFetchContext::Tree, id, result.origin);
         self->updateProcessFetch(*fetchContext);
@@ -270,14 +308,153 @@ ImmediateFuture<folly::Unit> ObjectStore::prefetchBlobs(
   return backingStore_->prefetchBlobs(ids, fetchContext);
 }
 
+struct ObjectStore::PrefetchTreesState {
+  PrefetchTreesState(
+      const EdenStatsPtr& stats,
+      size_t depth,
+      PrefetchTreesFilter filter,
+      const ObjectFetchContextPtr& context,
+      folly::CancellationToken cancellation)
+      : statScope{stats, &ObjectStoreStats::prefetchTrees},
+        depth{depth},
+        filter{std::move(filter)},
+        context{context.copy()},
+        cancellation{std::move(cancellation)} {}
+
+  DurationScope statScope;
+  const size_t depth;
+  const PrefetchTreesFilter filter;
+  const ObjectFetchContextPtr context;
+  const folly::CancellationToken cancellation;
+
+  /**
+   * The trees of the level being fetched, and the index of the first one
+   * that has not been requested yet.
+   */
+  std::vector<std::pair<RelativePath, ObjectId>> level;
+  size_t next{0};
+  size_t levelDepth{0};
+
+  /**
+   * The subtrees found so far in the trees of the current level.
+   */
+  std::vector<std::pair<RelativePath, ObjectId>> nextLevel;
+};
+
+ImmediateFuture<folly::Unit> ObjectStore::prefetchTrees(
+    const ObjectId& root,
+    size_t depth,
+    PrefetchTreesFilter filter,
+    const ObjectFetchContextPtr& context,
+    folly::CancellationToken cancellation) const {
+  auto state = std::make_shared<PrefetchTreesState>(
+      stats_, depth, std::move(filter), context, std::move(cancellation));
+  state->level.emplace_back(RelativePath{}, root);
+  return prefetchTreesStep(std::move(state));
+}
+
+ImmediateFuture<folly::Unit> ObjectStore::prefetchTreesStep(
+    std::shared_ptr<PrefetchTreesState> state) const {
+  if (state->cancellation.isCancellationRequested()) {
+    return makeImmediateFuture<folly::Unit>(folly::OperationCancelled{});
+  }
+
+  if (state->next == state->level.size()) {
+    if (state->nextLevel.empty()) {
+      return folly::unit;
+    }
+    state->level = std::move(state->nextLevel);
+    state->nextLevel.clear();
+    state->next = 0;
+    ++state->levelDepth;
+  }
+
+  auto batchSize = std::max<size_t>(
+      edenConfig_->prefetchTreesBatchSize.getValue(), 1);
+  auto begin = state->next;
+  auto end = std::min(state->level.size(), begin + batchSize);
+  state->next = end;
+
+  std::vector<ImmediateFuture<std::shared_ptr<const Tree>>> futures;
+  futures.reserve(end - begin);
+  for (auto i = begin; i < end; ++i) {
+    futures.push_back(getTree(state->level[i].second, state->context));
+  }
+
+  return collectAll(std::move(futures))
+      .thenValue([self = shared_from_this(), state, begin](
+                     std::vector<folly::Try<std::shared_ptr<const Tree>>>
+                         trees) mutable {
+        bool expand = state->levelDepth < state->depth;
+        for (size_t i = 0; i < trees.size(); ++i) {
+          const auto& [path, id] = state->level[begin + i];
+          if (trees[i].hasException()) {
+            XLOG(DBG3) << "failed to prefetch tree " << id << " at " << path
+                       << ": " << trees[i].exception().what();
+            self->stats_->increment(&ObjectStoreStats::prefetchTreesFailed);
+            continue;
+          }
+          self->stats_->increment(&ObjectStoreStats::prefetchTreesFetched);
+
+          if (expand) {
+            for (const auto& [name, entry] : *trees[i].value()) {
+              if (!entry.isTree()) {
+                continue;
+              }
+              auto childPath = path + name;
+              if (state->filter && !state->filter(childPath, entry)) {
+                continue;
+              }
+              state->nextLevel.emplace_back(
+                  std::move(childPath), entry.getHash());
+            }
+          }
+        }
+        return self->prefetchTreesStep(std::move(state));
+      });
+}
+
+std::shared_ptr<const Blob> ObjectStore::getBlobFromDiskBlobCache(
+    const ObjectId& id) const {
+  if (!diskBlobCache_) {
+    return nullptr;
+  }
+  // Most blobs are too small to ever be on disk. Don't bother the cache
+  // about the ones whose size is known.
+  auto metadata = metadataCache_->get(id);
+  if (metadata && metadata->size < diskBlobCache_->getMinimumBlobSize()) {
+    return nullptr;
+  }
+  return diskBlobCache_->get(id);
+}
+
 ImmediateFuture<shared_ptr<const Blob>> ObjectStore::getBlob(
     const ObjectId& id,
     const ObjectFetchContextPtr& fetchContext) const {
   DurationScope statScope{stats_, &ObjectStoreStats::getBlob};
 
+  if (auto blob = getBlobFromDiskBlobCache(id)) {
+    stats_->increment(&ObjectStoreStats::getBlobFromDiskBlobCache);
+    updateProcessFetch(*fetchContext);
+    fetchContext->didFetch(
+        ObjectFetchContext::Blob, id, ObjectFetchContext::FromDiskCache);
+    return blob;
+  }
+
   deprioritizeWhenFetchHeavy(*fetchContext);
-  return ImmediateFuture<BackingStore::GetBlobResult>{
-      backingStore_->getBlob(id, fetchContext)}
+  auto fetch = inFlightBlobs_.getOrFetch(
+      id, [&] { return backingStore_->getBlob(id, fetchContext); });
+  if (fetch.joined) {
+    stats_->increment(&ObjectStoreStats::getBlobInFlight);
+    fetch.future = refetchIfCancelled(
+        std::move(fetch.future),
+        fetchContext,
+        [self = shared_from_this(), id, fetchContext = fetchContext.copy()] {
+          return self->backingStore_->getBlob(id, fetchContext);
+        });
+  }
+
+  return ImmediateFuture<BackingStore::GetBlobResult>{std::move(fetch.future)}
       .thenValue(
           [self = shared_from_this(),
            statScope = std::move(statScope),
@@ -296,10 +473,57 @@ ImmediateFuture<shared_ptr<const Blob>> ObjectStore::getBlob(
             // We always cache metadata in LocalStore because it's faster to
             // query than the BackingStore, and metadata is very small (~28
             // bytes per blob).
-            if (!self->metadataCache_.rlock()->exists(id)) {
-              auto metadata = computeBlobMetadata(*result.blob);
-              self->localStore_->putBlobMetadata(id, metadata);
-              self->metadataCache_.wlock()->set(id, metadata);
+            if (!self->metadataCache_->contains(id)) {
+              self->computeBlobMetadata(id, result.blob);
+            }
+            if (self->diskBlobCache_) {
+              self->diskBlobCache_->insertInBackground(
+                  result.blob, [stats = self->stats_.copy()](size_t evicted) {
+                    if (evicted) {
+                      stats->increment(
+                          &ObjectStoreStats::diskBlobCacheEviction, evicted);
+                    }
+                  });
+            }
+            self->updateProcessFetch(*fetchContext);
+            fetchContext->didFetch(ObjectFetchContext::Blob, id, result.origin);
+            return std::move(result.blob);
+          });
+}
+
+bool ObjectStore::supportsBlobRange(const ObjectId& id) const {
+  return backingStore_->supportsBlobRange() ||
+      (diskBlobCache_ && diskBlobCache_->contains(id));
+}
+
+ImmediateFuture<shared_ptr<const Blob>> ObjectStore::getBlobRange(
+    const ObjectId& id,
+    uint64_t offset,
+    uint64_t length,
+    const ObjectFetchContextPtr& fetchContext) const {
+  DurationScope statScope{stats_, &ObjectStoreStats::getBlobRange};
+
+  if (auto blob = getBlobFromDiskBlobCache(id)) {
+    stats_->increment(&ObjectStoreStats::getBlobFromDiskBlobCache);
+    updateProcessFetch(*fetchContext);
+    fetchContext->didFetch(
+        ObjectFetchContext::Blob, id, ObjectFetchContext::FromDiskCache);
+    return std::make_shared<const Blob>(id, blob->getRange(offset, length));
+  }
+
+  deprioritizeWhenFetchHeavy(*fetchContext);
+  return ImmediateFuture<BackingStore::GetBlobResult>{
+      backingStore_->getBlobRange(id, offset, length, fetchContext)}
+      .thenValue(
+          [self = shared_from_this(),
+           statScope = std::move(statScope),
+           id,
+           fetchContext =
+               fetchContext.copy()](BackingStore::GetBlobResult result)
+              -> std::shared_ptr<const Blob> {
+            if (!result.blob) {
+              XLOG(DBG2) << "unable to find blob " << id;
+              throwf<std::domain_error>("blob {} not found", id);
             }
             self->updateProcessFetch(*fetchContext);
             fetchContext->didFetch(ObjectFetchContext::Blob, id, result.origin);
@@ -311,21 +535,71 @@ std::optional<BlobMetadata> ObjectStore::getBlobMetadataFromInMemoryCache(
     const ObjectId& id,
     const ObjectFetchContextPtr& context) const {
   // Check in-memory cache
-  {
-    auto metadataCache = metadataCache_.wlock();
-    auto cacheIter = metadataCache->find(id);
-    if (cacheIter != metadataCache->end()) {
-      stats_->increment(&ObjectStoreStats::getBlobMetadataFromMemory);
-      context->didFetch(
-          ObjectFetchContext::BlobMetadata,
-          id,
-          ObjectFetchContext::FromMemoryCache);
-
-      updateProcessFetch(*context);
-      return cacheIter->second;
-    }
+  auto metadata = metadataCache_->get(id);
+  if (metadata) {
+    stats_->increment(&ObjectStoreStats::getBlobMetadataFromMemory);
+    context->didFetch(
+        ObjectFetchContext::BlobMetadata,
+        id,
+        ObjectFetchContext::FromMemoryCache);
+
+    updateProcessFetch(*context);
+  } else {
+    stats_->increment(&ObjectStoreStats::blobMetadataMemoryCacheMiss);
+  }
+  return metadata;
+}
+
+std::shared_ptr<const Tree> ObjectStore::getTreeFromInMemoryCache(
+    const ObjectId& id,
+    const ObjectFetchContextPtr& context) const {
+  auto tree = treeCache_->get(id);
+  if (tree) {
+    context->didFetch(
+        ObjectFetchContext::Tree, id, ObjectFetchContext::FromMemoryCache);
+    updateProcessFetch(*context);
+  }
+  return tree;
+}
+
+void ObjectStore::insertBlobMetadataIntoCache(
+    const ObjectId& id,
+    const BlobMetadata& metadata) const {
+  if (auto evicted = metadataCache_->insert(id, metadata)) {
+    stats_->increment(
+        &ObjectStoreStats::blobMetadataMemoryCacheEviction, evicted);
   }
-  return std::nullopt;
+}
+
+void ObjectStore::computeBlobMetadata(
+    const ObjectId& id,
+    std::shared_ptr<const Blob> blob) const {
+  if (!blobHasher_ || !blobHasher_->isLarge(*blob)) {
+    auto metadata = BlobHasher::computeMetadata(*blob);
+    localStore_->putBlobMetadata(id, metadata);
+    insertBlobMetadataIntoCache(id, metadata);
+    return;
+  }
+
+  // The blob is returned right away. Until the blob hashing threads are done
+  // with it, getBlobMetadata() joins this computation rather than fetching
+  // the metadata again. If a metadata fetch is already in flight, it will
+  // provide the metadata instead.
+  inFlightBlobMetadata_.getOrFetch(
+      id, [self = shared_from_this(), id, blob = std::move(blob)] {
+        return self->blobHasher_->computeMetadataAsync(blob)
+            .thenValue([self, id](BlobMetadata metadata) {
+              self->localStore_->putBlobMetadata(id, metadata);
+              self->insertBlobMetadataIntoCache(id, metadata);
+              return SharedBlobMetaResult{
+                  std::move(metadata), ObjectFetchContext::FromMemoryCache};
+            })
+            .thenError([id](folly::exception_wrapper&& ew) {
+              XLOG(ERR) << "failed to hash blob " << id << ": " << ew.what();
+              return folly::makeFuture<SharedBlobMetaResult>(std::move(ew));
+            })
+            .semi();
+      });
 }
 
 ImmediateFuture<BlobMetadata> ObjectStore::getBlobMetadata(
@@ -342,17 +616,35 @@ ImmediateFuture<BlobMetadata> ObjectStore::getBlobMetadata(
 
   deprioritizeWhenFetchHeavy(*fetchContext);
 
+  auto fetchShared = [self = shared_from_this(),
+                      id,
+                      fetchContext = fetchContext.copy()] {
+    return self->backingStore_->getBlobMetadata(id, fetchContext)
+        .deferValue([](BackingStore::GetBlobMetaResult result) {
+          SharedBlobMetaResult shared{std::nullopt, result.origin};
+          if (result.blobMeta) {
+            shared.blobMeta = std::move(*result.blobMeta);
+          }
+          return shared;
+        });
+  };
+  auto fetch = inFlightBlobMetadata_.getOrFetch(id, fetchShared);
+  if (fetch.joined) {
+    stats_->increment(&ObjectStoreStats::getBlobMetadataInFlight);
+    fetch.future = refetchIfCancelled(
+        std::move(fetch.future), fetchContext, std::move(fetchShared));
+  }
+
   auto self = shared_from_this();
-  return ImmediateFuture<BackingStore::GetBlobMetaResult>{
-      backingStore_->getBlobMetadata(id, fetchContext)}
+  return ImmediateFuture<SharedBlobMetaResult>{std::move(fetch.future)}
       .thenValue([self, fetchContext = fetchContext.copy(), id](
-                     BackingStore::GetBlobMetaResult result) {
+                     SharedBlobMetaResult result) {
         if (!result.blobMeta) {
           self->stats_->increment(&ObjectStoreStats::getBlobMetadataFailed);
           XLOG(DBG2) << "unable to find aux data for " << id;
           throwf<std::domain_error>("aux data {} not found", id);
         }
-        self->metadataCache_.wlock()->set(id, *result.blobMeta);
+        self->insertBlobMetadataIntoCache(id, *result.blobMeta);
         fetchContext->didFetch(
             ObjectFetchContext::BlobMetadata, id, result.origin);
         self->updateProcessFetch(*fetchContext);
@@ -374,6 +666,51 @@ ImmediateFuture<Hash20> ObjectStore::getBlobSha1(
       .thenValue([](const BlobMetadata& metadata) { return metadata.sha1; });
 }
 
+ImmediateFuture<Hash32> ObjectStore::getBlobBlake3(
+    const ObjectId& id,
+    const ObjectFetchContextPtr& context) const {
+  return getBlobMetadata(id, context)
+      .thenValue([self = shared_from_this(), id, context = context.copy()](
+                     BlobMetadata metadata) -> ImmediateFuture<Hash32> {
+        if (metadata.blake3) {
+          return *metadata.blake3;
+        }
+        return self->localStore_->getBlobBlake3(id).thenValue(
+            [self, id, context = context.copy(), metadata](
+                std::optional<Hash32> stored) mutable
+            -> ImmediateFuture<Hash32> {
+              if (stored) {
+                metadata.blake3 = *stored;
+                self->insertBlobMetadataIntoCache(id, metadata);
+                return *stored;
+              }
+              return self->computeBlobBlake3(id, std::move(metadata), context);
+            });
+      });
+}
+
+ImmediateFuture<Hash32> ObjectStore::computeBlobBlake3(
+    const ObjectId& id,
+    BlobMetadata metadata,
+    const ObjectFetchContextPtr& context) const {
+  return getBlob(id, context)
+      .thenValue([self = shared_from_this()](std::shared_ptr<const Blob> blob)
+                     -> ImmediateFuture<Hash32> {
+        if (self->blobHasher_) {
+          return self->blobHasher_->computeBlake3Async(std::move(blob)).semi();
+        }
+        return BlobHasher::computeBlake3(*blob);
+      })
+      .thenValue(
+          [self = shared_from_this(), id, metadata = std::move(metadata)](
+              Hash32 blake3) mutable {
+            self->localStore_->putBlobBlake3(id, blake3);
+            metadata.blake3 = blake3;
+            self->insertBlobMetadataIntoCache(id, metadata);
+            return blake3;
+          });
+}
+
 ImmediateFuture<bool> ObjectStore::areBlobsEqual(
     const ObjectId& one,
     const ObjectId& two,
@@ -7,9 +7,12 @@
 
 #pragma once
 
+#include <folly/CancellationToken.h>
 #include <folly/Synchronized.h>
-#include <folly/container/EvictingCacheMap.h>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 
 #include <folly/logging/xlog.h>
@@ -17,16 +20,21 @@
 #include "eden/fs/model/Hash.h"
 #include "eden/fs/model/RootId.h"
 #include "eden/fs/model/TreeEntry.h"
+#include "eden/fs/store/BackingStore.h"
 #include "eden/fs/store/IObjectStore.h"
+#include "eden/fs/store/InFlightFetchTable.h"
 #include "eden/fs/store/ImportPriority.h"
 #include "eden/fs/store/ObjectFetchContext.h"
+#include "eden/fs/store/PidFetchCounts.h"
 #include "eden/fs/utils/CaseSensitivity.h"
 #include "eden/fs/utils/RefPtr.h"
 
 namespace facebook::eden {
 
-class BackingStore;
 class Blob;
+class BlobHasher;
+class BlobMetadataCache;
+class DiskBlobCache;
 class EdenConfig;
 class EdenStats;
 class LocalStore;
@@ -38,30 +46,6 @@ enum class ObjectComparison : uint8_t;
 
 using EdenStatsPtr = RefPtr<EdenStats>;
 
-struct PidFetchCounts {
-  folly::Synchronized<std::unordered_map<pid_t, uint64_t>> map_;
-
-  uint64_t recordProcessFetch(pid_t pid) {
-    auto map_lock = map_.wlock();
-    auto fetch_count = (*map_lock)[pid]++;
-    return fetch_count;
-  }
-
-  void clear() {
-    map_.wlock()->clear();
-  }
-
-  uint64_t getCountByPid(pid_t pid) {
-    auto rl = map_.rlock();
-    auto fetch_count = rl->find(pid);
-    if (fetch_count != rl->end()) {
-      return fetch_count->second;
-    } else {
-      return 0;
-    }
-  }
-};
-
 /**
  * ObjectStore is a content-addressed store for eden object data.
  *
@@ -85,7 +69,9 @@ class ObjectStore : public IObjectStore,
       std::shared_ptr<ProcessNameCache> processNameCache,
       std::shared_ptr<StructuredLogger> structuredLogger,
       std::shared_ptr<const EdenConfig> edenConfig,
-      CaseSensitivity caseSensitive);
+      CaseSensitivity caseSensitive,
+      std::shared_ptr<DiskBlobCache> diskBlobCache = nullptr,
+      std::shared_ptr<BlobHasher> blobHasher = nullptr);
   ~ObjectStore() override;
 
   /**
@@ -183,6 +169,38 @@ class ObjectStore : public IObjectStore,
       ObjectIdRange ids,
       const ObjectFetchContextPtr& context) const override;
 
+  /**
+   * Called by prefetchTrees for every subdirectory it finds, with the path of
+   * the subdirectory relative to the root tree. Returning false skips the
+   * subdirectory and everything below it.
+   */
+  using PrefetchTreesFilter =
+      std::function<bool(RelativePathPiece path, const TreeEntry& entry)>;
+
+  static constexpr size_t kUnlimitedDepth = std::numeric_limits<size_t>::max();
+
+  /**
+   * Fetch the tree root and its subtrees up to depth levels below it, so that
+   * later reads find them in the local caches. A depth of 0 only fetches root.
+   *
+   * Trees are fetched breadth-first: every tree of a level is requested at
+   * once, which lets the BackingStore import them in a few large batches
+   * instead of one at a time, and the next level is only requested once the
+   * previous one is done. At most store:prefetch-trees-batch-size trees are
+   * requested at once, and only the ids of the trees left to fetch are kept
+   * in memory.
+   *
+   * Trees that fail to load are skipped. The returned future fails with
+   * folly::OperationCancelled if cancellation is requested before the walk
+   * completes.
+   */
+  ImmediateFuture<folly::Unit> prefetchTrees(
+      const ObjectId& root,
+      size_t depth,
+      PrefetchTreesFilter filter,
+      const ObjectFetchContextPtr& context,
+      folly::CancellationToken cancellation = {}) const;
+
   /**
    * Get a Blob by ID.
    *
@@ -194,6 +212,26 @@ class ObjectStore : public IObjectStore,
       const ObjectId& id,
       const ObjectFetchContextPtr& context) const override;
 
+  /**
+   * Ranges are supported when the BackingStore supports them, or when the
+   * blob is in the on-disk blob cache, which maps it without reading it.
+   */
+  bool supportsBlobRange(const ObjectId& id) const override;
+
+  /**
+   * Get up to length bytes of a Blob, starting at offset.
+   *
+   * The returned Blob carries the ID of the whole blob but only holds the
+   * requested range. Blobs in the on-disk blob cache are sliced without
+   * copying; otherwise the BackingStore is asked for the range. Nothing is
+   * cached here: BlobAccess caches the chunks it reads.
+   */
+  ImmediateFuture<std::shared_ptr<const Blob>> getBlobRange(
+      const ObjectId& id,
+      uint64_t offset,
+      uint64_t length,
+      const ObjectFetchContextPtr& context) const override;
+
   /**
    * Get metadata about a Blob.
    *
@@ -216,6 +254,15 @@ class ObjectStore : public IObjectStore,
       const ObjectId& id,
       const ObjectFetchContextPtr& context) const;
 
+  /**
+   * Get a Tree from EdenFS's in memory Tree cache, without fetching it.
+   *
+   * Returns nullptr if the tree is not in the cache.
+   */
+  std::shared_ptr<const Tree> getTreeFromInMemoryCache(
+      const ObjectId& id,
+      const ObjectFetchContextPtr& context) const;
+
   /**
    * Returns the size of the contents of the blob with the given ID.
    */
@@ -230,6 +277,17 @@ class ObjectStore : public IObjectStore,
       const ObjectId& id,
       const ObjectFetchContextPtr& context) const;
 
+  /**
+   * Returns the BLAKE3 hash of the contents of the blob with the given ID.
+   *
+   * It is only computed when first asked for: metadata imported from the
+   * BackingStore or computed on fetch may not carry it, in which case it is
+   * read from the LocalStore, or else the blob is fetched and hashed.
+   */
+  ImmediateFuture<Hash32> getBlobBlake3(
+      const ObjectId& id,
+      const ObjectFetchContextPtr& context) const;
+
   /**
    * Compares the objects.
    *
@@ -274,8 +332,12 @@ class ObjectStore : public IObjectStore,
    */
   bool areObjectsKnownIdentical(const ObjectId& one, const ObjectId& two) const;
 
-  folly::Synchronized<std::unordered_map<pid_t, uint64_t>>& getPidFetches() {
-    return pidFetchCounts_->map_;
+  /**
+   * Returns the number of fetches of each process. See PidFetchCounts for
+   * the accuracy of these counts.
+   */
+  std::unordered_map<pid_t, uint64_t> getPidFetches() const {
+    return pidFetchCounts_->getAllCounts();
   }
 
   void clearFetchCounts() {
@@ -292,29 +354,74 @@ class ObjectStore : public IObjectStore,
       std::shared_ptr<ProcessNameCache> processNameCache,
       std::shared_ptr<StructuredLogger> structuredLogger,
       std::shared_ptr<const EdenConfig> edenConfig,
-      CaseSensitivity caseSensitive);
+      CaseSensitivity caseSensitive,
+      std::shared_ptr<DiskBlobCache> diskBlobCache,
+      std::shared_ptr<BlobHasher> blobHasher);
   // Forbidden copy constructor and assignment operator
   ObjectStore(ObjectStore const&) = delete;
   ObjectStore& operator=(ObjectStore const&) = delete;
 
-  static constexpr size_t kCacheSize = 1000000;
+  /**
+   * Copyable form of BackingStore::GetBlobMetaResult, so that its result can
+   * be shared by coalesced requests.
+   */
+  struct SharedBlobMetaResult {
+    std::optional<BlobMetadata> blobMeta;
+    ObjectFetchContext::Origin origin;
+  };
+
+  struct PrefetchTreesState;
+
+  /**
+   * Fetch the next batch of trees of a prefetchTrees walk, then continue with
+   * the rest of the walk.
+   */
+  ImmediateFuture<folly::Unit> prefetchTreesStep(
+      std::shared_ptr<PrefetchTreesState> state) const;
+
+  /**
+   * Compute the metadata of a blob fetched from the BackingStore, and store
+   * it in the LocalStore and metadataCache_. Large blobs are hashed in the
+   * background on the blobHasher_'s executor, as a fetch in
+   * inFlightBlobMetadata_ that getBlobMetadata() joins.
+   */
+  void computeBlobMetadata(
+      const ObjectId& id,
+      std::shared_ptr<const Blob> blob) const;
+
+  /**
+   * Fetch and hash the blob for getBlobBlake3(), then store its BLAKE3 hash
+   * in the LocalStore, and metadata with it in metadataCache_.
+   */
+  ImmediateFuture<Hash32> computeBlobBlake3(
+      const ObjectId& id,
+      BlobMetadata metadata,
+      const ObjectFetchContextPtr& context) const;
+
+  /**
+   * Look the blob up in diskBlobCache_, if any. Blobs whose size is known
+   * from metadataCache_ to be below the cache's minimum are not looked up.
+   */
+  std::shared_ptr<const Blob> getBlobFromDiskBlobCache(
+      const ObjectId& id) const;
+
+  /**
+   * Insert into metadataCache_, recording any evictions in the stats.
+   */
+  void insertBlobMetadataIntoCache(
+      const ObjectId& id,
+      const BlobMetadata& metadata) const;
 
   /**
    * During status and checkout, it's common to look up the SHA-1 for a given
    * blob ID. To avoid needing to hit RocksDB, keep a bounded in-memory cache of
-   * the sizes and SHA-1s of blobs we've seen. Each node is somewhere around 50
-   * bytes (20+28 + LRU overhead) and we store kMetadataCacheSize entries, which
-   * EvictingCacheMap divides in two for some reason. At the time of this
-   * comment, EvictingCacheMap does not store its nodes densely, so there may
-   * also be some jemalloc tracking overhead and some internal fragmentation
-   * depending on whether the node fits cleanly into one of jemalloc's size
-   * classes.
+   * the sizes and SHA-1s of blobs we've seen. Its size is controlled by
+   * store:blob-metadata-cache-size.
    *
-   * TODO: It never makes sense to rlock an LRU cache, since cache hits mutate
-   * the data structure. Thus, should we use a more appropriate type of lock?
+   * The cache is sharded and uses CLOCK eviction, so hits only take a shared
+   * lock: stat-heavy workloads hit it for every file.
    */
-  mutable folly::Synchronized<folly::EvictingCacheMap<ObjectId, BlobMetadata>>
-      metadataCache_;
+  std::unique_ptr<BlobMetadataCache> metadataCache_;
 
   /**
    * During glob, we need to read a lot of trees, but we avoid loading inodes,
@@ -329,6 +436,29 @@ class ObjectStore : public IObjectStore,
    */
   const std::shared_ptr<TreeCache> treeCache_;
 
+  /**
+   * Optional on-disk cache of large blobs, consulted before the BackingStore.
+   * Shared across all object stores, like the LocalStore.
+   */
+  const std::shared_ptr<DiskBlobCache> diskBlobCache_;
+
+  /**
+   * Hashes blobs fetched from the BackingStore. Null when large blobs are
+   * hashed inline.
+   */
+  const std::shared_ptr<BlobHasher> blobHasher_;
+
+  /**
+   * BackingStore fetches currently in flight. Concurrent cache misses for the
+   * same object share the first caller's fetch, including its LocalStore
+   * lookup and deserialization, rather than each issuing their own.
+   *
+   * The fetch keeps the priority and cause of the request that started it.
+   */
+  mutable InFlightFetchTable<BackingStore::GetTreeResult> inFlightTrees_;
+  mutable InFlightFetchTable<BackingStore::GetBlobResult> inFlightBlobs_;
+  mutable InFlightFetchTable<SharedBlobMetaResult> inFlightBlobMetadata_;
+
   /*
    * The LocalStore.
    *
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/PidFetchCounts.h"
+
+#include <folly/hash/Hash.h>
+#include <algorithm>
+
+namespace facebook::eden {
+
+PidFetchCounts::PidFetchCounts(size_t maximumPids)
+    : shards_(kNumShards),
+      // Round up so that at least maximumPids pids are tracked.
+      shardMaximumPids_{std::max<size_t>(
+          (maximumPids + kNumShards - 1) / kNumShards,
+          1)} {}
+
+PidFetchCounts::Shard& PidFetchCounts::getShard(pid_t pid) {
+  // Pids are mostly sequential, mix them so that consecutive processes do not
+  // land in a predictable pattern of shards.
+  auto index = folly::hash::twang_mix64(static_cast<uint64_t>(pid)) %
+      shards_.size();
+  return shards_[index];
+}
+
+const PidFetchCounts::Shard& PidFetchCounts::getShard(pid_t pid) const {
+  return const_cast<PidFetchCounts*>(this)->getShard(pid);
+}
+
+uint64_t PidFetchCounts::recordProcessFetch(pid_t pid) {
+  auto counts = getShard(pid).counts.lock();
+  if (auto it = counts->find(pid); it != counts->end()) {
+    return it->second.count++ - it->second.error;
+  }
+
+  uint64_t inherited = 0;
+  if (counts->size() >= shardMaximumPids_) {
+    // Take the place of the least fetching pid. Only done for pids that are
+    // not tracked yet, and shards are small, so a linear scan is cheap.
+    auto minimum = std::min_element(
+        counts->begin(), counts->end(), [](const auto& lhs, const auto& rhs) {
+          return lhs.second.count < rhs.second.count;
+        });
+    inherited = minimum->second.count;
+    counts->erase(minimum);
+  }
+  counts->emplace(pid, Count{inherited + 1, inherited});
+  return 0;
+}
+
+void PidFetchCounts::clear() {
+  for (auto& shard : shards_) {
+    shard.counts.lock()->clear();
+  }
+}
+
+uint64_t PidFetchCounts::getCountByPid(pid_t pid) const {
+  auto counts = getShard(pid).counts.lock();
+  auto it = counts->find(pid);
+  return it == counts->end() ? 0 : it->second.count - it->second.error;
+}
+
+uint64_t PidFetchCounts::getOverestimatedCountByPid(pid_t pid) const {
+  auto counts = getShard(pid).counts.lock();
+  auto it = counts->find(pid);
+  return it == counts->end() ? 0 : it->second.count;
+}
+
+std::unordered_map<pid_t, uint64_t> PidFetchCounts::getAllCounts() const {
+  std::unordered_map<pid_t, uint64_t> result;
+  for (const auto& shard : shards_) {
+    auto counts = shard.counts.lock();
+    for (const auto& [pid, count] : *counts) {
+      result.emplace(pid, count.count - count.error);
+    }
+  }
+  return result;
+}
+
+} // namespace facebook::eden
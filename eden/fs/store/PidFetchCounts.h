@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <folly/lang/Align.h>
+#include <sys/types.h>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace facebook::eden {
+
+/**
+ * Number of object fetches made on behalf of each process.
+ *
+ * Counts are split into independently locked shards selected by pid, so that
+ * fetches of unrelated processes do not contend. The shards are only merged
+ * when all counts are requested.
+ *
+ * At most about maximumPids processes are tracked, so that memory stays flat
+ * on hosts running millions of short-lived processes. Once full, a new pid
+ * replaces the least fetching one of its shard and inherits its count, as in
+ * the Space-Saving heavy hitters algorithm, which keeps the processes
+ * fetching the most. The inherited count is remembered as the error of the
+ * new pid's count: its true count lies between its count minus that error,
+ * which is what is reported, and its raw count, which is only an upper bound.
+ *
+ * It is safe to use this object from arbitrary threads.
+ */
+class PidFetchCounts {
+ public:
+  explicit PidFetchCounts(size_t maximumPids = 4096);
+
+  PidFetchCounts(const PidFetchCounts&) = delete;
+  PidFetchCounts& operator=(const PidFetchCounts&) = delete;
+
+  /**
+   * Count a fetch made by pid. Returns the count of pid before this fetch,
+   * never more than its true count.
+   */
+  uint64_t recordProcessFetch(pid_t pid);
+
+  /**
+   * Forget every count.
+   */
+  void clear();
+
+  /**
+   * Returns the count of pid, never more than its true count, or 0 if it is
+   * not tracked.
+   */
+  uint64_t getCountByPid(pid_t pid) const;
+
+  /**
+   * Returns the raw count of pid, including the count it inherited, which
+   * may exceed its true count. 0 if it is not tracked.
+   */
+  uint64_t getOverestimatedCountByPid(pid_t pid) const;
+
+  /**
+   * Returns the counts of every tracked pid, like getCountByPid().
+   */
+  std::unordered_map<pid_t, uint64_t> getAllCounts() const;
+
+ private:
+  static constexpr size_t kNumShards = 16;
+
+  struct Count {
+    uint64_t count;
+    /// The part of count inherited from the pid this one replaced.
+    uint64_t error;
+  };
+
+  /**
+   * Padded to a cache line so that neighbouring shard locks do not share one.
+   */
+  struct alignas(folly::hardware_destructive_interference_size) Shard {
+    folly::Synchronized<folly::F14FastMap<pid_t, Count>, std::mutex> counts;
+  };
+
+  Shard& getShard(pid_t pid);
+  const Shard& getShard(pid_t pid) const;
+
+  std::vector<Shard> shards_;
+  const size_t shardMaximumPids_;
+};
+
+} // namespace facebook::eden
@@ -17,6 +17,7 @@
 #include <folly/io/IOBuf.h>
 #include <folly/lang/Bits.h>
 #include <folly/logging/xlog.h>
+#include <rocksdb/cache.h>
 #include <rocksdb/convenience.h>
 #include <rocksdb/db.h>
 #include <rocksdb/filter_policy.h>
@@ -57,13 +58,97 @@ rocksdb::ColumnFamilyOptions makeColumnOptions(uint64_t LRUblockCacheSizeMB) {
   return options;
 }
 
+/**
+ * Table and compression settings of a column family under the per-KeySpace
+ * profiles.
+ */
+struct ColumnProfile {
+  size_t blockSize;
+  int bloomBitsPerKey;
+  rocksdb::CompressionType compression;
+  /**
+   * Maximum size of the compression dictionary built from samples of the
+   * column's values, or 0 to compress every block on its own.
+   */
+  uint32_t maxDictBytes;
+};
+
+ColumnProfile getColumnProfile(KeySpace keySpace, RocksDbProfile profile) {
+  constexpr size_t kSmallBlock = 4 * 1024;
+  if (keySpace->index == KeySpace::TreeFamily.index) {
+    // Serialized trees repeat the same entry names, modes and hash prefixes
+    // over and over, but each tree is too small for that redundancy to be
+    // found within a block. A dictionary shared by the whole column family
+    // captures it. Larger blocks also compress better.
+    if (profile == RocksDbProfile::PerKeySpaceZstd) {
+      return {16 * 1024, 10, rocksdb::kZSTD, 16 * 1024};
+    }
+    return {16 * 1024, 10, rocksdb::kLZ4Compression, 16 * 1024};
+  }
+  if (keySpace->index == KeySpace::BlobFamily.index) {
+    // Blobs are large; bigger blocks keep the index small. LZ4 is cheap
+    // enough to not slow down reads of already compressed contents.
+    return {64 * 1024, 10, rocksdb::kLZ4Compression, 0};
+  }
+  if (keySpace->index == KeySpace::BlobMetaDataFamily.index ||
+      keySpace->index == KeySpace::HgCommitToTreeFamily.index) {
+    // Small values mostly made of hashes, which do not compress. Small blocks
+    // minimize what a point lookup reads and decodes.
+    return {kSmallBlock, 10, rocksdb::kNoCompression, 0};
+  }
+  // Proxy hashes contain paths, which compress well.
+  return {kSmallBlock, 10, rocksdb::kLZ4Compression, 0};
+}
+
+rocksdb::ColumnFamilyOptions makeProfileColumnOptions(
+    const ColumnProfile& profile,
+    std::shared_ptr<rocksdb::Cache> blockCache) {
+  auto options = makeColumnOptions(0);
+
+  // Same table settings as OptimizeForPointLookup, but with the profile's
+  // block size and bloom filter, and a block cache shared across columns.
+  rocksdb::BlockBasedTableOptions tableOptions;
+  tableOptions.data_block_index_type =
+      rocksdb::BlockBasedTableOptions::kDataBlockBinaryAndHash;
+  tableOptions.data_block_hash_table_util_ratio = 0.75;
+  tableOptions.filter_policy.reset(
+      rocksdb::NewBloomFilterPolicy(profile.bloomBitsPerKey));
+  tableOptions.block_cache = std::move(blockCache);
+  tableOptions.block_size = profile.blockSize;
+  options.table_factory.reset(
+      rocksdb::NewBlockBasedTableFactory(tableOptions));
+
+  // OptimizeLevelStyleCompaction leaves the first two levels uncompressed so
+  // that flushes stay cheap. Keep that and compress the rest.
+  for (size_t level = 2; level < options.compression_per_level.size();
+       ++level) {
+    options.compression_per_level[level] = profile.compression;
+  }
+  options.compression = profile.compression;
+
+  if (profile.maxDictBytes > 0) {
+    options.compression_opts.max_dict_bytes = profile.maxDictBytes;
+    if (profile.compression == rocksdb::kZSTD) {
+      // Train the dictionary on 100x its size of samples rather than using
+      // the raw samples.
+      options.compression_opts.zstd_max_train_bytes =
+          100 * profile.maxDictBytes;
+    }
+    options.bottommost_compression = profile.compression;
+    options.bottommost_compression_opts = options.compression_opts;
+    options.bottommost_compression_opts.enabled = true;
+  }
+  return options;
+}
+
 /**
  * The different key spaces that we desire.
  * The ordering is coupled with the values of the KeySpace enum.
  */
 const std::vector<rocksdb::ColumnFamilyDescriptor> columnFamilies(
     const rocksdb::DBOptions& db_options,
-    const std::string& name) {
+    const std::string& name,
+    RocksDbProfile profile) {
   // Most of the column families will share the same cache.  We
   // want the blob data to live in its own smaller cache; the assumption
   // is that the vfs cache will compensate for that, together with the
@@ -71,6 +156,23 @@ const std::vector<rocksdb::ColumnFamilyDescriptor> columnFamilies(
   auto options = makeColumnOptions(64);
   auto blobOptions = makeColumnOptions(8);
 
+  // The per-KeySpace profiles keep the same cache split.
+  std::shared_ptr<rocksdb::Cache> sharedCache;
+  std::shared_ptr<rocksdb::Cache> blobCache;
+  if (profile != RocksDbProfile::Uniform) {
+    sharedCache = rocksdb::NewLRUCache(64 * 1024 * 1024);
+    blobCache = rocksdb::NewLRUCache(8 * 1024 * 1024);
+  }
+
+  auto getOptions = [&](KeySpace ks) {
+    if (profile == RocksDbProfile::Uniform || ks->isDeprecated()) {
+      return (ks->index == KeySpace::BlobFamily.index) ? blobOptions : options;
+    }
+    return makeProfileColumnOptions(
+        getColumnProfile(ks, profile),
+        (ks->index == KeySpace::BlobFamily.index) ? blobCache : sharedCache);
+  };
+
   // We have to open all column families that currenly exists in our RocksDb.
   // Else we will get "Invalid argument: You have to open all column
   // families." when we try to open the DB. This tracks if there are any
@@ -82,9 +184,7 @@ const std::vector<rocksdb::ColumnFamilyDescriptor> columnFamilies(
 
   std::vector<rocksdb::ColumnFamilyDescriptor> families;
   for (auto& ks : KeySpace::kAll) {
-    families.emplace_back(
-        ks->name.str(),
-        (ks->index == KeySpace::BlobFamily.index) ? blobOptions : options);
+    families.emplace_back(ks->name.str(), getOptions(ks));
     auto oldFamily = find(
         oldUnopenedColumnFamilies.begin(),
         oldUnopenedColumnFamilies.end(),
@@ -250,10 +350,13 @@ rocksdb::Options getRocksdbOptions() {
   return options;
 }
 
-RocksHandles openDB(AbsolutePathPiece path, RocksDBOpenMode mode) {
+RocksHandles openDB(
+    AbsolutePathPiece path,
+    RocksDBOpenMode mode,
+    RocksDbProfile profile) {
   auto options = getRocksdbOptions();
-  const auto columnDescriptors =
-      columnFamilies(rocksdb::DBOptions{options}, path.stringWithoutUNC());
+  const auto columnDescriptors = columnFamilies(
+      rocksdb::DBOptions{options}, path.stringWithoutUNC(), profile);
   try {
     return RocksHandles(
         path.viewWithoutUNC(), mode, options, columnDescriptors);
@@ -267,7 +370,7 @@ RocksHandles openDB(AbsolutePathPiece path, RocksDBOpenMode mode) {
     // Fall through and attempt to repair the DB
   }
 
-  RocksDbLocalStore::repairDB(path);
+  RocksDbLocalStore::repairDB(path, profile);
 
   // Now try opening the DB again.
   return RocksHandles(path.viewWithoutUNC(), mode, options, columnDescriptors);
@@ -286,12 +389,14 @@ RocksDbLocalStore::RocksDbLocalStore(
     AbsolutePathPiece pathToRocksDb,
     std::shared_ptr<StructuredLogger> structuredLogger,
     FaultInjector* faultInjector,
-    RocksDBOpenMode mode)
+    RocksDBOpenMode mode,
+    RocksDbProfile profile)
     : structuredLogger_{std::move(structuredLogger)},
       faultInjector_(*faultInjector),
       ioPool_(12, "RocksLocalStore"),
       pathToDb_{pathToRocksDb.copy()},
-      mode_{mode} {
+      mode_{mode},
+      profile_{profile} {
   XLOG(DBG2) << "Making a new RockDB localstore ( " << this
              << " ) . debug information for T136469251.";
 }
@@ -311,8 +416,8 @@ void RocksDbLocalStore::open() {
       case RockDbHandleStatus::NOT_YET_OPENED:
         break;
     }
-    handles->handles =
-        std::make_unique<RocksHandles>(openDB(pathToDb_.piece(), mode_));
+    handles->handles = std::make_unique<RocksHandles>(
+        openDB(pathToDb_.piece(), mode_, profile_));
     handles->status = RockDbHandleStatus::OPEN;
   }
   // Publish fb303 stats once when we first open the DB.
@@ -362,7 +467,9 @@ RocksDbLocalStore::getHandles() const {
   return handles;
 }
 
-void RocksDbLocalStore::repairDB(AbsolutePathPiece path) {
+void RocksDbLocalStore::repairDB(
+    AbsolutePathPiece path,
+    RocksDbProfile profile) {
   XLOG(ERR) << "Attempting to repair RocksDB " << path;
   rocksdb::ColumnFamilyOptions unknownColumFamilyOptions;
   unknownColumFamilyOptions.OptimizeForPointLookup(8);
@@ -372,7 +479,7 @@ void RocksDbLocalStore::repairDB(AbsolutePathPiece path) {
   rocksdb::DBOptions dbOptions(getRocksdbOptions());
 
   const auto columnDescriptors =
-      columnFamilies(dbOptions, path.stringWithoutUNC());
+      columnFamilies(dbOptions, path.stringWithoutUNC(), profile);
 
   auto status = RepairDB(
       dbPathStr, dbOptions, columnDescriptors, unknownColumFamilyOptions);
@@ -11,6 +11,7 @@
 #include <folly/Synchronized.h>
 #include <bitset>
 
+#include "eden/fs/config/RocksDbProfile.h"
 #include "eden/fs/rocksdb/RocksHandles.h"
 #include "eden/fs/store/LocalStore.h"
 #include "eden/fs/utils/UnboundedQueueExecutor.h"
@@ -33,7 +34,8 @@ class RocksDbLocalStore final : public LocalStore {
       AbsolutePathPiece pathToRocksDb,
       std::shared_ptr<StructuredLogger> structuredLogger,
       FaultInjector* FOLLY_NONNULL faultInjector,
-      RocksDBOpenMode mode = RocksDBOpenMode::ReadWrite);
+      RocksDBOpenMode mode = RocksDBOpenMode::ReadWrite,
+      RocksDbProfile profile = RocksDbProfile::Uniform);
   void open() override;
   ~RocksDbLocalStore();
   void close() override;
@@ -49,7 +51,9 @@ class RocksDbLocalStore final : public LocalStore {
   std::unique_ptr<WriteBatch> beginWrite(size_t bufSize = 0) override;
 
   // Call RocksDB's RepairDB() function on the DB at the specified location
-  static void repairDB(AbsolutePathPiece path);
+  static void repairDB(
+      AbsolutePathPiece path,
+      RocksDbProfile profile = RocksDbProfile::Uniform);
 
   // Get the approximate number of bytes stored on disk for the
   // specified key space.
@@ -127,6 +131,7 @@ class RocksDbLocalStore final : public LocalStore {
   folly::Synchronized<AutoGCState> autoGCState_;
   AbsolutePath pathToDb_;
   RocksDBOpenMode mode_;
+  RocksDbProfile profile_;
   folly::Synchronized<RockDBState> dbHandles_;
 };
 
@@ -55,6 +55,27 @@ std::unique_ptr<BlobMetadata> SerializedBlobMetadata::parse(
   return unslice(bytes);
 }
 
+std::string SerializedBlobMetadata::blake3Key(const ObjectId& blobID) {
+  // The NUL byte keeps the suffix from looking like the end of a blob ID.
+  static constexpr folly::StringPiece kBlake3KeySuffix{"\0blake3", 7};
+  auto key = folly::StringPiece{blobID.getBytes()}.str();
+  key.append(kBlake3KeySuffix.data(), kBlake3KeySuffix.size());
+  return key;
+}
+
+Hash32 SerializedBlobMetadata::parseBlake3(
+    ObjectId blobID,
+    const StoreResult& result) {
+  auto bytes = result.bytes();
+  if (bytes.size() != Hash32::RAW_SIZE) {
+    throwf<std::invalid_argument>(
+        "BLAKE3 hash for {} had unexpected size {}. Could not deserialize.",
+        blobID,
+        bytes.size());
+  }
+  return Hash32{bytes};
+}
+
 void SerializedBlobMetadata::serialize(
     const Hash20& contentsHash,
     uint64_t blobSize) {
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <folly/Range.h>
+#include <string>
 #include "eden/fs/model/BlobMetadata.h"
 #include "eden/fs/model/Hash.h"
 #include "eden/fs/model/ObjectId.h"
@@ -27,6 +28,18 @@ class SerializedBlobMetadata {
 
   static constexpr size_t SIZE = sizeof(uint64_t) + Hash20::RAW_SIZE;
 
+  /**
+   * The BLAKE3 hash of a blob is stored in the same KeySpace as its metadata,
+   * under this key rather than the blob ID. The metadata record thus keeps
+   * the size that older versions of EdenFS require to parse it.
+   */
+  static std::string blake3Key(const ObjectId& blobID);
+
+  /**
+   * Parse a BLAKE3 hash stored under blake3Key().
+   */
+  static Hash32 parseBlake3(ObjectId blobID, const StoreResult& result);
+
  private:
   void serialize(const Hash20& contentsHash, uint64_t blobSize);
 
@@ -9,7 +9,11 @@
 
 #include <folly/String.h>
 #include <folly/container/Array.h>
+#include <folly/container/F14Map.h>
+#include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
+#include <algorithm>
+#include <optional>
 
 #include "eden/fs/sqlite/SqliteStatement.h"
 #include "eden/fs/store/StoreResult.h"
@@ -22,6 +26,13 @@ using std::string;
 
 namespace {
 
+/**
+ * Maximum number of keys looked up by a single query of getBatch. Stays below
+ * the SQLITE_MAX_VARIABLE_NUMBER of 999 that older SQLite versions default
+ * to.
+ */
+constexpr size_t kMaxBatchKeys = 500;
+
 /**
  * Implements the write batching helper.
  * In an ideal world, we'd just start a transaction and have the WriteBatch
@@ -100,8 +111,16 @@ class SqliteWriteBatch : public LocalStore::WriteBatch {
 
 } // namespace
 
-SqliteLocalStore::SqliteLocalStore(AbsolutePathPiece pathToDb)
-    : db_(pathToDb, SqliteDatabase::DelayOpeningDB{}) {}
+SqliteLocalStore::SqliteLocalStore(
+    AbsolutePathPiece pathToDb,
+    size_t numReaders)
+    : db_(pathToDb, SqliteDatabase::DelayOpeningDB{}) {
+  readers_.reserve(std::max<size_t>(numReaders, 1));
+  for (size_t i = 0; i < std::max<size_t>(numReaders, 1); ++i) {
+    readers_.push_back(std::make_unique<SqliteDatabase>(
+        pathToDb, SqliteDatabase::DelayOpeningDB{}));
+  }
+}
 
 void SqliteLocalStore::open() {
   db_.openDb();
@@ -126,13 +145,29 @@ void SqliteLocalStore::open() {
     }
   }
 
+  // The reader connections are opened once the tables exist, as they are not
+  // allowed to create them.
+  for (auto& reader : readers_) {
+    reader->openDb();
+    auto db = reader->lock();
+    SqliteStatement(db, "PRAGMA query_only=ON").step();
+  }
+
   clearDeprecatedKeySpaces();
 }
 
 void SqliteLocalStore::close() {
+  for (auto& reader : readers_) {
+    reader->close();
+  }
   db_.close();
 }
 
+SqliteDatabase& SqliteLocalStore::getReader() const {
+  auto index = nextReader_.fetch_add(1, std::memory_order_relaxed);
+  return *readers_[index % readers_.size()];
+}
+
 void SqliteLocalStore::clearKeySpace(KeySpace keySpace) {
   auto db = db_.lock();
 
@@ -143,7 +178,7 @@ void SqliteLocalStore::clearKeySpace(KeySpace keySpace) {
 void SqliteLocalStore::compactKeySpace(KeySpace) {}
 
 StoreResult SqliteLocalStore::get(KeySpace keySpace, ByteRange key) const {
-  auto db = db_.lock();
+  auto db = getReader().lock();
 
   SqliteStatement stmt(
       db, "select value from ", keySpace->name, " where key = ?");
@@ -160,8 +195,85 @@ StoreResult SqliteLocalStore::get(KeySpace keySpace, ByteRange key) const {
   return StoreResult::missing(keySpace, key);
 }
 
+folly::Future<std::vector<StoreResult>> SqliteLocalStore::getBatch(
+    KeySpace keySpace,
+    const std::vector<ByteRange>& keys) const {
+  return folly::makeFutureWith([&] {
+    // Index of the first occurrence of each key, and the value found for it.
+    folly::F14FastMap<StringPiece, size_t> indices;
+    std::vector<std::optional<string>> values(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      indices.try_emplace(StringPiece{keys[i]}, i);
+    }
+
+    {
+      auto db = getReader().lock();
+
+      // Every query but the last has kMaxBatchKeys parameters, prepare it once.
+      std::optional<SqliteStatement> fullStmt;
+      auto prepare = [&](size_t count) {
+        string params;
+        params.reserve(2 * count);
+        for (size_t i = 0; i < count; ++i) {
+          params.append(i == 0 ? "?" : ",?");
+        }
+        return SqliteStatement(
+            db,
+            "select key, value from ",
+            keySpace->name,
+            " where key in (",
+            params,
+            ")");
+      };
+
+      for (size_t start = 0; start < keys.size(); start += kMaxBatchKeys) {
+        auto count = std::min(kMaxBatchKeys, keys.size() - start);
+        std::optional<SqliteStatement> partialStmt;
+        SqliteStatement* stmt;
+        if (count == kMaxBatchKeys) {
+          if (!fullStmt) {
+            fullStmt.emplace(prepare(count));
+          } else {
+            fullStmt->reset();
+          }
+          stmt = &*fullStmt;
+        } else {
+          partialStmt.emplace(prepare(count));
+          stmt = &*partialStmt;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+          stmt->bind(i + 1, keys[start + i]);
+        }
+        while (stmt->step()) {
+          auto it = indices.find(stmt->columnBlob(0));
+          if (it != indices.end()) {
+            values[it->second] = stmt->columnBlob(1).str();
+          }
+        }
+      }
+    }
+
+    // Values can only be moved out when no other key shares them.
+    bool hasDuplicates = indices.size() != keys.size();
+    std::vector<StoreResult> results;
+    results.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      auto& value = values[indices.at(StringPiece{keys[i]})];
+      if (!value) {
+        results.push_back(StoreResult::missing(keySpace, keys[i]));
+      } else if (hasDuplicates) {
+        results.emplace_back(string{*value});
+      } else {
+        results.emplace_back(std::move(*value));
+      }
+    }
+    return results;
+  });
+}
+
 bool SqliteLocalStore::hasKey(KeySpace keySpace, ByteRange key) const {
-  auto db = db_.lock();
+  auto db = getReader().lock();
 
   SqliteStatement stmt(db, "select 1 from ", keySpace->name, " where key = ?");
 
@@ -7,6 +7,9 @@
 
 #pragma once
 #include <folly/Synchronized.h>
+#include <atomic>
+#include <memory>
+#include <vector>
 #include "eden/fs/sqlite/SqliteDatabase.h"
 #include "eden/fs/store/LocalStore.h"
 
@@ -15,15 +18,27 @@ namespace facebook::eden {
 /** An implementation of LocalStore that stores values in Sqlite.
  * SqliteLocalStore is thread safe, allowing reads and writes from
  * any thread.
+ *
+ * The database is in WAL mode, where readers do not block the writer nor
+ * each other. Writes go through a single connection, while reads are spread
+ * over a pool of numReaders read-only connections so that lookups from
+ * different threads proceed in parallel.
  * */
 class SqliteLocalStore final : public LocalStore {
  public:
-  explicit SqliteLocalStore(AbsolutePathPiece pathToDb);
+  static constexpr size_t kDefaultNumReaders = 4;
+
+  explicit SqliteLocalStore(
+      AbsolutePathPiece pathToDb,
+      size_t numReaders = kDefaultNumReaders);
   void open() override;
   void close() override;
   void clearKeySpace(KeySpace keySpace) override;
   void compactKeySpace(KeySpace keySpace) override;
   StoreResult get(KeySpace keySpace, folly::ByteRange key) const override;
+  folly::Future<std::vector<StoreResult>> getBatch(
+      KeySpace keySpace,
+      const std::vector<folly::ByteRange>& keys) const override;
   bool hasKey(KeySpace keySpace, folly::ByteRange key) const override;
   void put(KeySpace keySpace, folly::ByteRange key, folly::ByteRange value)
       override;
@@ -31,7 +46,18 @@ class SqliteLocalStore final : public LocalStore {
       size_t bufSize = 0) override;
 
  private:
+  /**
+   * Returns the next reader connection, in a round-robin fashion.
+   */
+  SqliteDatabase& getReader() const;
+
+  /**
+   * The connection used for all writes and schema changes.
+   */
   mutable SqliteDatabase db_;
+
+  std::vector<std::unique_ptr<SqliteDatabase>> readers_;
+  mutable std::atomic<size_t> nextReader_{0};
 };
 
 } // namespace facebook::eden
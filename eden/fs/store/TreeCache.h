@@ -30,6 +30,9 @@ class ReloadableConfig;
  * be cachable your minimum entry count must be atleast 1, otherwise insert may
  * not actually insert the tree into the cache.
  *
+ * With treecache:enable-tiny-lfu, trees are instead evicted following the
+ * scan-resistant ObjectCachePolicy::TinyLFU policy.
+ *
  * It is safe to use this object from arbitrary threads.
  */
 class TreeCache : public ObjectCache<Tree, ObjectCacheFlavor::Simple> {
@@ -8,9 +8,13 @@
 #include "GitBackingStore.h"
 
 #include <folly/Conv.h>
+#include <folly/Try.h>
 #include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
+#include <folly/system/ThreadName.h>
 #include <git2.h>
+#include <algorithm>
+#include <type_traits>
 
 #include "eden/fs/model/Blob.h"
 #include "eden/fs/model/Hash.h"
@@ -20,6 +24,7 @@
 #include "eden/fs/service/ThriftUtil.h"
 #include "eden/fs/store/ObjectFetchContext.h"
 #include "eden/fs/utils/EnumValue.h"
+#include "eden/fs/utils/FaultInjector.h"
 #include "eden/fs/utils/Throw.h"
 #include "folly/String.h"
 
@@ -31,7 +36,6 @@
 
 using folly::ByteRange;
 using folly::IOBuf;
-using folly::makeSemiFuture;
 using folly::SemiFuture;
 using folly::StringPiece;
 using std::make_unique;
@@ -56,31 +60,77 @@ void freeBlobIOBufData(void* /*blobData*/, void* blobObject) {
   git_blob_free(gitBlob);
 }
 
-} // namespace
-
-GitBackingStore::GitBackingStore(AbsolutePathPiece repository) {
-  // Make sure libgit2 is initialized.
-  // (git_libgit2_init() is safe to call multiple times if multiple
-  // GitBackingStore objects are created.  git_libgit2_shutdown() should be
-  // called once for each call to git_libgit2_init().)
-  git_libgit2_init();
-
+git_repository* openRepository(AbsolutePathPiece repository) {
+  git_repository* repo = nullptr;
 #if defined(__has_feature)
 #if __has_feature(address_sanitizer)
   __lsan_disable();
 #endif
 #endif
   auto error =
-      git_repository_open(&repo_, std::string{repository.value()}.c_str());
+      git_repository_open(&repo, std::string{repository.value()}.c_str());
 #if defined(__has_feature)
 #if __has_feature(address_sanitizer)
   __lsan_enable();
 #endif
 #endif
   gitCheckError(error, "error opening git repository", repository);
+  return repo;
+}
+
+} // namespace
+
+GitBackingStore::GitBackingStore(
+    AbsolutePathPiece repository,
+    FaultInjector* faultInjector,
+    size_t numThreads,
+    size_t batchSize)
+    : faultInjector_{*faultInjector},
+      batchSize_{std::max<size_t>(batchSize, 1)} {
+  // Make sure libgit2 is initialized.
+  // (git_libgit2_init() is safe to call multiple times if multiple
+  // GitBackingStore objects are created.  git_libgit2_shutdown() should be
+  // called once for each call to git_libgit2_init().)
+  git_libgit2_init();
+
+  try {
+    repo_ = openRepository(repository);
+
+    // Open every handle up front, so that errors are reported here rather
+    // than on the worker threads.
+    numThreads = std::max<size_t>(numThreads, 1);
+    workerRepos_.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+      workerRepos_.push_back(openRepository(repository));
+    }
+  } catch (...) {
+    for (auto* repo : workerRepos_) {
+      git_repository_free(repo);
+    }
+    git_repository_free(repo_);
+    git_libgit2_shutdown();
+    throw;
+  }
+
+  workerThreads_.reserve(workerRepos_.size());
+  for (auto* repo : workerRepos_) {
+    workerThreads_.emplace_back([this, repo] {
+      folly::setThreadName("GitImport");
+      processOnWorkerThread(repo);
+    });
+  }
 }
 
 GitBackingStore::~GitBackingStore() {
+  state_.lock()->stopping = true;
+  workCV_.notify_all();
+  for (auto& thread : workerThreads_) {
+    thread.join();
+  }
+
+  for (auto* repo : workerRepos_) {
+    git_repository_free(repo);
+  }
   git_repository_free(repo_);
   git_libgit2_shutdown();
 }
@@ -116,6 +166,7 @@ ImmediateFuture<unique_ptr<Tree>> GitBackingStore::getRootTree(
   // Look up the commit info
   git_oid commitOID = root2Oid(rootId);
   git_commit* commit = nullptr;
+  std::lock_guard<std::mutex> guard{repoMutex_};
 #if defined(__has_feature)
 #if __has_feature(address_sanitizer)
   __lsan_disable();
@@ -141,18 +192,35 @@ ImmediateFuture<unique_ptr<Tree>> GitBackingStore::getRootTree(
   ObjectId treeID = oid2Hash(git_commit_tree_id(commit));
 
   // Now get the specified tree.
-  return getTreeImpl(treeID);
+  return getTreeImpl(repo_, treeID);
 }
 
 SemiFuture<BackingStore::GetTreeResult> GitBackingStore::getTree(
     const ObjectId& id,
+    const ObjectFetchContextPtr& context) {
+  return std::move(getTreeBatch({id}, context)[0]);
+}
+
+std::vector<SemiFuture<BackingStore::GetTreeResult>>
+GitBackingStore::getTreeBatch(
+    const std::vector<ObjectId>& ids,
     const ObjectFetchContextPtr& /*context*/) {
-  // TODO: Use a separate thread pool to do the git I/O
-  return makeSemiFuture(BackingStore::GetTreeResult{
-      getTreeImpl(id), ObjectFetchContext::Origin::FromDiskCache});
+  auto trees = enqueue<Tree>(ids);
+  std::vector<SemiFuture<BackingStore::GetTreeResult>> results;
+  results.reserve(trees.size());
+  for (auto& tree : trees) {
+    results.push_back(
+        std::move(tree).deferValue([](std::shared_ptr<const Tree> tree) {
+          return BackingStore::GetTreeResult{
+              std::move(tree), ObjectFetchContext::Origin::FromDiskCache};
+        }));
+  }
+  return results;
 }
 
-unique_ptr<Tree> GitBackingStore::getTreeImpl(const ObjectId& id) {
+unique_ptr<Tree> GitBackingStore::getTreeImpl(
+    git_repository* repo,
+    const ObjectId& id) {
   XLOG(DBG4) << "importing tree " << id;
 
   git_oid treeOID = hash2Oid(id);
@@ -162,14 +230,18 @@ unique_ptr<Tree> GitBackingStore::getTreeImpl(const ObjectId& id) {
   __lsan_disable();
 #endif
 #endif
-  auto error = git_tree_lookup(&gitTree, repo_, &treeOID);
+  auto error = git_tree_lookup(&gitTree, repo, &treeOID);
 #if defined(__has_feature)
 #if __has_feature(address_sanitizer)
   __lsan_enable();
 #endif
 #endif
   gitCheckError(
-      error, "unable to find git tree ", id, " in repository ", getPath());
+      error,
+      "unable to find git tree ",
+      id,
+      " in repository ",
+      git_repository_path(repo));
   SCOPE_EXIT {
     git_tree_free(gitTree);
   };
@@ -208,13 +280,30 @@ unique_ptr<Tree> GitBackingStore::getTreeImpl(const ObjectId& id) {
 
 SemiFuture<BackingStore::GetBlobResult> GitBackingStore::getBlob(
     const ObjectId& id,
+    const ObjectFetchContextPtr& context) {
+  return std::move(getBlobBatch({id}, context)[0]);
+}
+
+std::vector<SemiFuture<BackingStore::GetBlobResult>>
+GitBackingStore::getBlobBatch(
+    const std::vector<ObjectId>& ids,
     const ObjectFetchContextPtr& /*context*/) {
-  // TODO: Use a separate thread pool to do the git I/O
-  return makeSemiFuture(BackingStore::GetBlobResult{
-      getBlobImpl(id), ObjectFetchContext::Origin::FromDiskCache});
+  auto blobs = enqueue<Blob>(ids);
+  std::vector<SemiFuture<BackingStore::GetBlobResult>> results;
+  results.reserve(blobs.size());
+  for (auto& blob : blobs) {
+    results.push_back(
+        std::move(blob).deferValue([](std::shared_ptr<const Blob> blob) {
+          return BackingStore::GetBlobResult{
+              std::move(blob), ObjectFetchContext::Origin::FromDiskCache};
+        }));
+  }
+  return results;
 }
 
-unique_ptr<Blob> GitBackingStore::getBlobImpl(const ObjectId& id) {
+unique_ptr<Blob> GitBackingStore::getBlobImpl(
+    git_repository* repo,
+    const ObjectId& id) {
   XLOG(DBG5) << "importing blob " << id;
 
   auto blobOID = hash2Oid(id);
@@ -224,14 +313,18 @@ unique_ptr<Blob> GitBackingStore::getBlobImpl(const ObjectId& id) {
   __lsan_disable();
 #endif
 #endif
-  int error = git_blob_lookup(&blob, repo_, &blobOID);
+  int error = git_blob_lookup(&blob, repo, &blobOID);
 #if defined(__has_feature)
 #if __has_feature(address_sanitizer)
   __lsan_enable();
 #endif
 #endif
   gitCheckError(
-      error, "unable to find git blob ", id, " in repository ", getPath());
+      error,
+      "unable to find git blob ",
+      id,
+      " in repository ",
+      git_repository_path(repo));
 
   // Create an IOBuf which points at the blob data owned by git.
   auto dataSize = git_blob_rawsize(blob);
@@ -255,6 +348,125 @@ GitBackingStore::getBlobMetadata(
       nullptr, ObjectFetchContext::Origin::NotFetched};
 }
 
+template <typename T>
+GitBackingStore::ImportQueue<T>& GitBackingStore::getImportQueue(
+    State& state) {
+  if constexpr (std::is_same_v<T, Tree>) {
+    return state.trees;
+  } else {
+    static_assert(std::is_same_v<T, Blob>, "Unsupported object type");
+    return state.blobs;
+  }
+}
+
+template <typename T>
+std::vector<SemiFuture<std::shared_ptr<const T>>> GitBackingStore::enqueue(
+    const std::vector<ObjectId>& ids) {
+  std::vector<SemiFuture<std::shared_ptr<const T>>> futures;
+  futures.reserve(ids.size());
+  size_t queued = 0;
+  {
+    auto state = state_.lock();
+    auto& importQueue = getImportQueue<T>(*state);
+    for (const auto& id : ids) {
+      auto [it, inserted] = importQueue.pending.try_emplace(id);
+      if (inserted) {
+        importQueue.queue.push_back(id);
+        ++queued;
+      }
+      futures.push_back(it->second.emplace_back().getSemiFuture());
+    }
+  }
+
+  // Requests joining imports already queued need no worker, and a single
+  // new import only needs one.
+  if (queued == 1) {
+    workCV_.notify_one();
+  } else if (queued > 1) {
+    workCV_.notify_all();
+  }
+  return futures;
+}
+
+template <typename T>
+void GitBackingStore::importBatch(
+    git_repository* repo,
+    const std::vector<ObjectId>& ids) {
+  for (const auto& id : ids) {
+    auto result =
+        folly::makeTryWith([&]() -> std::shared_ptr<const T> {
+          faultInjector_.check("git_import", id.asHexString());
+          if constexpr (std::is_same_v<T, Tree>) {
+            return getTreeImpl(repo, id);
+          } else {
+            return getBlobImpl(repo, id);
+          }
+        });
+
+    // Requests for this id that arrived during the import joined it.
+    std::vector<folly::Promise<std::shared_ptr<const T>>> promises;
+    {
+      auto state = state_.lock();
+      auto& pending = getImportQueue<T>(*state).pending;
+      auto it = pending.find(id);
+      promises = std::move(it->second);
+      pending.erase(it);
+    }
+    for (auto& promise : promises) {
+      promise.setTry(folly::Try<std::shared_ptr<const T>>{result});
+    }
+  }
+}
+
+void GitBackingStore::processOnWorkerThread(git_repository* repo) {
+  for (;;) {
+    std::vector<ObjectId> trees;
+    std::vector<ObjectId> blobs;
+    {
+      auto state = state_.lock();
+      workCV_.wait(state.as_lock(), [&] {
+        return state->stopping || !state->trees.queue.empty() ||
+            !state->blobs.queue.empty();
+      });
+      if (state->stopping) {
+        // Pending promises are broken when the store is destroyed.
+        return;
+      }
+
+      // Trees come first: the directories they describe must be listed
+      // before their files can be read.
+      auto take = [&](std::deque<ObjectId>& queue,
+                      std::vector<ObjectId>& batch) {
+        auto count = computeBatchSize(
+            queue.size(), workerRepos_.size(), batchSize_);
+        batch.assign(
+            std::make_move_iterator(queue.begin()),
+            std::make_move_iterator(queue.begin() + count));
+        queue.erase(queue.begin(), queue.begin() + count);
+      };
+      if (!state->trees.queue.empty()) {
+        take(state->trees.queue, trees);
+      } else {
+        take(state->blobs.queue, blobs);
+      }
+    }
+
+    if (!trees.empty()) {
+      importBatch<Tree>(repo, trees);
+    } else {
+      importBatch<Blob>(repo, blobs);
+    }
+  }
+}
+
+size_t GitBackingStore::computeBatchSize(
+    size_t queueSize,
+    size_t numThreads,
+    size_t maxBatchSize) {
+  numThreads = std::max<size_t>(numThreads, 1);
+  return std::min((queueSize + numThreads - 1) / numThreads, maxBatchSize);
+}
+
 git_oid GitBackingStore::root2Oid(const RootId& rootId) {
   auto& value = rootId.value();
   CHECK_EQ(40, value.size());
@@ -8,6 +8,14 @@
 #pragma once
 
 #include <folly/Range.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <folly/futures/Promise.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "eden/fs/store/BackingStore.h"
 #include "eden/fs/store/ObjectFetchContext.h"
@@ -18,19 +26,33 @@ struct git_repository;
 
 namespace facebook::eden {
 
+class FaultInjector;
+
 /**
  * A BackingStore implementation that loads data out of a git repository.
+ *
+ * A libgit2 repository handle can only be used by one thread at a time, so
+ * trees and blobs are imported by a pool of worker threads, each with its own
+ * handle. Requests are queued, de-duplicated against the imports already
+ * queued or in progress, and split between the workers in batches.
  */
 class GitBackingStore final : public BijectiveBackingStore {
  public:
+  static constexpr size_t kDefaultNumThreads = 8;
+  static constexpr size_t kDefaultBatchSize = 32;
+
   /**
-   * Create a new GitBackingStore.
+   * Create a new GitBackingStore, with numThreads import threads each taking
+   * up to batchSize requests at a time off the queue.
    *
-   * The LocalStore object is owned by the EdenServer (which also owns this
-   * GitBackingStore object).  It is guaranteed to be valid for the lifetime of
-   * the GitBackingStore object.
+   * The given FaultInjector must be valid during the lifetime of this
+   * GitBackingStore object.
    */
-  explicit GitBackingStore(AbsolutePathPiece repository);
+  GitBackingStore(
+      AbsolutePathPiece repository,
+      FaultInjector* FOLLY_NONNULL faultInjector,
+      size_t numThreads = kDefaultNumThreads,
+      size_t batchSize = kDefaultBatchSize);
   ~GitBackingStore() override;
 
   /**
@@ -64,6 +86,35 @@ class GitBackingStore final : public BijectiveBackingStore {
       const ObjectId& id,
       const ObjectFetchContextPtr& context) override;
 
+  /**
+   * Queue the import of several trees at once, under one lock acquisition.
+   * Returns one future per id, in the same order, each completing as soon as
+   * its tree is imported.
+   */
+  std::vector<folly::SemiFuture<BackingStore::GetTreeResult>> getTreeBatch(
+      const std::vector<ObjectId>& ids,
+      const ObjectFetchContextPtr& context);
+
+  /**
+   * Queue the import of several blobs at once, like getTreeBatch.
+   */
+  std::vector<folly::SemiFuture<BackingStore::GetBlobResult>> getBlobBatch(
+      const std::vector<ObjectId>& ids,
+      const ObjectFetchContextPtr& context);
+
+  /**
+   * Number of requests a worker takes off a queue of queueSize requests.
+   *
+   * The queue is split evenly between the numThreads workers, so that a
+   * burst of requests is imported in parallel rather than serially by
+   * whichever worker wakes up first. Batches still hold at most
+   * maxBatchSize requests.
+   */
+  static size_t computeBatchSize(
+      size_t queueSize,
+      size_t numThreads,
+      size_t maxBatchSize);
+
   // TODO(T119221752): Implement for all BackingStore subclasses
   int64_t dropAllPendingRequestsFromQueue() override {
     XLOG(
@@ -76,15 +127,79 @@ class GitBackingStore final : public BijectiveBackingStore {
   GitBackingStore(GitBackingStore const&) = delete;
   GitBackingStore& operator=(GitBackingStore const&) = delete;
 
-  std::unique_ptr<Tree> getTreeImpl(const ObjectId& id);
-  std::unique_ptr<Blob> getBlobImpl(const ObjectId& id);
+  template <typename T>
+  struct ImportQueue {
+    /**
+     * Ids waiting for a worker thread, oldest first. An id is queued at most
+     * once.
+     */
+    std::deque<ObjectId> queue;
+
+    /**
+     * Promises of every queued or in progress import. A request for an id
+     * already in here joins the existing import.
+     */
+    folly::F14NodeMap<
+        ObjectId,
+        std::vector<folly::Promise<std::shared_ptr<const T>>>>
+        pending;
+  };
+
+  struct State {
+    ImportQueue<Tree> trees;
+    ImportQueue<Blob> blobs;
+    bool stopping{false};
+  };
+
+  template <typename T>
+  static ImportQueue<T>& getImportQueue(State& state);
+
+  template <typename T>
+  std::vector<folly::SemiFuture<std::shared_ptr<const T>>> enqueue(
+      const std::vector<ObjectId>& ids);
+
+  /**
+   * Import the given ids with repo and fulfill the promises waiting for them.
+   */
+  template <typename T>
+  void importBatch(git_repository* repo, const std::vector<ObjectId>& ids);
+
+  void processOnWorkerThread(git_repository* repo);
+
+  static std::unique_ptr<Tree> getTreeImpl(
+      git_repository* repo,
+      const ObjectId& id);
+  static std::unique_ptr<Blob> getBlobImpl(
+      git_repository* repo,
+      const ObjectId& id);
 
   static git_oid root2Oid(const RootId& rootId);
 
   static git_oid hash2Oid(const ObjectId& hash);
   static ObjectId oid2Hash(const git_oid* oid);
 
+  /**
+   * Handle used to resolve root trees, which are only needed when checking
+   * out a commit. Protected by repoMutex_.
+   */
   git_repository* repo_{nullptr};
+  std::mutex repoMutex_;
+
+  FaultInjector& faultInjector_;
+  const size_t batchSize_;
+
+  folly::Synchronized<State, std::mutex> state_;
+
+  /**
+   * Signaled when imports are queued or the worker threads must stop.
+   */
+  std::condition_variable workCV_;
+
+  /**
+   * One handle per worker thread, used only by that thread.
+   */
+  std::vector<git_repository*> workerRepos_;
+  std::vector<std::thread> workerThreads_;
 };
 
 } // namespace facebook::eden
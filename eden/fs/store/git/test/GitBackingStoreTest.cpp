@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/git/GitBackingStore.h"
+
+#include <fmt/format.h>
+#include <folly/portability/GTest.h>
+#include <git2.h>
+#include <thread>
+
+#include "eden/fs/model/Blob.h"
+#include "eden/fs/model/Tree.h"
+#include "eden/fs/testharness/TempFile.h"
+#include "eden/fs/utils/FaultInjector.h"
+
+using namespace facebook::eden;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr auto kTimeout = 10s;
+
+ObjectId oidToObjectId(const git_oid& oid) {
+  return ObjectId{folly::ByteRange{oid.id, GIT_OID_RAWSZ}};
+}
+
+/**
+ * Creates a bare git repository in a temporary directory, to be read by a
+ * GitBackingStore.
+ */
+class GitBackingStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    git_libgit2_init();
+    ASSERT_EQ(
+        0,
+        git_repository_init(
+            &repo_, repoPath().asString().c_str(), /*is_bare=*/1));
+  }
+
+  void TearDown() override {
+    git_repository_free(repo_);
+    git_libgit2_shutdown();
+  }
+
+  AbsolutePath repoPath() const {
+    return canonicalPath(tempDir_.path().string());
+  }
+
+  ObjectId writeBlob(folly::StringPiece contents) {
+    git_oid oid;
+    EXPECT_EQ(
+        0,
+        git_blob_create_frombuffer(
+            &oid, repo_, contents.data(), contents.size()));
+    return oidToObjectId(oid);
+  }
+
+  ObjectId writeTree(
+      const std::vector<std::pair<std::string, ObjectId>>& files) {
+    git_treebuilder* builder = nullptr;
+    EXPECT_EQ(0, git_treebuilder_new(&builder, repo_, nullptr));
+    for (const auto& [name, id] : files) {
+      git_oid oid;
+      memcpy(oid.id, id.getBytes().data(), GIT_OID_RAWSZ);
+      EXPECT_EQ(
+          0,
+          git_treebuilder_insert(
+              nullptr, builder, name.c_str(), &oid, GIT_FILEMODE_BLOB));
+    }
+    git_oid treeOid;
+    EXPECT_EQ(0, git_treebuilder_write(&treeOid, builder));
+    git_treebuilder_free(builder);
+    return oidToObjectId(treeOid);
+  }
+
+  std::unique_ptr<GitBackingStore> makeStore(size_t numThreads) {
+    return std::make_unique<GitBackingStore>(
+        repoPath(), &faultInjector_, numThreads);
+  }
+
+  folly::test::TemporaryDirectory tempDir_ = makeTempDir();
+  git_repository* repo_{nullptr};
+  FaultInjector faultInjector_{/*enabled=*/true};
+};
+
+} // namespace
+
+TEST(GitBackingStoreBatchSize, splits_queue_between_threads) {
+  EXPECT_EQ(1, GitBackingStore::computeBatchSize(1, 8, 32));
+  EXPECT_EQ(1, GitBackingStore::computeBatchSize(8, 8, 32));
+  EXPECT_EQ(2, GitBackingStore::computeBatchSize(9, 8, 32));
+  EXPECT_EQ(32, GitBackingStore::computeBatchSize(1000, 8, 32));
+  EXPECT_EQ(5, GitBackingStore::computeBatchSize(5, 1, 32));
+}
+
+TEST_F(GitBackingStoreTest, imports_trees_and_blobs) {
+  auto fooId = writeBlob("foo contents");
+  auto barId = writeBlob("bar contents");
+  auto treeId = writeTree({{"bar", barId}, {"foo", fooId}});
+  auto store = makeStore(2);
+
+  auto tree = store->getTree(treeId, ObjectFetchContext::getNullContext())
+                  .get(kTimeout)
+                  .tree;
+  ASSERT_EQ(2, tree->size());
+  EXPECT_EQ(fooId, tree->find("foo"_pc)->second.getHash());
+
+  auto blob = store->getBlob(fooId, ObjectFetchContext::getNullContext())
+                  .get(kTimeout)
+                  .blob;
+  EXPECT_EQ("foo contents", blob->asString());
+}
+
+TEST_F(GitBackingStoreTest, concurrent_requests_share_one_import) {
+  auto id = writeBlob("contents");
+  auto store = makeStore(2);
+
+  // Hold the import so that the second request arrives while it is pending.
+  faultInjector_.injectBlock("git_import", ".*", /*count=*/1);
+  auto first = store->getBlob(id, ObjectFetchContext::getNullContext());
+  auto second = store->getBlob(id, ObjectFetchContext::getNullContext());
+  EXPECT_FALSE(first.isReady());
+  EXPECT_FALSE(second.isReady());
+
+  while (faultInjector_.unblock("git_import", ".*") == 0) {
+    std::this_thread::yield();
+  }
+  auto firstBlob = std::move(first).get(kTimeout).blob;
+  auto secondBlob = std::move(second).get(kTimeout).blob;
+  EXPECT_EQ("contents", firstBlob->asString());
+  EXPECT_EQ(firstBlob, secondBlob);
+}
+
+TEST_F(GitBackingStoreTest, imports_burst_with_several_threads) {
+  std::vector<ObjectId> ids;
+  for (size_t i = 0; i < 64; ++i) {
+    ids.push_back(writeBlob(fmt::format("blob {}", i)));
+  }
+  auto store = makeStore(4);
+
+  std::vector<folly::SemiFuture<BackingStore::GetBlobResult>> futures;
+  for (const auto& id : ids) {
+    futures.push_back(
+        store->getBlob(id, ObjectFetchContext::getNullContext()));
+  }
+  for (size_t i = 0; i < futures.size(); ++i) {
+    auto blob = std::move(futures[i]).get(kTimeout).blob;
+    EXPECT_EQ(fmt::format("blob {}", i), blob->asString());
+  }
+}
+
+TEST_F(GitBackingStoreTest, batch_results_follow_request_order) {
+  auto fooId = writeBlob("foo");
+  auto barId = writeBlob("bar");
+  auto treeId = writeTree({{"bar", barId}, {"foo", fooId}});
+  auto store = makeStore(2);
+
+  auto blobs = store->getBlobBatch(
+      {barId, fooId, barId}, ObjectFetchContext::getNullContext());
+  ASSERT_EQ(3, blobs.size());
+  auto first = std::move(blobs[0]).get(kTimeout).blob;
+  EXPECT_EQ("bar", first->asString());
+  EXPECT_EQ("foo", std::move(blobs[1]).get(kTimeout).blob->asString());
+  // Both requests for bar share its import.
+  EXPECT_EQ(first, std::move(blobs[2]).get(kTimeout).blob);
+
+  auto trees =
+      store->getTreeBatch({treeId}, ObjectFetchContext::getNullContext());
+  ASSERT_EQ(1, trees.size());
+  EXPECT_EQ(2, std::move(trees[0]).get(kTimeout).tree->size());
+}
@@ -127,13 +127,13 @@ void HgDatapackStore::getTreeBatch(
             importRequest->getRequest<HgImportRequest::TreeImport>();
         // A proposed folly::Try::and_then would make the following much
         // simpler.
-        importRequest->getPromise<std::unique_ptr<Tree>>()->setWith(
-            [&]() -> folly::Try<std::unique_ptr<Tree>> {
+        using Response = HgImportRequest::TreeImport::Response;
+        importRequest->getPromise<Response>()->setWith(
+            [&]() -> folly::Try<Response> {
               if (content.hasException()) {
-                return folly::Try<std::unique_ptr<Tree>>{
-                    std::move(content).exception()};
+                return folly::Try<Response>{std::move(content).exception()};
               }
-              return folly::Try{fromRawTree(
+              return folly::Try<Response>{fromRawTree(
                   content.value().get(),
                   treeRequest->hash,
                   treeRequest->proxyHash.path(),
@@ -221,14 +221,14 @@ void HgDatapackStore::getBlobBatch(
             importRequest->getRequest<HgImportRequest::BlobImport>();
         // A proposed folly::Try::and_then would make the following much
         // simpler.
-        importRequest->getPromise<std::unique_ptr<Blob>>()->setWith(
-            [&]() -> folly::Try<std::unique_ptr<Blob>> {
+        using Response = HgImportRequest::BlobImport::Response;
+        importRequest->getPromise<Response>()->setWith(
+            [&]() -> folly::Try<Response> {
               if (content.hasException()) {
-                return folly::Try<std::unique_ptr<Blob>>{
-                    std::move(content).exception()};
+                return folly::Try<Response>{std::move(content).exception()};
               }
-              return folly::Try{
-                  std::make_unique<Blob>(blobRequest->hash, *content.value())};
+              return folly::Try<Response>{std::make_shared<const Blob>(
+                  blobRequest->hash, *content.value())};
             });
 
         // Make sure that we're stopping this watch.
@@ -290,15 +290,15 @@ void HgDatapackStore::getBlobMetadataBatch(
 
         XLOGF(DBG9, "Imported aux={}", folly::hexlify(requests[index]));
         auto& importRequest = importRequests[index];
-        importRequest->getPromise<std::unique_ptr<BlobMetadata>>()->setWith(
-            [&]() -> folly::Try<std::unique_ptr<BlobMetadata>> {
+        using Response = HgImportRequest::BlobMetaImport::Response;
+        importRequest->getPromise<Response>()->setWith(
+            [&]() -> folly::Try<Response> {
               if (auxTry.hasException()) {
-                return folly::Try<std::unique_ptr<BlobMetadata>>{
-                    std::move(auxTry).exception()};
+                return folly::Try<Response>{std::move(auxTry).exception()};
               }
 
               auto& aux = auxTry.value();
-              return folly::Try{std::make_unique<BlobMetadata>(
+              return folly::Try<Response>{std::make_shared<const BlobMetadata>(
                   Hash20{aux->content_sha1}, aux->total_size)};
             });
 
@@ -10,6 +10,7 @@
 #include <folly/Try.h>
 #include <folly/futures/Future.h>
 #include <folly/futures/Promise.h>
+#include <algorithm>
 
 #include "eden/fs/telemetry/RequestMetricsScope.h"
 
@@ -20,22 +21,26 @@ HgImportRequest::HgImportRequest(
     RequestType request,
     ImportPriority priority,
     ObjectFetchContext::Cause cause,
+    std::optional<pid_t> clientPid,
     folly::Promise<typename RequestType::Response>&& promise)
     : request_(std::move(request)),
       priority_(priority),
       cause_(cause),
+      clientPid_(clientPid),
       promise_(std::move(promise)) {}
 
 template <typename RequestType, typename... Input>
 std::shared_ptr<HgImportRequest> HgImportRequest::makeRequest(
     ImportPriority priority,
     ObjectFetchContext::Cause cause,
+    std::optional<pid_t> clientPid,
     Input&&... input) {
   auto promise = folly::Promise<typename RequestType::Response>{};
   return std::make_shared<HgImportRequest>(
       RequestType{std::forward<Input>(input)...},
       priority,
       cause,
+      clientPid,
       std::move(promise));
 }
 
@@ -43,24 +48,66 @@ std::shared_ptr<HgImportRequest> HgImportRequest::makeBlobImportRequest(
     const ObjectId& hash,
     const HgProxyHash& proxyHash,
     ImportPriority priority,
-    ObjectFetchContext::Cause cause) {
-  return makeRequest<BlobImport>(priority, cause, hash, proxyHash);
+    ObjectFetchContext::Cause cause,
+    std::optional<pid_t> clientPid) {
+  return makeRequest<BlobImport>(priority, cause, clientPid, hash, proxyHash);
 }
 
 std::shared_ptr<HgImportRequest> HgImportRequest::makeTreeImportRequest(
     const ObjectId& hash,
     const HgProxyHash& proxyHash,
     ImportPriority priority,
-    ObjectFetchContext::Cause cause) {
-  return makeRequest<TreeImport>(priority, cause, hash, proxyHash);
+    ObjectFetchContext::Cause cause,
+    std::optional<pid_t> clientPid) {
+  return makeRequest<TreeImport>(priority, cause, clientPid, hash, proxyHash);
 }
 
 std::shared_ptr<HgImportRequest> HgImportRequest::makeBlobMetaImportRequest(
     const ObjectId& hash,
     const HgProxyHash& proxyHash,
     ImportPriority priority,
-    ObjectFetchContext::Cause cause) {
-  return makeRequest<BlobMetaImport>(priority, cause, hash, proxyHash);
+    ObjectFetchContext::Cause cause,
+    std::optional<pid_t> clientPid) {
+  return makeRequest<BlobMetaImport>(
+      priority, cause, clientPid, hash, proxyHash);
+}
+
+void HgImportRequest::setCancellationToken(folly::CancellationToken token) {
+  waiters_.clear();
+  hasUncancellableWaiter_ = !token.canBeCancelled();
+  if (!hasUncancellableWaiter_) {
+    waiters_.push_back(std::move(token));
+  }
+}
+
+void HgImportRequest::addWaitersOf(const HgImportRequest& duplicate) {
+  if (hasUncancellableWaiter_) {
+    return;
+  }
+  if (duplicate.hasUncancellableWaiter_) {
+    hasUncancellableWaiter_ = true;
+    waiters_.clear();
+    return;
+  }
+  // Forget the waiters that already went away so that a heavily duplicated
+  // request does not accumulate tokens.
+  waiters_.erase(
+      std::remove_if(
+          waiters_.begin(),
+          waiters_.end(),
+          [](const auto& token) { return token.isCancellationRequested(); }),
+      waiters_.end());
+  waiters_.insert(
+      waiters_.end(), duplicate.waiters_.begin(), duplicate.waiters_.end());
+}
+
+bool HgImportRequest::isCancelled() const {
+  if (hasUncancellableWaiter_) {
+    return false;
+  }
+  return std::all_of(waiters_.begin(), waiters_.end(), [](const auto& token) {
+    return token.isCancellationRequested();
+  });
 }
 
 } // namespace facebook::eden
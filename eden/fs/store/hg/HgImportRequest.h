@@ -7,9 +7,13 @@
 
 #pragma once
 
+#include <folly/CancellationToken.h>
 #include <folly/futures/Promise.h>
+#include <optional>
+#include <type_traits>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "eden/fs/model/Blob.h"
 #include "eden/fs/model/Hash.h"
@@ -28,11 +32,14 @@ namespace facebook::eden {
  * information needed to fulfill the request as well as a promise that will be
  * resolved after the requested data is imported. Blobs and Trees also contain
  * a vector of promises to fulfill, corresponding to duplicate requests
+ *
+ * Imported objects are immutable and handed out as shared_ptr<const T> so that
+ * the original request and all of its duplicates share a single copy.
  */
 class HgImportRequest {
  public:
   struct BlobImport {
-    using Response = std::unique_ptr<Blob>;
+    using Response = std::shared_ptr<const Blob>;
     BlobImport(ObjectId hash, HgProxyHash proxyHash)
         : hash{std::move(hash)}, proxyHash{std::move(proxyHash)} {}
 
@@ -45,7 +52,7 @@ class HgImportRequest {
   };
 
   struct TreeImport {
-    using Response = std::unique_ptr<Tree>;
+    using Response = std::shared_ptr<const Tree>;
     TreeImport(ObjectId hash, HgProxyHash proxyHash)
         : hash{std::move(hash)}, proxyHash{std::move(proxyHash)} {}
 
@@ -57,7 +64,7 @@ class HgImportRequest {
   };
 
   struct BlobMetaImport {
-    using Response = std::unique_ptr<BlobMetadata>;
+    using Response = std::shared_ptr<const BlobMetadata>;
     BlobMetaImport(ObjectId hash, HgProxyHash proxyHash)
         : hash{std::move(hash)}, proxyHash{std::move(proxyHash)} {}
 
@@ -70,12 +77,16 @@ class HgImportRequest {
 
   /**
    * Allocate a blob request.
+   *
+   * clientPid is the process that caused the request, when known. It is used
+   * to share the import queue fairly between processes.
    */
   static std::shared_ptr<HgImportRequest> makeBlobImportRequest(
       const ObjectId& hash,
       const HgProxyHash& proxyHash,
       ImportPriority priority,
-      ObjectFetchContext::Cause cause);
+      ObjectFetchContext::Cause cause,
+      std::optional<pid_t> clientPid = std::nullopt);
 
   /**
    * Allocate a tree request.
@@ -84,13 +95,15 @@ class HgImportRequest {
       const ObjectId& hash,
       const HgProxyHash& proxyHash,
       ImportPriority priority,
-      ObjectFetchContext::Cause cause);
+      ObjectFetchContext::Cause cause,
+      std::optional<pid_t> clientPid = std::nullopt);
 
   static std::shared_ptr<HgImportRequest> makeBlobMetaImportRequest(
       const ObjectId& hash,
       const HgProxyHash& proxyHash,
       ImportPriority priority,
-      ObjectFetchContext::Cause cause);
+      ObjectFetchContext::Cause cause,
+      std::optional<pid_t> clientPid = std::nullopt);
 
   /**
    * Implementation detail of the make*Request functions from above. Do not use
@@ -101,6 +114,7 @@ class HgImportRequest {
       RequestType request,
       ImportPriority priority,
       ObjectFetchContext::Cause cause,
+      std::optional<pid_t> clientPid,
       folly::Promise<typename RequestType::Response>&& promise);
 
   ~HgImportRequest() = default;
@@ -118,6 +132,13 @@ class HgImportRequest {
     return std::holds_alternative<T>(request_);
   }
 
+  /**
+   * Values returned by getType().
+   */
+  static constexpr size_t kBlobImportType = 0;
+  static constexpr size_t kTreeImportType = 1;
+  static constexpr size_t kBlobMetaImportType = 2;
+
   size_t getType() const noexcept {
     return request_.index();
   }
@@ -130,10 +151,33 @@ class HgImportRequest {
     return cause_;
   }
 
+  std::optional<pid_t> getClientPid() const noexcept {
+    return clientPid_;
+  }
+
   void setPriority(ImportPriority priority) noexcept {
     priority_ = priority;
   }
 
+  /**
+   * Set the token through which the waiter of this request signals that it no
+   * longer needs the imported object. Must be called before the request is
+   * queued. Requests without a cancellable token are never cancelled.
+   */
+  void setCancellationToken(folly::CancellationToken token);
+
+  /**
+   * Attach the waiters of duplicate, a request for the same object that was
+   * de-duplicated against this one. Called with the queue locked.
+   */
+  void addWaitersOf(const HgImportRequest& duplicate);
+
+  /**
+   * Returns true if every waiter of this request has gone away, in which case
+   * the import can be dropped. Called with the queue locked.
+   */
+  bool isCancelled() const;
+
   template <typename T>
   folly::Promise<T>* getPromise() {
     auto promise = std::get_if<folly::Promise<T>>(&promise_); // Promise<T>
@@ -160,20 +204,39 @@ class HgImportRequest {
   static std::shared_ptr<HgImportRequest> makeRequest(
       ImportPriority priority,
       ObjectFetchContext::Cause cause,
+      std::optional<pid_t> clientPid,
       Input&&... input);
 
   HgImportRequest(const HgImportRequest&) = delete;
   HgImportRequest& operator=(const HgImportRequest&) = delete;
 
   using Request = std::variant<BlobImport, TreeImport, BlobMetaImport>;
+  static_assert(std::is_same_v<
+                std::variant_alternative_t<kBlobImportType, Request>,
+                BlobImport>);
+  static_assert(std::is_same_v<
+                std::variant_alternative_t<kTreeImportType, Request>,
+                TreeImport>);
+  static_assert(std::is_same_v<
+                std::variant_alternative_t<kBlobMetaImportType, Request>,
+                BlobMetaImport>);
   using Response = std::variant<
-      folly::Promise<std::unique_ptr<Blob>>,
-      folly::Promise<std::unique_ptr<Tree>>,
-      folly::Promise<std::unique_ptr<BlobMetadata>>>;
+      folly::Promise<BlobImport::Response>,
+      folly::Promise<TreeImport::Response>,
+      folly::Promise<BlobMetaImport::Response>>;
 
   Request request_;
   ImportPriority priority_;
   ObjectFetchContext::Cause cause_;
+  std::optional<pid_t> clientPid_;
+
+  /**
+   * Tokens of the waiters of this request, only meaningful when
+   * hasUncancellableWaiter_ is false.
+   */
+  std::vector<folly::CancellationToken> waiters_;
+  bool hasUncancellableWaiter_ = true;
+
   Response promise_;
   uint64_t unique_ = generateUniqueID();
   std::chrono::steady_clock::time_point requestTime_ =
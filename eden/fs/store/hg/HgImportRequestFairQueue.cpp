@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/hg/HgImportRequestFairQueue.h"
+
+#include <algorithm>
+
+#include "eden/fs/store/hg/HgImportRequest.h"
+
+namespace facebook::eden {
+
+namespace {
+constexpr size_t kBlobType = HgImportRequest::kBlobImportType;
+constexpr size_t kTreeType = HgImportRequest::kTreeImportType;
+constexpr size_t kBlobMetaType = HgImportRequest::kBlobMetaImportType;
+
+/**
+ * Order in which types are considered by dequeue(). Trees come first since
+ * they fan out into more requests, which increases fetch concurrency.
+ */
+constexpr std::array<size_t, 3> kDequeueOrder{
+    kTreeType,
+    kBlobMetaType,
+    kBlobType};
+
+/**
+ * Order in which takeAll() returns requests.
+ */
+constexpr std::array<size_t, 3> kTakeAllOrder{
+    kTreeType,
+    kBlobType,
+    kBlobMetaType};
+
+/**
+ * Flows of requests without a pid are numbered after every possible pid.
+ */
+constexpr uint64_t kCauseFlowBase = uint64_t{1} << 32;
+
+const ObjectId& getHash(HgImportRequest& request) {
+  if (auto* blob = request.getRequest<HgImportRequest::BlobImport>()) {
+    return blob->hash;
+  } else if (auto* tree = request.getRequest<HgImportRequest::TreeImport>()) {
+    return tree->hash;
+  }
+  return request.getRequest<HgImportRequest::BlobMetaImport>()->hash;
+}
+} // namespace
+
+uint64_t HgImportRequestFairQueue::getFlow(const HgImportRequest& request) {
+  if (auto pid = request.getClientPid()) {
+    return static_cast<uint32_t>(*pid);
+  }
+  return kCauseFlowBase | request.getCause();
+}
+
+size_t HgImportRequestFairQueue::getWeight(ImportPriority priority) {
+  auto cls = priority.getClass();
+  if (cls >= ImportPriority::Class::High) {
+    return 4;
+  } else if (cls >= ImportPriority::Class::Normal) {
+    return 2;
+  }
+  return 1;
+}
+
+bool HgImportRequestFairQueue::Flow::empty() const {
+  return std::all_of(heaps.begin(), heaps.end(), [](const auto& heap) {
+    return heap.empty();
+  });
+}
+
+void HgImportRequestFairQueue::push(State& state, uint64_t flow, Entry entry) {
+  auto [it, inserted] = state.flows.try_emplace(flow);
+  if (inserted) {
+    state.active.push_back(flow);
+  }
+  auto& heap = it->second.heaps[entry.request->getType()];
+  heap.push_back(std::move(entry));
+  std::push_heap(heap.begin(), heap.end());
+}
+
+bool HgImportRequestFairQueue::claim(
+    State& state,
+    const Entry& entry,
+    std::vector<std::shared_ptr<HgImportRequest>>* cancelled) {
+  auto& tracker = state.trackers[entry.request->getType()];
+  auto it = tracker.find(getHash(*entry.request));
+  // The object may have been imported and requested again since this entry
+  // was queued, so compare the requests rather than only the ids.
+  if (it == tracker.end() || it->second.request != entry.request ||
+      it->second.dequeued) {
+    return false;
+  }
+  if (cancelled && entry.request->isCancelled()) {
+    cancelled->push_back(std::move(it->second.request));
+    tracker.erase(it);
+    return false;
+  }
+  it->second.dequeued = true;
+  return true;
+}
+
+void HgImportRequestFairQueue::enqueue(
+    std::shared_ptr<HgImportRequest> request,
+    const ObjectId& hash,
+    folly::FunctionRef<void(HgImportRequest& existing)> addDuplicate) {
+  auto type = request->getType();
+  auto flow = getFlow(*request);
+  {
+    auto state = state_.lock();
+    auto [it, inserted] =
+        state->trackers[type].try_emplace(hash, Tracked{request, flow});
+    if (inserted) {
+      auto priority = request->getPriority();
+      push(*state, flow, Entry{priority, std::move(request)});
+    } else {
+      auto& existing = it->second;
+      addDuplicate(*existing.request);
+      bool raised = existing.request->getPriority() < request->getPriority();
+      if (raised) {
+        existing.request->setPriority(request->getPriority());
+      }
+      // Also queue the request in the new flow, so that its waiter is not
+      // held up by the flow of the original request.
+      if (existing.dequeued || (!raised && existing.flow == flow)) {
+        return;
+      }
+      existing.flow = flow;
+      push(
+          *state,
+          flow,
+          Entry{existing.request->getPriority(), existing.request});
+    }
+  }
+  queueCV_.notify_one();
+}
+
+std::vector<std::shared_ptr<HgImportRequest>>
+HgImportRequestFairQueue::dequeue(
+    folly::FunctionRef<size_t(size_t type)> getBatchSize,
+    std::vector<std::shared_ptr<HgImportRequest>>& cancelled) {
+  std::vector<std::shared_ptr<HgImportRequest>> result;
+  auto state = state_.lock();
+  for (;;) {
+    if (!state->running) {
+      state->flows.clear();
+      state->active.clear();
+      return {};
+    }
+    if (state->active.empty()) {
+      queueCV_.wait(state.as_lock());
+      continue;
+    }
+
+    auto flowId = state->active.front();
+    auto& flow = state->flows.at(flowId);
+
+    // Flows are removed from active as soon as they are empty, so one of the
+    // heaps has entries.
+    std::vector<Entry>* heap = nullptr;
+    size_t type = 0;
+    for (auto candidate : kDequeueOrder) {
+      auto& candidateHeap = flow.heaps[candidate];
+      if (!candidateHeap.empty() &&
+          (!heap || heap->front().priority < candidateHeap.front().priority)) {
+        heap = &candidateHeap;
+        type = candidate;
+      }
+    }
+
+    auto batchSize = std::max<size_t>(getBatchSize(type), 1);
+    if (flow.deficit == 0) {
+      flow.deficit = getWeight(heap->front().priority) * batchSize;
+    }
+    // Batches are not split to fit the quantum, a flow may thus exceed it by
+    // less than a batch.
+    while (!heap->empty() && result.size() < batchSize) {
+      std::pop_heap(heap->begin(), heap->end());
+      auto entry = std::move(heap->back());
+      heap->pop_back();
+      if (claim(*state, entry, &cancelled)) {
+        result.push_back(std::move(entry.request));
+      }
+    }
+    flow.deficit -= std::min(flow.deficit, result.size());
+
+    if (flow.empty()) {
+      state->flows.erase(flowId);
+      state->active.pop_front();
+    } else if (flow.deficit == 0) {
+      // The flow used up its quantum, let the next one be served.
+      state->active.pop_front();
+      state->active.push_back(flowId);
+    }
+
+    if (!result.empty() || !cancelled.empty()) {
+      return result;
+    }
+  }
+}
+
+void HgImportRequestFairQueue::stop() {
+  auto state = state_.lock();
+  if (state->running) {
+    state->running = false;
+    queueCV_.notify_all();
+  }
+}
+
+std::shared_ptr<HgImportRequest> HgImportRequestFairQueue::finishImport(
+    size_t type,
+    const ObjectId& hash) {
+  auto state = state_.lock();
+  auto& tracker = state->trackers[type];
+  auto it = tracker.find(hash);
+  if (it == tracker.end()) {
+    return nullptr;
+  }
+  auto request = std::move(it->second.request);
+  tracker.erase(it);
+  return request;
+}
+
+std::vector<std::shared_ptr<HgImportRequest>>
+HgImportRequestFairQueue::takeAll() {
+  std::vector<std::shared_ptr<HgImportRequest>> result;
+  auto state = state_.lock();
+  for (auto type : kTakeAllOrder) {
+    for (auto& flow : state->flows) {
+      for (auto& entry : flow.second.heaps[type]) {
+        if (claim(*state, entry, nullptr)) {
+          result.push_back(std::move(entry.request));
+        }
+      }
+    }
+  }
+  state->flows.clear();
+  state->active.clear();
+  return result;
+}
+
+} // namespace facebook::eden
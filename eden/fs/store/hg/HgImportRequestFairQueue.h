@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/Function.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "eden/fs/model/Hash.h"
+#include "eden/fs/store/ImportPriority.h"
+
+namespace facebook::eden {
+
+class HgImportRequest;
+
+/**
+ * Storage for HgImportRequestQueue's pending requests that shares the import
+ * threads fairly between the clients issuing the requests.
+ *
+ * Requests are grouped in flows: one per client pid, and one per
+ * ObjectFetchContext::Cause for the requests whose pid is not known. Flows
+ * with queued requests are served in weighted round-robin order: when a flow
+ * reaches the front of the round, it is granted a quantum of requests, that
+ * is its weight times the batch size of the type it is served, and it keeps
+ * being served until the quantum is used up or it runs out of requests. The
+ * weight of a flow is derived from the priority class of its most urgent
+ * request, so that priorities still matter across flows, but no flow can
+ * starve another: a request waits for at most one quantum of each other flow
+ * before its flow is served, however many requests the other flows queued.
+ *
+ * Within a flow, dequeue() follows the same order as with a single heap per
+ * request type: the type whose most urgent request has the highest priority
+ * is chosen, trees first on ties, then blob metadata, then blobs.
+ *
+ * When a request is de-duplicated against a queued one of higher priority or
+ * of another flow, the queued request is pushed again into the new request's
+ * flow, and whichever of its entries is dequeued first claims it, the others
+ * being dropped.
+ */
+class HgImportRequestFairQueue {
+ public:
+  HgImportRequestFairQueue() = default;
+
+  HgImportRequestFairQueue(const HgImportRequestFairQueue&) = delete;
+  HgImportRequestFairQueue& operator=(const HgImportRequestFairQueue&) =
+      delete;
+
+  /**
+   * Queue request, the import of the object hash.
+   *
+   * If an import of the same object and type is already tracked, request is
+   * dropped instead and addDuplicate is called with the tracked request, with
+   * the queue locked, to attach request's waiter to it.
+   */
+  void enqueue(
+      std::shared_ptr<HgImportRequest> request,
+      const ObjectId& hash,
+      folly::FunctionRef<void(HgImportRequest& existing)> addDuplicate);
+
+  /**
+   * Block until requests are available and return a batch of them, all of
+   * the same type and from the same flow. getBatchSize is called with the
+   * chosen type, as returned by HgImportRequest::getType(), to bound the size
+   * of the batch.
+   *
+   * Requests whose waiters have all gone away, see
+   * HgImportRequest::isCancelled(), are not returned: they stop being tracked
+   * and are appended to cancelled instead, for the caller to fail them. This
+   * may make the returned batch empty, in which case cancelled is not.
+   *
+   * Returns an empty list once stop() has been called.
+   */
+  std::vector<std::shared_ptr<HgImportRequest>> dequeue(
+      folly::FunctionRef<size_t(size_t type)> getBatchSize,
+      std::vector<std::shared_ptr<HgImportRequest>>& cancelled);
+
+  /**
+   * Wake up all consumers and make future dequeue() calls return right away.
+   */
+  void stop();
+
+  /**
+   * Stop tracking the import of the object hash and return its request, or
+   * nullptr if it was not tracked.
+   */
+  std::shared_ptr<HgImportRequest> finishImport(
+      size_t type,
+      const ObjectId& hash);
+
+  /**
+   * Remove and return every queued request, trees first, then blobs, then
+   * blob metadata. The requests remain tracked until finishImport().
+   */
+  std::vector<std::shared_ptr<HgImportRequest>> takeAll();
+
+  /**
+   * Returns the flow that request is scheduled in.
+   */
+  static uint64_t getFlow(const HgImportRequest& request);
+
+  /**
+   * Returns the weight of a flow whose most urgent request has priority.
+   */
+  static size_t getWeight(ImportPriority priority);
+
+ private:
+  static constexpr size_t kNumTypes = 3;
+
+  struct Entry {
+    ImportPriority priority;
+    std::shared_ptr<HgImportRequest> request;
+
+    friend bool operator<(const Entry& lhs, const Entry& rhs) {
+      return lhs.priority < rhs.priority;
+    }
+  };
+
+  struct Flow {
+    /**
+     * Queued entries of this flow, a heap per request type.
+     */
+    std::array<std::vector<Entry>, kNumTypes> heaps;
+
+    /**
+     * Number of requests this flow may still be served before the next flow
+     * gets its turn.
+     */
+    size_t deficit{0};
+
+    bool empty() const;
+  };
+
+  struct Tracked {
+    std::shared_ptr<HgImportRequest> request;
+
+    /**
+     * Flow the request was last pushed into.
+     */
+    uint64_t flow;
+    bool dequeued = false;
+  };
+
+  struct State {
+    bool running = true;
+
+    /**
+     * Flows with queued entries, and the order in which they are served. The
+     * flow at the front of active is the one currently being served.
+     */
+    folly::F14NodeMap<uint64_t, Flow> flows;
+    std::deque<uint64_t> active;
+
+    std::array<folly::F14FastMap<ObjectId, Tracked>, kNumTypes> trackers;
+  };
+
+  static void push(State& state, uint64_t flow, Entry entry);
+
+  /**
+   * Mark the entry's request as dequeued. Returns false if the entry is stale:
+   * its request was already dequeued through another entry, or finished.
+   *
+   * When cancelled is set and the request was cancelled, it is untracked and
+   * appended to cancelled instead of being claimed.
+   */
+  static bool claim(
+      State& state,
+      const Entry& entry,
+      std::vector<std::shared_ptr<HgImportRequest>>* cancelled);
+
+  folly::Synchronized<State, std::mutex> state_;
+  std::condition_variable queueCV_;
+};
+
+} // namespace facebook::eden
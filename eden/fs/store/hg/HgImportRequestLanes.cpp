@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/hg/HgImportRequestLanes.h"
+
+#include <algorithm>
+#include <optional>
+
+#include "eden/fs/store/hg/HgImportRequest.h"
+
+namespace facebook::eden {
+
+namespace {
+constexpr size_t kBlobType = HgImportRequest::kBlobImportType;
+constexpr size_t kTreeType = HgImportRequest::kTreeImportType;
+constexpr size_t kBlobMetaType = HgImportRequest::kBlobMetaImportType;
+
+/**
+ * Order in which types are considered by dequeue(). Trees come first since
+ * they fan out into more requests, which increases fetch concurrency.
+ */
+constexpr std::array<size_t, 3> kDequeueOrder{
+    kTreeType,
+    kBlobMetaType,
+    kBlobType};
+
+/**
+ * Order in which takeAll() returns requests.
+ */
+constexpr std::array<size_t, 3> kTakeAllOrder{
+    kTreeType,
+    kBlobType,
+    kBlobMetaType};
+
+size_t getClassIndex(ImportPriority priority) {
+  auto cls = priority.getClass();
+  if (cls >= ImportPriority::Class::High) {
+    return 2;
+  } else if (cls >= ImportPriority::Class::Normal) {
+    return 1;
+  }
+  return 0;
+}
+} // namespace
+
+HgImportRequestLanes::Lane& HgImportRequestLanes::getLane(
+    size_t type,
+    ImportPriority priority) {
+  return getLane(type, getClassIndex(priority));
+}
+
+void HgImportRequestLanes::updateTopPriority(
+    Lane& lane,
+    const std::vector<Entry>& heap) {
+  lane.topPriority.store(
+      heap.empty() ? 0 : heap.front().priority.value(),
+      std::memory_order_release);
+}
+
+HgImportRequestLanes::TrackerShard& HgImportRequestLanes::getShard(
+    size_t type,
+    const ObjectId& hash) {
+  auto shard = std::hash<ObjectId>{}(hash) % kNumShards;
+  return trackers_[type * kNumShards + shard];
+}
+
+void HgImportRequestLanes::enqueue(
+    std::shared_ptr<HgImportRequest> request,
+    const ObjectId& hash,
+    folly::FunctionRef<void(HgImportRequest& existing)> addDuplicate) {
+  auto type = request->getType();
+  std::optional<Entry> entry;
+  {
+    auto tracker = getShard(type, hash).lock();
+    auto [it, inserted] = tracker->try_emplace(hash, Tracked{request});
+    if (inserted) {
+      entry = Entry{request->getPriority(), std::move(request)};
+    } else {
+      auto& existing = it->second;
+      addDuplicate(*existing.request);
+      if (existing.request->getPriority() < request->getPriority()) {
+        existing.request->setPriority(request->getPriority());
+        if (!existing.dequeued) {
+          entry = Entry{request->getPriority(), existing.request};
+        }
+      }
+    }
+  }
+
+  if (entry) {
+    push(std::move(*entry));
+    available_.post();
+  }
+}
+
+void HgImportRequestLanes::push(Entry entry) {
+  auto& lane = getLane(entry.request->getType(), entry.priority);
+  auto heap = lane.heap.lock();
+  heap->push_back(std::move(entry));
+  std::push_heap(heap->begin(), heap->end());
+  updateTopPriority(lane, *heap);
+}
+
+uint64_t HgImportRequestLanes::getTopPriority(size_t type) {
+  // Classes never overlap, so the most urgent entry is in the highest
+  // non-empty class.
+  for (size_t classIndex = kNumClasses; classIndex-- > 0;) {
+    auto priority = getLane(type, classIndex)
+                        .topPriority.load(std::memory_order_acquire);
+    if (priority) {
+      return priority;
+    }
+  }
+  return 0;
+}
+
+bool HgImportRequestLanes::claim(
+    const Entry& entry,
+    std::vector<std::shared_ptr<HgImportRequest>>* cancelled) {
+  auto type = entry.request->getType();
+  const ObjectId* hash;
+  if (auto* blob = entry.request->getRequest<HgImportRequest::BlobImport>()) {
+    hash = &blob->hash;
+  } else if (
+      auto* tree = entry.request->getRequest<HgImportRequest::TreeImport>()) {
+    hash = &tree->hash;
+  } else {
+    hash = &entry.request->getRequest<HgImportRequest::BlobMetaImport>()->hash;
+  }
+
+  auto tracker = getShard(type, *hash).lock();
+  auto it = tracker->find(*hash);
+  // The object may have been imported and requested again since this entry
+  // was queued, so compare the requests rather than only the ids.
+  if (it == tracker->end() || it->second.request != entry.request ||
+      it->second.dequeued) {
+    return false;
+  }
+  if (cancelled && entry.request->isCancelled()) {
+    cancelled->push_back(std::move(it->second.request));
+    tracker->erase(it);
+    return false;
+  }
+  it->second.dequeued = true;
+  return true;
+}
+
+std::vector<std::shared_ptr<HgImportRequest>> HgImportRequestLanes::dequeue(
+    folly::FunctionRef<size_t(size_t type)> getBatchSize,
+    std::vector<std::shared_ptr<HgImportRequest>>& cancelled) {
+  std::vector<std::shared_ptr<HgImportRequest>> result;
+  for (;;) {
+    bool shutdown = false;
+    try {
+      available_.wait();
+    } catch (const folly::ShutdownSemError&) {
+      shutdown = true;
+    }
+    // Waits only throw once the semaphore is exhausted, so also check
+    // running_ to not hand out requests after stop().
+    if (shutdown || !running_.load(std::memory_order_acquire)) {
+      for (auto& lane : lanes_) {
+        lane.heap.lock()->clear();
+        lane.topPriority.store(0, std::memory_order_release);
+      }
+      return {};
+    }
+
+    std::optional<size_t> type;
+    uint64_t highestPriority = 0;
+    for (auto candidate : kDequeueOrder) {
+      auto priority = getTopPriority(candidate);
+      if (priority > highestPriority) {
+        type = candidate;
+        highestPriority = priority;
+      }
+    }
+    if (!type) {
+      // Another consumer took the entry this wakeup was for as part of its
+      // batch.
+      continue;
+    }
+
+    auto count = std::max<size_t>(getBatchSize(*type), 1);
+    size_t popped = 0;
+    std::vector<Entry> entries;
+    for (size_t classIndex = kNumClasses;
+         classIndex-- > 0 && result.size() < count;) {
+      auto& lane = getLane(*type, classIndex);
+      while (result.size() < count) {
+        entries.clear();
+        {
+          auto heap = lane.heap.lock();
+          while (!heap->empty() && entries.size() < count - result.size()) {
+            std::pop_heap(heap->begin(), heap->end());
+            entries.push_back(std::move(heap->back()));
+            heap->pop_back();
+          }
+          updateTopPriority(lane, *heap);
+        }
+        if (entries.empty()) {
+          break;
+        }
+        popped += entries.size();
+        for (auto& entry : entries) {
+          if (claim(entry, &cancelled)) {
+            result.push_back(std::move(entry.request));
+          }
+        }
+      }
+    }
+
+    // One semaphore unit was consumed by wait() above, consume the units
+    // posted for the other popped entries. Some may not have been posted yet,
+    // in which case a later wait() returns without finding anything.
+    for (size_t i = 1; i < popped; ++i) {
+      if (!available_.tryWait()) {
+        break;
+      }
+    }
+
+    if (!result.empty() || !cancelled.empty()) {
+      return result;
+    }
+  }
+}
+
+void HgImportRequestLanes::stop() {
+  running_.store(false, std::memory_order_release);
+  available_.shutdown();
+}
+
+std::shared_ptr<HgImportRequest> HgImportRequestLanes::finishImport(
+    size_t type,
+    const ObjectId& hash) {
+  auto tracker = getShard(type, hash).lock();
+  auto it = tracker->find(hash);
+  if (it == tracker->end()) {
+    return nullptr;
+  }
+  auto request = std::move(it->second.request);
+  tracker->erase(it);
+  return request;
+}
+
+std::vector<std::shared_ptr<HgImportRequest>> HgImportRequestLanes::takeAll() {
+  std::vector<std::shared_ptr<HgImportRequest>> result;
+  for (auto type : kTakeAllOrder) {
+    for (size_t classIndex = kNumClasses; classIndex-- > 0;) {
+      auto& lane = getLane(type, classIndex);
+      std::vector<Entry> entries;
+      {
+        auto heap = lane.heap.lock();
+        entries.swap(*heap);
+        updateTopPriority(lane, *heap);
+      }
+      for (auto& entry : entries) {
+        if (claim(entry, nullptr)) {
+          result.push_back(std::move(entry.request));
+        }
+        available_.tryWait();
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/Function.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <folly/synchronization/LifoSem.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "eden/fs/model/Hash.h"
+#include "eden/fs/store/ImportPriority.h"
+
+namespace facebook::eden {
+
+class HgImportRequest;
+
+/**
+ * Storage for HgImportRequestQueue's pending requests, split so that
+ * producers and consumers rarely contend with each other.
+ *
+ * Requests are kept in one lane per (request type, priority class), each a
+ * heap with its own lock, and de-duplicated through a sharded tracker keyed by
+ * ObjectId. Consumers choose a lane by reading the priority of each lane's
+ * head without locking, and sleep on a semaphore instead of a condition
+ * variable shared with every producer.
+ *
+ * Ordering is the same as with a single heap per request type: dequeue()
+ * picks the type whose most urgent request has the highest priority, trees
+ * first on ties, then blob metadata, then blobs, and returns that type's
+ * requests in priority order.
+ *
+ * Raising the priority of a queued request does not search its lane: the
+ * request is pushed again at its new priority, and whichever of its entries
+ * is dequeued first claims it, the others being dropped.
+ */
+class HgImportRequestLanes {
+ public:
+  HgImportRequestLanes() = default;
+
+  HgImportRequestLanes(const HgImportRequestLanes&) = delete;
+  HgImportRequestLanes& operator=(const HgImportRequestLanes&) = delete;
+
+  /**
+   * Queue request, the import of the object hash.
+   *
+   * If an import of the same object and type is already tracked, request is
+   * dropped instead and addDuplicate is called with the tracked request, with
+   * the shard lock held, to attach request's waiter to it.
+   */
+  void enqueue(
+      std::shared_ptr<HgImportRequest> request,
+      const ObjectId& hash,
+      folly::FunctionRef<void(HgImportRequest& existing)> addDuplicate);
+
+  /**
+   * Block until requests are available and return a batch of them, all of
+   * the same type. getBatchSize is called with the chosen type, as returned
+   * by HgImportRequest::getType(), to bound the size of the batch.
+   *
+   * Requests whose waiters have all gone away, see
+   * HgImportRequest::isCancelled(), are not returned: they stop being tracked
+   * and are appended to cancelled instead, for the caller to fail them. This
+   * may make the returned batch empty, in which case cancelled is not.
+   *
+   * Returns an empty list once stop() has been called.
+   */
+  std::vector<std::shared_ptr<HgImportRequest>> dequeue(
+      folly::FunctionRef<size_t(size_t type)> getBatchSize,
+      std::vector<std::shared_ptr<HgImportRequest>>& cancelled);
+
+  /**
+   * Wake up all consumers and make future dequeue() calls return right away.
+   */
+  void stop();
+
+  /**
+   * Stop tracking the import of the object hash and return its request, or
+   * nullptr if it was not tracked.
+   */
+  std::shared_ptr<HgImportRequest> finishImport(
+      size_t type,
+      const ObjectId& hash);
+
+  /**
+   * Remove and return every queued request, trees first, then blobs, then
+   * blob metadata. The requests remain tracked until finishImport().
+   */
+  std::vector<std::shared_ptr<HgImportRequest>> takeAll();
+
+ private:
+  static constexpr size_t kNumTypes = 3;
+  static constexpr size_t kNumClasses = 3;
+  static constexpr size_t kNumShards = 16;
+
+  struct Entry {
+    ImportPriority priority;
+    std::shared_ptr<HgImportRequest> request;
+
+    friend bool operator<(const Entry& lhs, const Entry& rhs) {
+      return lhs.priority < rhs.priority;
+    }
+  };
+
+  struct Lane {
+    folly::Synchronized<std::vector<Entry>, std::mutex> heap;
+
+    /**
+     * Priority of the entry at the top of the heap, or 0 when the heap is
+     * empty. Read without the lock when choosing a lane, so it may be stale.
+     */
+    std::atomic<uint64_t> topPriority{0};
+  };
+
+  struct Tracked {
+    std::shared_ptr<HgImportRequest> request;
+    bool dequeued = false;
+  };
+
+  using Tracker = folly::F14FastMap<ObjectId, Tracked>;
+  using TrackerShard = folly::Synchronized<Tracker, std::mutex>;
+
+  Lane& getLane(size_t type, ImportPriority priority);
+  Lane& getLane(size_t type, size_t classIndex) {
+    return lanes_[type * kNumClasses + classIndex];
+  }
+  TrackerShard& getShard(size_t type, const ObjectId& hash);
+
+  /**
+   * Returns the priority of the most urgent entry of this type, or 0.
+   */
+  uint64_t getTopPriority(size_t type);
+
+  void push(Entry entry);
+
+  static void updateTopPriority(Lane& lane, const std::vector<Entry>& heap);
+
+  /**
+   * Mark the entry's request as dequeued. Returns false if the entry is stale:
+   * its request was already dequeued through another entry, or finished.
+   *
+   * When cancelled is set and the request was cancelled, it is untracked and
+   * appended to cancelled instead of being claimed.
+   */
+  bool claim(
+      const Entry& entry,
+      std::vector<std::shared_ptr<HgImportRequest>>* cancelled);
+
+  std::array<Lane, kNumTypes * kNumClasses> lanes_;
+  std::array<TrackerShard, kNumTypes * kNumShards> trackers_;
+
+  /**
+   * Counts entries pushed into the lanes and not yet popped.
+   */
+  folly::LifoSem available_;
+  std::atomic<bool> running_{true};
+};
+
+} // namespace facebook::eden
@@ -6,14 +6,92 @@
  */
 
 #include "eden/fs/store/hg/HgImportRequestQueue.h"
+#include <folly/CancellationToken.h>
 #include <folly/MapUtil.h>
 #include <folly/futures/Future.h>
 #include <algorithm>
+#include "eden/fs/config/EdenConfig.h"
 #include "eden/fs/config/ReloadableConfig.h"
 
 namespace facebook::eden {
 
+namespace {
+size_t getConfiguredBatchSize(const EdenConfig& config, size_t type) {
+  switch (type) {
+    case HgImportRequest::kTreeImportType:
+      return config.importBatchSizeTree.getValue();
+    case HgImportRequest::kBlobMetaImportType:
+      return config.importBatchSizeBlobMeta.getValue();
+    default:
+      return config.importBatchSize.getValue();
+  }
+}
+
+/**
+ * Start the adaptive batchSize of requests of the given type at the
+ * configured size, and keep it within the bounds, which a config reload may
+ * have changed. Returns batchSize.
+ */
+size_t& boundAdaptiveBatchSize(
+    size_t& batchSize,
+    const EdenConfig& config,
+    size_t type) {
+  if (batchSize == 0) {
+    batchSize = getConfiguredBatchSize(config, type);
+  }
+  size_t minimum = config.adaptiveImportBatchSizeMin.getValue();
+  size_t maximum =
+      std::max<size_t>(minimum, config.adaptiveImportBatchSizeMax.getValue());
+  batchSize = std::clamp(batchSize, std::max<size_t>(minimum, 1), maximum);
+  return batchSize;
+}
+
+const ObjectId& getHash(HgImportRequest& request) {
+  if (auto* blob = request.getRequest<HgImportRequest::BlobImport>()) {
+    return blob->hash;
+  } else if (auto* tree = request.getRequest<HgImportRequest::TreeImport>()) {
+    return tree->hash;
+  }
+  return request.getRequest<HgImportRequest::BlobMetaImport>()->hash;
+}
+
+template <typename ImportType>
+void failImport(HgImportRequest& request, const folly::exception_wrapper& ew) {
+  using Response = typename ImportType::Response;
+  request.getPromise<Response>()->setException(ew);
+  for (auto& promise : request.getRequest<ImportType>()->promises) {
+    promise.setException(ew);
+  }
+}
+} // namespace
+
+HgImportRequestQueue::HgImportRequestQueue(
+    std::shared_ptr<ReloadableConfig> config,
+    EdenStatsPtr stats)
+    : config_{std::move(config)},
+      stats_{std::move(stats)},
+      lanes_{
+          config_->getEdenConfig()->importQueueLanes.getValue() &&
+                  !config_->getEdenConfig()
+                       ->importQueueFairScheduling.getValue()
+              ? std::make_unique<HgImportRequestLanes>()
+              : nullptr},
+      fairQueue_{
+          config_->getEdenConfig()->importQueueFairScheduling.getValue()
+              ? std::make_unique<HgImportRequestFairQueue>()
+              : nullptr},
+      adaptiveBatchSizes_{std::array<size_t, 3>{}} {}
+
 void HgImportRequestQueue::stop() {
+  if (fairQueue_) {
+    fairQueue_->stop();
+    return;
+  }
+  if (lanes_) {
+    lanes_->stop();
+    return;
+  }
+
   auto state = state_.lock();
   if (state->running) {
     state->running = false;
@@ -21,17 +99,17 @@ void HgImportRequestQueue::stop() {
   }
 }
 
-folly::Future<std::unique_ptr<Blob>> HgImportRequestQueue::enqueueBlob(
+folly::Future<std::shared_ptr<const Blob>> HgImportRequestQueue::enqueueBlob(
     std::shared_ptr<HgImportRequest> request) {
   return enqueue<Blob, HgImportRequest::BlobImport>(std::move(request));
 }
 
-folly::Future<std::unique_ptr<Tree>> HgImportRequestQueue::enqueueTree(
+folly::Future<std::shared_ptr<const Tree>> HgImportRequestQueue::enqueueTree(
     std::shared_ptr<HgImportRequest> request) {
   return enqueue<Tree, HgImportRequest::TreeImport>(std::move(request));
 }
 
-folly::Future<std::unique_ptr<BlobMetadata>>
+folly::Future<std::shared_ptr<const BlobMetadata>>
 HgImportRequestQueue::enqueueBlobMeta(
     std::shared_ptr<HgImportRequest> request) {
   return enqueue<BlobMetadata, HgImportRequest::BlobMetaImport>(
@@ -39,8 +117,33 @@ HgImportRequestQueue::enqueueBlobMeta(
 }
 
 template <typename T, typename ImportType>
-folly::Future<std::unique_ptr<T>> HgImportRequestQueue::enqueue(
+folly::Future<std::shared_ptr<const T>> HgImportRequestQueue::enqueue(
     std::shared_ptr<HgImportRequest> request) {
+  if (lanes_ || fairQueue_) {
+    // Take the future before the request is visible to the workers. If the
+    // request turns out to be a duplicate, it is dropped along with this
+    // future and the caller waits on a promise added to the tracked request.
+    auto future = request->getPromise<std::shared_ptr<const T>>()->getFuture();
+    const auto hash = request->getRequest<ImportType>()->hash;
+    // The request is moved into the backend, which keeps it alive until
+    // enqueue returns.
+    const auto* duplicate = request.get();
+    auto addDuplicate = [&](HgImportRequest& existing) {
+      auto [promise, duplicateFuture] =
+          folly::makePromiseContract<std::shared_ptr<const T>>();
+      existing.getRequest<ImportType>()->promises.emplace_back(
+          std::move(promise));
+      existing.addWaitersOf(*duplicate);
+      future = std::move(duplicateFuture).toUnsafeFuture();
+    };
+    if (fairQueue_) {
+      fairQueue_->enqueue(std::move(request), hash, addDuplicate);
+    } else {
+      lanes_->enqueue(std::move(request), hash, addDuplicate);
+    }
+    return future;
+  }
+
   auto state = state_.lock();
   auto* importQueue = getImportQueue<T>(state);
   auto* requestQueue = &importQueue->queue;
@@ -51,8 +154,10 @@ folly::Future<std::unique_ptr<T>> HgImportRequestQueue::enqueue(
     auto& existingRequest = *existingRequestPtr;
     auto* trackedImport = existingRequest->template getRequest<ImportType>();
 
-    auto [promise, future] = folly::makePromiseContract<std::unique_ptr<T>>();
+    auto [promise, future] =
+        folly::makePromiseContract<std::shared_ptr<const T>>();
     trackedImport->promises.emplace_back(std::move(promise));
+    existingRequest->addWaitersOf(*request);
 
     if (existingRequest->getPriority() < request->getPriority()) {
       existingRequest->setPriority(request->getPriority());
@@ -75,7 +180,7 @@ folly::Future<std::unique_ptr<T>> HgImportRequestQueue::enqueue(
   }
 
   requestQueue->emplace_back(request);
-  auto promise = request->getPromise<std::unique_ptr<T>>();
+  auto promise = request->getPromise<std::shared_ptr<const T>>();
 
   importQueue->requestTracker.emplace(hash, std::move(request));
 
@@ -94,6 +199,13 @@ folly::Future<std::unique_ptr<T>> HgImportRequestQueue::enqueue(
 
 std::vector<std::shared_ptr<HgImportRequest>>
 HgImportRequestQueue::combineAndClearRequestQueues() {
+  if (fairQueue_) {
+    return fairQueue_->takeAll();
+  }
+  if (lanes_) {
+    return lanes_->takeAll();
+  }
+
   auto state = state_.lock();
   auto treeQSz = state->treeQueue.queue.size();
   auto blobQSz = state->blobQueue.queue.size();
@@ -121,8 +233,35 @@ HgImportRequestQueue::combineAndClearRequestQueues() {
 }
 
 std::vector<std::shared_ptr<HgImportRequest>> HgImportRequestQueue::dequeue() {
+  for (;;) {
+    std::vector<std::shared_ptr<HgImportRequest>> cancelled;
+    std::vector<std::shared_ptr<HgImportRequest>> result;
+    auto batchSize = [&](size_t type) { return getBatchSize(type); };
+    if (fairQueue_) {
+      result = fairQueue_->dequeue(batchSize, cancelled);
+    } else if (lanes_) {
+      result = lanes_->dequeue(batchSize, cancelled);
+    } else {
+      result = dequeueFromHeaps(cancelled);
+    }
+
+    // An empty batch means that the queue was stopped, unless every request
+    // that was dequeued turned out to be cancelled.
+    if (cancelled.empty()) {
+      return result;
+    }
+    failCancelled(cancelled);
+    if (!result.empty()) {
+      return result;
+    }
+  }
+}
+
+std::vector<std::shared_ptr<HgImportRequest>>
+HgImportRequestQueue::dequeueFromHeaps(
+    std::vector<std::shared_ptr<HgImportRequest>>& cancelled) {
   size_t count;
-  std::vector<std::shared_ptr<HgImportRequest>>* queue = nullptr;
+  ImportQueue* importQueue = nullptr;
 
   auto state = state_.lock();
   while (true) {
@@ -140,40 +279,41 @@ std::vector<std::shared_ptr<HgImportRequest>> HgImportRequestQueue::dequeue() {
     // allowing a higher fan-out and thus increasing concurrency of fetches
     // which translate onto a higher overall throughput.
     if (!state->treeQueue.queue.empty()) {
-      count = config_->getEdenConfig()->importBatchSizeTree.getValue();
+      count = getBatchSize(HgImportRequest::kTreeImportType);
       highestPriority = state->treeQueue.queue.front()->getPriority();
-      queue = &state->treeQueue.queue;
+      importQueue = &state->treeQueue;
     }
 
     if (!state->blobMetaQueue.queue.empty()) {
       auto priority = state->blobMetaQueue.queue.front()->getPriority();
-      if (!queue || priority > highestPriority) {
-        queue = &state->blobMetaQueue.queue;
-        count = config_->getEdenConfig()->importBatchSizeBlobMeta.getValue();
+      if (!importQueue || priority > highestPriority) {
+        importQueue = &state->blobMetaQueue;
+        count = getBatchSize(HgImportRequest::kBlobMetaImportType);
         highestPriority = priority;
       }
     }
 
     if (!state->blobQueue.queue.empty()) {
       auto priority = state->blobQueue.queue.front()->getPriority();
-      if (!queue || priority > highestPriority) {
-        queue = &state->blobQueue.queue;
-        count = config_->getEdenConfig()->importBatchSize.getValue();
+      if (!importQueue || priority > highestPriority) {
+        importQueue = &state->blobQueue;
+        count = getBatchSize(HgImportRequest::kBlobImportType);
         highestPriority = priority;
       }
     }
 
-    if (queue) {
+    if (importQueue) {
       break;
     } else {
       queueCV_.wait(state.as_lock());
     }
   }
 
+  auto* queue = &importQueue->queue;
   count = std::min(count, queue->size());
   std::vector<std::shared_ptr<HgImportRequest>> result;
   result.reserve(count);
-  for (size_t i = 0; i < count; i++) {
+  while (result.size() < count && !queue->empty()) {
     std::pop_heap(
         queue->begin(),
         queue->end(),
@@ -182,11 +322,95 @@ std::vector<std::shared_ptr<HgImportRequest>> HgImportRequestQueue::dequeue() {
           return (*lhs) < (*rhs);
         });
 
-    result.emplace_back(std::move(queue->back()));
+    auto request = std::move(queue->back());
     queue->pop_back();
+    if (request->isCancelled()) {
+      importQueue->requestTracker.erase(getHash(*request));
+      cancelled.push_back(std::move(request));
+      continue;
+    }
+    result.emplace_back(std::move(request));
   }
 
   return result;
 }
 
+void HgImportRequestQueue::failCancelled(
+    std::vector<std::shared_ptr<HgImportRequest>>& cancelled) {
+  XLOGF(DBG4, "dropping {} cancelled import requests", cancelled.size());
+  if (stats_) {
+    stats_->increment(&HgBackingStoreStats::importCancelled, cancelled.size());
+  }
+  auto ew = folly::exception_wrapper{folly::OperationCancelled{}};
+  for (auto& request : cancelled) {
+    switch (request->getType()) {
+      case HgImportRequest::kBlobImportType:
+        failImport<HgImportRequest::BlobImport>(*request, ew);
+        break;
+      case HgImportRequest::kTreeImportType:
+        failImport<HgImportRequest::TreeImport>(*request, ew);
+        break;
+      case HgImportRequest::kBlobMetaImportType:
+        failImport<HgImportRequest::BlobMetaImport>(*request, ew);
+        break;
+    }
+  }
+}
+
+size_t HgImportRequestQueue::getBatchSize(size_t type) const {
+  auto config = config_->getEdenConfig();
+  if (!config->adaptiveImportBatchSize.getValue()) {
+    return getConfiguredBatchSize(*config, type);
+  }
+  auto batchSizes = adaptiveBatchSizes_.lock();
+  return boundAdaptiveBatchSize((*batchSizes)[type], *config, type);
+}
+
+template <typename T>
+size_t HgImportRequestQueue::getBatchSize() const {
+  return getBatchSize(getRequestType<T>());
+}
+
+template <typename T>
+void HgImportRequestQueue::recordBatchLatency(
+    size_t batchSize,
+    std::chrono::nanoseconds elapsed) {
+  auto config = config_->getEdenConfig();
+  if (!config->adaptiveImportBatchSize.getValue()) {
+    return;
+  }
+  auto target = config->adaptiveImportBatchLatencyTarget.getValue();
+  size_t step = config->adaptiveImportBatchSizeStep.getValue();
+
+  constexpr auto type = getRequestType<T>();
+  // Concurrent batches of the same type must not overwrite each other's
+  // updates, so the size is read and updated under a single lock.
+  auto batchSizes = adaptiveBatchSizes_.lock();
+  auto& current = boundAdaptiveBatchSize((*batchSizes)[type], *config, type);
+  if (elapsed > target) {
+    // Multiplicative decrease: a slow batch delays every request queued
+    // behind it, so back off quickly.
+    current = std::max<size_t>(current / 2, 1);
+  } else if (batchSize >= current) {
+    // Additive increase, but only when the batch was limited by its size
+    // rather than by the depth of the queue.
+    current += step;
+  }
+  // Apply the bounds right away so getBatchSize() reports the effective size.
+  boundAdaptiveBatchSize(current, *config, type);
+}
+
+template size_t HgImportRequestQueue::getBatchSize<Blob>() const;
+template size_t HgImportRequestQueue::getBatchSize<Tree>() const;
+template size_t HgImportRequestQueue::getBatchSize<BlobMetadata>() const;
+template void HgImportRequestQueue::recordBatchLatency<Blob>(
+    size_t,
+    std::chrono::nanoseconds);
+template void HgImportRequestQueue::recordBatchLatency<Tree>(
+    size_t,
+    std::chrono::nanoseconds);
+template void HgImportRequestQueue::recordBatchLatency<BlobMetadata>(
+    size_t,
+    std::chrono::nanoseconds);
+
 } // namespace facebook::eden
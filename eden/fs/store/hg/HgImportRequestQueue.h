@@ -10,28 +10,55 @@
 #include <folly/Synchronized.h>
 #include <folly/Try.h>
 #include <folly/container/F14Map.h>
+#include <array>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <vector>
 #include "eden/fs/model/Hash.h"
 #include "eden/fs/store/hg/HgImportRequest.h"
+#include "eden/fs/store/hg/HgImportRequestFairQueue.h"
+#include "eden/fs/store/hg/HgImportRequestLanes.h"
+#include "eden/fs/telemetry/EdenStats.h"
 #include "folly/futures/Future.h"
 
 namespace facebook::eden {
 
 class ReloadableConfig;
 
+/**
+ * Queue of the import requests waiting for an HgQueuedBackingStore worker,
+ * de-duplicating concurrent requests for the same object.
+ *
+ * By default, the requests of each type are kept in a heap and the whole
+ * queue is protected by a single lock. When hg:import-queue-lanes is set at
+ * construction, they are kept in HgImportRequestLanes instead, which splits
+ * them further so that producers and consumers do not contend. When
+ * hg:import-queue-fair-scheduling is set, they are kept in
+ * HgImportRequestFairQueue, which shares the import threads between the
+ * client processes.
+ *
+ * Requests carry the cancellation tokens of their waiters. Once all of them
+ * are cancelled, because the filesystem requests that triggered the import
+ * were interrupted or timed out, the request is dropped when it reaches the
+ * front of the queue rather than handed to a worker, and its waiters fail
+ * with folly::OperationCancelled.
+ */
 class HgImportRequestQueue {
  public:
-  explicit HgImportRequestQueue(std::shared_ptr<ReloadableConfig> config)
-      : config_(std::move(config)) {}
+  /**
+   * stats, when set, receives the number of dropped requests.
+   */
+  explicit HgImportRequestQueue(
+      std::shared_ptr<ReloadableConfig> config,
+      EdenStatsPtr stats = nullptr);
 
   /**
    * Enqueue a blob request to the queue.
    *
    * Return a future that will complete when the blob request completes.
    */
-  folly::Future<std::unique_ptr<Blob>> enqueueBlob(
+  folly::Future<std::shared_ptr<const Blob>> enqueueBlob(
       std::shared_ptr<HgImportRequest> request);
 
   /**
@@ -39,7 +66,7 @@ class HgImportRequestQueue {
    *
    * Return a future that will complete when the blob request completes.
    */
-  folly::Future<std::unique_ptr<Tree>> enqueueTree(
+  folly::Future<std::shared_ptr<const Tree>> enqueueTree(
       std::shared_ptr<HgImportRequest> request);
 
   /**
@@ -47,7 +74,7 @@ class HgImportRequestQueue {
    *
    * Return a future that will complete when the aux data request completes.
    */
-  folly::Future<std::unique_ptr<BlobMetadata>> enqueueBlobMeta(
+  folly::Future<std::shared_ptr<const BlobMetadata>> enqueueBlobMeta(
       std::shared_ptr<HgImportRequest> request);
 
   /**
@@ -57,10 +84,29 @@ class HgImportRequestQueue {
    *
    * All requests in the vector are guaranteed to be the same type.
    * The number of the returned requests is controlled by `import-batch-size*`
-   * options in the config. It may have fewer requests than configured.
+   * options in the config, or by the adaptive batch size of that type when
+   * `hg:adaptive-import-batch-size` is set. It may have fewer requests than
+   * that.
    */
   std::vector<std::shared_ptr<HgImportRequest>> dequeue();
 
+  /* ====== Batch sizing methods ====== */
+
+  /**
+   * Returns the maximum number of requests of type T that dequeue() will
+   * currently return in a single batch.
+   */
+  template <typename T>
+  size_t getBatchSize() const;
+
+  /**
+   * Report that importing a batch of batchSize requests of type T took
+   * elapsed. When adaptive batch sizing is enabled, this is used to tune the
+   * size of the following batches of that type; otherwise it does nothing.
+   */
+  template <typename T>
+  void recordBatchLatency(size_t batchSize, std::chrono::nanoseconds elapsed);
+
   /**
    * Destroy the queue.
    *
@@ -72,10 +118,14 @@ class HgImportRequestQueue {
 
   /* ====== De-duplication methods ====== */
 
+  /**
+   * Fulfill the promises of all the requests that were de-duplicated against
+   * the import of id. Every waiter receives the same immutable object.
+   */
   template <typename T>
   void markImportAsFinished(
       const ObjectId& id,
-      folly::Try<std::unique_ptr<T>>& importTry);
+      folly::Try<std::shared_ptr<const T>>& importTry);
 
   /**
    * Combines all requests into 1 vec and clears the contents of the originals.
@@ -87,7 +137,7 @@ class HgImportRequestQueue {
    * Puts an item into the queue.
    */
   template <typename T, typename ImportType>
-  folly::Future<std::unique_ptr<T>> enqueue(
+  folly::Future<std::shared_ptr<const T>> enqueue(
       std::shared_ptr<HgImportRequest> request);
 
   HgImportRequestQueue(HgImportRequestQueue&&) = delete;
@@ -122,32 +172,106 @@ class HgImportRequestQueue {
       folly::Synchronized<HgImportRequestQueue::State, std::mutex>::LockedPtr&
           state);
 
+  /**
+   * Returns the HgImportRequest::getType() of the requests importing T.
+   */
+  template <typename T>
+  static constexpr size_t getRequestType() {
+    if constexpr (std::is_same_v<T, Tree>) {
+      return HgImportRequest::kTreeImportType;
+    } else if constexpr (std::is_same_v<T, BlobMetadata>) {
+      return HgImportRequest::kBlobMetaImportType;
+    } else {
+      static_assert(
+          std::is_same_v<T, Blob>,
+          "getRequestType can only be called with Tree, Blob or BlobMetadata types");
+      return HgImportRequest::kBlobImportType;
+    }
+  }
+
+  /**
+   * Returns the batch size to use for requests of the given type, as
+   * returned by HgImportRequest::getType().
+   */
+  size_t getBatchSize(size_t type) const;
+
+  /**
+   * Stop tracking the import of id and return its request, or nullptr if it
+   * was not tracked.
+   */
+  template <typename T>
+  std::shared_ptr<HgImportRequest> finishImport(const ObjectId& id);
+
+  /**
+   * Fail the waiters of requests that were dropped by dequeue() because
+   * they were cancelled. The requests must no longer be tracked.
+   */
+  void failCancelled(
+      std::vector<std::shared_ptr<HgImportRequest>>& cancelled);
+
+  /**
+   * Implementation of dequeue() for the single-lock queue.
+   */
+  std::vector<std::shared_ptr<HgImportRequest>> dequeueFromHeaps(
+      std::vector<std::shared_ptr<HgImportRequest>>& cancelled);
+
   std::shared_ptr<ReloadableConfig> config_;
+  EdenStatsPtr stats_;
   folly::Synchronized<State, std::mutex> state_;
   std::condition_variable queueCV_;
+
+  /**
+   * Set when hg:import-queue-lanes is enabled, in which case state_ is
+   * unused.
+   */
+  const std::unique_ptr<HgImportRequestLanes> lanes_;
+
+  /**
+   * Set when hg:import-queue-fair-scheduling is enabled, in which case
+   * state_ and lanes_ are unused.
+   */
+  const std::unique_ptr<HgImportRequestFairQueue> fairQueue_;
+
+  /**
+   * Current adaptive batch size of each request type, indexed by
+   * HgImportRequest::getType(). 0 until the first batch of that type is
+   * dequeued with adaptive batch sizing enabled.
+   */
+  mutable folly::Synchronized<std::array<size_t, 3>, std::mutex>
+      adaptiveBatchSizes_;
 };
 
 template <typename T>
-void HgImportRequestQueue::markImportAsFinished(
-    const ObjectId& id,
-    folly::Try<std::unique_ptr<T>>& importTry) {
-  std::shared_ptr<HgImportRequest> import;
-  {
-    auto state = state_.lock();
-
-    auto& requestTracker = getImportQueue<T>(state)->requestTracker;
-    auto importReq = requestTracker.find(id);
-    if (importReq != requestTracker.end()) {
-      import = std::move(importReq->second);
-      requestTracker.erase(importReq);
-    }
+std::shared_ptr<HgImportRequest> HgImportRequestQueue::finishImport(
+    const ObjectId& id) {
+  if (fairQueue_) {
+    return fairQueue_->finishImport(getRequestType<T>(), id);
+  }
+  if (lanes_) {
+    return lanes_->finishImport(getRequestType<T>(), id);
   }
 
+  auto state = state_.lock();
+  auto& requestTracker = getImportQueue<T>(state)->requestTracker;
+  auto importReq = requestTracker.find(id);
+  if (importReq == requestTracker.end()) {
+    return nullptr;
+  }
+  auto import = std::move(importReq->second);
+  requestTracker.erase(importReq);
+  return import;
+}
+
+template <typename T>
+void HgImportRequestQueue::markImportAsFinished(
+    const ObjectId& id,
+    folly::Try<std::shared_ptr<const T>>& importTry) {
+  auto import = finishImport<T>(id);
   if (!import) {
     return;
   }
 
-  std::vector<folly::Promise<std::unique_ptr<T>>>* promises;
+  std::vector<folly::Promise<std::shared_ptr<const T>>>* promises;
 
   if constexpr (std::is_same_v<T, Tree>) {
     auto* treeImport = import->getRequest<HgImportRequest::TreeImport>();
@@ -166,10 +290,10 @@ void HgImportRequestQueue::markImportAsFinished(
 
   if (importTry.hasValue()) {
     // If we find the id in the map, loop through all of the associated
-    // Promises and fulfill them with the obj. We need to construct a
-    // deep copy of the unique_ptr to fulfill the Promises
+    // Promises and fulfill them with the obj. The object is immutable, so all
+    // of them can share it instead of each receiving a copy.
     for (auto& promise : (*promises)) {
-      promise.setValue(std::make_unique<T>(*(importTry.value())));
+      promise.setValue(importTry.value());
     }
   } else {
     // If we find the id in the map, loop through all of the associated
@@ -84,7 +84,7 @@ HgQueuedBackingStore::HgQueuedBackingStore(
       stats_(std::move(stats)),
       config_(config),
       backingStore_(std::move(backingStore)),
-      queue_(std::move(config)),
+      queue_(std::move(config), stats_.copy()),
       structuredLogger_{std::move(structuredLogger)},
       logger_(std::move(logger)),
       activityBuffer_{
@@ -144,7 +144,8 @@ void HgQueuedBackingStore::processBlobImportRequests(
     futures.reserve(requests.size());
 
     for (auto& request : requests) {
-      auto* promise = request->getPromise<std::unique_ptr<Blob>>();
+      auto* promise =
+          request->getPromise<HgImportRequest::BlobImport::Response>();
       if (promise->isFulfilled()) {
         stats_->addDuration(&HgBackingStoreStats::fetchBlob, watch.elapsed());
         continue;
@@ -153,8 +154,13 @@ void HgQueuedBackingStore::processBlobImportRequests(
       // The blobs were either not found locally, or, when EdenAPI is enabled,
       // not found on the server. Let's import the blob through the hg importer.
       // TODO(xavierd): remove when EdenAPI has been rolled out everywhere.
-      auto fetchSemiFuture = backingStore_->fetchBlobFromHgImporter(
-          request->getRequest<HgImportRequest::BlobImport>()->proxyHash);
+      auto fetchSemiFuture =
+          backingStore_
+              ->fetchBlobFromHgImporter(
+                  request->getRequest<HgImportRequest::BlobImport>()->proxyHash)
+              .deferValue([](std::unique_ptr<Blob> blob) {
+                return HgImportRequest::BlobImport::Response{std::move(blob)};
+              });
       futures.emplace_back(
           std::move(fetchSemiFuture)
               .defer([request = std::move(request),
@@ -200,7 +206,8 @@ void HgQueuedBackingStore::processTreeImportRequests(
     futures.reserve(requests.size());
 
     for (auto& request : requests) {
-      auto* promise = request->getPromise<std::unique_ptr<Tree>>();
+      auto* promise =
+          request->getPromise<HgImportRequest::TreeImport::Response>();
       if (promise->isFulfilled()) {
         stats_->addDuration(&HgBackingStoreStats::fetchTree, watch.elapsed());
         continue;
@@ -210,7 +217,11 @@ void HgQueuedBackingStore::processTreeImportRequests(
       // not found on the server. Let's import the trees through the hg
       // importer.
       // TODO(xavierd): remove when EdenAPI has been rolled out everywhere.
-      auto treeSemiFuture = backingStore_->getTree(request);
+      auto treeSemiFuture =
+          backingStore_->getTree(request).deferValue(
+              [](std::unique_ptr<Tree> tree) {
+                return HgImportRequest::TreeImport::Response{std::move(tree)};
+              });
       futures.emplace_back(
           std::move(treeSemiFuture)
               .defer([request = std::move(request),
@@ -254,7 +265,8 @@ void HgQueuedBackingStore::processBlobMetaImportRequests(
 
   {
     for (auto& request : requests) {
-      auto* promise = request->getPromise<std::unique_ptr<BlobMetadata>>();
+      auto* promise =
+          request->getPromise<HgImportRequest::BlobMetaImport::Response>();
       if (promise->isFulfilled()) {
         stats_->addDuration(
             &HgBackingStoreStats::fetchBlobMetadata, watch.elapsed());
@@ -280,13 +292,24 @@ void HgQueuedBackingStore::processRequest() {
     }
 
     const auto& first = requests.at(0);
+    auto batchSize = requests.size();
+    folly::stop_watch<std::chrono::nanoseconds> watch;
 
     if (first->isType<HgImportRequest::BlobImport>()) {
       processBlobImportRequests(std::move(requests));
+      queue_.recordBatchLatency<Blob>(batchSize, watch.elapsed());
+      stats_->addDuration(
+          &HgBackingStoreStats::blobImportBatch, watch.elapsed());
     } else if (first->isType<HgImportRequest::TreeImport>()) {
       processTreeImportRequests(std::move(requests));
+      queue_.recordBatchLatency<Tree>(batchSize, watch.elapsed());
+      stats_->addDuration(
+          &HgBackingStoreStats::treeImportBatch, watch.elapsed());
     } else if (first->isType<HgImportRequest::BlobMetaImport>()) {
       processBlobMetaImportRequests(std::move(requests));
+      queue_.recordBatchLatency<BlobMetadata>(batchSize, watch.elapsed());
+      stats_->addDuration(
+          &HgBackingStoreStats::blobMetadataImportBatch, watch.elapsed());
     }
   }
 }
@@ -421,7 +444,12 @@ HgQueuedBackingStore::getTreeImpl(
     const ObjectFetchContextPtr& context) {
   auto getTreeFuture = folly::makeFutureWith([&] {
     auto request = HgImportRequest::makeTreeImportRequest(
-        id, proxyHash, context->getPriority(), context->getCause());
+        id,
+        proxyHash,
+        context->getPriority(),
+        context->getCause(),
+        context->getClientPid());
+    request->setCancellationToken(context->getCancellationToken());
     uint64_t unique = request->getUnique();
 
     auto importTracker =
@@ -449,7 +477,7 @@ HgQueuedBackingStore::getTreeImpl(
   });
 
   return std::move(getTreeFuture)
-      .thenTry([this, id](folly::Try<std::unique_ptr<Tree>>&& result) {
+      .thenTry([this, id](folly::Try<std::shared_ptr<const Tree>>&& result) {
         this->queue_.markImportAsFinished<Tree>(id, result);
         auto tree = std::move(result).value();
         return GetTreeResult{
@@ -495,7 +523,12 @@ HgQueuedBackingStore::getBlobImpl(
                << ", hash is:" << id;
 
     auto request = HgImportRequest::makeBlobImportRequest(
-        id, proxyHash, context->getPriority(), context->getCause());
+        id,
+        proxyHash,
+        context->getPriority(),
+        context->getCause(),
+        context->getClientPid());
+    request->setCancellationToken(context->getCancellationToken());
     auto unique = request->getUnique();
 
     auto importTracker =
@@ -523,7 +556,7 @@ HgQueuedBackingStore::getBlobImpl(
   });
 
   return std::move(getBlobFuture)
-      .thenTry([this, id](folly::Try<std::unique_ptr<Blob>>&& result) {
+      .thenTry([this, id](folly::Try<std::shared_ptr<const Blob>>&& result) {
         this->queue_.markImportAsFinished<Blob>(id, result);
         auto blob = std::move(result).value();
         return GetBlobResult{
@@ -576,7 +609,12 @@ HgQueuedBackingStore::getBlobMetadataImpl(
                << ", hash is:" << id;
 
     auto request = HgImportRequest::makeBlobMetaImportRequest(
-        id, proxyHash, context->getPriority(), context->getCause());
+        id,
+        proxyHash,
+        context->getPriority(),
+        context->getCause(),
+        context->getClientPid());
+    request->setCancellationToken(context->getCancellationToken());
     auto unique = request->getUnique();
 
     auto importTracker =
@@ -604,11 +642,15 @@ HgQueuedBackingStore::getBlobMetadataImpl(
   });
 
   return std::move(getBlobMetaFuture)
-      .thenTry([this, id](folly::Try<std::unique_ptr<BlobMetadata>>&& result) {
+      .thenTry([this, id](
+                   folly::Try<std::shared_ptr<const BlobMetadata>>&& result) {
         this->queue_.markImportAsFinished<BlobMetadata>(id, result);
-        auto blobMeta = std::move(result).value();
+        // GetBlobMetaResult hands out an owned BlobMetadata. Unlike trees and
+        // blobs, it is only a few bytes, so copying it is cheap.
+        auto& blobMeta = result.value();
         return GetBlobMetaResult{
-            std::move(blobMeta), ObjectFetchContext::Origin::FromNetworkFetch};
+            blobMeta ? std::make_unique<BlobMetadata>(*blobMeta) : nullptr,
+            ObjectFetchContext::Origin::FromNetworkFetch};
       });
 }
 
@@ -716,6 +758,20 @@ size_t HgQueuedBackingStore::getImportMetric(
       metric, getImportWatches(stage, object));
 }
 
+size_t HgQueuedBackingStore::getImportBatchSize(
+    HgBackingStore::HgImportObject object) const {
+  switch (object) {
+    case HgBackingStore::HgImportObject::TREE:
+    case HgBackingStore::HgImportObject::BATCHED_TREE:
+      return queue_.getBatchSize<Tree>();
+    case HgBackingStore::HgImportObject::BLOBMETA:
+    case HgBackingStore::HgImportObject::BATCHED_BLOBMETA:
+      return queue_.getBatchSize<BlobMetadata>();
+    default:
+      return queue_.getBatchSize<Blob>();
+  }
+}
+
 RequestMetricsScope::LockedRequestWatchList&
 HgQueuedBackingStore::getImportWatches(
     RequestMetricsScope::RequestStage stage,
@@ -779,7 +835,7 @@ void HgQueuedBackingStore::periodicManagementTask() {
 
 namespace {
 void dropBlobImportRequest(std::shared_ptr<HgImportRequest>& request) {
-  auto* promise = request->getPromise<std::unique_ptr<Blob>>();
+  auto* promise = request->getPromise<HgImportRequest::BlobImport::Response>();
   if (promise != nullptr) {
     if (!promise->isFulfilled()) {
       promise->setException(std::runtime_error("Request forcibly dropped"));
@@ -788,7 +844,7 @@ void dropBlobImportRequest(std::shared_ptr<HgImportRequest>& request) {
 }
 
 void dropTreeImportRequest(std::shared_ptr<HgImportRequest>& request) {
-  auto* promise = request->getPromise<std::unique_ptr<Tree>>();
+  auto* promise = request->getPromise<HgImportRequest::TreeImport::Response>();
   if (promise != nullptr) {
     if (!promise->isFulfilled()) {
       promise->setException(std::runtime_error("Request forcibly dropped"));
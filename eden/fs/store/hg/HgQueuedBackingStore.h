@@ -181,6 +181,12 @@ class HgQueuedBackingStore final : public BackingStore {
       HgBackingStore::HgImportObject object,
       RequestMetricsScope::RequestMetric metric) const;
 
+  /**
+   * Returns the number of `object` imports that are currently requested from
+   * the backing store at once.
+   */
+  size_t getImportBatchSize(HgBackingStore::HgImportObject object) const;
+
   void startRecordingFetch() override;
   std::unordered_set<std::string> stopRecordingFetch() override;
 
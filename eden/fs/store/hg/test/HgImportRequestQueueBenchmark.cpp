@@ -32,12 +32,22 @@ std::shared_ptr<HgImportRequest> makeBlobImportRequest(
       hash, std::move(proxyHash), priority, ObjectFetchContext::Cause::Unknown);
 }
 
-void enqueue(benchmark::State& state) {
+/**
+ * Returns the config of a queue using lanes if st.range(0) is 1, and the fair
+ * queue if it is 2, so that the queue implementations can be compared.
+ */
+std::shared_ptr<ReloadableConfig> makeQueueConfig(benchmark::State& st) {
   auto rawEdenConfig = EdenConfig::createTestEdenConfig();
-  auto edenConfig = std::make_shared<ReloadableConfig>(
+  rawEdenConfig->importQueueLanes.setValue(
+      st.range(0) == 1, ConfigSourceType::Default, true);
+  rawEdenConfig->importQueueFairScheduling.setValue(
+      st.range(0) == 2, ConfigSourceType::Default, true);
+  return std::make_shared<ReloadableConfig>(
       rawEdenConfig, ConfigReloadBehavior::NoReload);
+}
 
-  auto queue = HgImportRequestQueue{edenConfig};
+void enqueue(benchmark::State& state) {
+  auto queue = HgImportRequestQueue{makeQueueConfig(state)};
 
   std::vector<std::shared_ptr<HgImportRequest>> requests;
   requests.reserve(state.max_iterations);
@@ -53,11 +63,7 @@ void enqueue(benchmark::State& state) {
 }
 
 void dequeue(benchmark::State& state) {
-  auto rawEdenConfig = EdenConfig::createTestEdenConfig();
-  auto edenConfig = std::make_shared<ReloadableConfig>(
-      rawEdenConfig, ConfigReloadBehavior::NoReload);
-
-  auto queue = HgImportRequestQueue{edenConfig};
+  auto queue = HgImportRequestQueue{makeQueueConfig(state)};
 
   for (size_t i = 0; i < state.max_iterations; i++) {
     queue.enqueueBlob(makeBlobImportRequest(kDefaultImportPriority));
@@ -68,8 +74,170 @@ void dequeue(benchmark::State& state) {
   }
 }
 
+/**
+ * Every thread enqueues a request and dequeues one from a queue shared by all
+ * threads, so producers and consumers contend with each other.
+ */
+void enqueueDequeueShared(benchmark::State& state) {
+  static std::unique_ptr<HgImportRequestQueue> queue;
+  if (state.thread_index() == 0) {
+    // With the default batch size of 1, each dequeue() takes exactly one
+    // request, so no thread is left waiting for a request that another took.
+    queue = std::make_unique<HgImportRequestQueue>(makeQueueConfig(state));
+  }
+
+  std::vector<std::shared_ptr<HgImportRequest>> requests;
+  requests.reserve(state.max_iterations);
+  for (size_t i = 0; i < state.max_iterations; i++) {
+    requests.emplace_back(makeBlobImportRequest(ImportPriority{
+        ImportPriority::Class::Normal, static_cast<int64_t>(i % 64)}));
+  }
+  auto blob = folly::Try<std::shared_ptr<const Blob>>{
+      std::make_shared<const Blob>(ObjectId{}, folly::IOBuf{})};
+
+  auto requestIter = requests.begin();
+  for (auto _ : state) {
+    auto& request = *requestIter++;
+    queue->enqueueBlob(std::move(request));
+    auto dequeued = queue->dequeue().at(0);
+    queue->markImportAsFinished<Blob>(
+        dequeued->getRequest<HgImportRequest::BlobImport>()->hash, blob);
+  }
+
+  if (state.thread_index() == 0) {
+    queue.reset();
+  }
+}
+
+/**
+ * Replays a mixed workload: a bulk process, such as a recursive grep, keeps
+ * st.range(1) blob requests queued, while an interactive process issues one
+ * request at a time and waits for it. Each iteration is the time for the
+ * interactive request to be dequeued by a single import thread, and the
+ * "imports_ahead" counter is the average number of bulk requests imported
+ * before it.
+ */
+void mixedInteractiveAndBulk(benchmark::State& st) {
+  constexpr pid_t kBulkPid = 1;
+  constexpr pid_t kInteractivePid = 2;
+
+  auto rawEdenConfig = EdenConfig::createTestEdenConfig();
+  rawEdenConfig->importBatchSize.setValue(8, ConfigSourceType::Default, true);
+  rawEdenConfig->importQueueLanes.setValue(
+      st.range(0) == 1, ConfigSourceType::Default, true);
+  rawEdenConfig->importQueueFairScheduling.setValue(
+      st.range(0) == 2, ConfigSourceType::Default, true);
+  auto queue = HgImportRequestQueue{std::make_shared<ReloadableConfig>(
+      rawEdenConfig, ConfigReloadBehavior::NoReload)};
+
+  auto blob = folly::Try<std::shared_ptr<const Blob>>{
+      std::make_shared<const Blob>(ObjectId{}, folly::IOBuf{})};
+  auto makeRequest = [](ImportPriority priority, pid_t pid) {
+    auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, uniqueHash()};
+    auto hash = proxyHash.sha1();
+    return HgImportRequest::makeBlobImportRequest(
+        hash,
+        std::move(proxyHash),
+        priority,
+        ObjectFetchContext::Cause::Fs,
+        pid);
+  };
+
+  auto bulkBacklog = static_cast<size_t>(st.range(1));
+  size_t bulkQueued = 0;
+  size_t importsAhead = 0;
+  for (auto _ : st) {
+    for (; bulkQueued < bulkBacklog; ++bulkQueued) {
+      // Later bulk requests are more urgent, as when a process walks down a
+      // directory hierarchy, so the interactive request can not simply
+      // overtake all of them.
+      queue.enqueueBlob(makeRequest(
+          ImportPriority{
+              ImportPriority::Class::Normal,
+              static_cast<int64_t>(bulkQueued % 64)},
+          kBulkPid));
+    }
+    auto interactive = makeRequest(kDefaultImportPriority, kInteractivePid);
+    auto interactiveHash =
+        interactive->getRequest<HgImportRequest::BlobImport>()->hash;
+    queue.enqueueBlob(std::move(interactive));
+
+    bool found = false;
+    while (!found) {
+      for (auto& request : queue.dequeue()) {
+        const auto& hash =
+            request->getRequest<HgImportRequest::BlobImport>()->hash;
+        if (hash == interactiveHash) {
+          found = true;
+        } else {
+          --bulkQueued;
+          ++importsAhead;
+        }
+        queue.markImportAsFinished<Blob>(hash, blob);
+      }
+    }
+  }
+
+  st.counters["imports_ahead"] = benchmark::Counter(
+      static_cast<double>(importsAhead), benchmark::Counter::kAvgIterations);
+}
+
+/**
+ * Measures the cost of resolving an import that st.range(0) callers are
+ * waiting on. All waiters share the imported blob, so this should stay flat
+ * as the fan-in grows, independent of the blob size st.range(1).
+ */
+void markImportAsFinishedFanIn(benchmark::State& st) {
+  auto rawEdenConfig = EdenConfig::createTestEdenConfig();
+  auto edenConfig = std::make_shared<ReloadableConfig>(
+      rawEdenConfig, ConfigReloadBehavior::NoReload);
+
+  auto queue = HgImportRequestQueue{edenConfig};
+  auto waiters = st.range(0);
+  auto contents = std::string(st.range(1), 'a');
+
+  for (auto _ : st) {
+    auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, uniqueHash()};
+    auto hash = proxyHash.sha1();
+
+    std::vector<folly::Future<std::shared_ptr<const Blob>>> futures;
+    futures.reserve(waiters);
+    for (int64_t i = 0; i < waiters; i++) {
+      futures.emplace_back(
+          queue.enqueueBlob(HgImportRequest::makeBlobImportRequest(
+              hash,
+              proxyHash,
+              kDefaultImportPriority,
+              ObjectFetchContext::Cause::Unknown)));
+    }
+    auto request = queue.dequeue().at(0);
+
+    folly::Try<std::shared_ptr<const Blob>> blob{std::make_shared<const Blob>(
+        hash, folly::IOBuf{folly::IOBuf::COPY_BUFFER, contents})};
+    request->getPromise<HgImportRequest::BlobImport::Response>()->setValue(
+        blob.value());
+    queue.markImportAsFinished<Blob>(hash, blob);
+
+    for (auto& future : futures) {
+      benchmark::DoNotOptimize(std::move(future).get());
+    }
+  }
+}
+
+BENCHMARK(mixedInteractiveAndBulk)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgNames({"queue", "backlog"})
+    ->ArgsProduct({{0, 1, 2}, {100, 10000}});
+
+BENCHMARK(markImportAsFinishedFanIn)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({{1, 10, 100}, {1024, 1024 * 1024}});
+
 BENCHMARK(enqueue)
     ->Unit(benchmark::kNanosecond)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(2)
     ->Threads(1)
     ->Threads(2)
     ->Threads(4)
@@ -79,6 +247,21 @@ BENCHMARK(enqueue)
 
 BENCHMARK(dequeue)
     ->Unit(benchmark::kNanosecond)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(2)
+    ->Threads(1)
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(8)
+    ->Threads(16)
+    ->Threads(32);
+
+BENCHMARK(enqueueDequeueShared)
+    ->Unit(benchmark::kNanosecond)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(2)
     ->Threads(1)
     ->Threads(2)
     ->Threads(4)
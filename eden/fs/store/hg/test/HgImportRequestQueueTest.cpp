@@ -5,11 +5,15 @@
  * GNU General Public License version 2.
  */
 
+#include <folly/CancellationToken.h>
 #include <folly/Try.h>
 #include <folly/logging/xlog.h>
 #include <folly/portability/GTest.h>
 #include <array>
 #include <memory>
+#include <optional>
+#include <set>
+#include <thread>
 
 #include "eden/fs/config/ReloadableConfig.h"
 #include "eden/fs/model/Hash.h"
@@ -25,7 +29,15 @@
 
 using namespace facebook::eden;
 
-struct HgImportRequestQueueTest : ::testing::Test {
+enum class QueueKind { SingleQueue, Lanes, FairQueue };
+
+/**
+ * Runs every test against each queue implementation: the single-lock queue,
+ * the multi-lane one and the fair one, selected by the parameter. These tests
+ * do not set client pids, so with the fair queue all the requests are in the
+ * same flow.
+ */
+struct HgImportRequestQueueTest : ::testing::TestWithParam<QueueKind> {
   std::shared_ptr<ReloadableConfig> edenConfig;
   std::shared_ptr<EdenConfig> rawEdenConfig;
 
@@ -35,6 +47,10 @@ struct HgImportRequestQueueTest : ::testing::Test {
     rawEdenConfig->importBatchSize.setValue(1, ConfigSourceType::Default, true);
     rawEdenConfig->importBatchSizeTree.setValue(
         1, ConfigSourceType::Default, true);
+    rawEdenConfig->importQueueLanes.setValue(
+        GetParam() == QueueKind::Lanes, ConfigSourceType::Default, true);
+    rawEdenConfig->importQueueFairScheduling.setValue(
+        GetParam() == QueueKind::FairQueue, ConfigSourceType::Default, true);
 
     edenConfig = std::make_shared<ReloadableConfig>(
         rawEdenConfig, ConfigReloadBehavior::NoReload);
@@ -120,7 +136,7 @@ ObjectId insertTreeImportRequest(
   return hash;
 }
 
-TEST_F(HgImportRequestQueueTest, sameObjectIdDifferentType) {
+TEST_P(HgImportRequestQueueTest, sameObjectIdDifferentType) {
   auto queue = HgImportRequestQueue{edenConfig};
 
   auto hgRevHash = uniqueHash();
@@ -141,7 +157,7 @@ TEST_F(HgImportRequestQueueTest, sameObjectIdDifferentType) {
   EXPECT_NE(request2, nullptr);
 }
 
-TEST_F(HgImportRequestQueueTest, getRequestByPriority) {
+TEST_P(HgImportRequestQueueTest, getRequestByPriority) {
   auto queue = HgImportRequestQueue{edenConfig};
   std::vector<ObjectId> enqueued;
 
@@ -166,9 +182,10 @@ TEST_F(HgImportRequestQueueTest, getRequestByPriority) {
     EXPECT_EQ(
         expected, request->getRequest<HgImportRequest::BlobImport>()->hash);
 
-    folly::Try<std::unique_ptr<Blob>> blob = folly::makeTryWith([expected]() {
-      return std::make_unique<Blob>(expected, folly::IOBuf{});
-    });
+    folly::Try<std::shared_ptr<const Blob>> blob =
+        folly::makeTryWith([expected]() {
+          return std::make_shared<const Blob>(expected, folly::IOBuf{});
+        });
 
     queue.markImportAsFinished<Blob>(
         request->getRequest<HgImportRequest::BlobImport>()->hash, blob);
@@ -179,9 +196,9 @@ TEST_F(HgImportRequestQueueTest, getRequestByPriority) {
       smallHash,
       smallRequestDequeue->getRequest<HgImportRequest::BlobImport>()->hash);
 
-  folly::Try<std::unique_ptr<Blob>> smallBlob =
+  folly::Try<std::shared_ptr<const Blob>> smallBlob =
       folly::makeTryWith([smallHash = smallHash]() {
-        return std::make_unique<Blob>(smallHash, folly::IOBuf{});
+        return std::make_shared<const Blob>(smallHash, folly::IOBuf{});
       });
 
   queue.markImportAsFinished<Blob>(
@@ -189,7 +206,7 @@ TEST_F(HgImportRequestQueueTest, getRequestByPriority) {
       smallBlob);
 }
 
-TEST_F(HgImportRequestQueueTest, getRequestByPriorityReverse) {
+TEST_P(HgImportRequestQueueTest, getRequestByPriorityReverse) {
   auto queue = HgImportRequestQueue{edenConfig};
   std::deque<ObjectId> enqueued;
 
@@ -211,9 +228,9 @@ TEST_F(HgImportRequestQueueTest, getRequestByPriorityReverse) {
       largeHash,
       largeHashDequeue->getRequest<HgImportRequest::BlobImport>()->hash);
 
-  folly::Try<std::unique_ptr<Blob>> largeBlob =
+  folly::Try<std::shared_ptr<const Blob>> largeBlob =
       folly::makeTryWith([largeHash = largeHash]() {
-        return std::make_unique<Blob>(largeHash, folly::IOBuf{});
+        return std::make_shared<const Blob>(largeHash, folly::IOBuf{});
       });
   queue.markImportAsFinished<Blob>(
       largeHashDequeue->getRequest<HgImportRequest::BlobImport>()->hash,
@@ -228,15 +245,16 @@ TEST_F(HgImportRequestQueueTest, getRequestByPriorityReverse) {
     EXPECT_EQ(
         expected, request->getRequest<HgImportRequest::BlobImport>()->hash);
 
-    folly::Try<std::unique_ptr<Blob>> blob = folly::makeTryWith([expected]() {
-      return std::make_unique<Blob>(expected, folly::IOBuf{});
-    });
+    folly::Try<std::shared_ptr<const Blob>> blob =
+        folly::makeTryWith([expected]() {
+          return std::make_shared<const Blob>(expected, folly::IOBuf{});
+        });
     queue.markImportAsFinished<Blob>(
         request->getRequest<HgImportRequest::BlobImport>()->hash, blob);
   }
 }
 
-TEST_F(HgImportRequestQueueTest, mixedPriority) {
+TEST_P(HgImportRequestQueueTest, mixedPriority) {
   auto queue = HgImportRequestQueue{edenConfig};
   std::set<ObjectId> enqueued_blob;
   std::set<ObjectId> enqueued_tree;
@@ -272,10 +290,10 @@ TEST_F(HgImportRequestQueueTest, mixedPriority) {
         ImportPriority(ImportPriority::Class::Normal, 10 - i)
             .value()); // assert tree requests of priority 10 and 9
 
-    folly::Try<std::unique_ptr<Tree>> tree = folly::makeTryWith(
+    folly::Try<std::shared_ptr<const Tree>> tree = folly::makeTryWith(
         [hash = dequeuedRequest->getRequest<HgImportRequest::TreeImport>()
                     ->hash]() {
-          return std::make_unique<Tree>(
+          return std::make_shared<const Tree>(
               Tree::container{kPathMapDefaultCaseSensitive}, hash);
         });
     queue.markImportAsFinished<Tree>(
@@ -297,17 +315,17 @@ TEST_F(HgImportRequestQueueTest, mixedPriority) {
         ImportPriority(ImportPriority::Class::Normal, 9 - i)
             .value()); // assert blob requests of priority 9, 8, and 7
 
-    folly::Try<std::unique_ptr<Blob>> blob = folly::makeTryWith(
+    folly::Try<std::shared_ptr<const Blob>> blob = folly::makeTryWith(
         [hash = dequeuedRequest->getRequest<HgImportRequest::BlobImport>()
                     ->hash]() {
-          return std::make_unique<Blob>(hash, folly::IOBuf{});
+          return std::make_shared<const Blob>(hash, folly::IOBuf{});
         });
     queue.markImportAsFinished<Blob>(
         dequeuedRequest->getRequest<HgImportRequest::BlobImport>()->hash, blob);
   }
 }
 
-TEST_F(HgImportRequestQueueTest, getMultipleRequests) {
+TEST_P(HgImportRequestQueueTest, getMultipleRequests) {
   auto queue = HgImportRequestQueue{edenConfig};
   std::set<ObjectId> enqueued_blob;
   std::set<ObjectId> enqueued_tree;
@@ -335,10 +353,10 @@ TEST_F(HgImportRequestQueueTest, getMultipleRequests) {
             dequeuedRequest->getRequest<HgImportRequest::TreeImport>()->hash) !=
         enqueued_tree.end());
 
-    folly::Try<std::unique_ptr<Tree>> tree = folly::makeTryWith(
+    folly::Try<std::shared_ptr<const Tree>> tree = folly::makeTryWith(
         [hash = dequeuedRequest->getRequest<HgImportRequest::TreeImport>()
                     ->hash]() {
-          return std::make_unique<Tree>(
+          return std::make_shared<const Tree>(
               Tree::container{kPathMapDefaultCaseSensitive}, hash);
         });
     queue.markImportAsFinished<Tree>(
@@ -357,17 +375,17 @@ TEST_F(HgImportRequestQueueTest, getMultipleRequests) {
             dequeuedRequest->getRequest<HgImportRequest::BlobImport>()->hash) !=
         enqueued_blob.end());
 
-    folly::Try<std::unique_ptr<Blob>> blob = folly::makeTryWith(
+    folly::Try<std::shared_ptr<const Blob>> blob = folly::makeTryWith(
         [hash = dequeuedRequest->getRequest<HgImportRequest::BlobImport>()
                     ->hash]() {
-          return std::make_unique<Blob>(hash, folly::IOBuf{});
+          return std::make_shared<const Blob>(hash, folly::IOBuf{});
         });
     queue.markImportAsFinished<Blob>(
         dequeuedRequest->getRequest<HgImportRequest::BlobImport>()->hash, blob);
   }
 }
 
-TEST_F(HgImportRequestQueueTest, duplicateRequestAfterEnqueue) {
+TEST_P(HgImportRequestQueueTest, duplicateRequestAfterEnqueue) {
   auto queue = HgImportRequestQueue{edenConfig};
   std::vector<ObjectId> enqueued;
 
@@ -395,15 +413,15 @@ TEST_F(HgImportRequestQueueTest, duplicateRequestAfterEnqueue) {
       expected,
       dequeuedRequest->getRequest<HgImportRequest::BlobImport>()->hash);
 
-  folly::Try<std::unique_ptr<Blob>> blob =
+  folly::Try<std::shared_ptr<const Blob>> blob =
       folly::makeTryWith([hash = proxyHash.sha1()]() {
-        return std::make_unique<Blob>(hash, folly::IOBuf{});
+        return std::make_shared<const Blob>(hash, folly::IOBuf{});
       });
   queue.markImportAsFinished<Blob>(
       dequeuedRequest->getRequest<HgImportRequest::BlobImport>()->hash, blob);
 }
 
-TEST_F(HgImportRequestQueueTest, duplicateRequestAfterDequeue) {
+TEST_P(HgImportRequestQueueTest, duplicateRequestAfterDequeue) {
   auto queue = HgImportRequestQueue{edenConfig};
   std::vector<ObjectId> enqueued;
 
@@ -433,15 +451,15 @@ TEST_F(HgImportRequestQueueTest, duplicateRequestAfterDequeue) {
       dequeuedRequest->getRequest<HgImportRequest::BlobImport>()
           ->promises.size());
 
-  folly::Try<std::unique_ptr<Blob>> blob =
+  folly::Try<std::shared_ptr<const Blob>> blob =
       folly::makeTryWith([hash = proxyHash.sha1()]() {
-        return std::make_unique<Blob>(hash, folly::IOBuf{});
+        return std::make_shared<const Blob>(hash, folly::IOBuf{});
       });
   queue.markImportAsFinished<Blob>(
       dequeuedRequest->getRequest<HgImportRequest::BlobImport>()->hash, blob);
 }
 
-TEST_F(HgImportRequestQueueTest, duplicateRequestAfterMarkedDone) {
+TEST_P(HgImportRequestQueueTest, duplicateRequestAfterMarkedDone) {
   auto queue = HgImportRequestQueue{edenConfig};
   std::vector<ObjectId> enqueued;
 
@@ -468,15 +486,15 @@ TEST_F(HgImportRequestQueueTest, duplicateRequestAfterMarkedDone) {
       expected,
       dequeuedRequest->getRequest<HgImportRequest::BlobImport>()->hash);
 
-  folly::Try<std::unique_ptr<Blob>> blob =
+  folly::Try<std::shared_ptr<const Blob>> blob =
       folly::makeTryWith([hash = proxyHash.sha1()]() {
-        return std::make_unique<Blob>(hash, folly::IOBuf{});
+        return std::make_shared<const Blob>(hash, folly::IOBuf{});
       });
   queue.markImportAsFinished<Blob>(
       dequeuedRequest->getRequest<HgImportRequest::BlobImport>()->hash, blob);
 }
 
-TEST_F(HgImportRequestQueueTest, multipleDuplicateRequests) {
+TEST_P(HgImportRequestQueueTest, multipleDuplicateRequests) {
   auto queue = HgImportRequestQueue{edenConfig};
   std::vector<ObjectId> enqueued;
 
@@ -514,15 +532,48 @@ TEST_F(HgImportRequestQueueTest, multipleDuplicateRequests) {
       dequeuedRequest->getRequest<HgImportRequest::BlobImport>()
           ->promises.size());
 
-  folly::Try<std::unique_ptr<Blob>> blob =
+  folly::Try<std::shared_ptr<const Blob>> blob =
       folly::makeTryWith([hash = proxyHash.sha1()]() {
-        return std::make_unique<Blob>(hash, folly::IOBuf{});
+        return std::make_shared<const Blob>(hash, folly::IOBuf{});
       });
   queue.markImportAsFinished<Blob>(
       dequeuedRequest->getRequest<HgImportRequest::BlobImport>()->hash, blob);
 }
 
-TEST_F(HgImportRequestQueueTest, twoDuplicateRequestsDifferentPriority) {
+TEST_P(HgImportRequestQueueTest, duplicateRequestsShareImportedObject) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  auto hgRevHash = uniqueHash();
+  auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, hgRevHash};
+
+  auto [hash, request] = makeBlobImportRequestWithHash(
+      ImportPriority(ImportPriority::Class::Normal, 5), proxyHash);
+  auto [hash2, request2] = makeBlobImportRequestWithHash(
+      ImportPriority(ImportPriority::Class::Normal, 5), proxyHash);
+  auto [hash3, request3] = makeBlobImportRequestWithHash(
+      ImportPriority(ImportPriority::Class::Normal, 5), proxyHash);
+
+  queue.enqueueBlob(std::move(request));
+  auto future2 = queue.enqueueBlob(std::move(request2));
+  auto future3 = queue.enqueueBlob(std::move(request3));
+
+  auto dequeuedRequest = queue.dequeue().at(0);
+
+  folly::Try<std::shared_ptr<const Blob>> blob =
+      folly::makeTryWith([hash = proxyHash.sha1()]() {
+        return std::make_shared<const Blob>(hash, folly::IOBuf{});
+      });
+  queue.markImportAsFinished<Blob>(
+      dequeuedRequest->getRequest<HgImportRequest::BlobImport>()->hash, blob);
+
+  ASSERT_TRUE(future2.isReady());
+  ASSERT_TRUE(future3.isReady());
+  // Every waiter gets the very same object rather than a copy.
+  EXPECT_EQ(blob.value().get(), std::move(future2).get().get());
+  EXPECT_EQ(blob.value().get(), std::move(future3).get().get());
+}
+
+TEST_P(HgImportRequestQueueTest, twoDuplicateRequestsDifferentPriority) {
   auto queue = HgImportRequestQueue{edenConfig};
   std::vector<ObjectId> enqueued;
 
@@ -570,9 +621,10 @@ TEST_F(HgImportRequestQueueTest, twoDuplicateRequestsDifferentPriority) {
     EXPECT_EQ(
         expected, request->getRequest<HgImportRequest::BlobImport>()->hash);
 
-    folly::Try<std::unique_ptr<Blob>> blob = folly::makeTryWith([expected]() {
-      return std::make_unique<Blob>(expected, folly::IOBuf{});
-    });
+    folly::Try<std::shared_ptr<const Blob>> blob =
+        folly::makeTryWith([expected]() {
+          return std::make_shared<const Blob>(expected, folly::IOBuf{});
+        });
     queue.markImportAsFinished<Blob>(
         request->getRequest<HgImportRequest::BlobImport>()->hash, blob);
   }
@@ -582,9 +634,9 @@ TEST_F(HgImportRequestQueueTest, twoDuplicateRequestsDifferentPriority) {
   EXPECT_EQ(
       lowPriHash, expLowPri->getRequest<HgImportRequest::BlobImport>()->hash);
 
-  folly::Try<std::unique_ptr<Blob>> blob =
+  folly::Try<std::shared_ptr<const Blob>> blob =
       folly::makeTryWith([lowPriHash = lowPriHash]() {
-        return std::make_unique<Blob>(lowPriHash, folly::IOBuf{});
+        return std::make_shared<const Blob>(lowPriHash, folly::IOBuf{});
       });
   queue.markImportAsFinished<Blob>(
       expLowPri->getRequest<HgImportRequest::BlobImport>()->hash, blob);
@@ -598,11 +650,371 @@ TEST_F(HgImportRequestQueueTest, twoDuplicateRequestsDifferentPriority) {
     EXPECT_EQ(
         expected, request->getRequest<HgImportRequest::BlobImport>()->hash);
 
-    folly::Try<std::unique_ptr<Blob>> expBlob =
+    folly::Try<std::shared_ptr<const Blob>> expBlob =
         folly::makeTryWith([expected]() {
-          return std::make_unique<Blob>(expected, folly::IOBuf{});
+          return std::make_shared<const Blob>(expected, folly::IOBuf{});
         });
     queue.markImportAsFinished<Blob>(
         request->getRequest<HgImportRequest::BlobImport>()->hash, expBlob);
   }
 }
+
+TEST_P(HgImportRequestQueueTest, fixedBatchSizeIgnoresLatency) {
+  auto queue = HgImportRequestQueue{edenConfig};
+  rawEdenConfig->importBatchSize.setValue(
+      4, ConfigSourceType::UserConfig, true);
+
+  queue.recordBatchLatency<Blob>(4, std::chrono::seconds(10));
+  EXPECT_EQ(4, queue.getBatchSize<Blob>());
+  queue.recordBatchLatency<Blob>(4, std::chrono::nanoseconds(1));
+  EXPECT_EQ(4, queue.getBatchSize<Blob>());
+}
+
+TEST_P(HgImportRequestQueueTest, adaptiveBatchSizeFollowsLatency) {
+  auto queue = HgImportRequestQueue{edenConfig};
+  rawEdenConfig->adaptiveImportBatchSize.setValue(
+      true, ConfigSourceType::UserConfig, true);
+  rawEdenConfig->adaptiveImportBatchSizeMin.setValue(
+      2, ConfigSourceType::UserConfig, true);
+  rawEdenConfig->adaptiveImportBatchSizeMax.setValue(
+      40, ConfigSourceType::UserConfig, true);
+  rawEdenConfig->adaptiveImportBatchSizeStep.setValue(
+      8, ConfigSourceType::UserConfig, true);
+  rawEdenConfig->adaptiveImportBatchLatencyTarget.setValue(
+      std::chrono::milliseconds(100), ConfigSourceType::UserConfig, true);
+  rawEdenConfig->importBatchSize.setValue(
+      16, ConfigSourceType::UserConfig, true);
+
+  auto fast = std::chrono::milliseconds(10);
+  auto slow = std::chrono::milliseconds(500);
+
+  // Starts from the configured size, and grows while batches are full and
+  // fast.
+  EXPECT_EQ(16, queue.getBatchSize<Blob>());
+  queue.recordBatchLatency<Blob>(16, fast);
+  EXPECT_EQ(24, queue.getBatchSize<Blob>());
+
+  // A partial batch says nothing about larger batches.
+  queue.recordBatchLatency<Blob>(3, fast);
+  EXPECT_EQ(24, queue.getBatchSize<Blob>());
+
+  // Growth stops at the maximum.
+  queue.recordBatchLatency<Blob>(24, fast);
+  queue.recordBatchLatency<Blob>(32, fast);
+  EXPECT_EQ(40, queue.getBatchSize<Blob>());
+
+  // Slow batches halve the size down to the minimum.
+  queue.recordBatchLatency<Blob>(40, slow);
+  EXPECT_EQ(20, queue.getBatchSize<Blob>());
+  for (int i = 0; i < 10; i++) {
+    queue.recordBatchLatency<Blob>(20, slow);
+  }
+  EXPECT_EQ(2, queue.getBatchSize<Blob>());
+
+  // Each object type is tuned separately. Trees start from their configured
+  // size of 1, raised to the minimum.
+  EXPECT_EQ(2, queue.getBatchSize<Tree>());
+}
+
+TEST_P(HgImportRequestQueueTest, dequeueUsesAdaptiveBatchSize) {
+  auto queue = HgImportRequestQueue{edenConfig};
+  rawEdenConfig->adaptiveImportBatchSize.setValue(
+      true, ConfigSourceType::UserConfig, true);
+  rawEdenConfig->adaptiveImportBatchSizeStep.setValue(
+      3, ConfigSourceType::UserConfig, true);
+
+  for (int i = 0; i < 10; i++) {
+    insertBlobImportRequest(
+        queue, ImportPriority{ImportPriority::Class::Normal});
+  }
+
+  EXPECT_EQ(1, queue.dequeue().size());
+  queue.recordBatchLatency<Blob>(1, std::chrono::nanoseconds(1));
+  EXPECT_EQ(4, queue.dequeue().size());
+}
+
+TEST_P(HgImportRequestQueueTest, duplicateRaisesPriorityClass) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, uniqueHash()};
+  auto [lowHash, lowRequest] = makeBlobImportRequestWithHash(
+      ImportPriority{ImportPriority::Class::Low}, proxyHash);
+  auto [highHash, highRequest] = makeBlobImportRequestWithHash(
+      ImportPriority{ImportPriority::Class::High}, proxyHash);
+
+  queue.enqueueBlob(std::move(lowRequest));
+  auto normalHash = insertBlobImportRequest(
+      queue, ImportPriority{ImportPriority::Class::Normal});
+  queue.enqueueBlob(std::move(highRequest));
+
+  // The queued request moves ahead of the normal priority one, and is only
+  // returned once.
+  auto first = queue.dequeue().at(0);
+  EXPECT_EQ(lowHash, first->getRequest<HgImportRequest::BlobImport>()->hash);
+  EXPECT_EQ(
+      ImportPriority{ImportPriority::Class::High}.value(),
+      first->getPriority().value());
+
+  auto second = queue.dequeue().at(0);
+  EXPECT_EQ(
+      normalHash, second->getRequest<HgImportRequest::BlobImport>()->hash);
+
+  EXPECT_TRUE(queue.combineAndClearRequestQueues().empty());
+}
+
+TEST_P(HgImportRequestQueueTest, stopWakesUpBlockedDequeue) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  std::vector<std::shared_ptr<HgImportRequest>> dequeued;
+  std::thread consumer{[&] { dequeued = queue.dequeue(); }};
+  queue.stop();
+  consumer.join();
+  EXPECT_TRUE(dequeued.empty());
+
+  insertBlobImportRequest(queue, kDefaultImportPriority);
+  EXPECT_TRUE(queue.dequeue().empty());
+}
+
+TEST_P(HgImportRequestQueueTest, cancelledRequestIsDropped) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  folly::CancellationSource source;
+  auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, uniqueHash()};
+  auto [cancelledHash, cancelledRequest] = makeBlobImportRequestWithHash(
+      ImportPriority{ImportPriority::Class::High}, proxyHash);
+  cancelledRequest->setCancellationToken(source.getToken());
+  auto cancelledFuture = queue.enqueueBlob(std::move(cancelledRequest));
+  auto liveHash = insertBlobImportRequest(
+      queue, ImportPriority{ImportPriority::Class::Normal});
+
+  source.requestCancellation();
+  auto dequeued = queue.dequeue();
+  ASSERT_EQ(1, dequeued.size());
+  EXPECT_EQ(
+      liveHash, dequeued[0]->getRequest<HgImportRequest::BlobImport>()->hash);
+  EXPECT_THROW(std::move(cancelledFuture).get(), folly::OperationCancelled);
+
+  // The dropped request is no longer tracked, so requesting the object again
+  // queues a new import rather than a duplicate.
+  auto [hash, request] = makeBlobImportRequestWithHash(
+      ImportPriority{ImportPriority::Class::Normal}, proxyHash);
+  queue.enqueueBlob(std::move(request));
+  auto requeued = queue.dequeue();
+  ASSERT_EQ(1, requeued.size());
+  auto* requeuedImport = requeued[0]->getRequest<HgImportRequest::BlobImport>();
+  EXPECT_EQ(cancelledHash, requeuedImport->hash);
+  EXPECT_EQ(0, requeuedImport->promises.size());
+}
+
+TEST_P(HgImportRequestQueueTest, liveDuplicateKeepsCancelledRequest) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  folly::CancellationSource source;
+  folly::CancellationSource duplicateSource;
+  auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, uniqueHash()};
+  auto [hash, request] =
+      makeBlobImportRequestWithHash(kDefaultImportPriority, proxyHash);
+  request->setCancellationToken(source.getToken());
+  auto [hash2, duplicate] =
+      makeBlobImportRequestWithHash(kDefaultImportPriority, proxyHash);
+  duplicate->setCancellationToken(duplicateSource.getToken());
+
+  queue.enqueueBlob(std::move(request));
+  queue.enqueueBlob(std::move(duplicate));
+  source.requestCancellation();
+
+  auto dequeued = queue.dequeue();
+  ASSERT_EQ(1, dequeued.size());
+  EXPECT_EQ(hash, dequeued[0]->getRequest<HgImportRequest::BlobImport>()->hash);
+}
+
+TEST_P(HgImportRequestQueueTest, uncancellableDuplicateKeepsRequest) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  folly::CancellationSource source;
+  auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, uniqueHash()};
+  auto [hash, request] =
+      makeBlobImportRequestWithHash(kDefaultImportPriority, proxyHash);
+  request->setCancellationToken(source.getToken());
+  auto [hash2, duplicate] =
+      makeBlobImportRequestWithHash(kDefaultImportPriority, proxyHash);
+
+  queue.enqueueBlob(std::move(request));
+  queue.enqueueBlob(std::move(duplicate));
+  source.requestCancellation();
+
+  auto dequeued = queue.dequeue();
+  ASSERT_EQ(1, dequeued.size());
+  EXPECT_EQ(hash, dequeued[0]->getRequest<HgImportRequest::BlobImport>()->hash);
+}
+
+TEST_P(HgImportRequestQueueTest, requestIsDroppedOnceAllWaitersAreCancelled) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  const auto highPriority = ImportPriority{ImportPriority::Class::High};
+  folly::CancellationSource source;
+  folly::CancellationSource duplicateSource;
+  auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, uniqueHash()};
+  auto [hash, request] =
+      makeBlobImportRequestWithHash(highPriority, proxyHash);
+  request->setCancellationToken(source.getToken());
+  auto [hash2, duplicate] =
+      makeBlobImportRequestWithHash(highPriority, proxyHash);
+  duplicate->setCancellationToken(duplicateSource.getToken());
+
+  auto future = queue.enqueueBlob(std::move(request));
+  auto duplicateFuture = queue.enqueueBlob(std::move(duplicate));
+  auto liveHash = insertBlobImportRequest(queue, kDefaultImportPriority);
+  source.requestCancellation();
+  duplicateSource.requestCancellation();
+
+  auto dequeued = queue.dequeue();
+  ASSERT_EQ(1, dequeued.size());
+  EXPECT_EQ(
+      liveHash, dequeued[0]->getRequest<HgImportRequest::BlobImport>()->hash);
+  EXPECT_THROW(std::move(future).get(), folly::OperationCancelled);
+  EXPECT_THROW(std::move(duplicateFuture).get(), folly::OperationCancelled);
+}
+
+/**
+ * Tests of the scheduling between clients, which only the fair queue does.
+ */
+struct HgImportRequestFairQueueTest : ::testing::Test {
+  std::shared_ptr<ReloadableConfig> edenConfig;
+
+  void SetUp() override {
+    auto rawEdenConfig = EdenConfig::createTestEdenConfig();
+    rawEdenConfig->importBatchSize.setValue(1, ConfigSourceType::Default, true);
+    rawEdenConfig->importQueueFairScheduling.setValue(
+        true, ConfigSourceType::Default, true);
+    edenConfig = std::make_shared<ReloadableConfig>(
+        rawEdenConfig, ConfigReloadBehavior::NoReload);
+  }
+};
+
+ObjectId insertBlobImportRequestFrom(
+    HgImportRequestQueue& queue,
+    ImportPriority priority,
+    std::optional<pid_t> pid,
+    ObjectFetchContext::Cause cause = ObjectFetchContext::Cause::Fs,
+    std::optional<HgProxyHash> proxyHash = std::nullopt) {
+  if (!proxyHash) {
+    proxyHash = HgProxyHash{RelativePath{"some_blob"}, uniqueHash()};
+  }
+  auto hash = proxyHash->sha1();
+  queue.enqueueBlob(HgImportRequest::makeBlobImportRequest(
+      hash, *proxyHash, priority, cause, pid));
+  return hash;
+}
+
+ObjectId dequeueBlob(HgImportRequestQueue& queue) {
+  return queue.dequeue().at(0)->getRequest<HgImportRequest::BlobImport>()->hash;
+}
+
+TEST_F(HgImportRequestFairQueueTest, bulkProcessDoesNotStarveOthers) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  for (int i = 0; i < 100; i++) {
+    insertBlobImportRequestFrom(queue, kDefaultImportPriority, 1);
+  }
+  auto interactive =
+      insertBlobImportRequestFrom(queue, kDefaultImportPriority, 2);
+
+  // The bulk process is served its quantum of 2 batches, then it is the turn
+  // of the other process.
+  EXPECT_NE(interactive, dequeueBlob(queue));
+  EXPECT_NE(interactive, dequeueBlob(queue));
+  EXPECT_EQ(interactive, dequeueBlob(queue));
+}
+
+TEST_F(HgImportRequestFairQueueTest, flowsAreServedByWeight) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  std::set<ObjectId> low;
+  for (int i = 0; i < 100; i++) {
+    low.insert(insertBlobImportRequestFrom(
+        queue, ImportPriority{ImportPriority::Class::Low}, 1));
+  }
+  for (int i = 0; i < 100; i++) {
+    insertBlobImportRequestFrom(
+        queue, ImportPriority{ImportPriority::Class::High}, 2);
+  }
+
+  // Every round serves 1 low priority request and 4 high priority ones.
+  size_t lowCount = 0;
+  for (int i = 0; i < 50; i++) {
+    lowCount += low.count(dequeueBlob(queue));
+  }
+  EXPECT_EQ(10, lowCount);
+}
+
+TEST_F(HgImportRequestFairQueueTest, requestsWithoutPidAreGroupedByCause) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  for (int i = 0; i < 100; i++) {
+    insertBlobImportRequestFrom(
+        queue,
+        kDefaultImportPriority,
+        std::nullopt,
+        ObjectFetchContext::Cause::Prefetch);
+  }
+  auto fs = insertBlobImportRequestFrom(
+      queue,
+      kDefaultImportPriority,
+      std::nullopt,
+      ObjectFetchContext::Cause::Fs);
+
+  dequeueBlob(queue);
+  dequeueBlob(queue);
+  EXPECT_EQ(fs, dequeueBlob(queue));
+}
+
+TEST_F(HgImportRequestFairQueueTest, duplicateIsScheduledInItsOwnFlow) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  for (int i = 10; i > 0; i--) {
+    insertBlobImportRequestFrom(
+        queue, ImportPriority{ImportPriority::Class::Normal, i}, 1);
+  }
+  auto proxyHash = HgProxyHash{RelativePath{"shared_blob"}, uniqueHash()};
+  auto shared = insertBlobImportRequestFrom(
+      queue,
+      ImportPriority{ImportPriority::Class::Normal, 0},
+      1,
+      ObjectFetchContext::Cause::Fs,
+      proxyHash);
+  insertBlobImportRequestFrom(
+      queue,
+      ImportPriority{ImportPriority::Class::Normal, 0},
+      2,
+      ObjectFetchContext::Cause::Fs,
+      proxyHash);
+
+  // The shared request is the least urgent of the first process, but the
+  // second process gets it as soon as its turn comes.
+  EXPECT_NE(shared, dequeueBlob(queue));
+  EXPECT_NE(shared, dequeueBlob(queue));
+  EXPECT_EQ(shared, dequeueBlob(queue));
+
+  // It is not handed out a second time.
+  EXPECT_EQ(8, queue.combineAndClearRequestQueues().size());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    HgImportRequestQueueTest,
+    HgImportRequestQueueTest,
+    ::testing::Values(
+        QueueKind::SingleQueue,
+        QueueKind::Lanes,
+        QueueKind::FairQueue),
+    [](const ::testing::TestParamInfo<QueueKind>& info) -> std::string {
+      switch (info.param) {
+        case QueueKind::SingleQueue:
+          return "SingleQueue";
+        case QueueKind::Lanes:
+          return "Lanes";
+        case QueueKind::FairQueue:
+          return "FairQueue";
+      }
+      return "Unknown";
+    });
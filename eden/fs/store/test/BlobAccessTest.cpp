@@ -173,3 +173,56 @@ TEST_F(BlobAccessTest, drops_oldest_blobs) {
   EXPECT_EQ(2, backingStore->getAccessCount(hash4));
   EXPECT_EQ(1, backingStore->getAccessCount(hash5));
 }
+
+TEST_F(BlobAccessTest, caches_blob_chunks) {
+  auto getChunkBlocking = [&](const ObjectId& hash) {
+    return blobAccess
+        ->getBlobChunk(hash, 0, ObjectFetchContext::getNullContext())
+        .get(0ms);
+  };
+
+  auto chunk1 = getChunkBlocking(hash6);
+  auto chunk2 = getChunkBlocking(hash6);
+
+  EXPECT_EQ("666666", chunk1->asString());
+  EXPECT_EQ("666666", chunk2->asString());
+  EXPECT_EQ(1, backingStore->getAccessCount(hash6));
+  // FakeBackingStore only returns whole blobs, so the blob is cached whole
+  // and its chunks are sliced out of it.
+  EXPECT_NE(nullptr, blobCache->get(hash6).object);
+  EXPECT_EQ(nullptr, blobCache->getChunk(hash6, 0));
+}
+
+TEST_F(BlobAccessTest, slices_chunks_from_cached_blobs) {
+  getBlobBlocking(hash5);
+  auto chunk =
+      blobAccess->getBlobChunk(hash5, 0, ObjectFetchContext::getNullContext())
+          .get(0ms);
+
+  EXPECT_EQ("55555", chunk->asString());
+  EXPECT_EQ(1, backingStore->getAccessCount(hash5));
+}
+
+TEST_F(BlobAccessTest, fetches_whole_blob_once_for_all_chunks) {
+  const auto hash7 =
+      ObjectId::fromHex("0000000000000000000000000000000000000004");
+  std::string contents(2 * BlobCache::kChunkSize + 7, 'x');
+  contents.back() = 'y';
+  backingStore->putBlob(hash7, contents)->setReady();
+
+  // FakeBackingStore only returns whole blobs.
+  auto chunkCache = BlobCache::create(4 * BlobCache::kChunkSize, 0);
+  auto chunkAccess = std::make_shared<BlobAccess>(objectStore, chunkCache);
+  auto getChunkBlocking = [&](uint64_t index) {
+    return chunkAccess
+        ->getBlobChunk(hash7, index, ObjectFetchContext::getNullContext())
+        .get(0ms);
+  };
+
+  EXPECT_EQ(BlobCache::kChunkSize, getChunkBlocking(0)->getSize());
+  EXPECT_EQ(BlobCache::kChunkSize, getChunkBlocking(1)->getSize());
+  EXPECT_EQ("xxxxxxy", getChunkBlocking(2)->asString());
+  EXPECT_EQ(1, backingStore->getAccessCount(hash7));
+  EXPECT_EQ(nullptr, chunkCache->getChunk(hash7, 0))
+      << "Chunks of a blob cached whole must not be copied";
+}
@@ -118,3 +118,20 @@ TEST(BlobCache, does_not_forget_blob_until_last_handle_is_forgotten) {
   result2.interestHandle.reset();
   EXPECT_FALSE(weak.lock());
 }
+
+TEST(BlobCache, chunks_are_keyed_by_blob_and_index) {
+  auto cache = BlobCache::create(10, 0);
+  cache->insertChunk(hash3, 0, *blob3);
+  cache->insertChunk(hash3, 1, *blob4);
+
+  auto chunk0 = cache->getChunk(hash3, 0);
+  auto chunk1 = cache->getChunk(hash3, 1);
+  ASSERT_TRUE(chunk0);
+  ASSERT_TRUE(chunk1);
+  EXPECT_EQ("333", chunk0->asString());
+  EXPECT_EQ("4444", chunk1->asString());
+  EXPECT_FALSE(cache->getChunk(hash3, 2));
+  EXPECT_FALSE(cache->getChunk(hash4, 1));
+  EXPECT_FALSE(cache->get(hash3).object)
+      << "Chunks are not visible as whole blobs";
+}
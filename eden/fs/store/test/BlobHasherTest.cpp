@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/BlobHasher.h"
+#include <folly/portability/GTest.h>
+
+#include "eden/fs/model/Blob.h"
+#include "eden/fs/store/SerializedBlobMetadata.h"
+#include "eden/fs/utils/UnboundedQueueExecutor.h"
+
+using namespace facebook::eden;
+
+namespace {
+
+std::shared_ptr<const Blob> makeBlob(const std::string& contents) {
+  return std::make_shared<Blob>(
+      ObjectId::sha1(contents), folly::StringPiece{contents});
+}
+
+} // namespace
+
+TEST(BlobHasher, computes_sha1_and_blake3_separately) {
+  std::string contents = "hello world";
+  auto blob = makeBlob(contents);
+  auto metadata = BlobHasher::computeMetadata(*blob);
+
+  EXPECT_EQ(11, metadata.size);
+  EXPECT_EQ(Hash20::sha1(contents), metadata.sha1);
+  EXPECT_FALSE(metadata.blake3.has_value());
+  EXPECT_EQ(Hash32::blake3(contents), BlobHasher::computeBlake3(*blob));
+}
+
+TEST(BlobHasher, large_blobs_are_hashed_on_the_executor) {
+  BlobHasher hasher{
+      std::make_shared<UnboundedQueueExecutor>(2, "BlobHashingTest"), 1024};
+
+  auto small = makeBlob(std::string(1023, 'a'));
+  auto large = makeBlob(std::string(1024 * 1024, 'b'));
+  EXPECT_FALSE(hasher.isLarge(*small));
+  EXPECT_TRUE(hasher.isLarge(*large));
+
+  EXPECT_TRUE(hasher.computeMetadataAsync(small).isReady());
+  EXPECT_TRUE(hasher.computeBlake3Async(small).isReady());
+
+  for (const auto& blob : {small, large}) {
+    auto expected = BlobHasher::computeMetadata(*blob);
+    auto metadata = hasher.computeMetadataAsync(blob).get();
+    EXPECT_EQ(expected.size, metadata.size);
+    EXPECT_EQ(expected.sha1, metadata.sha1);
+    EXPECT_EQ(
+        BlobHasher::computeBlake3(*blob),
+        hasher.computeBlake3Async(blob).get());
+  }
+}
+
+TEST(SerializedBlobMetadata, keeps_the_28_byte_record) {
+  auto sha1 = Hash20::sha1(std::string{"contents"});
+  SerializedBlobMetadata serialized{
+      BlobMetadata{sha1, Hash32::blake3(std::string{"contents"}), 8}};
+  EXPECT_EQ(28, SerializedBlobMetadata::SIZE);
+  EXPECT_EQ(SerializedBlobMetadata::SIZE, serialized.slice().size());
+
+  auto parsed = SerializedBlobMetadata::parse(
+      ObjectId::sha1("contents"),
+      StoreResult{folly::StringPiece{serialized.slice()}.str()});
+  EXPECT_EQ(8, parsed->size);
+  EXPECT_EQ(sha1, parsed->sha1);
+  EXPECT_FALSE(parsed->blake3.has_value());
+}
+
+TEST(SerializedBlobMetadata, blake3_lives_under_its_own_key) {
+  auto id = ObjectId::sha1("contents");
+  auto key = SerializedBlobMetadata::blake3Key(id);
+  EXPECT_NE(folly::StringPiece{id.getBytes()}, folly::StringPiece{key});
+  EXPECT_TRUE(folly::StringPiece{key}.startsWith(
+      folly::StringPiece{id.getBytes()}));
+
+  auto blake3 = Hash32::blake3(std::string{"contents"});
+  auto parsed = SerializedBlobMetadata::parseBlake3(
+      id, StoreResult{folly::StringPiece{blake3.getBytes()}.str()});
+  EXPECT_EQ(blake3, parsed);
+
+  EXPECT_THROW(
+      SerializedBlobMetadata::parseBlake3(id, StoreResult{std::string(28, 0)}),
+      std::invalid_argument);
+}
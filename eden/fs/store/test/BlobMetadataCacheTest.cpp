@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/BlobMetadataCache.h"
+#include <folly/portability/GTest.h>
+
+using namespace facebook::eden;
+
+namespace {
+
+ObjectId makeId(size_t i) {
+  return ObjectId::sha1(fmt::to_string(i));
+}
+
+BlobMetadata makeMetadata(size_t i) {
+  return BlobMetadata{Hash20::sha1(fmt::to_string(i)), i};
+}
+
+} // namespace
+
+TEST(BlobMetadataCache, returns_inserted_metadata) {
+  BlobMetadataCache cache{100, 4};
+  cache.insert(makeId(1), makeMetadata(1));
+
+  auto metadata = cache.get(makeId(1));
+  ASSERT_TRUE(metadata);
+  EXPECT_EQ(1, metadata->size);
+  EXPECT_EQ(Hash20::sha1(fmt::to_string(1)), metadata->sha1);
+  EXPECT_FALSE(cache.get(makeId(2)));
+  EXPECT_TRUE(cache.contains(makeId(1)));
+  EXPECT_FALSE(cache.contains(makeId(2)));
+}
+
+TEST(BlobMetadataCache, insert_overwrites_existing_entry) {
+  BlobMetadataCache cache{100, 1};
+  cache.insert(makeId(1), makeMetadata(1));
+  EXPECT_EQ(0, cache.insert(makeId(1), makeMetadata(2)));
+
+  EXPECT_EQ(2, cache.get(makeId(1))->size);
+  EXPECT_EQ(1, cache.getStats().entryCount);
+}
+
+TEST(BlobMetadataCache, never_exceeds_capacity) {
+  BlobMetadataCache cache{64, 4};
+  size_t evicted = 0;
+  for (size_t i = 0; i < 1000; ++i) {
+    evicted += cache.insert(makeId(i), makeMetadata(i));
+  }
+
+  auto stats = cache.getStats();
+  EXPECT_EQ(64, stats.capacity);
+  EXPECT_GE(64, stats.entryCount);
+  EXPECT_EQ(1000, stats.entryCount + evicted);
+}
+
+TEST(BlobMetadataCache, referenced_entries_survive_eviction) {
+  BlobMetadataCache cache{4, 1};
+  for (size_t i = 0; i < 4; ++i) {
+    cache.insert(makeId(i), makeMetadata(i));
+  }
+
+  // Entry 0 was read, so the clock hand gives it a second chance and evicts
+  // entry 1 instead.
+  EXPECT_TRUE(cache.get(makeId(0)));
+  EXPECT_EQ(1, cache.insert(makeId(4), makeMetadata(4)));
+
+  EXPECT_TRUE(cache.contains(makeId(0)));
+  EXPECT_FALSE(cache.contains(makeId(1)));
+  EXPECT_TRUE(cache.contains(makeId(4)));
+}
+
+TEST(BlobMetadataCache, clear_evicts_everything) {
+  BlobMetadataCache cache{100, 4};
+  for (size_t i = 0; i < 10; ++i) {
+    cache.insert(makeId(i), makeMetadata(i));
+  }
+  cache.clear();
+
+  EXPECT_EQ(0, cache.getStats().entryCount);
+  EXPECT_FALSE(cache.get(makeId(0)));
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/DiskBlobCache.h"
+
+#include <boost/filesystem.hpp>
+#include <folly/executors/ManualExecutor.h>
+#include <folly/portability/GTest.h>
+
+#include "eden/fs/model/Blob.h"
+#include "eden/fs/testharness/TempFile.h"
+#include "eden/fs/utils/FileUtils.h"
+
+using namespace facebook::eden;
+
+namespace {
+
+constexpr uint64_t kHeaderSize = 16;
+
+Blob makeBlob(folly::StringPiece hex, size_t size, char fill = 'x') {
+  return Blob{ObjectId::fromHex(hex), std::string(size, fill)};
+}
+
+class DiskBlobCacheTest : public ::testing::Test {
+ protected:
+  AbsolutePath root() const {
+    return canonicalPath(tempDir_.path().string());
+  }
+
+  std::shared_ptr<DiskBlobCache> makeCache(
+      uint64_t maximumBytes,
+      uint64_t minimumBlobSize = 10,
+      std::shared_ptr<folly::Executor> writeExecutor = nullptr,
+      uint64_t maximumPendingWriteBytes =
+          std::numeric_limits<uint64_t>::max()) {
+    return std::make_shared<DiskBlobCache>(
+        root(),
+        maximumBytes,
+        minimumBlobSize,
+        std::move(writeExecutor),
+        maximumPendingWriteBytes);
+  }
+
+  folly::test::TemporaryDirectory tempDir_ = makeTempDir();
+};
+
+} // namespace
+
+TEST_F(DiskBlobCacheTest, inserted_blob_is_readable) {
+  auto cache = makeCache(1000);
+  auto blob = makeBlob("00112233", 100, 'a');
+
+  EXPECT_EQ(nullptr, cache->get(blob.getHash()));
+  EXPECT_EQ(0, cache->insert(blob));
+  EXPECT_TRUE(cache->contains(blob.getHash()));
+
+  auto result = cache->get(blob.getHash());
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(blob.asString(), result->asString());
+  EXPECT_EQ(100, result->getSize());
+
+  auto stats = cache->getStats();
+  EXPECT_EQ(1, stats.entryCount);
+  EXPECT_EQ(100 + kHeaderSize, stats.totalBytes);
+}
+
+TEST_F(DiskBlobCacheTest, small_blobs_are_not_cached) {
+  auto cache = makeCache(1000, 10);
+  auto blob = makeBlob("00112233", 9);
+  EXPECT_EQ(0, cache->insert(blob));
+  EXPECT_FALSE(cache->contains(blob.getHash()));
+  EXPECT_EQ(nullptr, cache->get(blob.getHash()));
+}
+
+TEST_F(DiskBlobCacheTest, evicts_least_recently_used_blobs) {
+  auto cache = makeCache(3 * (100 + kHeaderSize));
+  auto blob1 = makeBlob("0101", 100);
+  auto blob2 = makeBlob("0202", 100);
+  auto blob3 = makeBlob("0303", 100);
+  auto blob4 = makeBlob("0404", 100);
+
+  EXPECT_EQ(0, cache->insert(blob1));
+  EXPECT_EQ(0, cache->insert(blob2));
+  EXPECT_EQ(0, cache->insert(blob3));
+
+  // Touch blob1 so that blob2 is the least recently used.
+  EXPECT_NE(nullptr, cache->get(blob1.getHash()));
+
+  EXPECT_EQ(1, cache->insert(blob4));
+  EXPECT_TRUE(cache->contains(blob1.getHash()));
+  EXPECT_FALSE(cache->contains(blob2.getHash()));
+  EXPECT_TRUE(cache->contains(blob3.getHash()));
+  EXPECT_TRUE(cache->contains(blob4.getHash()));
+  EXPECT_FALSE(
+      boost::filesystem::exists((root() + "02"_pc + "02"_pc).asString()));
+}
+
+TEST_F(DiskBlobCacheTest, blobs_survive_restart) {
+  auto blob = makeBlob("00112233", 100, 'b');
+  makeCache(1000)->insert(blob);
+
+  auto cache = makeCache(1000);
+  EXPECT_EQ(1, cache->getStats().entryCount);
+  auto result = cache->get(blob.getHash());
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(blob.asString(), result->asString());
+}
+
+TEST_F(DiskBlobCacheTest, restart_removes_stray_files_and_shrinks_to_budget) {
+  {
+    auto cache = makeCache(1000);
+    cache->insert(makeBlob("0101", 100));
+    cache->insert(makeBlob("0202", 100));
+  }
+  auto stray = root() + "00"_pc + "112233.tmpXYZ"_pc;
+  writeFile(stray, folly::ByteRange{folly::StringPiece{"partial"}}).value();
+
+  auto cache = makeCache(100 + kHeaderSize);
+  EXPECT_EQ(1, cache->getStats().entryCount);
+  EXPECT_FALSE(boost::filesystem::exists(stray.asString()));
+}
+
+TEST_F(DiskBlobCacheTest, corrupted_file_is_a_miss) {
+  auto cache = makeCache(1000);
+  auto blob = makeBlob("00112233", 100);
+  cache->insert(blob);
+
+  writeFile(
+      root() + "00"_pc + "112233"_pc,
+      folly::ByteRange{folly::StringPiece{"garbage"}})
+      .value();
+
+  EXPECT_EQ(nullptr, cache->get(blob.getHash()));
+  EXPECT_FALSE(cache->contains(blob.getHash()));
+  EXPECT_EQ(0, cache->getStats().totalBytes);
+}
+
+TEST_F(DiskBlobCacheTest, clear_removes_everything) {
+  auto cache = makeCache(1000);
+  auto blob = makeBlob("00112233", 100);
+  cache->insert(blob);
+  cache->clear();
+
+  EXPECT_FALSE(cache->contains(blob.getHash()));
+  EXPECT_EQ(0, cache->getStats().entryCount);
+  EXPECT_EQ(0, makeCache(1000)->getStats().entryCount);
+}
+
+TEST_F(DiskBlobCacheTest, background_insert_writes_on_executor_once) {
+  auto executor = std::make_shared<folly::ManualExecutor>();
+  auto cache = makeCache(1000, 10, executor);
+  auto blob = std::make_shared<const Blob>(makeBlob("00112233", 100));
+
+  size_t callbacks = 0;
+  auto onInserted = [&](size_t evicted) {
+    EXPECT_EQ(0, evicted);
+    ++callbacks;
+  };
+  cache->insertInBackground(blob, onInserted);
+  cache->insertInBackground(blob, onInserted);
+  EXPECT_FALSE(cache->contains(blob->getHash()));
+
+  executor->drain();
+  EXPECT_EQ(1, callbacks);
+  EXPECT_TRUE(cache->contains(blob->getHash()));
+  auto result = cache->get(blob->getHash());
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(blob->asString(), result->asString());
+}
+
+TEST_F(DiskBlobCacheTest, background_insert_drops_writes_over_budget) {
+  auto executor = std::make_shared<folly::ManualExecutor>();
+  auto cache = makeCache(1000, 10, executor, 150);
+  auto blob1 = std::make_shared<const Blob>(makeBlob("0101", 100));
+  auto blob2 = std::make_shared<const Blob>(makeBlob("0202", 100));
+
+  size_t callbacks = 0;
+  auto onInserted = [&](size_t) { ++callbacks; };
+  cache->insertInBackground(blob1, onInserted);
+  cache->insertInBackground(blob2, onInserted);
+  executor->drain();
+  EXPECT_EQ(1, callbacks);
+  EXPECT_TRUE(cache->contains(blob1->getHash()));
+  EXPECT_FALSE(cache->contains(blob2->getHash()));
+
+  // Writing blob1 made room for blob2 again.
+  cache->insertInBackground(blob2, onInserted);
+  executor->drain();
+  EXPECT_EQ(2, callbacks);
+  EXPECT_TRUE(cache->contains(blob2->getHash()));
+}
+
+TEST_F(DiskBlobCacheTest, reinserting_evicted_blob_keeps_its_file) {
+  auto cache = makeCache(100 + kHeaderSize);
+  auto blob1 = makeBlob("0101", 100);
+  auto blob2 = makeBlob("0202", 100);
+
+  EXPECT_EQ(0, cache->insert(blob1));
+  EXPECT_EQ(1, cache->insert(blob2));
+  EXPECT_EQ(1, cache->insert(blob1));
+
+  auto result = cache->get(blob1.getHash());
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(blob1.asString(), result->asString());
+  EXPECT_FALSE(
+      boost::filesystem::exists((root() + "02"_pc + "02"_pc).asString()));
+}
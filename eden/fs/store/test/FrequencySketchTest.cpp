@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/FrequencySketch.h"
+#include <gtest/gtest.h>
+
+using namespace facebook::eden;
+
+TEST(FrequencySketch, counts_increments) {
+  FrequencySketch sketch;
+  sketch.ensureCapacity(100);
+
+  EXPECT_EQ(0, sketch.frequency(1));
+  sketch.increment(1);
+  sketch.increment(1);
+  sketch.increment(1);
+  sketch.increment(2);
+
+  EXPECT_EQ(3, sketch.frequency(1));
+  EXPECT_EQ(1, sketch.frequency(2));
+  EXPECT_EQ(0, sketch.frequency(3));
+}
+
+TEST(FrequencySketch, saturates) {
+  FrequencySketch sketch;
+  for (int i = 0; i < 100; ++i) {
+    sketch.increment(42);
+  }
+  EXPECT_EQ(FrequencySketch::kMaximumFrequency, sketch.frequency(42));
+}
+
+TEST(FrequencySketch, ages_counts) {
+  FrequencySketch sketch;
+  sketch.ensureCapacity(16);
+  auto width = sketch.getWidth();
+
+  for (int i = 0; i < 8; ++i) {
+    sketch.increment(1);
+  }
+  EXPECT_EQ(8, sketch.frequency(1));
+
+  // Other keys are accessed until a reset halves every counter. Collisions
+  // can only raise the estimate of key 1 before that.
+  size_t increments = 0;
+  while (sketch.frequency(1) >= 8) {
+    sketch.increment(1000 + increments % 20);
+    ASSERT_GT(10 * width, ++increments);
+  }
+  EXPECT_LE(4, sketch.frequency(1));
+}
+
+TEST(FrequencySketch, growing_keeps_counts) {
+  FrequencySketch sketch;
+  sketch.ensureCapacity(16);
+  for (uint64_t key = 0; key < 16; ++key) {
+    for (uint64_t i = 0; i <= key % 4; ++i) {
+      sketch.increment(key);
+    }
+  }
+
+  auto width = sketch.getWidth();
+  sketch.ensureCapacity(1024);
+  EXPECT_LT(width, sketch.getWidth());
+  for (uint64_t key = 0; key < 16; ++key) {
+    EXPECT_LE(key % 4 + 1, sketch.frequency(key));
+  }
+
+  // Shrinking is a no-op.
+  width = sketch.getWidth();
+  sketch.ensureCapacity(16);
+  EXPECT_EQ(width, sketch.getWidth());
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/GroupCommitLocalStore.h"
+
+#include <fmt/format.h>
+#include <folly/portability/GTest.h>
+#include <thread>
+
+#include "eden/fs/store/MemoryLocalStore.h"
+#include "eden/fs/store/StoreResult.h"
+
+using namespace facebook::eden;
+using namespace folly::string_piece_literals;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct GroupCommitLocalStoreTest : ::testing::Test {
+  /**
+   * Batches are only committed on flush() unless a test lowers batchBytes.
+   */
+  void makeStore(size_t batchBytes = 1024 * 1024 * 1024) {
+    store = std::make_shared<GroupCommitLocalStore>(
+        inner, batchBytes, 1h, makeRefPtr<EdenStats>());
+    store->open();
+  }
+
+  void SetUp() override {
+    makeStore();
+  }
+
+  std::shared_ptr<MemoryLocalStore> inner =
+      std::make_shared<MemoryLocalStore>();
+  std::shared_ptr<GroupCommitLocalStore> store;
+};
+
+TEST_F(GroupCommitLocalStoreTest, reads_see_queued_writes) {
+  store->put(KeySpace::BlobFamily, "key"_sp, "value"_sp);
+
+  EXPECT_FALSE(inner->hasKey(KeySpace::BlobFamily, "key"_sp));
+  EXPECT_TRUE(store->hasKey(KeySpace::BlobFamily, "key"_sp));
+  EXPECT_EQ("value", store->get(KeySpace::BlobFamily, "key"_sp).piece());
+  EXPECT_FALSE(store->hasKey(KeySpace::TreeFamily, "key"_sp));
+
+  store->flush();
+  EXPECT_EQ("value", inner->get(KeySpace::BlobFamily, "key"_sp).piece());
+  EXPECT_EQ("value", store->get(KeySpace::BlobFamily, "key"_sp).piece());
+}
+
+TEST_F(GroupCommitLocalStoreTest, newer_write_wins) {
+  store->put(KeySpace::BlobFamily, "key"_sp, "old"_sp);
+  store->put(KeySpace::BlobFamily, "key"_sp, "new"_sp);
+  EXPECT_EQ("new", store->get(KeySpace::BlobFamily, "key"_sp).piece());
+
+  store->flush();
+  EXPECT_EQ("new", inner->get(KeySpace::BlobFamily, "key"_sp).piece());
+}
+
+TEST_F(GroupCommitLocalStoreTest, write_batch_is_queued_on_flush) {
+  auto batch = store->beginWrite();
+  batch->put(KeySpace::TreeFamily, "tree"_sp, "contents"_sp);
+  batch->put(
+      KeySpace::BlobFamily,
+      "blob"_sp,
+      std::vector<folly::ByteRange>{"con"_sp, "tents"_sp});
+  EXPECT_FALSE(store->hasKey(KeySpace::TreeFamily, "tree"_sp));
+
+  batch->flush();
+  EXPECT_EQ("contents", store->get(KeySpace::TreeFamily, "tree"_sp).piece());
+  EXPECT_EQ("contents", store->get(KeySpace::BlobFamily, "blob"_sp).piece());
+
+  store->flush();
+  EXPECT_TRUE(inner->hasKey(KeySpace::TreeFamily, "tree"_sp));
+  EXPECT_TRUE(inner->hasKey(KeySpace::BlobFamily, "blob"_sp));
+}
+
+TEST_F(GroupCommitLocalStoreTest, get_batch_merges_queued_and_stored) {
+  inner->put(KeySpace::BlobFamily, "stored"_sp, "1"_sp);
+  store->put(KeySpace::BlobFamily, "queued"_sp, "2"_sp);
+
+  auto results =
+      store
+          ->getBatch(
+              KeySpace::BlobFamily,
+              std::vector<folly::ByteRange>{
+                  "queued"_sp, "missing"_sp, "stored"_sp})
+          .get();
+  ASSERT_EQ(3, results.size());
+  EXPECT_EQ("2", results[0].piece());
+  EXPECT_FALSE(results[1].isValid());
+  EXPECT_EQ("1", results[2].piece());
+}
+
+TEST_F(GroupCommitLocalStoreTest, full_batch_is_committed_without_flush) {
+  makeStore(/*batchBytes=*/64);
+
+  auto value = std::string(100, 'a');
+  store->put(KeySpace::BlobFamily, "key"_sp, folly::StringPiece{value});
+  while (!inner->hasKey(KeySpace::BlobFamily, "key"_sp)) {
+    std::this_thread::sleep_for(1ms);
+  }
+}
+
+TEST_F(GroupCommitLocalStoreTest, clear_key_space_drops_queued_writes) {
+  store->put(KeySpace::BlobFamily, "blob"_sp, "value"_sp);
+  store->put(KeySpace::TreeFamily, "tree"_sp, "value"_sp);
+
+  store->clearKeySpace(KeySpace::BlobFamily);
+  EXPECT_FALSE(store->hasKey(KeySpace::BlobFamily, "blob"_sp));
+  EXPECT_TRUE(store->hasKey(KeySpace::TreeFamily, "tree"_sp));
+
+  store->flush();
+  EXPECT_FALSE(inner->hasKey(KeySpace::BlobFamily, "blob"_sp));
+  EXPECT_TRUE(inner->hasKey(KeySpace::TreeFamily, "tree"_sp));
+}
+
+TEST_F(GroupCommitLocalStoreTest, close_commits_queued_writes) {
+  store->put(KeySpace::BlobFamily, "key"_sp, "value"_sp);
+  store->close();
+  EXPECT_TRUE(inner->hasKey(KeySpace::BlobFamily, "key"_sp));
+}
+
+TEST_F(GroupCommitLocalStoreTest, concurrent_writes_are_all_committed) {
+  makeStore(/*batchBytes=*/4096);
+
+  constexpr int kThreads = 8;
+  constexpr int kWrites = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < kWrites; ++i) {
+        auto key = fmt::format("{}-{}", t, i);
+        store->put(KeySpace::BlobFamily, folly::StringPiece{key}, "v"_sp);
+        EXPECT_TRUE(
+            store->hasKey(KeySpace::BlobFamily, folly::StringPiece{key}));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  store->flush();
+  for (int t = 0; t < kThreads; ++t) {
+    for (int i = 0; i < kWrites; ++i) {
+      auto key = fmt::format("{}-{}", t, i);
+      EXPECT_TRUE(inner->hasKey(KeySpace::BlobFamily, folly::StringPiece{key}));
+    }
+  }
+}
+
+} // namespace
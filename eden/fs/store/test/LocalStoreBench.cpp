@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/common/utils/benchharness/Bench.h"
+#include "eden/fs/store/RocksDbLocalStore.h"
+#include "eden/fs/store/SqliteLocalStore.h"
+#include "eden/fs/store/StoreResult.h"
+#include "eden/fs/telemetry/NullStructuredLogger.h"
+#include "eden/fs/testharness/TempFile.h"
+#include "eden/fs/utils/FaultInjector.h"
+
+/**
+ * Compares the read performance of the on-disk LocalStore implementations.
+ * Every benchmark takes the backend as its first argument: 0 for SQLite and 1
+ * for RocksDB.
+ */
+
+namespace {
+using namespace facebook::eden;
+using namespace folly::string_piece_literals;
+
+constexpr size_t kNumKeys = 100'000;
+constexpr size_t kValueSize = 256;
+
+struct BenchStore {
+  folly::test::TemporaryDirectory tempDir = makeTempDir();
+  FaultInjector faultInjector{false};
+  std::unique_ptr<LocalStore> store;
+  std::vector<std::string> keys;
+};
+
+std::unique_ptr<LocalStore> openStore(
+    int64_t backend,
+    AbsolutePathPiece path,
+    FaultInjector* faultInjector) {
+  std::unique_ptr<LocalStore> store;
+  if (backend == 0) {
+    store = std::make_unique<SqliteLocalStore>(path + "sqlite"_pc);
+  } else {
+    store = std::make_unique<RocksDbLocalStore>(
+        path, std::make_shared<NullStructuredLogger>(), faultInjector);
+  }
+  store->open();
+  return store;
+}
+
+std::unique_ptr<BenchStore> makeBenchStore(int64_t backend) {
+  auto bench = std::make_unique<BenchStore>();
+  auto path = canonicalPath(bench->tempDir.path().string());
+  bench->store = openStore(backend, path, &bench->faultInjector);
+
+  bench->keys.reserve(kNumKeys);
+  auto batch = bench->store->beginWrite();
+  std::string value(kValueSize, 'x');
+  for (size_t i = 0; i < kNumKeys; ++i) {
+    bench->keys.push_back(fmt::format("{:020}", i));
+    batch->put(
+        KeySpace::BlobFamily,
+        folly::StringPiece{bench->keys.back()},
+        folly::StringPiece{value});
+  }
+  batch->flush();
+
+  // Reopen the database to exercise the read-from-disk path.
+  bench->store->close();
+  bench->store.reset();
+  bench->store = openStore(backend, path, &bench->faultInjector);
+  return bench;
+}
+
+void get(benchmark::State& state) {
+  static std::unique_ptr<BenchStore> bench;
+  if (state.thread_index() == 0) {
+    bench = makeBenchStore(state.range(0));
+  }
+
+  // Other threads only see bench once they have entered the loop.
+  size_t i = state.thread_index() * 7919;
+  for (auto _ : state) {
+    const auto& keys = bench->keys;
+    benchmark::DoNotOptimize(bench->store->get(
+        KeySpace::BlobFamily, folly::StringPiece{keys[i % keys.size()]}));
+    ++i;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    bench.reset();
+  }
+}
+
+void getBatch(benchmark::State& state) {
+  static std::unique_ptr<BenchStore> bench;
+  if (state.thread_index() == 0) {
+    bench = makeBenchStore(state.range(0));
+  }
+
+  auto batchSize = static_cast<size_t>(state.range(1));
+  size_t i = state.thread_index() * 7919;
+  std::vector<folly::ByteRange> batch;
+  batch.reserve(batchSize);
+  for (auto _ : state) {
+    const auto& keys = bench->keys;
+    batch.clear();
+    for (size_t j = 0; j < batchSize; ++j) {
+      batch.push_back(folly::StringPiece{keys[i++ % keys.size()]});
+    }
+    benchmark::DoNotOptimize(
+        bench->store->getBatch(KeySpace::BlobFamily, batch).get());
+  }
+
+  state.SetItemsProcessed(state.iterations() * batchSize);
+  if (state.thread_index() == 0) {
+    bench.reset();
+  }
+}
+
+BENCHMARK(get)
+    ->ArgName("rocksdb")
+    ->Arg(0)
+    ->Arg(1)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16);
+
+BENCHMARK(getBatch)
+    ->ArgNames({"rocksdb", "batch"})
+    ->ArgsProduct({{0, 1}, {16, 256, 2048}})
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16);
+
+} // namespace
+
+EDEN_BENCHMARK_MAIN();
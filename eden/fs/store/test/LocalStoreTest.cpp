@@ -6,6 +6,8 @@
  */
 
 #include "eden/fs/store/test/LocalStoreTest.h"
+#include <fmt/format.h>
+#include "eden/fs/store/GroupCommitLocalStore.h"
 #include "eden/fs/store/MemoryLocalStore.h"
 #include "eden/fs/store/SqliteLocalStore.h"
 
@@ -26,6 +28,13 @@ LocalStoreImplResult makeSqliteLocalStore(FaultInjector*) {
   return {std::move(tempDir), std::move(store)};
 }
 
+LocalStoreImplResult makeGroupCommitLocalStore(FaultInjector* faultInjector) {
+  auto [tempDir, sqliteStore] = makeSqliteLocalStore(faultInjector);
+  auto store = std::make_shared<GroupCommitLocalStore>(
+      std::move(sqliteStore), 1024 * 1024, 1ms, makeRefPtr<EdenStats>());
+  return {std::move(tempDir), std::move(store)};
+}
+
 TEST_P(OpenCloseLocalStoreTest, closeBeforeOpen) {
   auto tempDir = makeTempDir();
   store_->close();
@@ -248,6 +257,63 @@ TEST_P(LocalStoreTest, testClearKeySpace) {
   EXPECT_TRUE(store_->hasKey(KeySpace::TreeFamily, "tree"_sp));
 }
 
+TEST_P(LocalStoreTest, testGetBatch) {
+  // More keys than a single SQLite query looks up.
+  constexpr size_t kKeys = 1200;
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < kKeys; ++i) {
+    keys.push_back(fmt::format("key{}", i));
+  }
+
+  auto batch = store_->beginWrite();
+  for (size_t i = 0; i < kKeys; i += 2) {
+    batch->put(
+        KeySpace::BlobFamily,
+        StringPiece{keys[i]},
+        StringPiece{fmt::format("value{}", i)});
+  }
+  batch->flush();
+
+  std::vector<folly::ByteRange> lookups;
+  for (const auto& key : keys) {
+    lookups.push_back(StringPiece{key});
+  }
+  // Keys looked up twice get the same result.
+  lookups.push_back(StringPiece{keys[0]});
+  lookups.push_back(StringPiece{keys[1]});
+
+  auto results = store_->getBatch(KeySpace::BlobFamily, lookups).get();
+  ASSERT_EQ(kKeys + 2, results.size());
+  for (size_t i = 0; i < kKeys; ++i) {
+    if (i % 2 == 0) {
+      EXPECT_EQ(fmt::format("value{}", i), results[i].piece());
+    } else {
+      EXPECT_FALSE(results[i].isValid());
+    }
+  }
+  EXPECT_EQ("value0", results[kKeys].piece());
+  EXPECT_FALSE(results[kKeys + 1].isValid());
+}
+
+TEST_P(LocalStoreTest, testConcurrentReadsAndWrites) {
+  constexpr int kThreads = 8;
+  constexpr int kKeys = 200;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < kKeys; ++i) {
+        auto key = fmt::format("{}-{}", t, i);
+        store_->put(KeySpace::BlobFamily, StringPiece{key}, StringPiece{key});
+        auto result = store_->get(KeySpace::BlobFamily, StringPiece{key});
+        EXPECT_EQ(key, result.piece());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wdeprecated-declarations"
 INSTANTIATE_TEST_CASE_P(
@@ -269,6 +335,16 @@ INSTANTIATE_TEST_CASE_P(
     Sqlite,
     OpenCloseLocalStoreTest,
     ::testing::Values(makeSqliteLocalStore));
+
+INSTANTIATE_TEST_CASE_P(
+    GroupCommit,
+    LocalStoreTest,
+    ::testing::Values(makeGroupCommitLocalStore));
+
+INSTANTIATE_TEST_CASE_P(
+    GroupCommit,
+    OpenCloseLocalStoreTest,
+    ::testing::Values(makeGroupCommitLocalStore));
 #pragma clang diagnostic pop
 
 } // namespace
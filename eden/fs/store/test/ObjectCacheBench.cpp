@@ -5,9 +5,30 @@
  * GNU General Public License version 2.
  */
 
+#include <folly/Random.h>
+#include <folly/portability/GFlags.h>
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
 #include "eden/common/utils/benchharness/Bench.h"
 #include "eden/fs/store/ObjectCache.h"
 
+DEFINE_string(
+    replay_trace,
+    "",
+    "Access trace replayed by the replay benchmark: one object per line, as "
+    "an arbitrary key optionally followed by its size in bytes. When empty, a "
+    "synthetic trace of a working set interleaved with scans is used.");
+DEFINE_uint64(
+    replay_cache_size,
+    10 * 1024 * 1024,
+    "Size in bytes of the cache the replay benchmark feeds the trace through");
+
 namespace {
 
 using namespace facebook::eden;
@@ -28,6 +49,24 @@ class Object {
   ObjectId hash_;
 };
 
+class SizedObject {
+ public:
+  SizedObject(ObjectId hash, size_t size)
+      : hash_{std::move(hash)}, size_{size} {}
+
+  const ObjectId& getHash() const {
+    return hash_;
+  }
+
+  size_t getSizeBytes() const {
+    return size_;
+  }
+
+ private:
+  ObjectId hash_;
+  size_t size_;
+};
+
 using SimpleObjectCache = ObjectCache<Object, ObjectCacheFlavor::Simple>;
 
 void getSimple(benchmark::State& st) {
@@ -78,6 +117,197 @@ void insertSimple(benchmark::State& st) {
 }
 BENCHMARK(insertSimple);
 
+constexpr size_t kConcurrentNumObjects = 100000;
+
+const std::vector<ObjectId>& getConcurrentIds() {
+  static const auto ids = [] {
+    std::vector<ObjectId> result;
+    result.reserve(kConcurrentNumObjects);
+    for (size_t i = 0; i < kConcurrentNumObjects; ++i) {
+      result.push_back(ObjectId::sha1(fmt::to_string(i)));
+    }
+    return result;
+  }();
+  return ids;
+}
+
+/**
+ * Returns a cache with every id from getConcurrentIds() inserted, shared by
+ * all the benchmark threads that use the same shard count.
+ */
+std::shared_ptr<SimpleObjectCache> getPopulatedCache(size_t numShards) {
+  static std::mutex mutex;
+  static std::unordered_map<size_t, std::shared_ptr<SimpleObjectCache>> caches;
+
+  std::lock_guard<std::mutex> lock{mutex};
+  auto& cache = caches[numShards];
+  if (!cache) {
+    cache = SimpleObjectCache::create(40 * 1024 * 1024, 1, numShards);
+    for (const auto& id : getConcurrentIds()) {
+      cache->insertSimple(std::make_shared<Object>(id));
+    }
+  }
+  return cache;
+}
+
+/**
+ * Every thread looks up objects that are all present in the cache, starting
+ * at a different offset so that threads are not in lock-step.
+ */
+void concurrentGetSimpleHit(benchmark::State& st) {
+  auto cache = getPopulatedCache(st.range(0));
+  const auto& ids = getConcurrentIds();
+
+  size_t i = folly::Random::rand32(kConcurrentNumObjects);
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(cache->getSimple(ids[i]));
+
+    if (++i == kConcurrentNumObjects) {
+      i = 0;
+    }
+  }
+}
+
+/**
+ * Every thread looks up objects that were never inserted.
+ */
+void concurrentGetSimpleMiss(benchmark::State& st) {
+  auto cache = getPopulatedCache(st.range(0));
+
+  std::vector<ObjectId> missingIds;
+  missingIds.reserve(kConcurrentNumObjects);
+  for (size_t i = 0; i < kConcurrentNumObjects; ++i) {
+    missingIds.push_back(ObjectId::sha1(fmt::format("missing-{}", i)));
+  }
+
+  size_t i = 0;
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(cache->getSimple(missingIds[i]));
+
+    if (++i == kConcurrentNumObjects) {
+      i = 0;
+    }
+  }
+}
+
+BENCHMARK(concurrentGetSimpleHit)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(64)
+    ->Threads(1)
+    ->Threads(8)
+    ->Threads(32)
+    ->Threads(64)
+    ->UseRealTime();
+
+BENCHMARK(concurrentGetSimpleMiss)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(64)
+    ->Threads(1)
+    ->Threads(8)
+    ->Threads(32)
+    ->Threads(64)
+    ->UseRealTime();
+
+struct TraceAccess {
+  ObjectId id;
+  size_t size;
+};
+
+std::vector<TraceAccess> loadTrace(const std::string& path) {
+  std::vector<TraceAccess> trace;
+  std::ifstream file{path};
+  if (!file) {
+    throw std::runtime_error(fmt::format("cannot open trace {}", path));
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream fields{line};
+    std::string key;
+    size_t size = 4096;
+    if (fields >> key) {
+      fields >> size;
+      trace.push_back(TraceAccess{ObjectId::sha1(key), size});
+    }
+  }
+  return trace;
+}
+
+/**
+ * A working set of 2000 objects read with a skewed distribution, as editors
+ * and builds do, interrupted every 50000 reads by a scan of 20000 objects
+ * that are never read again, as a recursive grep would.
+ */
+std::vector<TraceAccess> makeSyntheticTrace() {
+  constexpr size_t kWorkingSetSize = 2000;
+  constexpr size_t kScanSize = 20000;
+  constexpr size_t kReadsBetweenScans = 50000;
+  constexpr size_t kRounds = 10;
+  constexpr size_t kObjectSize = 4096;
+
+  std::mt19937_64 rng{0};
+  std::uniform_real_distribution<double> uniform;
+  std::vector<TraceAccess> trace;
+  size_t scanned = 0;
+  for (size_t round = 0; round < kRounds; ++round) {
+    for (size_t i = 0; i < kReadsBetweenScans; ++i) {
+      auto u = uniform(rng);
+      auto index = static_cast<size_t>(u * u * u * kWorkingSetSize);
+      trace.push_back(TraceAccess{
+          ObjectId::sha1(fmt::format("hot-{}", index)), kObjectSize});
+    }
+    for (size_t i = 0; i < kScanSize; ++i) {
+      trace.push_back(TraceAccess{
+          ObjectId::sha1(fmt::format("scan-{}", scanned++)), kObjectSize});
+    }
+  }
+  return trace;
+}
+
+const std::vector<TraceAccess>& getReplayTrace() {
+  static const auto trace = FLAGS_replay_trace.empty()
+      ? makeSyntheticTrace()
+      : loadTrace(FLAGS_replay_trace);
+  return trace;
+}
+
+/**
+ * Replays an access trace through a cache using the policy st.range(0),
+ * inserting objects on misses, and reports the hit rate.
+ */
+void replayTrace(benchmark::State& st) {
+  auto policy = static_cast<ObjectCachePolicy>(st.range(0));
+  const auto& trace = getReplayTrace();
+
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  for (auto _ : st) {
+    auto cache = ObjectCache<SizedObject, ObjectCacheFlavor::Simple>::create(
+        FLAGS_replay_cache_size, 0, 1, policy);
+    for (const auto& access : trace) {
+      if (cache->getSimple(access.id)) {
+        continue;
+      }
+      cache->insertSimple(
+          std::make_shared<SizedObject>(access.id, access.size));
+    }
+    auto stats = cache->getStats();
+    hits += stats.hitCount;
+    misses += stats.missCount;
+  }
+
+  st.counters["hit_rate"] =
+      static_cast<double>(hits) / std::max<uint64_t>(hits + misses, 1);
+  st.SetItemsProcessed(st.iterations() * trace.size());
+}
+
+BENCHMARK(replayTrace)
+    ->ArgName("policy")
+    ->Arg(static_cast<int64_t>(ObjectCachePolicy::LRU))
+    ->Arg(static_cast<int64_t>(ObjectCachePolicy::TinyLFU))
+    ->Unit(benchmark::kMillisecond);
+
 } // namespace
 
 EDEN_BENCHMARK_MAIN();
@@ -534,3 +534,217 @@ TEST(
   handle3.reset();
   EXPECT_TRUE(cache->contains(hash3));
 }
+
+/**
+ * sharded cache test cases
+ */
+
+TEST(ObjectCache, sharded_cache_finds_inserted_objects) {
+  auto cache =
+      ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::create(1000, 0, 4);
+  EXPECT_EQ(4, cache->getNumShards());
+
+  cache->insertSimple(object3);
+  cache->insertSimple(object4);
+  cache->insertSimple(object5);
+  cache->insertSimple(object6);
+
+  EXPECT_EQ(object3, cache->getSimple(hash3));
+  EXPECT_EQ(object4, cache->getSimple(hash4));
+  EXPECT_EQ(object5, cache->getSimple(hash5));
+  EXPECT_EQ(object6, cache->getSimple(hash6));
+  EXPECT_EQ(nullptr, cache->getSimple(hash9));
+}
+
+TEST(ObjectCache, sharded_cache_aggregates_stats) {
+  auto cache =
+      ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::create(1000, 0, 4);
+
+  cache->insertSimple(object3);
+  cache->insertSimple(object4);
+  cache->insertSimple(object5);
+  cache->getSimple(hash3);
+  cache->getSimple(hash4);
+  cache->getSimple(hash9);
+
+  auto stats = cache->getStats();
+  EXPECT_EQ(3, stats.objectCount);
+  EXPECT_EQ(12, stats.totalSizeInBytes);
+  EXPECT_EQ(2, stats.hitCount);
+  EXPECT_EQ(1, stats.missCount);
+
+  cache->clear();
+  stats = cache->getStats();
+  EXPECT_EQ(0, stats.objectCount);
+  EXPECT_EQ(0, stats.totalSizeInBytes);
+}
+
+TEST(ObjectCache, sharded_cache_splits_size_budget) {
+  // Each of the 2 shards gets a 5 byte budget, so no shard can hold more than
+  // one of these objects.
+  auto cache =
+      ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::create(10, 0, 2);
+
+  cache->insertSimple(object3);
+  cache->insertSimple(object3a);
+  cache->insertSimple(object3b);
+  cache->insertSimple(object3c);
+
+  auto stats = cache->getStats();
+  EXPECT_GE(2, stats.objectCount);
+  EXPECT_GE(10, stats.totalSizeInBytes);
+  EXPECT_EQ(4 - stats.objectCount, stats.evictionCount);
+}
+
+TEST(ObjectCache, sharded_cache_interest_handle_evicts_on_drop) {
+  auto cache =
+      ObjectCache<CacheObject, ObjectCacheFlavor::InterestHandle>::create(
+          1000, 0, 4);
+  auto handle3 = cache->insertInterestHandle(
+      object3,
+      ObjectCache<CacheObject, ObjectCacheFlavor::InterestHandle>::Interest::
+          WantHandle);
+  cache->insertInterestHandle(object4);
+  EXPECT_TRUE(cache->contains(hash3));
+
+  handle3.reset();
+  EXPECT_FALSE(cache->contains(hash3));
+  EXPECT_TRUE(cache->contains(hash4));
+  EXPECT_EQ(1, cache->getStats().dropCount);
+}
+
+namespace {
+std::vector<std::shared_ptr<CacheObject>> makeObjects(
+    folly::StringPiece prefix,
+    size_t count,
+    size_t size) {
+  std::vector<std::shared_ptr<CacheObject>> objects;
+  objects.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    objects.push_back(std::make_shared<CacheObject>(
+        ObjectId::sha1(fmt::format("{}-{}", prefix, i)), size));
+  }
+  return objects;
+}
+
+/**
+ * Inserts and reads hot objects a few times, then reads many cold objects
+ * once each, the way a scan of the repository would. Returns the number of
+ * hot objects still cached.
+ */
+size_t countHotObjectsAfterScan(ObjectCachePolicy policy) {
+  auto cache = ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::create(
+      1000, 0, 1, policy);
+
+  auto hot = makeObjects("hot", 10, 10);
+  for (const auto& object : hot) {
+    cache->insertSimple(object);
+  }
+  for (int round = 0; round < 3; ++round) {
+    for (const auto& object : hot) {
+      EXPECT_EQ(object, cache->getSimple(object->getHash()));
+    }
+  }
+
+  for (const auto& object : makeObjects("cold", 500, 10)) {
+    EXPECT_EQ(nullptr, cache->getSimple(object->getHash()));
+    cache->insertSimple(object);
+  }
+
+  EXPECT_GE(1000, cache->getStats().totalSizeInBytes);
+  size_t cached = 0;
+  for (const auto& object : hot) {
+    cached += cache->contains(object->getHash());
+  }
+  return cached;
+}
+} // namespace
+
+TEST(ObjectCache, lru_cache_is_flushed_by_scan) {
+  EXPECT_EQ(0, countHotObjectsAfterScan(ObjectCachePolicy::LRU));
+}
+
+TEST(ObjectCache, tinylfu_cache_keeps_hot_objects_across_scan) {
+  EXPECT_EQ(10, countHotObjectsAfterScan(ObjectCachePolicy::TinyLFU));
+}
+
+TEST(ObjectCache, tinylfu_cache_admits_everything_until_full) {
+  auto cache = ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::create(
+      1000, 0, 1, ObjectCachePolicy::TinyLFU);
+
+  auto objects = makeObjects("object", 100, 10);
+  for (const auto& object : objects) {
+    cache->insertSimple(object);
+  }
+  for (const auto& object : objects) {
+    EXPECT_TRUE(cache->contains(object->getHash()));
+  }
+
+  auto stats = cache->getStats();
+  EXPECT_EQ(100, stats.objectCount);
+  EXPECT_EQ(1000, stats.totalSizeInBytes);
+  EXPECT_EQ(0, stats.evictionCount);
+}
+
+TEST(ObjectCache, tinylfu_cache_keeps_minimum_entry_count) {
+  auto cache = ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::create(
+      10, 2, 1, ObjectCachePolicy::TinyLFU);
+
+  cache->insertSimple(object9);
+  cache->insertSimple(object11);
+  EXPECT_TRUE(cache->contains(hash9));
+  EXPECT_TRUE(cache->contains(hash11));
+  EXPECT_EQ(2, cache->getStats().objectCount);
+}
+
+TEST(ObjectCache, tinylfu_cache_admits_objects_larger_than_window) {
+  using Cache = ObjectCache<CacheObject, ObjectCacheFlavor::InterestHandle>;
+  auto cache = Cache::create(100, 0, 1, ObjectCachePolicy::TinyLFU);
+
+  auto popular = makeObjects("popular", 10, 10);
+  for (const auto& object : popular) {
+    cache->insertInterestHandle(object);
+  }
+  for (const auto& object : popular) {
+    cache->getInterestHandle(object->getHash());
+  }
+
+  // The newcomer is larger than the 1 byte window, and was never read
+  // before, but is admitted anyway, so that its handle keeps it cached.
+  auto newcomer = std::make_shared<CacheObject>(ObjectId::sha1("new"), 10);
+  auto newcomerHash = newcomer->getHash();
+  auto handle = cache->insertInterestHandle(
+      std::move(newcomer), Cache::Interest::WantHandle);
+  EXPECT_TRUE(cache->contains(newcomerHash));
+  ASSERT_NE(nullptr, handle.getObject());
+  EXPECT_EQ(newcomerHash, handle.getObject()->getHash());
+  EXPECT_EQ(1, cache->getStats().evictionCount);
+
+  handle.reset();
+  EXPECT_FALSE(cache->contains(newcomerHash));
+  EXPECT_EQ(1, cache->getStats().dropCount);
+  EXPECT_EQ(9, cache->getStats().objectCount);
+}
+
+TEST(ObjectCache, tinylfu_cache_interest_handle_evicts_on_drop) {
+  using Cache = ObjectCache<CacheObject, ObjectCacheFlavor::InterestHandle>;
+  auto cache = Cache::create(1000, 0, 1, ObjectCachePolicy::TinyLFU);
+
+  // object3 leaves the window, then is read again and protected.
+  auto handle3 =
+      cache->insertInterestHandle(object3, Cache::Interest::WantHandle);
+  cache->insertInterestHandle(object4);
+  cache->insertInterestHandle(object5);
+  auto result = cache->getInterestHandle(hash3, Cache::Interest::WantHandle);
+  EXPECT_EQ(object3, result.object);
+
+  handle3.reset();
+  EXPECT_TRUE(cache->contains(hash3));
+  result.interestHandle.reset();
+  EXPECT_FALSE(cache->contains(hash3));
+  EXPECT_EQ(1, cache->getStats().dropCount);
+
+  auto stats = cache->getStats();
+  EXPECT_EQ(2, stats.objectCount);
+  EXPECT_EQ(9, stats.totalSizeInBytes);
+}
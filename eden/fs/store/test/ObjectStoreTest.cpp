@@ -11,6 +11,7 @@
 #include "eden/common/utils/ProcessNameCache.h"
 #include "eden/fs/config/ReloadableConfig.h"
 #include "eden/fs/model/TestOps.h"
+#include "eden/fs/store/DiskBlobCache.h"
 #include "eden/fs/store/LocalStoreCachedBackingStore.h"
 #include "eden/fs/store/MemoryLocalStore.h"
 #include "eden/fs/store/ObjectFetchContext.h"
@@ -21,6 +22,7 @@
 #include "eden/fs/testharness/FakeBackingStore.h"
 #include "eden/fs/testharness/LoggingFetchContext.h"
 #include "eden/fs/testharness/StoredObject.h"
+#include "eden/fs/testharness/TempFile.h"
 #include "eden/fs/utils/ImmediateFuture.h"
 
 using namespace facebook::eden;
@@ -227,6 +229,95 @@ TEST_F(ObjectStoreTest, get_size_and_sha1_only_imports_blob_once) {
   EXPECT_EQ(1, fakeBackingStore->getAccessCount(readyBlobId));
 }
 
+TEST_F(ObjectStoreTest, getBlobBlake3_is_computed_on_demand_and_stored) {
+  auto expected = Hash32::blake3(std::string{"readyblob"});
+
+  objectStore->getBlobMetadata(readyBlobId, context).get(0ms);
+  EXPECT_FALSE(localStore->getBlobBlake3(readyBlobId).get(0ms).has_value());
+
+  EXPECT_EQ(
+      expected, objectStore->getBlobBlake3(readyBlobId, context).get(0ms));
+  EXPECT_EQ(expected, localStore->getBlobBlake3(readyBlobId).get(0ms));
+
+  auto accesses = fakeBackingStore->getAccessCount(readyBlobId);
+  EXPECT_EQ(
+      expected, objectStore->getBlobBlake3(readyBlobId, context).get(0ms));
+  EXPECT_EQ(accesses, fakeBackingStore->getAccessCount(readyBlobId));
+}
+
+TEST_F(ObjectStoreTest, blob_ranges_are_served_from_disk_blob_cache) {
+  auto tempDir = makeTempDir();
+  auto diskBlobCache = std::make_shared<DiskBlobCache>(
+      canonicalPath(tempDir.path().string()), 1024 * 1024, 1);
+  auto store = ObjectStore::create(
+      localStore,
+      backingStore,
+      treeCache,
+      stats.copy(),
+      std::make_shared<ProcessNameCache>(),
+      std::make_shared<NullStructuredLogger>(),
+      EdenConfig::createTestEdenConfig(),
+      kPathMapDefaultCaseSensitive,
+      diskBlobCache);
+
+  auto id = putReadyBlob("disk cached blob");
+  EXPECT_FALSE(store->supportsBlobRange(id));
+  store->getBlob(id, context).get(0ms);
+  ASSERT_TRUE(diskBlobCache->contains(id));
+  EXPECT_TRUE(store->supportsBlobRange(id));
+
+  auto accesses = fakeBackingStore->getAccessCount(id);
+  EXPECT_EQ(
+      "cached", store->getBlobRange(id, 5, 6, context).get(0ms)->asString());
+  EXPECT_EQ(accesses, fakeBackingStore->getAccessCount(id));
+}
+
+TEST_F(ObjectStoreTest, concurrent_getBlob_shares_one_fetch) {
+  StoredBlob* storedBlob = fakeBackingStore->putBlob("pending");
+  auto id = storedBlob->get().getHash();
+
+  auto future1 = objectStore->getBlob(id, context).semi();
+  auto future2 = objectStore->getBlob(id, context).semi();
+  EXPECT_FALSE(future1.isReady());
+  EXPECT_FALSE(future2.isReady());
+
+  storedBlob->setReady();
+  auto blob1 = std::move(future1).get(0ms);
+  auto blob2 = std::move(future2).get(0ms);
+  EXPECT_EQ(blob1, blob2);
+  EXPECT_EQ(1, fakeBackingStore->getAccessCount(id));
+  EXPECT_EQ(2, loggingContext->requests.size())
+      << "each request still reports its own fetch";
+}
+
+TEST_F(ObjectStoreTest, concurrent_getTree_shares_one_fetch) {
+  StoredBlob* child = fakeBackingStore->putBlob("child");
+  StoredTree* storedTree = fakeBackingStore->putTree({{"file", child}});
+  auto id = storedTree->get().getHash();
+
+  auto future1 = objectStore->getTree(id, context).semi();
+  auto future2 = objectStore->getTree(id, context).semi();
+
+  storedTree->setReady();
+  auto tree1 = std::move(future1).get(0ms);
+  auto tree2 = std::move(future2).get(0ms);
+  EXPECT_EQ(tree1->getHash(), tree2->getHash());
+  EXPECT_EQ(1, fakeBackingStore->getAccessCount(id));
+}
+
+TEST_F(ObjectStoreTest, shared_fetch_failure_reaches_every_waiter) {
+  StoredBlob* storedBlob = fakeBackingStore->putBlob("failing");
+  auto id = storedBlob->get().getHash();
+
+  auto future1 = objectStore->getBlob(id, context).semi();
+  auto future2 = objectStore->getBlob(id, context).semi();
+
+  storedBlob->triggerError(std::runtime_error("fetch failed"));
+  EXPECT_THROW(std::move(future1).get(0ms), std::runtime_error);
+  EXPECT_THROW(std::move(future2).get(0ms), std::runtime_error);
+  EXPECT_EQ(1, fakeBackingStore->getAccessCount(id));
+}
+
 class PidFetchContext final : public ObjectFetchContext {
  public:
   PidFetchContext(pid_t pid) : ObjectFetchContext{}, pid_{pid} {}
@@ -256,16 +347,16 @@ TEST_F(ObjectStoreTest, test_process_access_counts) {
 
   // first fetch increments fetch count for pid0
   objectStore->getBlob(readyBlobId, pidContext0).get(0ms);
-  EXPECT_EQ(1, objectStore->getPidFetches().rlock()->at(pid0));
+  EXPECT_EQ(1, objectStore->getPidFetches().at(pid0));
 
   // local fetch also increments fetch count for pid0
   objectStore->getBlob(readyBlobId, pidContext0).get(0ms);
-  EXPECT_EQ(2, objectStore->getPidFetches().rlock()->at(pid0));
+  EXPECT_EQ(2, objectStore->getPidFetches().at(pid0));
 
   // increments fetch count for pid1
   objectStore->getBlob(readyBlobId, pidContext1).get(0ms);
-  EXPECT_EQ(2, objectStore->getPidFetches().rlock()->at(pid0));
-  EXPECT_EQ(1, objectStore->getPidFetches().rlock()->at(pid1));
+  EXPECT_EQ(2, objectStore->getPidFetches().at(pid0));
+  EXPECT_EQ(1, objectStore->getPidFetches().at(pid1));
 }
 
 class FetchContext final : public ObjectFetchContext {
@@ -332,3 +423,91 @@ TEST_F(
   EXPECT_TRUE(std::move(fut).get(0ms));
   EXPECT_EQ(context->getFetchCount(), 2);
 }
+
+namespace {
+struct PrefetchTreesTest : ObjectStoreTest {
+  void SetUp() override {
+    ObjectStoreTest::SetUp();
+
+    // root
+    //   a/
+    //     b/
+    //       file
+    //   c/
+    //   file
+    StoredBlob* file = fakeBackingStore->putBlob("file");
+    file->setReady();
+    StoredTree* b = fakeBackingStore->putTree({{"file", file}});
+    StoredTree* a = fakeBackingStore->putTree({{"b", b}});
+    // An empty tree with its own id: the fixture already stores one.
+    StoredTree* c = fakeBackingStore->putTree(
+        ObjectId{"c_tree"}, Tree::container{kPathMapDefaultCaseSensitive});
+    StoredTree* root =
+        fakeBackingStore->putTree({{"a", a}, {"c", c}, {"file", file}});
+    for (auto* tree : {b, a, c, root}) {
+      tree->setReady();
+    }
+    aId = a->get().getHash();
+    bId = b->get().getHash();
+    cId = c->get().getHash();
+    rootId = root->get().getHash();
+  }
+
+  ObjectId aId;
+  ObjectId bId;
+  ObjectId cId;
+  ObjectId rootId;
+};
+} // namespace
+
+TEST_F(PrefetchTreesTest, fetches_every_level) {
+  objectStore
+      ->prefetchTrees(rootId, ObjectStore::kUnlimitedDepth, nullptr, context)
+      .get(0ms);
+  for (const auto& id : {rootId, aId, bId, cId}) {
+    EXPECT_EQ(1, fakeBackingStore->getAccessCount(id));
+  }
+}
+
+TEST_F(PrefetchTreesTest, stops_at_depth) {
+  objectStore->prefetchTrees(rootId, 1, nullptr, context).get(0ms);
+  EXPECT_EQ(1, fakeBackingStore->getAccessCount(rootId));
+  EXPECT_EQ(1, fakeBackingStore->getAccessCount(aId));
+  EXPECT_EQ(1, fakeBackingStore->getAccessCount(cId));
+  EXPECT_EQ(0, fakeBackingStore->getAccessCount(bId));
+}
+
+TEST_F(PrefetchTreesTest, skips_filtered_subtrees) {
+  std::vector<RelativePath> visited;
+  objectStore
+      ->prefetchTrees(
+          rootId,
+          ObjectStore::kUnlimitedDepth,
+          [&](RelativePathPiece path, const TreeEntry& entry) {
+            EXPECT_TRUE(entry.isTree());
+            visited.emplace_back(path);
+            return path != "a"_relpath;
+          },
+          context)
+      .get(0ms);
+  EXPECT_EQ((std::vector<RelativePath>{"a"_relpath, "c"_relpath}), visited);
+  EXPECT_EQ(0, fakeBackingStore->getAccessCount(aId));
+  EXPECT_EQ(0, fakeBackingStore->getAccessCount(bId));
+  EXPECT_EQ(1, fakeBackingStore->getAccessCount(cId));
+}
+
+TEST_F(PrefetchTreesTest, can_be_cancelled) {
+  folly::CancellationSource cancellation;
+  cancellation.requestCancellation();
+  EXPECT_THROW(
+      objectStore
+          ->prefetchTrees(
+              rootId,
+              ObjectStore::kUnlimitedDepth,
+              nullptr,
+              context,
+              cancellation.getToken())
+          .get(0ms),
+      folly::OperationCancelled);
+  EXPECT_EQ(0, fakeBackingStore->getAccessCount(rootId));
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/PidFetchCounts.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace facebook::eden;
+
+TEST(PidFetchCounts, counts_fetches_by_pid) {
+  PidFetchCounts counts;
+
+  EXPECT_EQ(0, counts.recordProcessFetch(1));
+  EXPECT_EQ(1, counts.recordProcessFetch(1));
+  EXPECT_EQ(0, counts.recordProcessFetch(2));
+
+  EXPECT_EQ(2, counts.getCountByPid(1));
+  EXPECT_EQ(1, counts.getCountByPid(2));
+  EXPECT_EQ(0, counts.getCountByPid(3));
+
+  auto all = counts.getAllCounts();
+  EXPECT_EQ(2, all.size());
+  EXPECT_EQ(2, all.at(1));
+  EXPECT_EQ(1, all.at(2));
+
+  counts.clear();
+  EXPECT_EQ(0, counts.getCountByPid(1));
+  EXPECT_TRUE(counts.getAllCounts().empty());
+}
+
+TEST(PidFetchCounts, memory_is_bounded) {
+  PidFetchCounts counts{64};
+
+  for (int i = 0; i < 1000; ++i) {
+    counts.recordProcessFetch(1);
+  }
+  for (pid_t pid = 100; pid < 10000; ++pid) {
+    counts.recordProcessFetch(pid);
+  }
+
+  // Each shard tracks at most 64 / 16 pids.
+  EXPECT_GE(64, counts.getAllCounts().size());
+
+  // The heavy hitter is still tracked, and counts are never underestimated.
+  EXPECT_LE(1000, counts.getCountByPid(1));
+}
+
+TEST(PidFetchCounts, replacing_pid_does_not_inherit_reported_count) {
+  // A single pid per shard.
+  PidFetchCounts counts{1};
+
+  for (int i = 0; i < 100; ++i) {
+    counts.recordProcessFetch(1);
+  }
+  // Fetch from new pids until one lands in the shard of pid 1.
+  pid_t pid = 1;
+  while (counts.getOverestimatedCountByPid(1) != 0) {
+    EXPECT_EQ(0, counts.recordProcessFetch(++pid));
+  }
+
+  // The new pid only reports the fetches it made, but its raw count includes
+  // the ones of pid 1.
+  EXPECT_EQ(1, counts.getCountByPid(pid));
+  EXPECT_EQ(101, counts.getOverestimatedCountByPid(pid));
+  EXPECT_EQ(1, counts.recordProcessFetch(pid));
+  EXPECT_EQ(2, counts.getAllCounts().at(pid));
+}
+
+TEST(PidFetchCounts, concurrent_fetches_are_all_counted) {
+  PidFetchCounts counts;
+
+  constexpr int kThreads = 8;
+  constexpr int kFetches = 10000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < kFetches; ++i) {
+        counts.recordProcessFetch(1);
+        counts.recordProcessFetch(100 + t);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(kThreads * kFetches, counts.getCountByPid(1));
+  for (int t = 0; t < kThreads; ++t) {
+    EXPECT_EQ(kFetches, counts.getCountByPid(100 + t));
+  }
+}
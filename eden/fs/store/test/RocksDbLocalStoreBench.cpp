@@ -5,7 +5,9 @@
  * GNU General Public License version 2.
  */
 
+#include <folly/Utility.h>
 #include "eden/common/utils/benchharness/Bench.h"
+#include "eden/fs/model/Tree.h"
 #include "eden/fs/store/RocksDbLocalStore.h"
 #include "eden/fs/telemetry/NullStructuredLogger.h"
 #include "eden/fs/testharness/TempFile.h"
@@ -59,6 +61,86 @@ void getBlobMetadata(benchmark::State& st) {
 }
 BENCHMARK(getBlobMetadata);
 
+/**
+ * Fills a store with synthetic trees and blob metadata using the RocksDB
+ * profile given as argument, then reports the disk footprint of each column
+ * family and the latency of tree lookups.
+ */
+void profile(benchmark::State& st) {
+  auto profile = static_cast<RocksDbProfile>(st.range(0));
+  auto tempDir = makeTempDir();
+  FaultInjector faultInjector{false};
+  auto makeStore = [&] {
+    return std::make_unique<RocksDbLocalStore>(
+        canonicalPath(tempDir.path().string()),
+        std::make_shared<NullStructuredLogger>(),
+        &faultInjector,
+        RocksDBOpenMode::ReadWrite,
+        profile);
+  };
+  auto store = makeStore();
+  try {
+    store->open();
+  } catch (const std::exception& ex) {
+    // The zstd profile requires RocksDB to be built with zstd.
+    st.SkipWithError(ex.what());
+    return;
+  }
+
+  const size_t N = 100'000;
+  constexpr size_t kEntriesPerTree = 20;
+
+  // Trees reuse a limited set of names, like in a real repository.
+  std::vector<PathComponent> names;
+  for (size_t i = 0; i < 200; ++i) {
+    names.emplace_back(fmt::format("source_file_{}.cpp", i));
+  }
+
+  std::vector<ObjectId> ids;
+  ids.reserve(N);
+  auto batch = store->beginWrite(16 * 1024 * 1024);
+  for (size_t i = 0; i < N; ++i) {
+    ids.push_back(ObjectId::sha1(fmt::format("tree{}", i)));
+    Tree::container entries{kPathMapDefaultCaseSensitive};
+    for (size_t j = 0; j < kEntriesPerTree; ++j) {
+      auto contentId = ObjectId::sha1(fmt::format("blob{}-{}", i, j));
+      entries.emplace(
+          names[(i * 7 + j * 13) % names.size()],
+          contentId,
+          TreeEntryType::REGULAR_FILE);
+      batch->putBlobMetadata(
+          contentId,
+          BlobMetadata{Hash20::sha1(contentId.getBytes()), i * j});
+    }
+    batch->putTree(Tree{std::move(entries), ids.back()});
+  }
+  batch->flush();
+
+  // Compact so that the data ends up in the compressed levels, then reopen
+  // the database to exercise the read-from-disk path.
+  store->compactKeySpace(KeySpace::TreeFamily);
+  store->compactKeySpace(KeySpace::BlobMetaDataFamily);
+  st.counters["tree_bytes"] = store->getApproximateSize(KeySpace::TreeFamily);
+  st.counters["blobmeta_bytes"] =
+      store->getApproximateSize(KeySpace::BlobMetaDataFamily);
+  store.reset();
+  store = makeStore();
+  store->open();
+
+  size_t i = 0;
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(store->getTree(ids[i]).get());
+    if (++i == N) {
+      i = 0;
+    }
+  }
+}
+BENCHMARK(profile)
+    ->ArgName("profile")
+    ->Arg(folly::to_underlying(RocksDbProfile::Uniform))
+    ->Arg(folly::to_underlying(RocksDbProfile::PerKeySpace))
+    ->Arg(folly::to_underlying(RocksDbProfile::PerKeySpaceZstd));
+
 } // namespace
 
 EDEN_BENCHMARK_MAIN();
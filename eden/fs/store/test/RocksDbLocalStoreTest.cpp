@@ -12,6 +12,7 @@
 namespace {
 
 using namespace facebook::eden;
+using namespace folly::string_piece_literals;
 
 LocalStoreImplResult makeRocksDbLocalStore(FaultInjector* faultInjector) {
   auto tempDir = makeTempDir();
@@ -22,6 +23,47 @@ LocalStoreImplResult makeRocksDbLocalStore(FaultInjector* faultInjector) {
   return {std::move(tempDir), std::move(store)};
 }
 
+LocalStoreImplResult makePerKeySpaceRocksDbLocalStore(
+    FaultInjector* faultInjector) {
+  auto tempDir = makeTempDir();
+  auto store = std::make_unique<RocksDbLocalStore>(
+      canonicalPath(tempDir.path().string()),
+      std::make_shared<NullStructuredLogger>(),
+      faultInjector,
+      RocksDBOpenMode::ReadWrite,
+      RocksDbProfile::PerKeySpace);
+  return {std::move(tempDir), std::move(store)};
+}
+
+TEST(RocksDbLocalStore, profile_can_change_between_opens) {
+  auto tempDir = makeTempDir();
+  FaultInjector faultInjector{/*enabled=*/false};
+  auto makeStore = [&](RocksDbProfile profile) {
+    auto store = std::make_unique<RocksDbLocalStore>(
+        canonicalPath(tempDir.path().string()),
+        std::make_shared<NullStructuredLogger>(),
+        &faultInjector,
+        RocksDBOpenMode::ReadWrite,
+        profile);
+    store->open();
+    return store;
+  };
+
+  auto store = makeStore(RocksDbProfile::Uniform);
+  store->put(KeySpace::TreeFamily, "tree"_sp, "contents"_sp);
+  store->put(KeySpace::BlobMetaDataFamily, "meta"_sp, "data"_sp);
+  store->compactKeySpace(KeySpace::TreeFamily);
+  store->close();
+
+  store = makeStore(RocksDbProfile::PerKeySpace);
+  EXPECT_EQ("contents", store->get(KeySpace::TreeFamily, "tree"_sp).piece());
+  EXPECT_EQ(
+      "data", store->get(KeySpace::BlobMetaDataFamily, "meta"_sp).piece());
+  store->put(KeySpace::TreeFamily, "tree2"_sp, "contents2"_sp);
+  store->compactKeySpace(KeySpace::TreeFamily);
+  EXPECT_EQ("contents2", store->get(KeySpace::TreeFamily, "tree2"_sp).piece());
+}
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wdeprecated-declarations"
 INSTANTIATE_TEST_CASE_P(
@@ -33,6 +75,11 @@ INSTANTIATE_TEST_CASE_P(
     RocksDB,
     OpenCloseLocalStoreTest,
     ::testing::Values(makeRocksDbLocalStore));
+
+INSTANTIATE_TEST_CASE_P(
+    RocksDBPerKeySpace,
+    LocalStoreTest,
+    ::testing::Values(makePerKeySpaceRocksDbLocalStore));
 #pragma clang diagnostic pop
 
 } // namespace
@@ -28,6 +28,7 @@ struct JournalStats;
 struct ThriftStats;
 struct TelemetryStats;
 struct OverlayStats;
+struct LocalStoreStats;
 
 /**
  * StatsGroupBase is a base class for a group of thread-local stats
@@ -122,6 +123,7 @@ class EdenStats : public RefCounted {
   ThreadLocal<ThriftStats> thriftStats_;
   ThreadLocal<TelemetryStats> telemetryStats_;
   ThreadLocal<OverlayStats> overlayStats_;
+  ThreadLocal<LocalStoreStats> localStoreStats_;
 };
 
 using EdenStatsPtr = RefPtr<EdenStats>;
@@ -178,6 +180,11 @@ inline OverlayStats& EdenStats::getStatsForCurrentThread<OverlayStats>() {
   return *overlayStats_.get();
 }
 
+template <>
+inline LocalStoreStats& EdenStats::getStatsForCurrentThread<LocalStoreStats>() {
+  return *localStoreStats_.get();
+}
+
 template <typename T>
 class StatsGroup : public StatsGroupBase {
  public:
@@ -211,6 +218,7 @@ struct FuseStats : StatsGroup<FuseStats> {
   Duration fsync{"fuse.fsync_us"};
   Duration opendir{"fuse.opendir_us"};
   Duration readdir{"fuse.readdir_us"};
+  Duration readdirplus{"fuse.readdirplus_us"};
   Duration releasedir{"fuse.releasedir_us"};
   Duration fsyncdir{"fuse.fsyncdir_us"};
   Duration statfs{"fuse.statfs_us"};
@@ -284,12 +292,28 @@ struct PrjfsStats : StatsGroup<PrjfsStats> {
 struct ObjectStoreStats : StatsGroup<ObjectStoreStats> {
   Duration getTree{"store.get_tree_us"};
   Duration getBlob{"store.get_blob_us"};
+  Duration getBlobRange{"store.get_blob_range_us"};
   Duration getBlobMetadata{"store.get_blob_metadata_us"};
+  Duration prefetchTrees{"store.prefetch_trees_us"};
+
+  Counter prefetchTreesFetched{"object_store.prefetch_trees.fetched"};
+  Counter prefetchTreesFailed{"object_store.prefetch_trees.failed"};
 
   Counter getBlobFromLocalStore{"object_store.get_blob.local_store"};
+  Counter getBlobFromDiskBlobCache{"object_store.get_blob.disk_blob_cache"};
+  Counter diskBlobCacheEviction{"object_store.disk_blob_cache.eviction"};
   Counter getBlobFromBackingStore{"object_store.get_blob.backing_store"};
 
+  // Requests that joined an in-flight fetch of the same object.
+  Counter getTreeInFlight{"object_store.get_tree.in_flight"};
+  Counter getBlobInFlight{"object_store.get_blob.in_flight"};
+  Counter getBlobMetadataInFlight{"object_store.get_blob_metadata.in_flight"};
+
   Counter getBlobMetadataFromMemory{"object_store.get_blob_metadata.memory"};
+  Counter blobMetadataMemoryCacheMiss{
+      "object_store.blob_metadata_memory_cache.miss"};
+  Counter blobMetadataMemoryCacheEviction{
+      "object_store.blob_metadata_memory_cache.eviction"};
   Counter getBlobMetadataFromLocalStore{
       "object_store.get_blob_metadata.local_store"};
   Counter getBlobMetadataFromBackingStore{
@@ -318,6 +342,10 @@ struct HgBackingStoreStats : StatsGroup<HgBackingStoreStats> {
   Duration getBlobMetadata{"store.hg.get_blob_metadata_us"};
   Duration fetchBlobMetadata{"store.hg.get_blob_metadata_us"};
   Counter loadProxyHash{"store.hg.load_proxy_hash"};
+  Duration blobImportBatch{"store.hg.import_batch.blob_us"};
+  Duration treeImportBatch{"store.hg.import_batch.tree_us"};
+  Duration blobMetadataImportBatch{"store.hg.import_batch.blob_metadata_us"};
+  Counter importCancelled{"store.hg.import_cancelled"};
 };
 
 /**
@@ -359,6 +387,13 @@ struct OverlayStats : StatsGroup<OverlayStats> {
   Duration renameChild{"overlay.rename_child_us"};
 };
 
+struct LocalStoreStats : StatsGroup<LocalStoreStats> {
+  Duration groupCommitWrite{"local_store.group_commit.write_us"};
+  Counter groupCommitBatchSize{"local_store.group_commit.batch_size"};
+  Counter groupCommitBatchBytes{"local_store.group_commit.batch_bytes"};
+  Counter groupCommitWriteFailure{"local_store.group_commit.write_failure"};
+};
+
 /**
  * On construction, notes the current time. On destruction, records the elapsed
  * time in the specified EdenStats Duration.
@@ -82,6 +82,20 @@ ImmediateFuture<std::shared_ptr<const Blob>> FakeObjectStore::getBlob(
   return make_shared<const Blob>(iter->second);
 }
 
+ImmediateFuture<std::shared_ptr<const Blob>> FakeObjectStore::getBlobRange(
+    const ObjectId& id,
+    uint64_t offset,
+    uint64_t length,
+    const ObjectFetchContextPtr&) const {
+  ++accessCounts_[id];
+  auto iter = blobs_.find(id);
+  if (iter == blobs_.end()) {
+    return makeImmediateFuture<shared_ptr<const Blob>>(
+        std::domain_error(fmt::format("blob {} not found", id)));
+  }
+  return make_shared<const Blob>(id, iter->second.getRange(offset, length));
+}
+
 ImmediateFuture<folly::Unit> FakeObjectStore::prefetchBlobs(
     ObjectIdRange,
     const ObjectFetchContextPtr&) const {
@@ -45,6 +45,15 @@ class FakeObjectStore final : public IObjectStore {
       const ObjectId& id,
       const ObjectFetchContextPtr& context =
           ObjectFetchContext::getNullContext()) const override;
+  bool supportsBlobRange(const ObjectId&) const override {
+    return true;
+  }
+  ImmediateFuture<std::shared_ptr<const Blob>> getBlobRange(
+      const ObjectId& id,
+      uint64_t offset,
+      uint64_t length,
+      const ObjectFetchContextPtr& context =
+          ObjectFetchContext::getNullContext()) const override;
   ImmediateFuture<folly::Unit> prefetchBlobs(
       ObjectIdRange ids,
       const ObjectFetchContextPtr& context =
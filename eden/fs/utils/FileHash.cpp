@@ -8,12 +8,21 @@
 #include "eden/fs/utils/FileHash.h"
 #include <folly/portability/OpenSSL.h>
 #include "eden/common/utils/WinError.h"
+#include "eden/fs/digest/Blake3.h"
 
 namespace facebook::eden {
 
 #ifdef _WIN32
 
-Hash20 getFileSha1(AbsolutePathPiece filePath) {
+namespace {
+/**
+ * Read the whole file, passing its contents to update chunk by chunk.
+ */
+template <typename Update>
+void readFileChunks(
+    AbsolutePathPiece filePath,
+    folly::StringPiece hashName,
+    Update&& update) {
   auto widePath = filePath.wide();
 
   HANDLE fileHandle = CreateFileW(
@@ -33,8 +42,6 @@ Hash20 getFileSha1(AbsolutePathPiece filePath) {
     CloseHandle(fileHandle);
   };
 
-  SHA_CTX ctx;
-  SHA1_Init(&ctx);
   while (true) {
     uint8_t buf[8192];
 
@@ -43,15 +50,26 @@ Hash20 getFileSha1(AbsolutePathPiece filePath) {
       throw makeWin32ErrorExplicit(
           GetLastError(),
           fmt::format(
-              FMT_STRING("Error while computing SHA1 of {}"), filePath));
+              FMT_STRING("Error while computing {} of {}"),
+              hashName,
+              filePath));
     }
 
     if (bytesRead == 0) {
       break;
     }
 
-    SHA1_Update(&ctx, buf, bytesRead);
+    update(buf, bytesRead);
   }
+}
+} // namespace
+
+Hash20 getFileSha1(AbsolutePathPiece filePath) {
+  SHA_CTX ctx;
+  SHA1_Init(&ctx);
+  readFileChunks(filePath, "SHA1", [&](const uint8_t* buf, size_t len) {
+    SHA1_Update(&ctx, buf, len);
+  });
 
   static_assert(Hash20::RAW_SIZE == SHA_DIGEST_LENGTH);
   Hash20 sha1;
@@ -60,6 +78,17 @@ Hash20 getFileSha1(AbsolutePathPiece filePath) {
   return sha1;
 }
 
+Hash32 getFileBlake3(AbsolutePathPiece filePath) {
+  Blake3 hasher;
+  readFileChunks(filePath, "BLAKE3", [&](const uint8_t* buf, size_t len) {
+    hasher.update(buf, len);
+  });
+
+  Hash32 blake3;
+  hasher.finalize(blake3.mutableBytes());
+  return blake3;
+}
+
 #endif
 
 } // namespace facebook::eden
@@ -15,6 +15,9 @@ namespace facebook::eden {
 #ifdef _WIN32
 /** Compute the sha1 of the file */
 Hash20 getFileSha1(AbsolutePathPiece filePath);
+
+/** Compute the BLAKE3 hash of the file */
+Hash32 getFileBlake3(AbsolutePathPiece filePath);
 #endif
 
 } // namespace facebook::eden